@@ -1,11 +1,14 @@
 #include "com/centreon/engine/engine_impl.hh"
 
+#include <google/protobuf/util/field_mask_util.h>
 #include <google/protobuf/util/time_util.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <algorithm>
 #include <functional>
 #include <future>
+#include <numeric>
+#include <unordered_set>
 #include <fmt/format.h>
 
 #include "com/centreon/engine/anomalydetection.hh"
@@ -29,6 +32,7 @@
 #include "com/centreon/engine/service.hh"
 #include "com/centreon/engine/servicedependency.hh"
 #include "com/centreon/engine/servicegroup.hh"
+#include "com/centreon/engine/snapshot.hh"
 #include "com/centreon/engine/statistics.hh"
 #include "com/centreon/engine/statusdata.hh"
 #include "com/centreon/engine/version.hh"
@@ -37,6 +41,72 @@ using namespace com::centreon::engine;
 using namespace com::centreon::engine::logging;
 using namespace com::centreon::engine::downtimes;
 
+/**
+ * @brief Fill an EngineHost message from a snapshot entry.
+ *
+ * @param entry The host entry.
+ * @param host The message to fill.
+ */
+static void fill_host(const snapshot::host_entry& entry, EngineHost* host) {
+  host->set_name(entry.name);
+  host->set_alias(entry.alias);
+  host->set_address(entry.address);
+  host->set_check_period(entry.check_period);
+  host->set_current_state(static_cast<EngineHost::State>(entry.current_state));
+  host->set_id(entry.id);
+  host->set_state_type(static_cast<EngineHost::StateType>(entry.state_type));
+  host->set_output(entry.plugin_output);
+  host->set_last_check(entry.last_check);
+  host->set_current_attempt(entry.current_attempt);
+  host->set_acknowledged(entry.acknowledged);
+  host->set_in_downtime(entry.in_downtime);
+}
+
+/**
+ * @brief Fill an EngineService message from a snapshot entry.
+ *
+ * @param entry The service entry.
+ * @param service The message to fill.
+ */
+static void fill_service(const snapshot::service_entry& entry,
+                         EngineService* service) {
+  service->set_host_id(entry.host_id);
+  service->set_service_id(entry.service_id);
+  service->set_host_name(entry.host_name);
+  service->set_description(entry.description);
+  service->set_check_period(entry.check_period);
+  service->set_current_state(
+      static_cast<EngineService::State>(entry.current_state));
+  service->set_state_type(
+      static_cast<EngineService::StateType>(entry.state_type));
+  service->set_output(entry.plugin_output);
+  service->set_last_check(entry.last_check);
+  service->set_current_attempt(entry.current_attempt);
+  service->set_acknowledged(entry.acknowledged);
+  service->set_in_downtime(entry.in_downtime);
+}
+
+/**
+ * @brief Get the current snapshot. If nothing has been published yet, the
+ * main loop is asked to publish one.
+ *
+ * @return The snapshot.
+ */
+static std::shared_ptr<const snapshot::data> get_snapshot() {
+  std::shared_ptr<const snapshot::data> retval{snapshot::instance().get()};
+  if (!retval) {
+    auto fn = std::packaged_task<int(void)>([]() -> int32_t {
+      snapshot::instance().publish();
+      return 0;
+    });
+    std::future<int32_t> result = fn.get_future();
+    command_manager::instance().enqueue(std::move(fn));
+    result.get();
+    retval = snapshot::instance().get();
+  }
+  return retval;
+}
+
 /**
  * @brief Return the Engine's version.
  *
@@ -61,6 +131,26 @@ grpc::Status engine_impl::GetStats(grpc::ServerContext* context
                                    const GenericString* request
                                    __attribute__((unused)),
                                    Stats* response) {
+  /* Statistics sections are served by the snapshot when available. */
+  uint32_t sections = command_manager::stats_sections(request->str_arg());
+  if (sections) {
+    snapshot::instance().stats_requested(sections);
+    std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+    if (snap && snap->stats &&
+        (snap->stats_sections & sections) == sections) {
+      if (sections & command_manager::stats_program) {
+        *response->mutable_program_configuration() =
+            snap->stats->program_configuration();
+        *response->mutable_program_status() = snap->stats->program_status();
+      }
+      if (sections & command_manager::stats_services)
+        *response->mutable_services_stats() = snap->stats->services_stats();
+      if (sections & command_manager::stats_hosts)
+        *response->mutable_hosts_stats() = snap->stats->hosts_stats();
+      return grpc::Status::OK;
+    }
+  }
+
   auto fn = std::packaged_task<int(void)>(
       std::bind(&command_manager::get_stats, &command_manager::instance(),
                 request->str_arg(), response));
@@ -120,6 +210,32 @@ grpc::Status engine_impl::ProcessHostCheckResult(grpc::ServerContext* context
   return grpc::Status::OK;
 }
 
+/**
+ * @brief Submit many passive host/service check results in one call. The whole
+ * batch is handled by the main loop in one task and the accepted results are
+ * given to the checker at once.
+ *
+ * @param context The gRPC context.
+ * @param request The check results.
+ * @param response One status per check result, in the same order, and the
+ *                 number of accepted ones.
+ *
+ * @return A grpc::Status::OK, checks refused are only reported in response.
+ */
+grpc::Status engine_impl::ProcessCheckResults(grpc::ServerContext* context
+                                              __attribute__((unused)),
+                                              const Checks* request,
+                                              ChecksStatus* response) {
+  auto fn = std::packaged_task<int(void)>(
+      std::bind(&command_manager::process_passive_checks,
+                &command_manager::instance(), std::cref(*request), response));
+  std::future<int> result = fn.get_future();
+  command_manager::instance().enqueue(std::move(fn));
+  result.get();
+
+  return grpc::Status::OK;
+}
+
 /**
  * @brief When a new file arrives on the centreon server, this command is used
  * to notify engine to update its anomaly detection services with those new
@@ -159,6 +275,20 @@ grpc::Status engine_impl::GetHost(grpc::ServerContext* context
                                   const HostIdentifier* request
                                   __attribute__((unused)),
                                   EngineHost* response) {
+  /* Read from the snapshot, the main loop is only used on a miss. */
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    const snapshot::host_entry* entry = nullptr;
+    if (request->identifier_case() == HostIdentifier::kName)
+      entry = snap->find_host(request->name());
+    else if (request->identifier_case() == HostIdentifier::kId)
+      entry = snap->find_host(request->id());
+    if (entry) {
+      fill_host(*entry, response);
+      return grpc::Status::OK;
+    }
+  }
+
   std::string err;
   auto fn =
       std::packaged_task<int(void)>([&err, request, host = response]() -> int32_t {
@@ -199,6 +329,14 @@ grpc::Status engine_impl::GetHost(grpc::ServerContext* context
         host->set_current_state(
             static_cast<EngineHost::State>(selectedhost->get_current_state()));
         host->set_id(selectedhost->get_host_id());
+        host->set_state_type(
+            static_cast<EngineHost::StateType>(selectedhost->get_state_type()));
+        host->set_output(selectedhost->get_plugin_output());
+        host->set_last_check(selectedhost->get_last_check());
+        host->set_current_attempt(selectedhost->get_current_attempt());
+        host->set_acknowledged(
+            selectedhost->get_problem_has_been_acknowledged());
+        host->set_in_downtime(selectedhost->is_in_downtime());
         return 0;
       });
 
@@ -266,6 +404,22 @@ grpc::Status engine_impl::GetService(grpc::ServerContext* context
                                      __attribute__((unused)),
                                      const ServiceIdentifier* request,
                                      EngineService* response) {
+  /* Read from the snapshot, the main loop is only used on a miss. */
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    const snapshot::service_entry* entry = nullptr;
+    if (request->identifier_case() == ServiceIdentifier::kNames)
+      entry = snap->find_service(request->names().host_name(),
+                                 request->names().service_name());
+    else if (request->identifier_case() == ServiceIdentifier::kIds)
+      entry = snap->find_service(request->ids().host_id(),
+                                 request->ids().service_id());
+    if (entry) {
+      fill_service(*entry, response);
+      return grpc::Status::OK;
+    }
+  }
+
   std::string err;
   auto fn =
       std::packaged_task<int(void)>([&err, request, service = response]() -> int32_t {
@@ -312,6 +466,14 @@ grpc::Status engine_impl::GetService(grpc::ServerContext* context
         service->set_check_period(selectedservice->get_check_period());
         service->set_current_state(static_cast<EngineService::State>(
             selectedservice->get_current_state()));
+        service->set_state_type(static_cast<EngineService::StateType>(
+            selectedservice->get_state_type()));
+        service->set_output(selectedservice->get_plugin_output());
+        service->set_last_check(selectedservice->get_last_check());
+        service->set_current_attempt(selectedservice->get_current_attempt());
+        service->set_acknowledged(
+            selectedservice->get_problem_has_been_acknowledged());
+        service->set_in_downtime(selectedservice->is_in_downtime());
         return 0;
       });
 
@@ -324,6 +486,259 @@ grpc::Status engine_impl::GetService(grpc::ServerContext* context
     return grpc::Status(grpc::INVALID_ARGUMENT, err);
 }
 
+/**
+ * @brief Read the ids of the last returned object from a page token, that
+ * is "host_id" or "host_id:service_id".
+ *
+ * @param token The page token.
+ * @param ids The ids read.
+ * @param count The number of ids expected.
+ *
+ * @return false if the token is not valid.
+ */
+static bool parse_page_token(const std::string& token,
+                             uint64_t* ids,
+                             int count) {
+  const char* p = token.c_str();
+  for (int i = 0; i < count; ++i) {
+    if (i && *p++ != ':')
+      return false;
+    if (*p < '0' || *p > '9')
+      return false;
+    char* end;
+    ids[i] = strtoull(p, &end, 10);
+    p = end;
+  }
+  return *p == 0;
+}
+
+/**
+ * @brief Compute the positions to scan in a snapshot vector of size
+ * total, starting at start. If members is not null, only these positions
+ * are kept.
+ *
+ * @param total Size of the snapshot vector.
+ * @param members Positions of a group members or nullptr.
+ * @param start The first position to scan.
+ *
+ * @return Sorted positions.
+ */
+static std::vector<size_t> positions_to_scan(
+    size_t total,
+    const std::vector<size_t>* members,
+    size_t start) {
+  std::vector<size_t> retval;
+  if (members) {
+    retval.reserve(members->size());
+    for (size_t pos : *members)
+      if (pos >= start)
+        retval.push_back(pos);
+    std::sort(retval.begin(), retval.end());
+  } else if (start < total) {
+    retval.resize(total - start);
+    std::iota(retval.begin(), retval.end(), start);
+  }
+  return retval;
+}
+
+/**
+ * @brief Stream hosts in chunks. Hosts are read from the snapshot, so the
+ * main loop is not involved in the scan.
+ *
+ * @param context gRPC context
+ * @param request Filters, fields mask and paging of the query.
+ * @param writer The stream to fill.
+ *
+ * @return Status::OK
+ */
+grpc::Status engine_impl::ListHosts(grpc::ServerContext* context,
+                                    const HostsQuery* request,
+                                    grpc::ServerWriter<HostsChunk>* writer) {
+  if (request->fields().paths_size() &&
+      !google::protobuf::util::FieldMaskUtil::IsValidFieldMask<EngineHost>(
+          request->fields()))
+    return grpc::Status(grpc::INVALID_ARGUMENT, "invalid field mask");
+
+  std::shared_ptr<const snapshot::data> snap{get_snapshot()};
+
+  const std::vector<size_t>* members = nullptr;
+  if (!request->hostgroup().empty()) {
+    auto found = snap->idx->hostgroup_members.find(request->hostgroup());
+    if (found == snap->idx->hostgroup_members.end())
+      return grpc::Status(
+          grpc::INVALID_ARGUMENT,
+          fmt::format("could not find hostgroup '{}'", request->hostgroup()));
+    members = &found->second;
+  }
+
+  uint32_t states = 0;
+  for (int state : request->states()) {
+    if (!EngineHost::State_IsValid(state))
+      return grpc::Status(grpc::INVALID_ARGUMENT,
+                          fmt::format("invalid host state {}", state));
+    states |= 1 << state;
+  }
+
+  /* Hosts are sorted by id, the page starts after the last one read. */
+  size_t start = 0;
+  if (!request->page_token().empty()) {
+    uint64_t last_id;
+    if (!parse_page_token(request->page_token(), &last_id, 1))
+      return grpc::Status(grpc::INVALID_ARGUMENT, "invalid page token");
+    start = std::upper_bound(
+                snap->hosts.begin(), snap->hosts.end(), last_id,
+                [](uint64_t id,
+                   const std::shared_ptr<const snapshot::host_entry>& e) {
+                  return id < e->id;
+                }) -
+            snap->hosts.begin();
+  }
+
+  uint32_t chunk_size = request->chunk_size() ? request->chunk_size() : 1000;
+  uint32_t count = 0;
+  const snapshot::host_entry* last = nullptr;
+  std::vector<size_t> positions{
+      positions_to_scan(snap->hosts.size(), members, start)};
+  HostsChunk chunk;
+  for (size_t pos : positions) {
+    const snapshot::host_entry& entry = *snap->hosts[pos];
+    if (states && !(states & (1 << entry.current_state)))
+      continue;
+
+    /* Another host matches, the page ends with the previous one. */
+    if (request->page_size() && count == request->page_size()) {
+      chunk.set_next_page_token(std::to_string(last->id));
+      break;
+    }
+
+    EngineHost* host = chunk.add_hosts();
+    fill_host(entry, host);
+    if (request->fields().paths_size())
+      google::protobuf::util::FieldMaskUtil::TrimMessage(request->fields(),
+                                                         host);
+    last = &entry;
+    ++count;
+
+    if (static_cast<uint32_t>(chunk.hosts_size()) == chunk_size) {
+      if (context->IsCancelled())
+        return grpc::Status(grpc::CANCELLED, "query cancelled");
+      writer->Write(chunk);
+      chunk.Clear();
+    }
+  }
+  if (chunk.hosts_size() || !chunk.next_page_token().empty() || count == 0)
+    writer->Write(chunk);
+  return grpc::Status::OK;
+}
+
+/**
+ * @brief Stream services in chunks. Services are read from the snapshot, so
+ * the main loop is not involved in the scan.
+ *
+ * @param context gRPC context
+ * @param request Filters, fields mask and paging of the query.
+ * @param writer The stream to fill.
+ *
+ * @return Status::OK
+ */
+grpc::Status engine_impl::ListServices(
+    grpc::ServerContext* context,
+    const ServicesQuery* request,
+    grpc::ServerWriter<ServicesChunk>* writer) {
+  if (request->fields().paths_size() &&
+      !google::protobuf::util::FieldMaskUtil::IsValidFieldMask<EngineService>(
+          request->fields()))
+    return grpc::Status(grpc::INVALID_ARGUMENT, "invalid field mask");
+
+  std::shared_ptr<const snapshot::data> snap{get_snapshot()};
+
+  /* Hosts of the hostgroup, services are filtered on their host id. */
+  std::unordered_set<uint64_t> host_ids;
+  if (!request->hostgroup().empty()) {
+    auto found = snap->idx->hostgroup_members.find(request->hostgroup());
+    if (found == snap->idx->hostgroup_members.end())
+      return grpc::Status(
+          grpc::INVALID_ARGUMENT,
+          fmt::format("could not find hostgroup '{}'", request->hostgroup()));
+    for (size_t pos : found->second)
+      host_ids.insert(snap->hosts[pos]->id);
+  }
+
+  const std::vector<size_t>* members = nullptr;
+  if (!request->servicegroup().empty()) {
+    auto found = snap->idx->servicegroup_members.find(request->servicegroup());
+    if (found == snap->idx->servicegroup_members.end())
+      return grpc::Status(grpc::INVALID_ARGUMENT,
+                          fmt::format("could not find servicegroup '{}'",
+                                      request->servicegroup()));
+    members = &found->second;
+  }
+
+  uint32_t states = 0;
+  for (int state : request->states()) {
+    if (!EngineService::State_IsValid(state))
+      return grpc::Status(grpc::INVALID_ARGUMENT,
+                          fmt::format("invalid service state {}", state));
+    states |= 1 << state;
+  }
+
+  /* Services are sorted by ids, the page starts after the last one read. */
+  size_t start = 0;
+  if (!request->page_token().empty()) {
+    uint64_t last_ids[2];
+    if (!parse_page_token(request->page_token(), last_ids, 2))
+      return grpc::Status(grpc::INVALID_ARGUMENT, "invalid page token");
+    start = std::upper_bound(
+                snap->services.begin(), snap->services.end(),
+                std::make_pair(last_ids[0], last_ids[1]),
+                [](const std::pair<uint64_t, uint64_t>& ids,
+                   const std::shared_ptr<const snapshot::service_entry>& e) {
+                  return ids < std::make_pair(e->host_id, e->service_id);
+                }) -
+            snap->services.begin();
+  }
+
+  uint32_t chunk_size = request->chunk_size() ? request->chunk_size() : 1000;
+  uint32_t count = 0;
+  const snapshot::service_entry* last = nullptr;
+  std::vector<size_t> positions{
+      positions_to_scan(snap->services.size(), members, start)};
+  ServicesChunk chunk;
+  for (size_t pos : positions) {
+    const snapshot::service_entry& entry = *snap->services[pos];
+    if (states && !(states & (1 << entry.current_state)))
+      continue;
+    if (!request->hostgroup().empty() && !host_ids.count(entry.host_id))
+      continue;
+
+    /* Another service matches, the page ends with the previous one. */
+    if (request->page_size() && count == request->page_size()) {
+      chunk.set_next_page_token(
+          fmt::format("{}:{}", last->host_id, last->service_id));
+      break;
+    }
+
+    EngineService* service = chunk.add_services();
+    fill_service(entry, service);
+    if (request->fields().paths_size())
+      google::protobuf::util::FieldMaskUtil::TrimMessage(request->fields(),
+                                                         service);
+    last = &entry;
+    ++count;
+
+    if (static_cast<uint32_t>(chunk.services_size()) == chunk_size) {
+      if (context->IsCancelled())
+        return grpc::Status(grpc::CANCELLED, "query cancelled");
+      writer->Write(chunk);
+      chunk.Clear();
+    }
+  }
+  if (chunk.services_size() || !chunk.next_page_token().empty() ||
+      count == 0)
+    writer->Write(chunk);
+  return grpc::Status::OK;
+}
+
 /**
  * @brief Return the total number of hosts.
  *
@@ -338,6 +753,12 @@ grpc::Status engine_impl::GetHostsCount(grpc::ServerContext* context
                                         const ::google::protobuf::Empty* request
                                         __attribute__((unused)),
                                         GenericValue* response) {
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    response->set_value(snap->hosts.size());
+    return grpc::Status::OK;
+  }
+
   auto fn = std::packaged_task<int32_t(void)>(
       []() -> int32_t { return host::hosts.size(); });
 
@@ -363,6 +784,12 @@ grpc::Status engine_impl::GetContactsCount(
     grpc::ServerContext* context __attribute__((unused)),
     const ::google::protobuf::Empty* request __attribute__((unused)),
     GenericValue* response) {
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    response->set_value(snap->contacts_count);
+    return grpc::Status::OK;
+  }
+
   auto fn = std::packaged_task<int32_t(void)>(
       []() -> int32_t { return contact::contacts.size(); });
 
@@ -387,6 +814,12 @@ grpc::Status engine_impl::GetServicesCount(
     grpc::ServerContext* context __attribute__((unused)),
     const ::google::protobuf::Empty* request __attribute__((unused)),
     GenericValue* response) {
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    response->set_value(snap->services.size());
+    return grpc::Status::OK;
+  }
+
   auto fn = std::packaged_task<int32_t(void)>(
       []() -> int32_t { return service::services.size(); });
 
@@ -410,6 +843,12 @@ grpc::Status engine_impl::GetServiceGroupsCount(
     grpc::ServerContext* context __attribute__((unused)),
     const ::google::protobuf::Empty* request __attribute__((unused)),
     GenericValue* response) {
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    response->set_value(snap->servicegroups_count);
+    return grpc::Status::OK;
+  }
+
   auto fn = std::packaged_task<int32_t(void)>(
       []() -> int32_t { return servicegroup::servicegroups.size(); });
   std::future<int32_t> result = fn.get_future();
@@ -432,6 +871,12 @@ grpc::Status engine_impl::GetContactGroupsCount(
     grpc::ServerContext* context __attribute__((unused)),
     const ::google::protobuf::Empty* request __attribute__((unused)),
     GenericValue* response) {
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    response->set_value(snap->contactgroups_count);
+    return grpc::Status::OK;
+  }
+
   auto fn = std::packaged_task<int32_t(void)>(
       []() -> int32_t { return contactgroup::contactgroups.size(); });
   std::future<int32_t> result = fn.get_future();
@@ -454,6 +899,12 @@ grpc::Status engine_impl::GetHostGroupsCount(
     grpc::ServerContext* context __attribute__((unused)),
     const ::google::protobuf::Empty* request __attribute__((unused)),
     GenericValue* response) {
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    response->set_value(snap->hostgroups_count);
+    return grpc::Status::OK;
+  }
+
   auto fn = std::packaged_task<int32_t(void)>(
       []() -> int32_t { return hostgroup::hostgroups.size(); });
 
@@ -477,6 +928,12 @@ grpc::Status engine_impl::GetServiceDependenciesCount(
     grpc::ServerContext* context __attribute__((unused)),
     const ::google::protobuf::Empty* request __attribute__((unused)),
     GenericValue* response) {
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    response->set_value(snap->servicedependencies_count);
+    return grpc::Status::OK;
+  }
+
   auto fn = std::packaged_task<int32_t(void)>([]() -> int32_t {
     return servicedependency::servicedependencies.size();
   });
@@ -501,6 +958,12 @@ grpc::Status engine_impl::GetHostDependenciesCount(
     grpc::ServerContext* context __attribute__((unused)),
     const ::google::protobuf::Empty* request __attribute__((unused)),
     GenericValue* response) {
+  std::shared_ptr<const snapshot::data> snap{snapshot::instance().get()};
+  if (snap) {
+    response->set_value(snap->hostdependencies_count);
+    return grpc::Status::OK;
+  }
+
   auto fn = std::packaged_task<int32_t(void)>(
       []() -> int32_t { return hostdependency::hostdependencies.size(); });
   std::future<int32_t> result = fn.get_future();
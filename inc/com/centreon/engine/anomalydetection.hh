@@ -25,6 +25,7 @@
 #include <mutex>
 #include <tuple>
 
+#include "com/centreon/engine/perfdata.hh"
 #include "com/centreon/engine/service.hh"
 
 CCE_BEGIN()
@@ -91,7 +92,7 @@ class anomalydetection : public service {
                               time_t* preferred_time) noexcept override;
   commands::command* get_check_command_ptr() const;
   std::tuple<service::service_state, double, std::string, double, double>
-  parse_perfdata(std::string const& perfdata, time_t check_time);
+  parse_perfdata(perfdata::metric const* metric, time_t check_time);
   void init_thresholds();
   void set_status_change(bool status_change);
   const std::string& get_metric_name() const;
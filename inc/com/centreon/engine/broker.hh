@@ -278,6 +278,9 @@
 #define NEBTYPE_TIMEPERIOD_DELETE 3801
 #define NEBTYPE_TIMEPERIOD_UPDATE 3802
 
+/* Perfdata. */
+#define NEBTYPE_PERFDATA_PROCESSED 3900
+
 /*
 ** Event flags.
 */
@@ -552,6 +555,12 @@ int broker_notification_data(int type,
                              int escalated,
                              int contacts_notified,
                              struct timeval const* timestamp);
+void broker_perfdata(int type,
+                     int flags,
+                     int attr,
+                     com::centreon::engine::host* hst,
+                     com::centreon::engine::service* svc,
+                     struct timeval const* timestamp);
 void broker_program_state(int type,
                           int flags,
                           int attr,
@@ -24,6 +24,7 @@
 #include <string>
 
 #include "com/centreon/engine/namespace.hh"
+#include "com/centreon/engine/state_table.hh"
 
 CCE_BEGIN()
 namespace commands {
@@ -40,7 +41,8 @@ class checkable {
 
   enum state_type { soft, hard };
 
-  checkable(std::string const& display_name,
+  checkable(state_table& states,
+            std::string const& display_name,
             std::string const& check_command,
             bool checks_enabled,
             bool accept_passive_checks,
@@ -62,7 +64,9 @@ class checkable {
             int freshness_threshold,
             bool obsess_over,
             std::string const& timezone);
-  virtual ~checkable() = default;
+  checkable(checkable const&) = delete;
+  virtual ~checkable() noexcept;
+  checkable& operator=(checkable const&) = delete;
 
   std::string const& get_display_name() const;
   void set_display_name(std::string const& name);
@@ -149,20 +153,26 @@ class checkable {
   void set_should_be_scheduled(bool should_be_scheduled);
   virtual std::string const& get_current_state_as_string() const = 0;
   virtual bool is_in_downtime() const = 0;
+  virtual void update_freshness_deadline() = 0;
   void set_event_handler_ptr(commands::command* cmd);
   commands::command* get_event_handler_ptr() const;
   void set_check_command_ptr(commands::command* cmd);
   commands::command* get_check_command_ptr() const;
   bool get_is_executing() const;
   void set_is_executing(bool is_executing);
+  uint32_t get_state_id() const noexcept;
 
   timeperiod* check_period_ptr;
 
+ protected:
+  state_table& _states;
+  uint32_t _state_id;
+
  private:
+  void _set_flag(state_table::flag f, bool value) noexcept;
+
   std::string _display_name;
   std::string _check_command;
-  uint32_t _check_interval;
-  uint32_t _retry_interval;
   int _max_attempts;
   std::string _check_period;
   std::string _event_handler;
@@ -180,28 +190,14 @@ class checkable {
   double _high_flap_threshold;
   bool _obsess_over;
   std::string _timezone;
-  bool _checks_enabled;
-  bool _accept_passive_checks;
-  bool _check_freshness;
-  int _freshness_threshold;
   check_type _check_type;
-  int _current_attempt;
-  bool _has_been_checked;
   int _scheduled_downtime_depth;
   double _execution_time;
   bool _is_flapping;
-  int _last_check;
-  double _latency;
-  std::time_t _next_check;
-  bool _should_be_scheduled;
   uint32_t _state_history_index;
-  std::time_t _last_state_change;
-  std::time_t _last_hard_state_change;
-  enum state_type _state_type;
   double _percent_state_change;
   commands::command* _event_handler_ptr;
   commands::command* _check_command_ptr;
-  bool _is_executing;
 };
 
 CCE_END()
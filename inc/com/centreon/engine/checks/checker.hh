@@ -52,6 +52,7 @@ class checker : public commands::command_listener {
                 unsigned long check_timestamp_horizon);
   void add_check_result(uint64_t id, check_result* result) noexcept;
   void add_check_result_to_reap(check_result* result) noexcept;
+  void add_check_results_to_reap(std::deque<check_result*>& results) noexcept;
   static void forget(notifier* n) noexcept;
 
  private:
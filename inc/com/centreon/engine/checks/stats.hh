@@ -43,7 +43,9 @@
  *  @struct check_stats checks_stats.hh "com/centreon/engine/checks/stats.hh"
  *  @brief Used for tracking host and service check statistics.
  *
- *  Used for tracking host and service check statistics.
+ *  Last 1/5/15 minutes counters, filled by generate_check_stats() from
+ *  the checks::stats instance. The buckets are not used anymore, they are
+ *  kept so that the layout seen by already built modules does not change.
  */
 typedef struct check_stats_struct {
   int current_bucket;
@@ -63,6 +65,74 @@ int update_check_stats(int check_type, time_t check_time);
 
 #ifdef __cplusplus
 }
+
+#include <atomic>
+#include <cstdint>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace checks {
+/**
+ *  @class stats stats.hh "com/centreon/engine/checks/stats.hh"
+ *  @brief Sliding window statistics on checks.
+ *
+ *  Counts checks by type and keeps latency and execution time histograms
+ *  minute by minute over the last CHECK_STATS_BUCKETS minutes. Updates are
+ *  lock-free so they can be made from any thread, and queries only sum the
+ *  minutes of the asked window. Minutes are taken in the engine time base
+ *  (see time_base), a wall-clock step does not clear them.
+ *
+ *  Histograms use logarithmic buckets (four per power of two, starting at
+ *  1ms), so percentiles are given with a precision of about 20%.
+ */
+class stats {
+ public:
+  enum timing {
+    active_host_latency,
+    active_host_execution_time,
+    passive_host_latency,
+    active_service_latency,
+    active_service_execution_time,
+    passive_service_latency,
+    timing_max
+  };
+  static constexpr int histogram_buckets = 64;
+  /* Window used for the published percentiles. */
+  static constexpr int percentiles_minutes = 5;
+
+  static stats& instance();
+  void reset() noexcept;
+  void add_check(int check_type, time_t check_time) noexcept;
+  void add_timing(timing type, double value, time_t now) noexcept;
+  uint32_t checks_count(int check_type, int minutes, time_t now) const
+      noexcept;
+  double percentile(timing type, double q, int minutes, time_t now) const
+      noexcept;
+
+ private:
+  /* One more minute than the window, the oldest one is partially used. */
+  static constexpr int _slots_count = CHECK_STATS_BUCKETS + 1;
+
+  struct slot {
+    std::atomic<int64_t> minute;
+    std::atomic<uint32_t> checks[MAX_CHECK_STATS_TYPES];
+    std::atomic<uint32_t> timings[timing_max][histogram_buckets];
+  };
+
+  stats();
+  stats(const stats&) = delete;
+  stats& operator=(const stats&) = delete;
+  static int64_t _minute_of(time_t t) noexcept;
+  slot* _slot_for(time_t t) noexcept;
+
+  slot _slots[_slots_count];
+};
+}  // namespace checks
+
+CCE_END()
+
 #endif  // C++
 
 #endif  // !CCE_CHECKS_STATS_HH
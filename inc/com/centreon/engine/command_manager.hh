@@ -44,6 +44,14 @@ class command_manager {
   command_manager();
 
  public:
+  /* Parts of the statistics returned by GetStats. */
+  enum stats_section : uint32_t {
+    stats_program = 1 << 0,
+    stats_services = 1 << 1,
+    stats_hosts = 1 << 2,
+    stats_default = stats_program | stats_services | stats_hosts
+  };
+
   static command_manager& instance();
   void enqueue(std::packaged_task<int()>&& f);
 
@@ -56,7 +64,10 @@ class command_manager {
                                  const std::string& host_name,
                                  uint32_t return_code,
                                  const std::string& output);
+  int process_passive_checks(const Checks& checks, ChecksStatus* response);
   int get_stats(std::string const& request, Stats* response);
+  void fill_stats(uint32_t sections, Stats* response);
+  static uint32_t stats_sections(std::string const& request);
   int get_restart_stats(RestartStats* response);
   int get_services_stats(ServicesStats* sstats);
   int get_hosts_stats(HostsStats* hstats);
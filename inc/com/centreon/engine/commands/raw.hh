@@ -77,6 +77,10 @@ class raw : public command, public process_listener {
            nagios_macros& macros,
            uint32_t timeout,
            result& res) override;
+  uint64_t run(const std::string& process_cmd,
+               environment& env,
+               uint32_t timeout);
+  static void build_environment(nagios_macros& macros, environment& env);
 };
 }  // namespace commands
 
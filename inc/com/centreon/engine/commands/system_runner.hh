@@ -0,0 +1,134 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_COMMANDS_SYSTEM_RUNNER_HH
+#define CCE_COMMANDS_SYSTEM_RUNNER_HH
+
+#include <sys/time.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "com/centreon/engine/commands/command_listener.hh"
+#include "com/centreon/engine/commands/environment.hh"
+#include "com/centreon/engine/namespace.hh"
+
+class nagios_macros;
+
+CCE_BEGIN()
+
+namespace commands {
+class raw;
+
+/**
+ *  @class system_runner system_runner.hh
+ *  @brief Run notifications, event handlers, OCSP/OCHP and performance data
+ *  commands.
+ *
+ *  When max_concurrent_system_commands is 0, commands are run with
+ *  my_system_r() and the callback is called before run() returns. Otherwise
+ *  commands are started in the background and run() returns at once. The
+ *  callbacks are then called from the main loop by reap().
+ *
+ *  run() never waits: when max_concurrent_system_commands commands are
+ *  running, the next ones are queued with their environment and reap()
+ *  starts them, in their arrival order, as running commands finish. The
+ *  queue is bounded, commands beyond it are dropped.
+ *  Commands can also be given a group, the notification command name for
+ *  example. When max_concurrent_notifications_per_command commands of a
+ *  group are running, the next ones of this group are queued the same way.
+ *
+ *  In both cases, SYSTEM_COMMAND_START is sent to the broker when the command
+ *  is started and SYSTEM_COMMAND_END just before the callback is called, with
+ *  the same data. A queued command that cannot be started gets an unknown
+ *  result with the error as output.
+ */
+class system_runner : public command_listener {
+ public:
+  /* Called with the exit code, the timeout flag, the execution time and the
+   * (truncated) output of the command. */
+  typedef std::function<
+      void(int result, bool early_timeout, double exectime, std::string const&)>
+      callback;
+
+  static system_runner& instance();
+  static void init();
+  static void deinit();
+
+  bool is_async() const noexcept;
+  void run(nagios_macros* mac,
+           std::string const& cmd,
+           int timeout,
+           unsigned int max_output_length,
+           callback cb,
+           std::string const& group = "");
+  void reap();
+  size_t running() const;
+  size_t queued() const;
+
+ private:
+  struct pending {
+    std::string cmd;
+    std::string group;
+    timeval start_time;
+    int timeout;
+    unsigned int max_output_length;
+    callback cb;
+  };
+
+  /* A command waiting for a free slot in its group. */
+  struct waiting {
+    pending p;
+    environment env;
+  };
+
+  system_runner();
+  system_runner(system_runner const&) = delete;
+  ~system_runner() noexcept override;
+  system_runner& operator=(system_runner const&) = delete;
+  void finished(result const& res) noexcept override;
+  void _failed(pending& p, std::string const& error);
+  bool _group_is_full(std::string const& group) const;
+  void _start(pending&& p, environment& env);
+  void _start_waiting();
+  void _wait_all();
+
+  static system_runner* _instance;
+
+  std::unique_ptr<raw> _raw;
+  /* Protects _running, _running_by_group, _waiting and _done, the process
+   * manager thread fills _done. */
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+  std::unordered_map<uint64_t, pending> _running;
+  /* Running or starting commands per group. */
+  std::unordered_map<std::string, uint32_t> _running_by_group;
+  std::deque<waiting> _waiting;
+  std::deque<std::pair<pending, result>> _done;
+};
+}  // namespace commands
+
+CCE_END()
+
+#endif  // !CCE_COMMANDS_SYSTEM_RUNNER_HH
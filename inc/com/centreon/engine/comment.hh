@@ -23,16 +23,71 @@
 #include <time.h>
 #include <map>
 #include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "com/centreon/engine/contact.hh"
 #include "com/centreon/engine/host.hh"
 
 CCE_BEGIN()
 class comment;
 class service;
+
+/**
+ *  @class comment_store comment.hh "com/centreon/engine/comment.hh"
+ *  @brief The comments by id, as a map, also linked by host or service.
+ *
+ *  Comments of the same host, or of the same service, are chained through
+ *  pointers stored in the comments themselves, so deleting the comments of
+ *  an object only looks at them. Each expiring comment has its own expire
+ *  comment timed event.
+ */
+class comment_store {
+ public:
+  typedef std::map<uint64_t, std::shared_ptr<comment>> map_type;
+  typedef map_type::const_iterator iterator;
+  typedef map_type::const_iterator const_iterator;
+  typedef map_type::value_type value_type;
+
+  comment_store();
+  comment_store(comment_store const&) = delete;
+  comment_store& operator=(comment_store const&) = delete;
+  iterator begin() const noexcept;
+  void clear() noexcept;
+  bool empty() const noexcept;
+  iterator end() const noexcept;
+  iterator erase(iterator it);
+  size_t erase(uint64_t comment_id);
+  iterator find(uint64_t comment_id) const;
+  uint64_t first_free_id();
+  std::pair<iterator, bool> insert(value_type const& value);
+  void of_object(uint64_t host_id,
+                 uint64_t service_id,
+                 std::vector<comment*>& comments) const;
+  size_t size() const noexcept;
+
+ private:
+  typedef std::pair<uint64_t, uint64_t> object_key;
+
+  struct object_hash {
+    size_t operator()(object_key const& key) const noexcept {
+      return std::hash<uint64_t>()(key.first * 0x9e3779b97f4a7c15llu ^
+                                   key.second);
+    }
+  };
+
+  static object_key _key(comment const* cmt) noexcept;
+  void _unlink(comment* cmt) noexcept;
+
+  map_type _comments;
+  /* Every id below is used. */
+  uint64_t _free_hint;
+  /* First comment of each host or service. */
+  std::unordered_map<object_key, comment*, object_hash> _by_object;
+};
 CCE_END()
 
-typedef std::map<uint64_t, std::shared_ptr<com::centreon::engine::comment>>
-    comment_map;
+typedef com::centreon::engine::comment_store comment_map;
 
 CCE_BEGIN()
 // COMMENT structure
@@ -96,8 +151,18 @@ class comment {
   uint64_t _service_id;
   std::string _author;
   std::string _comment_data;
+  /* Comments of the same host or service, set by comment_store. */
+  comment* _prev_of_object;
+  comment* _next_of_object;
 
   static uint64_t _next_comment_id;
+
+  static void _delete_object_comments(comment::type comment_type,
+                                      uint64_t host_id,
+                                      uint64_t service_id,
+                                      bool acknowledgements);
+
+  friend class comment_store;
 };
 
 CCE_END()
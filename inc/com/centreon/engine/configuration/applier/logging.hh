@@ -59,11 +59,14 @@ class logging {
   void _del_stdout();
   void _del_stderr();
 
-  com::centreon::logging::file* _debug;
+  bool _async;
+  com::centreon::logging::backend* _debug;
+  std::string _debug_file;
   unsigned long long _debug_level;
   unsigned long _debug_max_size;
   unsigned int _debug_verbosity;
-  com::centreon::logging::file* _log;
+  com::centreon::logging::backend* _log;
+  std::string _log_file;
   com::centreon::logging::file* _stderr;
   com::centreon::logging::file* _stdout;
   com::centreon::logging::syslogger* _syslog;
@@ -78,7 +78,8 @@ class scheduler {
   std::vector<com::centreon::engine::service*> _get_services(
       set_service const& svc_cfg,
       bool throw_if_not_found = true);
-
+  void _place_service_checks(std::vector<engine::service*> const& services,
+                             time_t now);
   void _remove_misc_event(timed_event*& evt);
   void _schedule_host_events(
       std::vector<com::centreon::engine::host*> const& hosts);
@@ -70,7 +70,8 @@ class state {
     icd_none = 0,  // no inter-check delay
     icd_dumb,      // dumb delay of 1 second
     icd_smart,     // smart delay
-    icd_user       // user-specified delay
+    icd_user,      // user-specified delay
+    icd_even       // even spread by execution time (services only)
   };
 
   /**
@@ -239,6 +240,8 @@ class state {
   void illegal_output_chars(std::string const& value);
   unsigned int interval_length() const noexcept;
   void interval_length(unsigned int value);
+  bool log_async() const noexcept;
+  void log_async(bool value);
   bool log_event_handlers() const noexcept;
   void log_event_handlers(bool value);
   bool log_external_commands() const noexcept;
@@ -269,8 +272,12 @@ class state {
   void max_host_check_spread(unsigned int value);
   unsigned long max_log_file_size() const noexcept;
   void max_log_file_size(unsigned long value);
+  unsigned int max_parallel_notifications_per_command() const noexcept;
+  void max_parallel_notifications_per_command(unsigned int value);
   unsigned int max_parallel_service_checks() const noexcept;
   void max_parallel_service_checks(unsigned int value);
+  unsigned int max_parallel_system_commands() const noexcept;
+  void max_parallel_system_commands(unsigned int value);
   unsigned int max_service_check_spread() const noexcept;
   void max_service_check_spread(unsigned int value);
   unsigned int notification_timeout() const noexcept;
@@ -379,6 +386,8 @@ class state {
   void user(std::unordered_map<std::string, std::string> const& value);
   void user(std::string const& key, std::string const& value);
   void user(unsigned int key, std::string const& value);
+  bool use_adaptive_check_scheduler() const noexcept;
+  void use_adaptive_check_scheduler(bool value);
   void use_aggressive_host_checking(bool);
   bool use_large_installation_tweaks() const noexcept;
   void use_large_installation_tweaks(bool value);
@@ -534,6 +543,7 @@ class state {
   std::string _illegal_object_chars;
   std::string _illegal_output_chars;
   unsigned int _interval_length;
+  bool _log_async;
   bool _log_event_handlers;
   bool _log_external_commands;
   std::string _log_file;
@@ -549,7 +559,9 @@ class state {
   unsigned long _max_debug_file_size;
   unsigned int _max_host_check_spread;
   unsigned long _max_log_file_size;
+  unsigned int _max_parallel_notifications_per_command;
   unsigned int _max_parallel_service_checks;
+  unsigned int _max_parallel_system_commands;
   unsigned int _max_service_check_spread;
   unsigned int _notification_timeout;
   bool _obsess_over_hosts;
@@ -597,6 +609,7 @@ class state {
   unsigned int _time_change_threshold;
   bool _translate_passive_host_checks;
   std::unordered_map<std::string, std::string> _users;
+  bool _use_adaptive_check_scheduler;
   bool _use_large_installation_tweaks;
   uint32_t _instance_heartbeat_interval;
   bool _use_regexp_matches;
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_DEADLINE_QUEUE_HH
+#define CCE_DEADLINE_QUEUE_HH
+
+#include <algorithm>
+#include <ctime>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+/**
+ *  @class deadline_queue deadline_queue.hh
+ *  "com/centreon/engine/deadline_queue.hh"
+ *  @brief Objects indexed by the time they must be looked at again.
+ *
+ *  Each object has at most one deadline, kept in a hash table. Deadlines are
+ *  also pushed in a min-heap where changing or removing a deadline leaves
+ *  the old entry in place: such an entry is ignored when it reaches the top.
+ *  The heap is rebuilt when it holds too many of them.
+ */
+template <typename T>
+class deadline_queue {
+ public:
+  /**
+   *  Remove all the objects.
+   */
+  void clear() noexcept {
+    _deadlines.clear();
+    _heap.clear();
+  }
+
+  /**
+   *  Get the deadline of an object.
+   *
+   *  @param[in] obj  The object.
+   *
+   *  @return Its deadline, 0 if it is not in the queue.
+   */
+  time_t deadline(T const* obj) const noexcept {
+    typename std::unordered_map<T const*, time_t>::const_iterator it(
+        _deadlines.find(obj));
+    return it == _deadlines.end() ? 0 : it->second;
+  }
+
+  /**
+   *  Remove an object.
+   *
+   *  @param[in] obj  The object.
+   */
+  void erase(T const* obj) {
+    if (_deadlines.erase(obj))
+      _compact();
+  }
+
+  /**
+   *  Remove the objects whose deadline is before or at a given time.
+   *
+   *  @param[in]  now  The time.
+   *  @param[out] due  The removed objects, by deadline.
+   */
+  void pop_due(time_t now, std::vector<T*>& due) {
+    while (!_heap.empty() && _heap.front().first <= now) {
+      entry e(_heap.front());
+      std::pop_heap(_heap.begin(), _heap.end(), std::greater<entry>());
+      _heap.pop_back();
+      typename std::unordered_map<T const*, time_t>::iterator it(
+          _deadlines.find(e.second));
+      if (it != _deadlines.end() && it->second == e.first) {
+        _deadlines.erase(it);
+        due.push_back(e.second);
+      }
+    }
+  }
+
+  /**
+   *  Set the deadline of an object.
+   *
+   *  @param[in] obj       The object.
+   *  @param[in] deadline  Its new deadline.
+   */
+  void set(T* obj, time_t deadline) {
+    std::pair<typename std::unordered_map<T const*, time_t>::iterator, bool>
+        inserted(_deadlines.emplace(obj, deadline));
+    if (!inserted.second) {
+      if (inserted.first->second == deadline)
+        return;
+      inserted.first->second = deadline;
+    }
+    _heap.emplace_back(deadline, obj);
+    std::push_heap(_heap.begin(), _heap.end(), std::greater<entry>());
+    _compact();
+  }
+
+  /**
+   *  Get the number of objects in the queue.
+   *
+   *  @return A number.
+   */
+  size_t size() const noexcept { return _deadlines.size(); }
+
+ private:
+  typedef std::pair<time_t, T*> entry;
+
+  /**
+   *  Rebuild the heap when most of its entries are outdated.
+   */
+  void _compact() {
+    if (_heap.size() <= 2 * _deadlines.size() + 1024)
+      return;
+    _heap.clear();
+    for (typename std::unordered_map<T const*, time_t>::const_iterator
+             it(_deadlines.begin()),
+         end(_deadlines.end());
+         it != end; ++it)
+      _heap.emplace_back(it->second, const_cast<T*>(it->first));
+    std::make_heap(_heap.begin(), _heap.end(), std::greater<entry>());
+  }
+
+  std::unordered_map<T const*, time_t> _deadlines;
+  std::vector<entry> _heap;
+};
+
+CCE_END()
+
+#endif  // !CCE_DEADLINE_QUEUE_HH
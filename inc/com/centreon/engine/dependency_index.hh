@@ -0,0 +1,89 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_DEPENDENCY_INDEX_HH
+#define CCE_DEPENDENCY_INDEX_HH
+
+#include <cstdint>
+#include <vector>
+
+#include "com/centreon/engine/dependency.hh"
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class state_table;
+
+/**
+ *  @class dependency_index dependency_index.hh
+ *  "com/centreon/engine/dependency_index.hh"
+ *  @brief Host or service dependencies by dependent object, with the cached
+ *  result of their evaluation.
+ *
+ *  Objects are indexed by their id in their state_table. The dependencies of
+ *  each object are stored in one array with their offsets, in the order of
+ *  the dependency map, and the dependents of each master in another one.
+ *  Both are built on the first use after a dependency, a host or a service
+ *  is added or removed.
+ *
+ *  The result of authorized_by_dependencies() is kept for each object and
+ *  dependency type. When the state of a master changes, the results of its
+ *  dependents are forgotten, and so are those of the objects inheriting from
+ *  them. A result depending on a dependency period is never kept.
+ */
+class dependency_index {
+ public:
+  enum verdict : uint8_t { unknown, authorized, blocked };
+
+  struct range {
+    dependency* const* begin() const noexcept { return first; }
+    dependency* const* end() const noexcept { return last; }
+
+    dependency* const* first;
+    dependency* const* last;
+  };
+
+  explicit dependency_index(state_table const& states);
+  dependency_index(dependency_index const&) = delete;
+  dependency_index& operator=(dependency_index const&) = delete;
+  range dependencies(uint32_t id);
+  verdict get_verdict(uint32_t id, dependency::types type);
+  static dependency_index& hosts();
+  void invalidate() noexcept;
+  static dependency_index& of(state_table const& states);
+  static dependency_index& services();
+  void set_verdict(uint32_t id, dependency::types type, bool authorized);
+  void state_changed(uint32_t id);
+
+ private:
+  void _build();
+
+  state_table const& _states;
+  bool _valid;
+  std::vector<uint32_t> _offsets;
+  std::vector<dependency*> _dependencies;
+  std::vector<uint32_t> _dependent_offsets;
+  std::vector<uint32_t> _dependents;
+  /* One column per dependency type. */
+  std::vector<uint8_t> _verdicts[2];
+};
+
+CCE_END()
+
+#endif  // !CCE_DEPENDENCY_INDEX_HH
@@ -18,6 +18,9 @@ class engine_impl final : public Engine::Service {
   grpc::Status ProcessHostCheckResult(grpc::ServerContext* context,
                                       const Check* request,
                                       CommandSuccess* response) override;
+  grpc::Status ProcessCheckResults(grpc::ServerContext* context,
+                                   const Checks* request,
+                                   ChecksStatus* response) override;
   grpc::Status NewThresholdsFile(grpc::ServerContext* context,
                                  const ThresholdsFile* request,
                                  CommandSuccess* response) override;
@@ -54,6 +57,12 @@ class engine_impl final : public Engine::Service {
   grpc::Status GetService(grpc::ServerContext* context,
                           const ServiceIdentifier* request,
                           EngineService* response) override;
+  grpc::Status ListHosts(grpc::ServerContext* context,
+                         const HostsQuery* request,
+                         grpc::ServerWriter<HostsChunk>* writer) override;
+  grpc::Status ListServices(grpc::ServerContext* context,
+                            const ServicesQuery* request,
+                            grpc::ServerWriter<ServicesChunk>* writer) override;
   grpc::Status AddHostComment(grpc::ServerContext* context,
                               const EngineComment* request,
                               CommandSuccess* response) override;
@@ -21,6 +21,7 @@
 #define CCE_ESCALATION_HH
 
 #include <string>
+#include <vector>
 #include "com/centreon/engine/contactgroup.hh"
 #include "com/centreon/engine/namespace.hh"
 #include "com/centreon/engine/notifier.hh"
@@ -54,6 +55,7 @@ class escalation {
 
   contactgroup_map_unsafe const& get_contactgroups() const;
   contactgroup_map_unsafe& get_contactgroups();
+  std::vector<contact*> const& get_flattened_contacts();
   virtual void resolve(int& w, int& e);
 
   notifier* notifier_ptr;
@@ -66,6 +68,9 @@ class escalation {
   std::string _escalation_period;
   uint32_t _escalate_on;
   contactgroup_map_unsafe _contact_groups;
+  /* Members of the contact groups without duplicates. */
+  std::vector<contact*> _flattened_contacts;
+  uint64_t _flattened_contacts_generation;
   Uuid _uuid;
 };
 CCE_END()
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_EVENTS_CHECK_PLACEMENT_HH
+#define CCE_EVENTS_CHECK_PLACEMENT_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace events {
+/**
+ *  @class check_placement check_placement.hh
+ *  "com/centreon/engine/events/check_placement.hh"
+ *  @brief Choose the first check time of periodic checks so that the
+ *  number of checks running at once stays as flat as possible.
+ *
+ *  Time is cut in seconds over a horizon of at most max_horizon seconds.
+ *  The load of a second is the expected number of checks running during
+ *  this second, a check taking one check slot during its expected execution
+ *  time. Checks are placed by interval, the shortest first, and by
+ *  decreasing cost: for an interval p, the load of a phase is the highest
+ *  load of the seconds phase + k * p, and each check takes the least loaded
+ *  phase from a heap. Placing n checks of interval p costs about
+ *  O(n * (log(p) + horizon / p)) plus the seconds they fill.
+ *
+ *  Checks already scheduled either stay where they are (add_load()) or may
+ *  be moved (add_scheduled()): before placing, the movable checks starting
+ *  in a second loaded over the target, the average load rounded up to whole
+ *  check slots, are taken out and placed again with the new checks.
+ */
+class check_placement {
+ public:
+  static uint32_t const max_horizon = 3600;
+
+  check_placement(uint32_t horizon, uint32_t spread);
+  check_placement(check_placement const&) = delete;
+  check_placement& operator=(check_placement const&) = delete;
+  size_t add(uint32_t interval, double cost);
+  void add_load(uint32_t interval, uint32_t offset, double cost);
+  size_t add_scheduled(uint32_t interval, uint32_t offset, double cost);
+  std::vector<double> const& concurrency() const noexcept;
+  uint32_t horizon() const noexcept;
+  bool moved(size_t idx) const noexcept;
+  uint32_t phase(size_t idx) const noexcept;
+  void place();
+
+ private:
+  struct check {
+    uint32_t interval;
+    uint32_t phase;
+    double cost;
+    /* Already scheduled at phase, not placed by place(). */
+    bool scheduled;
+    bool moved;
+  };
+
+  void _add_occurrences(uint32_t phase, uint32_t period, double cost);
+  double _phase_load(uint32_t phase, uint32_t period) const noexcept;
+  uint32_t _period(uint32_t interval) const noexcept;
+  double _target() const noexcept;
+
+  uint32_t const _horizon;
+  uint32_t const _spread;
+  /* Checks to place or that may be moved, in their order of addition. */
+  std::vector<check> _checks;
+  /* Expected number of checks running during each second. */
+  std::vector<double> _load;
+};
+}  // namespace events
+
+CCE_END()
+
+#endif  // !CCE_EVENTS_CHECK_PLACEMENT_HH
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_EVENTS_CHECK_SCHEDULER_HH
+#define CCE_EVENTS_CHECK_SCHEDULER_HH
+
+#include <ctime>
+#include <string>
+#include <unordered_map>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class service;
+
+namespace events {
+/**
+ *  @class check_scheduler check_scheduler.hh
+ *  "com/centreon/engine/events/check_scheduler.hh"
+ *  @brief Admission of service checks, used by the main loop when
+ *  use_adaptive_check_scheduler is enabled.
+ *
+ *  Checks are admitted through a token bucket counted in seconds of check
+ *  slots: it is refilled with max_concurrent_checks slot-seconds every second
+ *  and each check costs the average execution time observed for its
+ *  command. The bucket then admits max_concurrent_checks / average execution
+ *  time checks per second and a long check takes the place of several short
+ *  ones. The main loop keeps the checks that are not admitted in a ready
+ *  queue until the bucket refills.
+ *
+ *  This class is used from the main loop only.
+ */
+class check_scheduler {
+ public:
+  static check_scheduler& instance();
+  void add_execution_time(service const* svc, double execution_time);
+  bool admit(service const* svc, double now);
+  double achieved_rate(time_t now) const noexcept;
+  double admission_rate() const noexcept;
+  double configured_rate() const;
+  double expected_execution_time(service const* svc);
+  double projected_overhead(service const* svc);
+  void reset();
+  void seed_execution_time(service const* svc, double execution_time);
+
+ private:
+  check_scheduler();
+  check_scheduler(check_scheduler const&) = delete;
+  check_scheduler& operator=(check_scheduler const&) = delete;
+  double* _command_average(service const* svc, bool create);
+
+  /* Average execution time of each check command, by command name. */
+  std::unordered_map<std::string, double> _averages;
+  /* Average execution time of all the checks. */
+  double _mean;
+  /* Used to extract command names without allocating. */
+  std::string _key;
+  /* Slot-seconds available, negative when a long check was admitted on
+   * credit. */
+  double _tokens;
+  double _last_refill;
+};
+}  // namespace events
+
+CCE_END()
+
+#endif  // !CCE_EVENTS_CHECK_SCHEDULER_HH
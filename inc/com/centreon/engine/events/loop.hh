@@ -24,6 +24,7 @@
 
 #include <ctime>
 #include <deque>
+#include <vector>
 #include "com/centreon/engine/events/timed_event.hh"
 #include "com/centreon/engine/namespace.hh"
 
@@ -41,7 +42,7 @@ namespace events {
  */
 class loop {
   time_t _last_status_update;
-  time_t _last_time;
+  time_t _last_snapshot;
   unsigned int _need_reload;
 
   bool _reload_running;
@@ -49,12 +50,18 @@ class loop {
 
   timed_event_list _event_list_high;
   timed_event_list _event_list_low;
+  /* Service check events due but not admitted yet by the adaptive check
+   * scheduler, in their due order. They belong to the low priority list. */
+  timed_event_list _ready_checks;
 
   loop();
   loop(const loop&) = delete;
   ~loop() noexcept = default;
   loop& operator=(const loop&) = delete;
   void _dispatching();
+  void _run_ready_checks();
+  std::vector<timed_event*> _shift_event_list(timed_event_list& list,
+                                              long time_difference);
 
  public:
   enum priority {
@@ -76,6 +83,7 @@ class loop {
   timed_event* find_event(priority priority,
                           uint32_t event_type,
                           void* data);
+  size_t ready_checks() const noexcept;
   void reschedule_event(timed_event* event, priority priority);
   void resort_event_list(priority priority);
   void schedule(timed_event* evt, bool high_priority);
@@ -29,6 +29,7 @@
 #include <unordered_map>
 
 #include "com/centreon/engine/common.hh"
+#include "com/centreon/engine/deadline_queue.hh"
 #include "com/centreon/engine/logging.hh"
 #include "com/centreon/engine/namespace.hh"
 #include "com/centreon/engine/notifier.hh"
@@ -114,7 +115,7 @@ class host : public notifier {
        bool retain_nonstatus_information,
        bool obsess_over_host,
        std::string const& timezone);
-  ~host() = default;
+  ~host() noexcept;
   uint64_t get_host_id(void) const;
   void set_host_id(uint64_t id);
   void add_child_host(host* child);
@@ -177,6 +178,7 @@ class host : public notifier {
       dependency::types dependency_type) const override;
   static void check_for_orphaned();
   static void check_result_freshness();
+  static void rebuild_check_deadlines();
 
   enum host_state determine_host_reachability();
   bool recovered() const override;
@@ -257,6 +259,8 @@ class host : public notifier {
   bool get_notify_on_current_state() const override;
   bool is_in_downtime() const override;
   void resolve(int& w, int& e);
+  void update_freshness_deadline() override;
+  void update_orphan_deadline();
 
   host_map_unsafe parent_hosts;
   host_map_unsafe child_hosts;
@@ -268,6 +272,14 @@ class host : public notifier {
   std::list<hostgroup*>& get_parent_groups();
 
  private:
+  time_t _freshness_expiration(int& freshness_threshold) const;
+  time_t _orphan_expected_time() const;
+
+  /* Hosts by the time their results become stale. */
+  static deadline_queue<host> _freshness_queue;
+  /* Hosts whose check is running, by the time their result is late. */
+  static deadline_queue<host> _orphan_queue;
+
   uint64_t _id;
   std::string _name;
   std::string _alias;
@@ -287,7 +299,6 @@ class host : public notifier {
   time_t _last_time_down;
   time_t _last_time_unreachable;
   time_t _last_time_up;
-  time_t _last_state_history_update;
   int _total_services;
   unsigned long _total_service_check_interval;
   int _circular_path_checked;
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_HOST_GRAPH_HH
+#define CCE_HOST_GRAPH_HH
+
+#include <cstdint>
+#include <vector>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class host;
+
+/**
+ *  @class host_graph host_graph.hh "com/centreon/engine/host_graph.hh"
+ *  @brief Parent/child topology of the hosts, as adjacency arrays.
+ *
+ *  Hosts are indexed by their id in state_table::hosts(). The parents and
+ *  the children of each host are stored in two arrays with their offsets,
+ *  built from the parent_hosts maps on the first use after a change of the
+ *  topology. The number of UP parents of each host is kept up to date on
+ *  each host state change, so the reachability of a host does not look at
+ *  its parents.
+ *
+ *  Propagated checks are collected with a visit mark, so a host is queued
+ *  only once per check result, whatever the paths leading to it.
+ */
+class host_graph {
+ public:
+  enum direction { parents, children };
+
+  host_graph();
+  host_graph(host_graph const&) = delete;
+  host_graph& operator=(host_graph const&) = delete;
+  void begin_visit() noexcept;
+  uint32_t count(host const* hst, direction dir);
+  static host_graph& instance();
+  void invalidate() noexcept;
+  void neighbours(host const* hst,
+                  direction dir,
+                  bool (*filter)(host const* neighbour),
+                  std::vector<host*>& targets);
+  void state_changed(host const* hst, bool up);
+  uint32_t up_parents(host const* hst);
+  bool visit(host const* hst);
+
+ private:
+  void _build();
+  uint32_t _index(host const* hst);
+
+  bool _valid;
+  std::vector<uint32_t> _parent_offsets;
+  std::vector<uint32_t> _parents;
+  std::vector<uint32_t> _child_offsets;
+  std::vector<uint32_t> _children;
+  std::vector<uint32_t> _up_parents;
+  std::vector<uint32_t> _visited;
+  uint32_t _visit;
+};
+
+CCE_END()
+
+#endif  // !CCE_HOST_GRAPH_HH
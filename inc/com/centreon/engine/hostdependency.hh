@@ -49,6 +49,7 @@ class hostdependency : public dependency {
                  bool fail_on_unreachable,
                  bool fail_on_pending,
                  std::string const& dependency_period);
+  ~hostdependency() noexcept override;
 
   bool get_fail_on_up() const;
   void set_fail_on_up(bool fail_on_up);
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_LOGGING_ASYNC_FILE_HH
+#define CCE_LOGGING_ASYNC_FILE_HH
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "com/centreon/engine/namespace.hh"
+#include "com/centreon/logging/backend.hh"
+
+CCE_BEGIN()
+
+namespace logging {
+/**
+ *  @class async_file async_file.hh "com/centreon/engine/logging/async_file.hh"
+ *  @brief Log file written in the background.
+ *
+ *  Each thread logging into this file copies its lines into its own ring
+ *  buffer, without lock. A writer thread empties all the ring buffers with
+ *  one writev() call and rotates the file when it is larger than max_size,
+ *  as debug_file does. A thread whose ring buffer is full waits for the
+ *  writer. Rings of the exited threads are released once written.
+ */
+class async_file : public com::centreon::logging::backend {
+ public:
+  async_file(std::string const& path, bool show_pid, uint64_t max_size = 0);
+  async_file(async_file const&) = delete;
+  ~async_file() noexcept override;
+  async_file& operator=(async_file const&) = delete;
+  void close() noexcept override;
+  std::string const& filename() const noexcept;
+  void flush();
+  void log(uint64_t types,
+           uint32_t verbose,
+           char const* msg,
+           uint32_t size) noexcept override;
+  void open() override;
+  void reopen() override;
+
+ private:
+  class ring;
+  struct thread_rings;
+
+  ring& _thread_ring();
+  void _build_line(std::string& buffer, char const* msg, uint32_t size) const;
+  void _drain();
+  void _drop_orphans();
+  void _open_file();
+  void _write_loop();
+
+  std::string const _path;
+  uint64_t const _max_size;
+  uint64_t const _id;
+
+  /* Used by the writer thread only. */
+  int _fd;
+  uint64_t _size;
+
+  /* Protects _rings, the producers only take it to register their ring. */
+  std::mutex _rings_m;
+  std::vector<std::shared_ptr<ring>> _rings;
+
+  /* Protects the following members. */
+  std::mutex _m;
+  std::condition_variable _cv;
+  std::condition_variable _drained_cv;
+  uint64_t _drained;
+  bool _closed;
+  bool _reopen;
+  bool _stop;
+  std::thread _writer;
+};
+}  // namespace logging
+
+CCE_END()
+
+#endif  // !CCE_LOGGING_ASYNC_FILE_HH
@@ -19,7 +19,12 @@
 #ifndef CCE_LOGGING_BROKER_HH
 #define CCE_LOGGING_BROKER_HH
 
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 #include "com/centreon/engine/namespace.hh"
 #include "com/centreon/logging/backend.hh"
 
@@ -30,13 +35,29 @@ namespace logging {
  *  @class broker broker.hh
  *  @brief Call broker for all logging message.
  *
- *  Call broker for all logging message without debug.
+ *  Call broker for all logging message without debug. When batch mode is
+ *  enabled, messages are stored and sent by the main loop with flush(). At
+ *  most max_pending messages are stored, the next ones are dropped until
+ *  the next flush().
  */
 class broker : public com::centreon::logging::backend {
+  struct pending_log {
+    uint64_t types;
+    time_t time;
+    std::string message;
+  };
+
   bool _enable;
   std::thread::id _thread_id;
 
+  static std::atomic_bool _batch;
+  static std::mutex _pending_m;
+  static std::vector<pending_log> _pending;
+  static uint32_t _dropped;
+
  public:
+  static size_t const max_pending = 100000;
+
   broker();
   broker(broker const& right);
   ~broker() noexcept override;
@@ -48,6 +69,8 @@ class broker : public com::centreon::logging::backend {
            uint32_t size) noexcept override;
   void open() override final;
   void reopen() override;
+  static void batch(bool enable) noexcept;
+  static void flush();
 };
 }  // namespace logging
 
@@ -20,6 +20,9 @@
 #ifndef CCE_LOGGING_LOGGER_HH
 #define CCE_LOGGING_LOGGER_HH
 
+#include <atomic>
+#include <cstdint>
+
 #include "com/centreon/engine/namespace.hh"
 #include "com/centreon/logging/temp_logger.hh"
 
@@ -83,15 +86,50 @@ enum type_value {
  *  Logging verbosity.
  */
 enum verbosity_level { basic = 0u, more = 1u, most = 2u };
+
+/**
+ *  @class mask logger.hh
+ *  @brief Types logged by the backends of the logging engine.
+ *
+ *  The logger() macro reads this cache instead of asking the logging engine,
+ *  so a disabled log only costs an atomic load. It must be updated each time
+ *  a backend is added to or removed from the logging engine.
+ */
+class mask {
+  static std::atomic<uint64_t> _types[most + 1];
+
+ public:
+  /**
+   *  Check if a log is written by at least one backend.
+   *
+   *  @param[in] types    Logging types.
+   *  @param[in] verbose  Verbosity level.
+   *
+   *  @return True if the log is written.
+   */
+  static bool is_log(uint64_t types, uint32_t verbose) noexcept {
+    return verbose <= most &&
+           (_types[verbose].load(std::memory_order_relaxed) & types);
+  }
+  static void update() noexcept;
+};
 }  // namespace logging
 
 CCE_END()
 
-#define logger(type, verbose)                                            \
-  for (unsigned int __com_centreon_engine_logging_define_ui(0);          \
-       !__com_centreon_engine_logging_define_ui &&                       \
-       com::centreon::logging::engine::instance().is_log(type, verbose); \
-       ++__com_centreon_engine_logging_define_ui)                        \
+/* Without WITH_DEBUG_LOGS, the dbg_* logs are removed by the compiler. */
+#ifdef CCE_NO_DEBUG_LOGS
+#define CCE_LOGGING_COMPILED_TYPES com::centreon::engine::logging::log_all
+#else
+#define CCE_LOGGING_COMPILED_TYPES com::centreon::engine::logging::all
+#endif  // CCE_NO_DEBUG_LOGS
+
+#define logger(type, verbose)                                           \
+  for (unsigned int __com_centreon_engine_logging_define_ui(0);         \
+       !__com_centreon_engine_logging_define_ui &&                      \
+       ((type) & CCE_LOGGING_COMPILED_TYPES) &&                         \
+       com::centreon::engine::logging::mask::is_log(type, verbose);     \
+       ++__com_centreon_engine_logging_define_ui)                       \
   com::centreon::logging::temp_logger(type, verbose)
 
 #endif  // !CCE_LOGGING_LOGGER_HH
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_NAME_TABLE_HH
+#define CCE_NAME_TABLE_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+/**
+ *  @class name_table name_table.hh "com/centreon/engine/name_table.hh"
+ *  @brief Interned object names.
+ *
+ *  Each distinct name is stored once and gets a small id, starting at 1, so
+ *  that objects can keep ids instead of their own copies of the same names
+ *  (a service keeps the ids of its host name and of its description). Names
+ *  are never removed, the table only grows with renamed objects.
+ *
+ *  Names are added by the main loop while the configuration is applied.
+ *  Other threads can look them up as they look up the object maps, never
+ *  during a configuration reload. References returned by name() stay valid
+ *  since names are never removed and the deque does not move its elements
+ *  when it grows, but the table itself must not be read while it grows.
+ */
+class name_table {
+ public:
+  name_table();
+  static name_table& instance();
+
+  uint32_t find(char const* name, size_t len) const noexcept;
+  uint32_t find(std::string const& name) const noexcept;
+  uint32_t intern(std::string const& name);
+  std::string const& name(uint32_t id) const noexcept;
+  size_t size() const noexcept;
+
+ private:
+  name_table(name_table const&) = delete;
+  name_table& operator=(name_table const&) = delete;
+  static uint32_t _hash(char const* name, size_t len) noexcept;
+  void _grow();
+
+  /* Name of each id, shifted by one since 0 is not used. */
+  std::deque<std::string> _names;
+  /* Open addressing table, the hash in the high half and the id in the low
+   * half of each slot, 0 for free slots. */
+  std::vector<uint64_t> _slots;
+};
+
+CCE_END()
+
+#endif  // !CCE_NAME_TABLE_HH
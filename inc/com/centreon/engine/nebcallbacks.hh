@@ -21,6 +21,7 @@
 #ifndef CCE_NEBCALLBACKS_HH
 #define CCE_NEBCALLBACKS_HH
 
+#include <stddef.h>
 #include "com/centreon/engine/nebmodules.hh"
 
 /* Callback types. */
@@ -28,7 +29,7 @@
 #define NEBCALLBACK_RESERVED1 1
 #define NEBCALLBACK_RESERVED2 2
 #define NEBCALLBACK_RESERVED3 3
-#define NEBCALLBACK_RESERVED4 4
+#define NEBCALLBACK_PERFDATA_DATA 4 /* Was NEBCALLBACK_RESERVED4. */
 #define NEBCALLBACK_RAW_DATA 5
 #define NEBCALLBACK_NEB_DATA 6
 #define NEBCALLBACK_PROCESS_DATA 7
@@ -72,13 +73,34 @@
 
 #define NEBCALLBACK_NUMITEMS 43 /* Total number of callback types we have. */
 
+/*
+** Batch of events given to the callbacks registered with
+** neb_register_batch_callback(). Each event points to the structure
+** usually given to the callbacks of this type. Events and their strings
+** are only valid during the callback. Only the events of the types
+** SERVICE_CHECK_DATA, HOST_CHECK_DATA, SERVICE_STATUS_DATA,
+** HOST_STATUS_DATA and STATE_CHANGE_DATA can be batched. Batches are sent
+** at the end of each check result reaping and at least every 100ms.
+*/
+typedef struct nebstruct_batch_struct {
+  int callback_type;
+  size_t size;
+  void** events;
+} nebstruct_batch_data;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* C++ */
 
+int neb_deregister_batch_callback(int callback_type,
+                                  int (*callback_func)(int, void*));
 int neb_deregister_callback(int callback_type,
                             int (*callback_func)(int, void*));
 int neb_deregister_module_callbacks(void* mod);
+int neb_register_batch_callback(int callback_type,
+                                void* mod_handle,
+                                int priority,
+                                int (*callback_func)(int, void*));
 int neb_register_callback(int callback_type,
                           void* mod_handle,
                           int priority,
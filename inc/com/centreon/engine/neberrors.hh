@@ -39,6 +39,8 @@
   206 /* module wants to override default handling of event */
 #define NEBERROR_CALLBACKCANCEL \
   207 /* module wants to cancel callbacks to other modules */
+#define NEBERROR_CALLBACKNOBATCH \
+  208 /* events of this callback type cannot be batched */
 
 // Module errors.
 #define NEBERROR_NOMEM 100    /* memory could not be allocated */
@@ -21,6 +21,7 @@
 #ifndef CCE_NEBMODS_HH
 #define CCE_NEBMODS_HH
 
+#include <vector>
 #include "com/centreon/engine/broker/handle.hh"
 #include "com/centreon/engine/nebcallbacks.hh"
 
@@ -32,6 +33,9 @@ typedef struct nebcallback_struct {
   struct nebcallback_struct* next;
 } nebcallback;
 
+// Callback function.
+typedef int (*neb_callback_func)(int, void*);
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // C++
@@ -54,6 +58,7 @@ int neb_unload_module(com::centreon::engine::broker::handle* mod,
 
 // Callback Functions
 int neb_make_callbacks(int callback_type, void* data);
+int neb_flush_batches(int max_delay_ms);
 int neb_init_callback_list();
 int neb_free_callback_list();
 
@@ -61,4 +66,29 @@ int neb_free_callback_list();
 }
 #endif  // C++
 
+/* Callbacks of each type, sorted by priority. An array is built again from
+ * neb_callback_list each time a callback of its type is registered or
+ * deregistered and is never modified, so neb_make_callbacks() can go through
+ * it even if a callback deregisters itself. It is null when no module
+ * subscribed to the type. */
+extern std::vector<neb_callback_func> const*
+    neb_dispatch_table[NEBCALLBACK_NUMITEMS];
+/* The same for batch callbacks. */
+extern std::vector<neb_callback_func> const*
+    neb_batch_dispatch_table[NEBCALLBACK_NUMITEMS];
+
+/**
+ *  Check if at least one module subscribed to a callback type, event by
+ *  event or by batch. The broker_*
+ *  functions use it to skip building the data of events nobody listens to.
+ *
+ *  @param[in] callback_type  A NEBCALLBACK_* value.
+ *
+ *  @return True if there is at least one callback.
+ */
+inline bool neb_has_callbacks(int callback_type) {
+  return neb_dispatch_table[callback_type] ||
+         neb_batch_dispatch_table[callback_type];
+}
+
 #endif  // !CCE_NEBMODS_HH
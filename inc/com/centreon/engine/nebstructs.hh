@@ -437,6 +437,45 @@ typedef struct nebstruct_notification_struct {
   void* object_ptr;
 } nebstruct_notification_data;
 
+/* Metric of a perfdata. Thresholds, min and max are NAN when absent. */
+typedef struct nebstruct_perfdata_metric_struct {
+  double value;
+  double warning_low;
+  double warning;
+  double critical_low;
+  double critical;
+  double min;
+  double max;
+  const char* label;
+  const char* uom;
+  /* The metric as written in the perfdata, without its thresholds, min and
+   * max. Not null-terminated. */
+  const char* text;
+  unsigned int text_size;
+  /* 'a' (absolute), 'c' (counter), 'd' (derive) or 'g' (gauge). */
+  char data_source_type;
+  /* Alert inside the range instead of outside ('@'). */
+  char warning_inverted;
+  char critical_inverted;
+} nebstruct_perfdata_metric;
+
+/* Perfdata structure. */
+typedef struct nebstruct_perfdata_struct {
+  int type;
+  int flags;
+  int attr;
+  struct timeval timestamp;
+
+  uint64_t host_id;
+  uint64_t service_id;
+  const char* host_name;
+  const char* service_description;
+  size_t size;
+  const nebstruct_perfdata_metric* metrics;
+
+  void* object_ptr;
+} nebstruct_perfdata_data;
+
 /* Process data structure. */
 typedef struct nebstruct_process_struct {
   int type;
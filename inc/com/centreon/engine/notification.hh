@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "com/centreon/engine/namespace.hh"
 #include "com/centreon/engine/notifier.hh"
@@ -55,7 +56,7 @@ class notification {
       uint32_t notification_interval,
       bool escalated = false,
       const std::set<std::string>& notified_contact = std::set<std::string>());
-  int execute(std::unordered_set<contact*> const& to_notify);
+  int execute(std::vector<contact*> const& to_notify);
   notifier::reason_type get_reason() const;
   uint32_t get_notification_interval() const;
   bool sent_to(const std::string& user) const;
@@ -22,6 +22,7 @@
 
 #include <array>
 #include <unordered_set>
+#include <vector>
 
 #include "com/centreon/engine/checkable.hh"
 #include "com/centreon/engine/contactgroup.hh"
@@ -246,11 +247,18 @@ class notifier : public checkable {
   bool is_notification_viable(notification_category cat,
                               reason_type type,
                               notification_option options);
-  std::unordered_set<contact*> get_contacts_to_notify(
+  std::vector<contact*> get_contacts_to_notify(
       notification_category cat,
       reason_type type,
       uint32_t& notification_interval,
       bool& escalated);
+  std::vector<contact*> const& get_flattened_contacts();
+  static void flatten_contacts(
+      std::unordered_map<std::string, contact*> const* contacts,
+      contactgroup_map_unsafe const& contactgroups,
+      std::vector<contact*>& retval);
+  static void invalidate_contacts_cache() noexcept;
+  static uint64_t get_contacts_generation() noexcept;
   notifier_type get_notifier_type() const noexcept;
   std::unordered_map<std::string, contact*>& get_contacts() noexcept;
   std::unordered_map<std::string, contact*> const& get_contacts()
@@ -277,6 +285,7 @@ class notifier : public checkable {
  private:
   static std::array<is_viable, 6> const _is_notification_viable;
   static uint64_t _next_notification_id;
+  static uint64_t _contacts_generation;
 
   bool _is_notification_viable_normal(reason_type type,
                                       notification_option options);
@@ -299,16 +308,12 @@ class notifier : public checkable {
   unsigned long _current_problem_id;
   unsigned long _last_problem_id;
 
-  time_t _initial_notif_time;
   int _acknowledgement_timeout;
-  time_t _last_acknowledgement;
   int32_t _out_notification_type;
   uint32_t _current_notifications;
   uint32_t _notification_interval;
   uint32_t _modified_attributes;
   uint64_t _current_notification_id;
-  time_t _next_notification;
-  time_t _last_notification;
   std::string _notification_period;
   timeperiod* _notification_period_ptr;
   uint32_t _first_notification_delay;
@@ -319,7 +324,6 @@ class notifier : public checkable {
   bool _has_been_checked;
   bool _no_more_notifications;
   uint64_t _flapping_comment_id;
-  int _check_options;
   int _acknowledgement_type;
   bool _retain_status_information;
   bool _retain_nonstatus_information;
@@ -336,6 +340,10 @@ class notifier : public checkable {
   // reason_type _type;
   std::unordered_map<std::string, contact*> _contacts;
   contactgroup_map_unsafe _contact_groups;
+  /* Contacts and contact groups members without duplicates, built again when
+   * the contacts generation changes. */
+  std::vector<contact*> _flattened_contacts;
+  uint64_t _flattened_contacts_generation;
   std::array<std::unique_ptr<notification>, 6> _notification;
   std::array<int, MAX_STATE_HISTORY_ENTRIES> _state_history;
   int _pending_flex_downtime;
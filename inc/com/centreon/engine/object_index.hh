@@ -0,0 +1,65 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_OBJECT_INDEX_HH
+#define CCE_OBJECT_INDEX_HH
+
+#include <cstddef>
+#include <string>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class contact;
+class contactgroup;
+class host;
+class hostgroup;
+class service;
+class servicegroup;
+
+/**
+ *  @class object_index object_index.hh "com/centreon/engine/object_index.hh"
+ *  @brief Find objects by name.
+ *
+ *  Lookups are made in the maps of the objects (host::hosts,
+ *  service::services...), so there is no index to maintain next to them.
+ *  Names do not need to be null-terminated so that external commands can be
+ *  looked up from their buffer. Lookups follow the threading rules of the
+ *  maps.
+ */
+class object_index {
+ public:
+  static contact* find_contact(std::string const& name);
+  static contactgroup* find_contactgroup(std::string const& name);
+  static host* find_host(char const* name, size_t len);
+  static host* find_host(std::string const& name);
+  static hostgroup* find_hostgroup(std::string const& name);
+  static service* find_service(char const* host_name,
+                               size_t host_len,
+                               char const* description,
+                               size_t description_len);
+  static service* find_service(std::string const& host_name,
+                               std::string const& description);
+  static servicegroup* find_servicegroup(std::string const& name);
+};
+
+CCE_END()
+
+#endif  // !CCE_OBJECT_INDEX_HH
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_PERFDATA_HH
+#define CCE_PERFDATA_HH
+
+#include <string>
+#include <vector>
+
+#include "com/centreon/engine/namespace.hh"
+#include "com/centreon/engine/nebstructs.hh"
+
+CCE_BEGIN()
+
+/**
+ *  @class perfdata perfdata.hh "com/centreon/engine/perfdata.hh"
+ *  @brief Parser of the perfdata returned by the plugins.
+ *
+ *  parse() cuts a perfdata string into metrics once, so that broker modules
+ *  and anomaly detections do not have to tokenize it again. The metrics and
+ *  their labels and units are kept in an arena owned by the calling thread:
+ *  they are valid until the next call of parse() in the same thread, and the
+ *  text of each metric points into the perfdata string.
+ */
+class perfdata {
+ public:
+  typedef nebstruct_perfdata_metric metric;
+
+  perfdata() = delete;
+  static metric const* find(std::vector<metric> const& metrics,
+                            std::string const& label) noexcept;
+  static std::vector<metric> const& parse(std::string const& perfdata);
+};
+
+CCE_END()
+
+#endif  // !CCE_PERFDATA_HH
@@ -32,6 +32,7 @@
 #include "com/centreon/engine/check_result.hh"
 #include "com/centreon/engine/common.hh"
 #include "com/centreon/engine/customvariable.hh"
+#include "com/centreon/engine/deadline_queue.hh"
 #include "com/centreon/engine/hash.hh"
 #include "com/centreon/engine/logging.hh"
 #include "com/centreon/engine/notifier.hh"
@@ -101,15 +102,17 @@ class service : public notifier {
           int freshness_threshold,
           bool obsess_over,
           std::string const& timezone);
-  ~service() = default;
+  ~service() noexcept;
   void set_host_id(uint64_t host_id);
   uint64_t get_host_id() const;
   void set_service_id(uint64_t service_id);
   uint64_t get_service_id() const;
   void set_hostname(std::string const& name);
   std::string const& get_hostname() const;
+  uint32_t get_hostname_id() const;
   void set_description(std::string const& desc);
   std::string const& get_description() const;
+  uint32_t get_description_id() const;
   void set_event_handler_args(std::string const& event_hdl_args);
   std::string const& get_event_handler_args() const;
   void set_check_command_args(std::string const& cmd_args);
@@ -190,8 +193,11 @@ class service : public notifier {
       dependency::types dependency_type) const override;
   static void check_for_orphaned();
   static void check_result_freshness();
+  static void rebuild_check_deadlines();
   bool is_in_downtime() const override;
   void resolve(int& w, int& e);
+  void update_freshness_deadline() override;
+  void update_orphan_deadline();
 
   std::list<servicegroup*> const& get_parent_groups() const;
   std::list<servicegroup*>& get_parent_groups();
@@ -204,10 +210,19 @@ class service : public notifier {
   static service_id_map services_by_id;
 
  private:
+  time_t _freshness_expiration(int& freshness_threshold) const;
+  time_t _orphan_expected_time() const;
+
+  /* Services by the time their results become stale. */
+  static deadline_queue<service> _freshness_queue;
+  /* Services whose check is running, by the time their result is late. */
+  static deadline_queue<service> _orphan_queue;
+
   uint64_t _host_id;
   uint64_t _service_id;
-  std::string _hostname;
-  std::string _description;
+  /* Ids in the name table. */
+  uint32_t _hostname_id;
+  uint32_t _description_id;
   std::string _event_handler_args;
   std::string _check_command_args;
 
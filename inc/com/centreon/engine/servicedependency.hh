@@ -52,6 +52,7 @@ class servicedependency : public dependency {
                     bool fail_on_critical,
                     bool fail_on_pending,
                     std::string const& dependency_period);
+  ~servicedependency() noexcept override;
 
   std::string const& get_dependent_service_description() const;
   void set_dependent_service_description(
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_SNAPSHOT_HH
+#define CCE_SNAPSHOT_HH
+
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "com/centreon/engine/hash.hh"
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+class Stats;
+class host;
+class service;
+
+/**
+ *  @class snapshot snapshot.hh
+ *  @brief Read-only copy of the hosts and services states.
+ *
+ *  The main loop periodically publishes an immutable view of the hosts and
+ *  services. Readers (the gRPC threads) get a reference on the current view
+ *  and keep it as long as they need it, they never block the main loop. A
+ *  new publication only replaces the pointer, old views are released when
+ *  their last reader drops them.
+ *
+ *  Objects are marked each time their status is sent to the broker (see
+ *  update_status()). A publication only copies again the marked objects, the
+ *  other entries and the lookup tables are shared with the previous view.
+ *  Everything is built again when the configuration is applied.
+ */
+class snapshot {
+ public:
+  struct host_entry {
+    const void* object;
+    uint64_t id;
+    std::string name;
+    std::string alias;
+    std::string address;
+    std::string check_period;
+    int current_state;
+    int state_type;
+    std::string plugin_output;
+    time_t last_check;
+    int current_attempt;
+    bool acknowledged;
+    bool in_downtime;
+  };
+
+  struct service_entry {
+    const void* object;
+    uint64_t host_id;
+    uint64_t service_id;
+    std::string host_name;
+    std::string description;
+    std::string check_period;
+    int current_state;
+    int state_type;
+    std::string plugin_output;
+    time_t last_check;
+    int current_attempt;
+    bool acknowledged;
+    bool in_downtime;
+  };
+
+  /* Lookup tables, shared between views while the objects set is stable. */
+  struct index {
+    std::unordered_map<std::string, size_t> host_by_name;
+    std::unordered_map<uint64_t, size_t> host_by_id;
+    std::unordered_map<std::pair<std::string, std::string>, size_t, pair_hash>
+        service_by_names;
+    std::unordered_map<std::pair<uint64_t, uint64_t>, size_t, pair_hash>
+        service_by_ids;
+    /* Group name -> positions of the members in hosts or services. */
+    std::unordered_map<std::string, std::vector<size_t>> hostgroup_members;
+    std::unordered_map<std::string, std::vector<size_t>> servicegroup_members;
+    /* Object -> position in hosts or services, for incremental updates. */
+    std::unordered_map<const void*, size_t> host_by_object;
+    std::unordered_map<const void*, size_t> service_by_object;
+  };
+
+  struct data {
+    time_t published;
+    /* Sorted by host id. */
+    std::vector<std::shared_ptr<const host_entry>> hosts;
+    /* Sorted by host id and service id. */
+    std::vector<std::shared_ptr<const service_entry>> services;
+    std::shared_ptr<const index> idx;
+    uint32_t contacts_count;
+    uint32_t hostgroups_count;
+    uint32_t servicegroups_count;
+    uint32_t contactgroups_count;
+    uint32_t hostdependencies_count;
+    uint32_t servicedependencies_count;
+    /* Only filled with the sections (command_manager::stats_section) some
+     * reader asked for recently. */
+    std::shared_ptr<const Stats> stats;
+    uint32_t stats_sections;
+
+    const host_entry* find_host(const std::string& name) const;
+    const host_entry* find_host(uint64_t id) const;
+    const service_entry* find_service(const std::string& host_name,
+                                      const std::string& description) const;
+    const service_entry* find_service(uint64_t host_id,
+                                      uint64_t service_id) const;
+  };
+
+  static snapshot& instance();
+  void publish();
+  std::shared_ptr<const data> get() const;
+  void clear();
+  void invalidate() noexcept;
+  void stats_requested(uint32_t sections) noexcept;
+  void host_changed(const host* hst);
+  void service_changed(const service* svc);
+
+ private:
+  snapshot();
+  snapshot(const snapshot&) = delete;
+  snapshot& operator=(const snapshot&) = delete;
+
+  std::shared_ptr<const data> _current;
+  /* Last request of each statistics section. */
+  std::atomic<time_t> _last_stats_request[3];
+  std::atomic<bool> _invalidated;
+  /* Objects changed since the last publication, main loop only. */
+  std::unordered_set<const host*> _dirty_hosts;
+  std::unordered_set<const service*> _dirty_services;
+};
+
+CCE_END()
+
+#endif  // !CCE_SNAPSHOT_HH
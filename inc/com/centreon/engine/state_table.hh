@@ -0,0 +1,98 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_STATE_TABLE_HH
+#define CCE_STATE_TABLE_HH
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class checkable;
+
+/**
+ *  @class state_table state_table.hh "com/centreon/engine/state_table.hh"
+ *  @brief Scheduling and state fields of the hosts or of the services, stored
+ *  by column.
+ *
+ *  Hosts and services keep their configuration, strings and lists, but the
+ *  few fields read and written by the scheduler, the reaper and the
+ *  freshness checks live here, one array per field, indexed by a dense id
+ *  given to each object. Going through all the objects only reads the
+ *  arrays needed instead of a large object per host or service.
+ *
+ *  The id of a removed object is given to the next added object, the slots
+ *  of removed objects have a null object and no flag. The columns are only
+ *  used by the main thread, as the objects.
+ *
+ *  Timestamps are in the engine time base (see time_base), the getters of
+ *  the objects give them in wall-clock time.
+ */
+class state_table {
+ public:
+  enum flag : uint16_t {
+    checks_enabled = 1 << 0,
+    accept_passive_checks = 1 << 1,
+    check_freshness = 1 << 2,
+    has_been_checked = 1 << 3,
+    is_executing = 1 << 4,
+    should_be_scheduled = 1 << 5,
+  };
+
+  state_table() = default;
+  state_table(state_table const&) = delete;
+  state_table& operator=(state_table const&) = delete;
+  uint32_t add(checkable* obj);
+  static state_table& hosts();
+  void remove(uint32_t id) noexcept;
+  static state_table& services();
+  uint32_t size() const noexcept;
+
+  std::vector<checkable*> object;
+  std::vector<std::time_t> next_check;
+  std::vector<std::time_t> last_check;
+  std::vector<std::time_t> last_state_change;
+  std::vector<std::time_t> last_hard_state_change;
+  std::vector<std::time_t> last_notification;
+  std::vector<std::time_t> next_notification;
+  std::vector<std::time_t> initial_notif_time;
+  std::vector<std::time_t> last_acknowledgement;
+  /* Hosts only. */
+  std::vector<std::time_t> last_state_history_update;
+  std::vector<double> latency;
+  std::vector<uint32_t> check_interval;
+  std::vector<uint32_t> retry_interval;
+  std::vector<int32_t> freshness_threshold;
+  std::vector<int32_t> current_attempt;
+  std::vector<int32_t> check_options;
+  std::vector<uint16_t> flags;
+  std::vector<uint8_t> current_state;
+  std::vector<uint8_t> state_type;
+
+ private:
+  std::vector<uint32_t> _free_ids;
+};
+
+CCE_END()
+
+#endif  // !CCE_STATE_TABLE_HH
@@ -21,6 +21,7 @@
 #define CCE_STATISTICS_HH
 
 #include <atomic>
+#include <string>
 #include <sys/types.h>
 #include <unistd.h>
 #include "com/centreon/engine/namespace.hh"
@@ -32,12 +33,24 @@ struct buffer_stats {
 };
 
 CCE_BEGIN()
+struct stats_segment;
+
 class statistics {
+  /* The memory mapped file read by centenginestats. */
+  std::string _segment_path;
+  stats_segment* _segment;
+
   statistics();
+  ~statistics() noexcept;
+  bool _open_segment(std::string const& path);
+  void _close_segment() noexcept;
+
  public:
   static statistics& instance();
   pid_t get_pid() const noexcept;
   bool get_external_command_buffer_stats(buffer_stats& retval) const noexcept;
+  void publish_segment();
+  void remove_segment() noexcept;
 };
 
 CCE_END()
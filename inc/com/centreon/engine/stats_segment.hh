@@ -0,0 +1,148 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_STATS_SEGMENT_HH
+#define CCE_STATS_SEGMENT_HH
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "com/centreon/engine/checks/stats.hh"
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+/**
+ *  @struct stats_segment stats_segment.hh
+ *  @brief Statistics shared by the engine with centenginestats.
+ *
+ *  This structure is the content of a memory mapped file written by the
+ *  engine each time status data are updated. Readers map it read-only and
+ *  copy the payload, a sequence counter (odd while the engine writes) tells
+ *  them if the copy is consistent. There is no lock between processes, so
+ *  the engine is never slowed down by readers.
+ *
+ *  Any change of the payload layout must increase version.
+ */
+struct stats_segment {
+  static uint32_t const magic_number = 0x43435353;
+  static uint32_t const current_version = 1;
+
+  struct type_stats {
+    double min_latency;
+    double max_latency;
+    double average_latency;
+    double min_execution_time;
+    double max_execution_time;
+    double average_execution_time;
+    double min_state_change;
+    double max_state_change;
+    double average_state_change;
+    /* 50th, 95th and 99th percentiles. */
+    double latency_percentiles[3];
+    double execution_time_percentiles[3];
+    /* Checks made during the last 1/5/15/60 minutes. */
+    uint32_t checks_last[4];
+  };
+
+  struct objects_stats {
+    uint32_t count;
+    uint32_t checked;
+    uint32_t scheduled;
+    uint32_t actively_checked;
+    uint32_t passively_checked;
+    double min_state_change;
+    double max_state_change;
+    double average_state_change;
+    type_stats active;
+    type_stats passive;
+    /* ok/warning/critical/unknown or up/down/unreachable. */
+    uint32_t states[4];
+    uint32_t flapping;
+    uint32_t downtime;
+  };
+
+  struct payload {
+    char version[32];
+    int64_t updated;
+    int64_t program_start;
+    int64_t pid;
+    uint32_t total_external_command_buffer_slots;
+    uint32_t used_external_command_buffer_slots;
+    uint32_t high_external_command_buffer_slots;
+    /* Last 1/5/15 minutes counters of each check type. */
+    uint32_t check_stats[MAX_CHECK_STATS_TYPES][3];
+    objects_stats services;
+    objects_stats hosts;
+  };
+
+  uint32_t magic;
+  uint32_t version;
+  std::atomic<uint64_t> sequence;
+  payload data;
+
+  static std::string path(std::string const& status_file) {
+    return status_file + ".shm";
+  }
+
+  /**
+   *  Copy the payload, only called by the engine.
+   *
+   *  @param[in] in The new payload.
+   */
+  void write(payload const& in) noexcept {
+    uint64_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&data, &in, sizeof(data));
+    sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  /**
+   *  Get a consistent copy of the payload.
+   *
+   *  @param[out] out The payload copy.
+   *
+   *  @return true on success, false if the segment is not compatible,
+   *          has never been written or is continuously written.
+   */
+  bool read(payload& out) const noexcept {
+    if (magic != magic_number || version != current_version)
+      return false;
+    for (int i = 0; i < 1000; ++i) {
+      uint64_t before = sequence.load(std::memory_order_acquire);
+      if (before & 1)
+        continue;
+      std::memcpy(&out, &data, sizeof(out));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) == before)
+        return before != 0;
+    }
+    return false;
+  }
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "the stats segment needs lock-free 64 bits atomics");
+
+CCE_END()
+
+#endif  // !CCE_STATS_SEGMENT_HH
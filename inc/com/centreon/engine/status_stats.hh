@@ -0,0 +1,160 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_STATUS_STATS_HH
+#define CCE_STATUS_STATS_HH
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+class checkable;
+class state_table;
+
+/**
+ *  @class status_stats status_stats.hh "com/centreon/engine/status_stats.hh"
+ *  @brief Aggregated status of the hosts or of the services: counts by
+ *  state, latency, execution time and state change, and checks during the
+ *  last minutes.
+ *
+ *  The contribution of each object is kept by its state_table id. When the
+ *  status of an object is updated, after a check result or a state change,
+ *  its previous contribution is taken out of the totals and the new one is
+ *  added, so reading the totals does not go through the objects. The totals
+ *  are built again from the objects on their first use after an object is
+ *  added or removed.
+ *
+ *  Minimum and maximum are computed again from the kept contributions, not
+ *  from the objects, only when the object holding one of them changed.
+ *  Check times are counted by second over the last hour, in the engine time
+ *  base so that a system time change does not move them.
+ */
+class status_stats {
+ public:
+  /* Active or passive checks. */
+  struct check_totals {
+    uint32_t count;
+    double min_latency;
+    double max_latency;
+    double average_latency;
+    double min_execution_time;
+    double max_execution_time;
+    double average_execution_time;
+    double min_state_change;
+    double max_state_change;
+    double average_state_change;
+    /* During the last 1, 5, 15 and 60 minutes. */
+    uint32_t checks_last[4];
+  };
+
+  struct totals {
+    uint32_t count;
+    uint32_t checked;
+    uint32_t scheduled;
+    /* By current state. */
+    uint32_t states[4];
+    uint32_t downtime;
+    uint32_t flapping;
+    double min_state_change;
+    double max_state_change;
+    double average_state_change;
+    check_totals active;
+    check_totals passive;
+  };
+
+  explicit status_stats(state_table const& states);
+  status_stats(status_stats const&) = delete;
+  status_stats& operator=(status_stats const&) = delete;
+  void get(std::time_t now, totals& retval);
+  static status_stats& hosts();
+  void invalidate() noexcept;
+  static status_stats& of(state_table const& states);
+  static status_stats& services();
+  void update(checkable const& obj);
+
+ private:
+  enum entry_flag : uint8_t {
+    counted = 1 << 0,
+    checked = 1 << 1,
+    scheduled = 1 << 2,
+    active = 1 << 3,
+    downtime = 1 << 4,
+    flapping = 1 << 5,
+  };
+
+  /* Contribution of an object to the totals. */
+  struct entry {
+    double latency;
+    double execution_time;
+    double state_change;
+    std::time_t last_check;
+    uint8_t state;
+    uint8_t flags;
+  };
+
+  /* Number of checks done during one second. */
+  struct second {
+    std::time_t time;
+    uint32_t checks;
+  };
+
+  struct extremum {
+    double min;
+    double max;
+  };
+
+  /* Sums of the active or of the passive checks. */
+  struct check_sums {
+    uint32_t count;
+    double latency;
+    double execution_time;
+    double state_change;
+    extremum latency_range;
+    extremum execution_time_range;
+    extremum state_change_range;
+    bool ranges_valid;
+    std::vector<second> seconds;
+  };
+
+  void _add(uint32_t id, checkable const& obj);
+  void _build();
+  void _compute_ranges(bool active);
+  void _fill(check_sums& sums, std::time_t now, check_totals& retval);
+  void _remove(uint32_t id) noexcept;
+
+  state_table const& _states;
+  bool _valid;
+  std::vector<entry> _entries;
+  uint32_t _count;
+  uint32_t _checked;
+  uint32_t _scheduled;
+  uint32_t _by_state[4];
+  uint32_t _downtime;
+  uint32_t _flapping;
+  check_sums _active;
+  check_sums _passive;
+};
+
+CCE_END()
+
+#endif  // !CCE_STATUS_STATS_HH
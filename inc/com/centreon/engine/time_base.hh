@@ -0,0 +1,66 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#ifndef CCE_TIME_BASE_HH
+#define CCE_TIME_BASE_HH
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+/**
+ *  @class time_base time_base.hh "com/centreon/engine/time_base.hh"
+ *  @brief Time base of the scheduling timestamps.
+ *
+ *  Next checks, last checks, state changes, notification times and
+ *  freshness deadlines are stored in an engine time base that follows the
+ *  monotonic clock: the wall clock minus an offset. When the wall clock
+ *  steps, only this offset changes and the stored timestamps keep their
+ *  order. They are converted back to the wall clock by the getters of the
+ *  objects, so modules and retention still see wall-clock times.
+ *
+ *  The values 0 and -1 mean unset and are never converted.
+ */
+class time_base {
+ public:
+  time_base();
+  time_base(time_base const&) = delete;
+  time_base& operator=(time_base const&) = delete;
+  int64_t detect_step(std::time_t wall, uint32_t threshold);
+  static time_base& instance();
+  std::time_t now() const;
+  int64_t offset() const noexcept;
+  void shift(int64_t time_difference) noexcept;
+  void start(std::time_t wall);
+  std::time_t to_internal(std::time_t wall) const noexcept;
+  std::time_t to_wall(std::time_t internal) const noexcept;
+
+ private:
+  int64_t _offset;
+  std::time_t _last_wall;
+  std::chrono::steady_clock::time_point _last_monotonic;
+};
+
+CCE_END()
+
+#endif  // !CCE_TIME_BASE_HH
@@ -20,6 +20,7 @@
 #ifndef CCE_OBJECTS_TIMEPERIOD_HH
 #define CCE_OBJECTS_TIMEPERIOD_HH
 
+#include <array>
 #include <ostream>
 #include <string>
 #include <unordered_map>
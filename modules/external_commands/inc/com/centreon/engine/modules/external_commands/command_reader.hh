@@ -0,0 +1,117 @@
+/*
+** Copyright 2021 Centreon
+**
+** This file is part of Centreon Engine.
+**
+** Centreon Engine is free software: you can redistribute it and/or
+** modify it under the terms of the GNU General Public License version 2
+** as published by the Free Software Foundation.
+**
+** Centreon Engine is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Centreon Engine. If not, see
+** <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CCE_MOD_EXTCMD_COMMAND_READER_HH
+#define CCE_MOD_EXTCMD_COMMAND_READER_HH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "com/centreon/engine/namespace.hh"
+
+CCE_BEGIN()
+
+namespace modules {
+namespace external_commands {
+/**
+ *  @class command_reader command_reader.hh
+ *  @brief Read external commands from the command file and hand them to the
+ *  main loop.
+ *
+ *  The reader thread reads the file with large non-blocking read() calls into
+ *  chunks of chunk_size bytes and splits the lines in place: each '\n' is
+ *  replaced by '\0' and the line is referenced by a pointer and a length.
+ *  Only a line cut by the end of a chunk is copied, at the beginning of the
+ *  next chunk.
+ *
+ *  Once the file is drained, the chunk and its lines are pushed on a
+ *  lock-free stack taken as a whole by the main loop. Processed chunks come
+ *  back to the reader through another lock-free stack, so once enough chunks
+ *  exist, commands do not allocate memory anymore.
+ *
+ *  There is one reader thread and one main loop thread, but commands can
+ *  also be submitted by other threads with submit().
+ */
+class command_reader {
+ public:
+  static uint32_t const chunk_size = 1u << 18;
+
+  /* Called with a command, null-terminated and without its '\n'. The
+   * command can be modified in place. */
+  typedef std::function<void(char* cmd, size_t len)> handler;
+  /* Called by the reader thread, returns true if it executed the command. */
+  typedef std::function<bool(char* cmd, size_t len)> filter;
+
+  command_reader(int fd, uint32_t max_queued, filter const& immediate);
+  command_reader(command_reader const&) = delete;
+  ~command_reader() noexcept;
+  command_reader& operator=(command_reader const&) = delete;
+  bool full() const noexcept;
+  size_t process(handler const& h);
+  uint32_t queued() const noexcept;
+  size_t read();
+  bool submit(char const* cmd);
+
+ private:
+  struct command {
+    char* data;
+    uint32_t size;
+  };
+
+  struct chunk {
+    explicit chunk(size_t capacity);
+    chunk* next;
+    size_t const capacity;
+    size_t used;
+    std::vector<command> lines;
+    std::unique_ptr<char[]> data;
+  };
+
+  static void _push(std::atomic<chunk*>& stack, chunk* c) noexcept;
+  chunk* _new_chunk();
+  void _publish();
+  void _split();
+
+  int const _fd;
+  uint32_t const _max_queued;
+  filter const _immediate;
+
+  /* Used by the reader thread only. */
+  chunk* _current;
+  chunk* _recycled;
+  /* Bytes of _current already split into lines. */
+  size_t _parsed;
+  /* The end of a too long line is being dropped. */
+  bool _skipping;
+
+  /* Chunks ready to be processed, last published first. */
+  std::atomic<chunk*> _ready;
+  /* Chunks processed, given back to the reader thread. */
+  std::atomic<chunk*> _free;
+  std::atomic<uint32_t> _queued;
+};
+}  // namespace external_commands
+}  // namespace modules
+
+CCE_END()
+
+#endif  // !CCE_MOD_EXTCMD_COMMAND_READER_HH
@@ -68,6 +68,9 @@ int process_passive_host_check(time_t check_time,
                                char const* host_name,
                                int return_code,
                                char const* output);
+void batch_passive_check_results(
+    int enable);  // keep the check results of this thread until flushed
+size_t flush_passive_check_results();  // send them to the checker
 int cmd_acknowledge_problem(
     int cmd,
     char* args);  // acknowledges a host or service problem
@@ -20,6 +20,8 @@
 #ifndef CCE_MODULES_EXTERNAL_COMMANDS_INTERNAL_HH
 #define CCE_MODULES_EXTERNAL_COMMANDS_INTERNAL_HH
 
+#include <memory>
+#include "com/centreon/engine/modules/external_commands/command_reader.hh"
 #include "com/centreon/engine/modules/external_commands/processing.hh"
 #include "com/centreon/engine/namespace.hh"
 
@@ -28,6 +30,7 @@ CCE_BEGIN()
 namespace modules {
 namespace external_commands {
 extern processing gl_processor;
+extern std::unique_ptr<command_reader> gl_reader;
 }
 }  // namespace modules
 
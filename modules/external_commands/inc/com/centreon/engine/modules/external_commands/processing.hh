@@ -20,17 +20,20 @@
 #ifndef CCE_MOD_EXTCMD_PROCESSING_HH
 #define CCE_MOD_EXTCMD_PROCESSING_HH
 
+#include <cstdint>
 #include <cstring>
 #include <map>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/contact.hh"
 #include "com/centreon/engine/contactgroup.hh"
 #include "com/centreon/engine/host.hh"
 #include "com/centreon/engine/hostgroup.hh"
 #include "com/centreon/engine/namespace.hh"
+#include "com/centreon/engine/object_index.hh"
 #include "com/centreon/engine/service.hh"
 #include "com/centreon/engine/servicegroup.hh"
 
@@ -43,6 +46,7 @@ class processing {
   processing();
   ~processing() throw();
   bool execute(std::string const& cmd) const;
+  bool execute(char* cmd, size_t len) const;
   bool is_thread_safe(char const* cmd) const;
 
  private:
@@ -120,11 +124,7 @@ class processing {
 
     char* name(my_strtok(args, ";"));
 
-    host* hst{nullptr};
-    host_map::const_iterator it(host::hosts.find(name));
-    if (it != host::hosts.end())
-      hst = it->second.get();
-
+    host* hst{name ? object_index::find_host(name, strlen(name)) : nullptr};
     if (!hst)
       return;
     (*fptr)(hst);
@@ -137,11 +137,7 @@ class processing {
 
     char* name(my_strtok(args, ";"));
 
-    host* hst{nullptr};
-    host_map::const_iterator it(host::hosts.find(name));
-    if (it != host::hosts.end())
-      hst = it->second.get();
-
+    host* hst{name ? object_index::find_host(name, strlen(name)) : nullptr};
     if (!hst)
       return;
     (*fptr)(hst, args + strlen(name) + 1);
@@ -154,10 +150,8 @@ class processing {
 
     char* group_name(my_strtok(args, ";"));
 
-    hostgroup* group(nullptr);
-    hostgroup_map::const_iterator it{hostgroup::hostgroups.find(group_name)};
-    if (it != hostgroup::hostgroups.end())
-      group = it->second.get();
+    hostgroup* group{group_name ? object_index::find_hostgroup(group_name)
+                                : nullptr};
     if (!group)
       return;
 
@@ -176,12 +170,13 @@ class processing {
     char* name(my_strtok(args, ";"));
     char* description(my_strtok(NULL, ";"));
 
-    service_map::const_iterator found(
-        service::services.find({name, description}));
-
-    if (found == service::services.end() || !found->second)
+    service* svc{description ? object_index::find_service(
+                                   name, strlen(name), description,
+                                   strlen(description))
+                             : nullptr};
+    if (!svc)
       return;
-    (*fptr)(found->second.get());
+    (*fptr)(svc);
   }
 
   template <void (*fptr)(service*, char*)>
@@ -191,12 +186,13 @@ class processing {
 
     char* name{my_strtok(args, ";")};
     char* description{my_strtok(NULL, ";")};
-    service_map::const_iterator found{
-        service::services.find({name, description})};
-
-    if (found == service::services.end() || !found->second)
+    service* svc{description ? object_index::find_service(
+                                   name, strlen(name), description,
+                                   strlen(description))
+                             : nullptr};
+    if (!svc)
       return;
-    (*fptr)(found->second.get(), args + strlen(name) + strlen(description) + 2);
+    (*fptr)(svc, args + strlen(name) + strlen(description) + 2);
   }
 
   template <void (*fptr)(service*)>
@@ -205,13 +201,13 @@ class processing {
     (void)entry_time;
 
     char* group_name(my_strtok(args, ";"));
-    servicegroup_map::const_iterator sg_it{
-        servicegroup::servicegroups.find(group_name)};
-    if (sg_it == servicegroup::servicegroups.end() || !sg_it->second)
+    servicegroup* group{
+        group_name ? object_index::find_servicegroup(group_name) : nullptr};
+    if (!group)
       return;
 
-    for (service_map_unsafe::iterator it2(sg_it->second->members.begin()),
-         end2(sg_it->second->members.end());
+    for (service_map_unsafe::iterator it2(group->members.begin()),
+         end2(group->members.end());
          it2 != end2; ++it2)
       if (it2->second)
         (*fptr)(it2->second);
@@ -223,20 +219,16 @@ class processing {
     (void)entry_time;
 
     char* group_name(my_strtok(args, ";"));
-    servicegroup_map::const_iterator sg_it{
-        servicegroup::servicegroups.find(group_name)};
-    if (sg_it == servicegroup::servicegroups.end() || !sg_it->second)
+    servicegroup* group{
+        group_name ? object_index::find_servicegroup(group_name) : nullptr};
+    if (!group)
       return;
 
     host* last_host{nullptr};
-    for (service_map_unsafe::iterator it2(sg_it->second->members.begin()),
-         end2(sg_it->second->members.end());
+    for (service_map_unsafe::iterator it2(group->members.begin()),
+         end2(group->members.end());
          it2 != end2; ++it2) {
-      host* hst{nullptr};
-      host_map::const_iterator found(host::hosts.find(it2->first.first));
-      if (found != host::hosts.end())
-        hst = found->second.get();
-
+      host* hst{object_index::find_host(it2->first.first)};
       if (!hst || hst == last_host)
         continue;
       (*fptr)(hst);
@@ -250,10 +242,10 @@ class processing {
     (void)entry_time;
 
     char* name(my_strtok(args, ";"));
-    contact_map::const_iterator ct_it{contact::contacts.find(name)};
-    if (ct_it == contact::contacts.end())
+    contact* cntct{name ? object_index::find_contact(name) : nullptr};
+    if (!cntct)
       return;
-    (*fptr)(ct_it->second.get());
+    (*fptr)(cntct);
   }
 
   template <void (*fptr)(char*)>
@@ -268,21 +260,41 @@ class processing {
     (void)entry_time;
 
     char* group_name(my_strtok(args, ";"));
-    contactgroup_map::iterator it_cg{
-        contactgroup::contactgroups.find(group_name)};
-    if (it_cg == contactgroup::contactgroups.end() || !it_cg->second)
+    contactgroup* group{
+        group_name ? object_index::find_contactgroup(group_name) : nullptr};
+    if (!group)
       return;
 
-    for (contact_map_unsafe::const_iterator
-             it(it_cg->second->get_members().begin()),
-         end(it_cg->second->get_members().end());
+    for (contact_map_unsafe::const_iterator it(group->get_members().begin()),
+         end(group->get_members().end());
          it != end; ++it)
       if (it->second)
         (*fptr)(it->second);
   }
 
+  /* A slot of the perfect hash table, name is empty in free slots. */
+  struct command_entry {
+    std::string name;
+    command_info info;
+  };
+
+  static uint32_t _hash(char const* name, size_t len, uint32_t seed) noexcept;
+  void _build_table();
+  command_info const* _find(char const* name, size_t len) const noexcept;
+
+  /* Only used by the constructor to build the perfect hash table. */
   std::unordered_map<std::string, command_info> _lst_command;
-  mutable std::mutex _mutex;
+
+  /* Perfect hash table of the commands, a name is first hashed to a bucket
+   * whose seed gives its slot in _table. They are not modified after the
+   * constructor, so lookups need no lock. */
+  std::vector<uint32_t> _seeds;
+  std::vector<command_entry> _table;
+
+  /* Handlers are still run one at a time, the command file worker and the
+   * main loop may both execute commands. PROCESS_FILE executes the commands
+   * of its file from its handler, hence the recursive mutex. */
+  mutable std::recursive_mutex _mutex;
 };
 }  // namespace external_commands
 }  // namespace modules
@@ -0,0 +1,270 @@
+/*
+** Copyright 2021 Centreon
+**
+** This file is part of Centreon Engine.
+**
+** Centreon Engine is free software: you can redistribute it and/or
+** modify it under the terms of the GNU General Public License version 2
+** as published by the Free Software Foundation.
+**
+** Centreon Engine is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+** General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with Centreon Engine. If not, see
+** <http://www.gnu.org/licenses/>.
+*/
+
+#include "com/centreon/engine/modules/external_commands/command_reader.hh"
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include "com/centreon/engine/logging/logger.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::logging;
+using namespace com::centreon::engine::modules::external_commands;
+
+/**
+ *  Chunk constructor.
+ *
+ *  @param[in] capacity  Size of the chunk data.
+ */
+command_reader::chunk::chunk(size_t capacity)
+    : next{nullptr}, capacity{capacity}, used{0}, data{new char[capacity]} {}
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] fd          The command file, opened in non-blocking mode.
+ *  @param[in] max_queued  The reader stops reading when this number of
+ *                         commands wait for the main loop, 0 for no limit.
+ *  @param[in] immediate   Called by the reader thread on each command, the
+ *                         command is not queued if it returns true. Can be
+ *                         empty.
+ */
+command_reader::command_reader(int fd,
+                               uint32_t max_queued,
+                               filter const& immediate)
+    : _fd{fd},
+      _max_queued{max_queued},
+      _immediate{immediate},
+      _current{new chunk(chunk_size)},
+      _recycled{nullptr},
+      _parsed{0},
+      _skipping{false},
+      _ready{nullptr},
+      _free{nullptr},
+      _queued{0} {}
+
+/**
+ *  Destructor. Commands not processed yet are lost.
+ */
+command_reader::~command_reader() noexcept {
+  delete _current;
+  for (chunk* list : {_recycled, _ready.load(), _free.load()}) {
+    while (list) {
+      chunk* c = list;
+      list = c->next;
+      delete c;
+    }
+  }
+}
+
+/**
+ *  Tell if too many commands are waiting for the main loop.
+ *
+ *  @return True if the reader should not read more commands.
+ */
+bool command_reader::full() const noexcept {
+  return _max_queued && _queued.load(std::memory_order_relaxed) >= _max_queued;
+}
+
+/**
+ *  Call a handler on each queued command, in their arrival order. This method
+ *  must be called from the main loop.
+ *
+ *  @param[in] h  The handler.
+ *
+ *  @return The number of processed commands.
+ */
+size_t command_reader::process(handler const& h) {
+  chunk* list = _ready.exchange(nullptr, std::memory_order_acquire);
+
+  /* The stack gives the last published chunk first. */
+  chunk* ordered = nullptr;
+  while (list) {
+    chunk* c = list;
+    list = c->next;
+    c->next = ordered;
+    ordered = c;
+  }
+
+  size_t count = 0;
+  while (ordered) {
+    chunk* c = ordered;
+    ordered = c->next;
+    for (command const& cmd : c->lines) {
+      try {
+        h(cmd.data, cmd.size);
+      } catch (std::exception const& e) {
+        logger(log_runtime_error, basic)
+            << "Error: external command failed: " << e.what();
+      }
+    }
+    count += c->lines.size();
+    _queued.fetch_sub(c->lines.size(), std::memory_order_relaxed);
+    _push(_free, c);
+  }
+  return count;
+}
+
+/**
+ *  Get the number of commands waiting for the main loop.
+ *
+ *  @return A number.
+ */
+uint32_t command_reader::queued() const noexcept {
+  return _queued.load(std::memory_order_relaxed);
+}
+
+/**
+ *  Read the command file until it is empty or until the queue is full, and
+ *  queue the complete lines. This method must be called from the reader
+ *  thread.
+ *
+ *  @return The number of bytes read.
+ */
+size_t command_reader::read() {
+  size_t total = 0;
+  while (!full()) {
+    if (_current->used == _current->capacity) {
+      if (_parsed == 0) {
+        logger(log_runtime_warning, basic)
+            << "Warning: external command longer than " << chunk_size
+            << " bytes ignored";
+        _current->used = 0;
+        _skipping = true;
+      } else
+        _publish();
+    }
+
+    ssize_t r = ::read(_fd, _current->data.get() + _current->used,
+                       _current->capacity - _current->used);
+    if (r < 0 && errno == EINTR)
+      continue;
+    /* EAGAIN: the file is empty. */
+    if (r <= 0)
+      break;
+    _current->used += r;
+    total += r;
+    _split();
+  }
+
+  if (!_current->lines.empty())
+    _publish();
+  return total;
+}
+
+/**
+ *  Queue a command. This method can be called from any thread, the command
+ *  is copied.
+ *
+ *  @param[in] cmd  The command.
+ *
+ *  @return False if the queue is full.
+ */
+bool command_reader::submit(char const* cmd) {
+  if (full())
+    return false;
+  size_t len = strlen(cmd);
+  chunk* c = new chunk(len + 1);
+  memcpy(c->data.get(), cmd, len + 1);
+  c->used = len + 1;
+  c->lines.push_back({c->data.get(), static_cast<uint32_t>(len)});
+  _queued.fetch_add(1, std::memory_order_relaxed);
+  _push(_ready, c);
+  return true;
+}
+
+/**
+ *  Push a chunk on a lock-free stack. Chunks are only taken from these stacks
+ *  all at once, with exchange(), so there is no ABA problem.
+ *
+ *  @param[in] stack  The stack.
+ *  @param[in] c      The chunk.
+ */
+void command_reader::_push(std::atomic<chunk*>& stack, chunk* c) noexcept {
+  c->next = stack.load(std::memory_order_relaxed);
+  while (!stack.compare_exchange_weak(c->next, c, std::memory_order_release,
+                                      std::memory_order_relaxed))
+    ;
+}
+
+/**
+ *  Get an empty chunk, processed chunks are reused.
+ *
+ *  @return The chunk.
+ */
+command_reader::chunk* command_reader::_new_chunk() {
+  if (!_recycled)
+    _recycled = _free.exchange(nullptr, std::memory_order_acquire);
+  while (_recycled) {
+    chunk* c = _recycled;
+    _recycled = c->next;
+    /* Chunks built by submit() are too small. */
+    if (c->capacity == chunk_size) {
+      c->next = nullptr;
+      c->used = 0;
+      c->lines.clear();
+      return c;
+    }
+    delete c;
+  }
+  return new chunk(chunk_size);
+}
+
+/**
+ *  Hand the lines of the current chunk to the main loop and continue in a
+ *  new chunk, starting with the incomplete line.
+ */
+void command_reader::_publish() {
+  chunk* next = _new_chunk();
+  next->used = _current->used - _parsed;
+  memcpy(next->data.get(), _current->data.get() + _parsed, next->used);
+
+  chunk* c = _current;
+  _current = next;
+  _parsed = 0;
+  if (c->lines.empty()) {
+    c->next = _recycled;
+    _recycled = c;
+  } else {
+    _queued.fetch_add(c->lines.size(), std::memory_order_relaxed);
+    _push(_ready, c);
+  }
+}
+
+/**
+ *  Split the new complete lines of the current chunk.
+ */
+void command_reader::_split() {
+  char* data = _current->data.get();
+  char* end = data + _current->used;
+  char* start = data + _parsed;
+  for (;;) {
+    char* nl = static_cast<char*>(memchr(start, '\n', end - start));
+    if (!nl)
+      break;
+    *nl = 0;
+    uint32_t len = nl - start;
+    if (_skipping)
+      _skipping = false;
+    else if (len && !(_immediate && _immediate(start, len)))
+      _current->lines.push_back({start, len});
+    start = nl + 1;
+  }
+  _parsed = start - data;
+}
@@ -25,7 +25,11 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <sstream>
+#include <string>
+#include <utility>
 
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks/checker.hh"
@@ -41,6 +45,7 @@
 #include "com/centreon/engine/modules/external_commands/internal.hh"
 #include "com/centreon/engine/modules/external_commands/processing.hh"
 #include "com/centreon/engine/modules/external_commands/utils.hh"
+#include "com/centreon/engine/object_index.hh"
 #include "com/centreon/engine/statusdata.hh"
 #include "com/centreon/engine/string.hh"
 #include "mmap.h"
@@ -74,37 +79,20 @@ int check_for_external_commands() {
     update_program_status(false);
   }
 
-  /* process all commands found in the buffer */
-  char* buffer(nullptr);
-  for (;;) {
-    /* get a lock on the buffer */
-    pthread_mutex_lock(&external_command_buffer.buffer_lock);
+  /* the command file is not open */
+  if (!modules::external_commands::gl_reader)
+    return OK;
 
-    /* if no items present, bail out */
-    if (external_command_buffer.items <= 0) {
-      pthread_mutex_unlock(&external_command_buffer.buffer_lock);
-      break;
-    }
-
-    buffer =
-        ((char**)external_command_buffer.buffer)[external_command_buffer.tail];
-    ((char**)external_command_buffer.buffer)[external_command_buffer.tail] =
-        nullptr;
-
-    /* adjust tail counter and number of items */
-    external_command_buffer.tail = (external_command_buffer.tail + 1) %
-                                   config->external_command_buffer_slots();
-    external_command_buffer.items--;
-
-    /* release the lock on the buffer */
-    pthread_mutex_unlock(&external_command_buffer.buffer_lock);
-
-    /* process the command */
-    process_external_command(buffer);
+  /* process all commands read from the command file */
+  modules::external_commands::gl_reader->process([](char* cmd, size_t len) {
+    modules::external_commands::gl_processor.execute(cmd, len);
+  });
 
-    /* free memory */
-    delete[] buffer;
-  }
+  /* update the buffer statistics */
+  pthread_mutex_lock(&external_command_buffer.buffer_lock);
+  external_command_buffer.items =
+      modules::external_commands::gl_reader->queued();
+  pthread_mutex_unlock(&external_command_buffer.buffer_lock);
 
   return OK;
 }
@@ -464,6 +452,68 @@ void cmd_signal_process(int cmd, char* args) {
   events::loop::instance().schedule(evt, true);
 }
 
+/* Passive check results built by a thread batching them (the command file
+ * reader), sent to the checker at once by flush_passive_check_results(). */
+static thread_local bool passive_batching = false;
+static thread_local std::deque<check_result*> passive_batch;
+
+/**
+ *  Send a passive check result to the checker, or keep it in the batch of
+ *  the calling thread.
+ *
+ *  @param[in] result  The check result.
+ */
+static void submit_passive_check_result(check_result* result) {
+  if (passive_batching)
+    passive_batch.push_back(result);
+  else
+    checks::checker::instance().add_check_result_to_reap(result);
+}
+
+/**
+ *  Find the host of a passive check result, by name or else by address.
+ *
+ *  @param[in] host_name  The host name or address.
+ *
+ *  @return The host, nullptr if not found.
+ */
+static host* find_passive_check_host(char const* host_name) {
+  host* hst(object_index::find_host(host_name, strlen(host_name)));
+  if (hst)
+    return hst;
+  for (host_map::iterator it(host::hosts.begin()), end(host::hosts.end());
+       it != end; ++it)
+    if (it->second && it->second->get_address() == host_name)
+      return it->second.get();
+  return nullptr;
+}
+
+/**
+ *  Keep the passive check results submitted by the calling thread until
+ *  flush_passive_check_results() is called, so that the checker lock is
+ *  taken once per batch. Disabling it flushes the batch.
+ *
+ *  @param[in] enable  True to batch the check results.
+ */
+void batch_passive_check_results(int enable) {
+  if (!enable)
+    flush_passive_check_results();
+  passive_batching = enable;
+}
+
+/**
+ *  Send the passive check results batched by the calling thread to the
+ *  checker.
+ *
+ *  @return The number of check results sent.
+ */
+size_t flush_passive_check_results() {
+  size_t retval = passive_batch.size();
+  if (retval)
+    checks::checker::instance().add_check_results_to_reap(passive_batch);
+  return retval;
+}
+
 /**
  *  Processes results of an external service check.
  *
@@ -516,8 +566,6 @@ int process_passive_service_check(time_t check_time,
                                   char const* svc_description,
                                   int return_code,
                                   char const* output) {
-  char const* real_host_name(nullptr);
-
   /* skip this service check result if we aren't accepting passive service
    * checks */
   if (config->accept_passive_service_checks() == false)
@@ -527,23 +575,12 @@ int process_passive_service_check(time_t check_time,
   if (host_name == nullptr || svc_description == nullptr || output == nullptr)
     return ERROR;
 
-  /* find the host by its name or address */
-  host_map::const_iterator it(host::hosts.find(host_name));
-  if (it != host::hosts.end() && it->second)
-    real_host_name = host_name;
-  else {
-    for (host_map::iterator itt(host::hosts.begin()), end(host::hosts.end());
-         itt != end; ++itt) {
-      if (itt->second && itt->second->get_address() == host_name) {
-        real_host_name = itt->first.c_str();
-        it = itt;
-        break;
-      }
-    }
-  }
+  /* find the host by its name or address, names are looked up through the
+   * object index to avoid building a key per check result */
+  host* hst(find_passive_check_host(host_name));
 
   /* we couldn't find the host */
-  if (real_host_name == nullptr) {
+  if (hst == nullptr) {
     logger(log_runtime_warning, basic)
         << "Warning:  Passive check result was received for service '"
         << svc_description << "' on host '" << host_name
@@ -552,9 +589,8 @@ int process_passive_service_check(time_t check_time,
   }
 
   /* make sure the service exists */
-  service_map::const_iterator found(
-      service::services.find({real_host_name, svc_description}));
-  if (found == service::services.end() || !found->second) {
+  service* svc(object_index::find_service(hst->get_name(), svc_description));
+  if (svc == nullptr) {
     logger(log_runtime_warning, basic)
         << "Warning:  Passive check result was received for service '"
         << svc_description << "' on host '" << host_name
@@ -563,7 +599,7 @@ int process_passive_service_check(time_t check_time,
   }
 
   /* skip this is we aren't accepting passive checks for this service */
-  if (!found->second->get_accept_passive_checks())
+  if (!svc->get_accept_passive_checks())
     return ERROR;
 
   timeval tv;
@@ -572,7 +608,7 @@ int process_passive_service_check(time_t check_time,
   timeval set_tv = {.tv_sec = check_time, .tv_usec = 0};
 
   check_result* result =
-      new check_result(service_check, found->second.get(),
+      new check_result(service_check, svc,
                        checkable::check_passive, CHECK_OPTION_NONE, false,
                        static_cast<double>(tv.tv_sec - check_time) +
                            static_cast<double>(tv.tv_usec / 1000000.0),
@@ -587,7 +623,7 @@ int process_passive_service_check(time_t check_time,
     result->set_latency(0.0);
   }
 
-  checks::checker::instance().add_check_result_to_reap(result);
+  submit_passive_check_result(result);
 
   return OK;
 }
@@ -634,7 +670,6 @@ int process_passive_host_check(time_t check_time,
                                char const* host_name,
                                int return_code,
                                char const* output) {
-  char const* real_host_name(nullptr);
   /* skip this host check result if we aren't accepting passive host checks */
   if (!config->accept_passive_service_checks())
     return ERROR;
@@ -648,22 +683,10 @@ int process_passive_host_check(time_t check_time,
     return ERROR;
 
   /* find the host by its name or address */
-  host_map::const_iterator it(host::hosts.find(host_name));
-  if (it != host::hosts.end() && it->second)
-    real_host_name = host_name;
-  else {
-    for (host_map::iterator itt(host::hosts.begin()), end(host::hosts.end());
-         itt != end; ++itt) {
-      if (itt->second && itt->second->get_address() == host_name) {
-        real_host_name = itt->first.c_str();
-        it = itt;
-        break;
-      }
-    }
-  }
+  host* hst(find_passive_check_host(host_name));
 
   /* we couldn't find the host */
-  if (real_host_name == nullptr) {
+  if (hst == nullptr) {
     logger(log_runtime_warning, basic)
         << "Warning:  Passive check result was received for host '" << host_name
         << "', but the host could not be found!";
@@ -671,7 +694,7 @@ int process_passive_host_check(time_t check_time,
   }
 
   /* skip this is we aren't accepting passive checks for this host */
-  if (!it->second->get_accept_passive_checks())
+  if (!hst->get_accept_passive_checks())
     return ERROR;
 
   timeval tv;
@@ -679,7 +702,7 @@ int process_passive_host_check(time_t check_time,
   timeval tv_start = {.tv_sec = check_time, .tv_usec = 0};
 
   check_result* result =
-      new check_result(host_check, it->second.get(), checkable::check_passive,
+      new check_result(host_check, hst, checkable::check_passive,
                        CHECK_OPTION_NONE, false,
                        static_cast<double>(tv.tv_sec - check_time) +
                            static_cast<double>(tv.tv_usec / 1000000.0),
@@ -692,7 +715,7 @@ int process_passive_host_check(time_t check_time,
   if (result->get_latency() < 0.0)
     result->set_latency(0.0);
 
-  checks::checker::instance().add_check_result_to_reap(result);
+  submit_passive_check_result(result);
 
   return OK;
 }
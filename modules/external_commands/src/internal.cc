@@ -23,3 +23,6 @@ using namespace com::centreon::engine::modules;
 
 // Global external command processor object.
 external_commands::processing external_commands::gl_processor;
+
+// Reader of the external command file, set while the file is open.
+std::unique_ptr<external_commands::command_reader> external_commands::gl_reader;
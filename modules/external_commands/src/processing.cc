@@ -18,8 +18,11 @@
 */
 
 #include "com/centreon/engine/modules/external_commands/processing.hh"
+#include <algorithm>
 #include <cstdlib>
+#include <numeric>
 #include "com/centreon/engine/broker.hh"
+#include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/flapping.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
@@ -574,26 +577,49 @@ processing::processing()
   // misc commands.
   _lst_command["PROCESS_FILE"] = command_info(
       CMD_PROCESS_FILE, &_redirector<&cmd_process_external_commands_from_file>);
+
+  _build_table();
+  _lst_command.clear();
 }
 
 processing::~processing() noexcept {}
 
+/**
+ *  Execute an external command.
+ *
+ *  @param[in] cmdstr  The command.
+ *
+ *  @return True if the command was recognized.
+ */
 bool processing::execute(const std::string& cmdstr) const {
+  std::string cmd(cmdstr);
+  return execute(&cmd[0], cmd.size());
+}
+
+/**
+ *  Execute an external command. The command is parsed in place: the command
+ *  name and the arguments are split by writing '\0' in it.
+ *
+ *  @param[in,out] cmd  The command, cmd[len] must be writable.
+ *  @param[in]     len  Length of the command.
+ *
+ *  @return True if the command was recognized.
+ */
+bool processing::execute(char* cmd, size_t len) const {
   logger(dbg_functions, basic) << "processing external command";
 
-  char const* cmd{cmdstr.c_str()};
-  size_t len{cmdstr.size()};
+  char* end{cmd + len};
 
   // Left trim command
-  while (*cmd && isspace(*cmd))
+  while (cmd != end && isspace(*cmd))
     ++cmd;
-  if (*cmd != '[')
+  if (cmd == end || *cmd != '[')
     return false;
 
-  // Right trim just by recomputing the optimal length value.
-  char const* end{cmd + len - 1};
-  while (end != cmd && isspace(*end))
+  // Right trim.
+  while (end != cmd && isspace(end[-1]))
     --end;
+  *end = 0;
 
   cmd++;
   char* tmp;
@@ -604,32 +630,25 @@ bool processing::execute(const std::string& cmdstr) const {
   if (*tmp != ']' || tmp[1] != ' ')
     return false;
 
-  cmd = tmp + 2;
-  char const* a;
-  for (a = cmd; *a && *a != ';'; ++a)
+  char* command_name = tmp + 2;
+  char* args;
+  for (args = command_name; *args && *args != ';'; ++args)
     ;
+  size_t name_len = args - command_name;
+  if (*args == ';')
+    *args++ = 0;
 
-  std::string command_name(cmd, a - cmd);
-  std::string args;
-  if (*a == ';') {
-    a++;
-    args = std::string(a, end - a + 1);
-  }
-
+  // Custom commands are only sent to the broker.
   int command_id(CMD_CUSTOM_COMMAND);
-
-  std::unordered_map<std::string, command_info>::const_iterator it;
-  {
-    std::unique_lock<std::mutex> lock(_mutex);
-    it = _lst_command.find(command_name);
-    if (it != _lst_command.end())
-      command_id = it->second.id;
-    else if (command_name[0] != '_') {
-      lock.unlock();
+  command_info const* info{nullptr};
+  if (*command_name != '_') {
+    info = _find(command_name, name_len);
+    if (!info) {
       logger(log_external_command | log_runtime_warning, basic)
           << "Warning: Unrecognized external command -> " << command_name;
       return false;
     }
+    command_id = info->id;
 
     // Update statistics for external commands.
     update_check_stats(EXTERNAL_COMMAND_STATS, std::time(nullptr));
@@ -653,21 +672,17 @@ bool processing::execute(const std::string& cmdstr) const {
   // Send data to event broker.
   broker_external_command(NEBTYPE_EXTERNALCOMMAND_START, NEBFLAG_NONE,
                           NEBATTR_NONE, command_id, entry_time,
-                          const_cast<char*>(command_name.c_str()),
-                          const_cast<char*>(args.c_str()), nullptr);
-
-  {
-    std::lock_guard<std::mutex> lock(_mutex);
-    if (it != _lst_command.end())
-      (*it->second.func)(command_id, entry_time,
-                         const_cast<char*>(args.c_str()));
+                          command_name, args, nullptr);
+
+  if (info) {
+    std::lock_guard<std::recursive_mutex> lock(_mutex);
+    (*info->func)(command_id, entry_time, args);
   }
 
   // Send data to event broker.
   broker_external_command(NEBTYPE_EXTERNALCOMMAND_END, NEBFLAG_NONE,
                           NEBATTR_NONE, command_id, entry_time,
-                          const_cast<char*>(command_name.c_str()),
-                          const_cast<char*>(args.c_str()), nullptr);
+                          command_name, args, nullptr);
   return true;
 }
 
@@ -680,11 +695,104 @@ bool processing::execute(const std::string& cmdstr) const {
  */
 bool processing::is_thread_safe(char const* cmd) const {
   char const* ptr = cmd + strspn(cmd, "[]0123456789 ");
-  std::string short_cmd(ptr, strcspn(ptr, ";"));
-  std::lock_guard<std::mutex> lock(_mutex);
-  std::unordered_map<std::string, command_info>::const_iterator it =
-      _lst_command.find(short_cmd);
-  return it != _lst_command.end() && it->second.thread_safe;
+  command_info const* info{_find(ptr, strcspn(ptr, ";"))};
+  return info && info->thread_safe;
+}
+
+/**
+ *  Hash a command name, FNV-1a followed by the murmur3 finalizer so that
+ *  different seeds give independent hashes.
+ *
+ *  @param[in] name  The command name.
+ *  @param[in] len   Its length.
+ *  @param[in] seed  The seed.
+ *
+ *  @return The hash.
+ */
+uint32_t processing::_hash(char const* name,
+                           size_t len,
+                           uint32_t seed) noexcept {
+  uint32_t h = 2166136261u ^ seed;
+  for (size_t i = 0; i < len; ++i) {
+    h ^= static_cast<unsigned char>(name[i]);
+    h *= 16777619u;
+  }
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ *  Build the perfect hash table from _lst_command. The commands are spread
+ *  in buckets, then from the largest bucket to the smallest, a seed is
+ *  looked for that puts all the commands of the bucket in free slots.
+ */
+void processing::_build_table() {
+  size_t size = 1;
+  while (size < _lst_command.size() * 2)
+    size <<= 1;
+  size_t const buckets = std::max<size_t>(size / 4, 1);
+
+  std::vector<std::vector<std::pair<std::string const, command_info> const*>>
+      by_bucket(buckets);
+  for (auto const& cmd : _lst_command)
+    by_bucket[_hash(cmd.first.data(), cmd.first.size(), 0) & (buckets - 1)]
+        .push_back(&cmd);
+
+  std::vector<size_t> order(buckets);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&by_bucket](size_t a, size_t b) {
+    return by_bucket[a].size() > by_bucket[b].size();
+  });
+
+  _seeds.assign(buckets, 0);
+  _table.assign(size, command_entry());
+  std::vector<size_t> slots;
+  for (size_t b : order) {
+    if (by_bucket[b].empty())
+      break;
+    for (uint32_t seed = 1;; ++seed) {
+      if (seed == 1u << 20)
+        throw engine_error() << "cannot build the external commands table";
+      slots.clear();
+      for (auto cmd : by_bucket[b]) {
+        size_t slot = _hash(cmd->first.data(), cmd->first.size(), seed) &
+                      (size - 1);
+        if (!_table[slot].name.empty() ||
+            std::find(slots.begin(), slots.end(), slot) != slots.end())
+          break;
+        slots.push_back(slot);
+      }
+      if (slots.size() == by_bucket[b].size()) {
+        for (size_t i = 0; i < slots.size(); ++i)
+          _table[slots[i]] = {by_bucket[b][i]->first, by_bucket[b][i]->second};
+        _seeds[b] = seed;
+        break;
+      }
+    }
+  }
+}
+
+/**
+ *  Find a command.
+ *
+ *  @param[in] name  The command name, not necessarily null-terminated.
+ *  @param[in] len   Its length.
+ *
+ *  @return The command or nullptr if it is unknown.
+ */
+processing::command_info const* processing::_find(char const* name,
+                                                  size_t len) const noexcept {
+  if (_seeds.empty())
+    return nullptr;
+  uint32_t seed = _seeds[_hash(name, len, 0) & (_seeds.size() - 1)];
+  command_entry const& e = _table[_hash(name, len, seed) & (_table.size() - 1)];
+  if (e.name.size() == len && !memcmp(e.name.data(), name, len))
+    return &e.info;
+  return nullptr;
 }
 
 void processing::_wrapper_read_state_information() {
@@ -25,6 +25,7 @@
 #include <unistd.h>
 #include <atomic>
 #include <cerrno>
+#include <chrono>
 #include <csignal>
 #include <cstdio>
 #include <memory>
@@ -32,16 +33,18 @@
 #include "com/centreon/engine/common.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/modules/external_commands/commands.hh"
 #include "com/centreon/engine/modules/external_commands/internal.hh"
-#include "com/centreon/engine/string.hh"
 #include "nagios.h"
 
 using namespace com::centreon::engine;
 using namespace com::centreon::engine::logging;
+using com::centreon::engine::modules::external_commands::command_reader;
+using com::centreon::engine::modules::external_commands::gl_processor;
+using com::centreon::engine::modules::external_commands::gl_reader;
 
 static int command_file_fd = -1;
 static int command_file_created = false;
-static FILE* command_file_fp = NULL;
 
 static std::unique_ptr<std::thread> worker;
 static std::atomic_bool should_exit{false};
@@ -113,22 +116,13 @@ int open_command_file(void) {
     }
   }
 
-  /* re-open the FIFO for use with fgets() */
-  if ((command_file_fp = (FILE*)fdopen(command_file_fd, "r")) == NULL) {
-    logger(log_runtime_error, basic)
-        << "Error: Could not open external command file for "
-           "reading via fdopen(): ("
-        << errno << ") -> " << strerror(errno);
-    return ERROR;
-  }
-
   /* initialize worker thread */
   if (init_command_file_worker_thread() == ERROR) {
     logger(log_runtime_error, basic)
         << "Error: Could not initialize command file worker thread.";
 
     /* close the command file */
-    fclose(command_file_fp);
+    close(command_file_fd);
 
     /* delete the named pipe */
     unlink(config->command_file().c_str());
@@ -156,40 +150,38 @@ int close_command_file(void) {
   command_file_created = false;
 
   /* close the command file */
-  fclose(command_file_fp);
+  close(command_file_fd);
 
   return OK;
 }
 
-/* clean up resources used by command file worker thread */
-static void cleanup_command_file_worker_thread() {
-  /* release memory allocated to circular buffer */
-  for (int x = external_command_buffer.tail; x != external_command_buffer.head;
-       x = (x + 1) % config->external_command_buffer_slots()) {
-    delete[]((char**)external_command_buffer.buffer)[x];
-    ((char**)external_command_buffer.buffer)[x] = NULL;
-  }
-  delete[] external_command_buffer.buffer;
-  external_command_buffer.buffer = NULL;
+/* updates the buffer statistics after the reader queued commands */
+static void update_buffer_statistics() {
+  pthread_mutex_lock(&external_command_buffer.buffer_lock);
+  external_command_buffer.items = gl_reader->queued();
+  if (external_command_buffer.items > external_command_buffer.high)
+    external_command_buffer.high = external_command_buffer.items;
+  pthread_mutex_unlock(&external_command_buffer.buffer_lock);
 }
 
-/* worker thread - artificially increases buffer of named pipe */
+/* worker thread - reads the named pipe and queues the commands for the main
+ * loop */
 static void command_file_worker_thread() {
-  char input_buffer[MAX_EXTERNAL_COMMAND_LENGTH];
   struct pollfd pfd;
   int pollval;
-  struct timeval tv;
-  int buffer_items = 0;
+
+  /* passive check results are sent to the checker once the file is drained */
+  batch_passive_check_results(true);
 
   while (!should_exit) {
-    pthread_testcancel();
+    /* let the main loop process the queued commands, the pipe keeps the next
+     * ones */
+    if (gl_reader->full()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
 
     /* wait for data to arrive */
-    /* select seems to not work, so we have to use poll instead */
-    /* 10-15-08 EG check into implementing William's patch @
-     * http://blog.netways.de/2008/08/15/nagios-unter-mac-os-x-installieren/ */
-    /* 10-15-08 EG poll() seems broken on OSX - see Jonathan's patch a few lines
-     * down */
     pfd.fd = command_file_fd;
     pfd.events = POLLIN;
     pollval = poll(&pfd, 1, 500);
@@ -218,10 +210,6 @@ static void command_file_worker_thread() {
 
         case EINTR:
           /* this can happen when running under a debugger like gdb */
-          /*
-            write_to_log("command_file_worker_thread(): poll(): EINTR
-            (impossible)",logging_options,NULL);
-          */
           break;
 
         default:
@@ -233,78 +221,41 @@ static void command_file_worker_thread() {
       continue;
     }
 
-    /* get number of items in the buffer */
-    pthread_mutex_lock(&external_command_buffer.buffer_lock);
-    buffer_items = external_command_buffer.items;
-    pthread_mutex_unlock(&external_command_buffer.buffer_lock);
-
-    /* 10-15-08 Fix for OS X by Jonathan Saggau - see
-     * http://www.jonathansaggau.com/blog/2008/09/using_shark_and_custom_dtrace.html
-     */
-    /* Not sure if this would have negative effects on other OSes... */
-    if (buffer_items == 0) {
-      /* pause a bit so OS X doesn't go nuts with CPU overload */
-      tv.tv_sec = 0;
-      tv.tv_usec = 500;
-      select(0, nullptr, nullptr, nullptr, &tv);
-    }
-
-    /* process all commands in the file (named pipe) if there's some space in
-     * the buffer */
-    if (buffer_items < config->external_command_buffer_slots()) {
-      /* clear EOF condition from prior run (FreeBSD fix) */
-      /* FIXME: use_poll_on_cmd_pipe: Still needed? */
-      clearerr(command_file_fp);
-
-      /* read and process the next command in the file */
-      while (!should_exit &&
-             fgets(input_buffer, (int)(sizeof(input_buffer) - 1),
-                   command_file_fp) != nullptr) {
-        // Check if command is thread-safe (for immediate execution).
-        if (modules::external_commands::gl_processor.is_thread_safe(
-                input_buffer))
-          modules::external_commands::gl_processor.execute(input_buffer);
-        // Submit the external command for processing
-        // (retry if buffer is full).
-        else {
-          while (!should_exit &&
-                 submit_external_command(input_buffer, &buffer_items) ==
-                     ERROR &&
-                 buffer_items == config->external_command_buffer_slots()) {
-            // Wait a bit.
-            tv.tv_sec = 0;
-            tv.tv_usec = 250000;
-            select(0, nullptr, nullptr, nullptr, &tv);
-          }
-
-          // Bail if the circular buffer is full.
-          if (buffer_items == config->external_command_buffer_slots())
-            break;
-        }
-      }
+    /* read all the commands in the file (named pipe), thread-safe commands
+     * are executed at once by the reader */
+    if (gl_reader->read()) {
+      flush_passive_check_results();
+      update_buffer_statistics();
     }
   }
 
-  cleanup_command_file_worker_thread();
+  batch_passive_check_results(false);
 }
 
 /* initializes command file worker thread */
 int init_command_file_worker_thread(void) {
-  /* initialize circular buffer */
+  /* initialize buffer statistics, commands are queued by the reader */
   external_command_buffer.head = 0;
   external_command_buffer.tail = 0;
   external_command_buffer.items = 0;
   external_command_buffer.high = 0;
   external_command_buffer.overflow = 0L;
-  external_command_buffer.buffer =
-      new void*[config->external_command_buffer_slots()];
-  if (external_command_buffer.buffer == NULL)
-    return ERROR;
+  external_command_buffer.buffer = NULL;
 
   /* initialize mutex (only on cold startup) */
   if (!sigrestart)
     pthread_mutex_init(&external_command_buffer.buffer_lock, NULL);
 
+  gl_reader.reset(new command_reader(
+      command_file_fd, config->external_command_buffer_slots(),
+      [](char* cmd, size_t len) {
+        // Check if command is thread-safe (for immediate execution).
+        if (!gl_processor.is_thread_safe(cmd))
+          return false;
+        gl_processor.execute(cmd, len);
+        return true;
+      }));
+
   /* create worker thread */
   worker = std::make_unique<std::thread>(&command_file_worker_thread);
 
@@ -319,6 +270,9 @@ int shutdown_command_file_worker_thread(void) {
 
     /* wait for the worker thread to exit */
     worker->join();
+
+    /* commands still queued are lost */
+    gl_reader.reset();
   }
 
   return OK;
@@ -326,39 +280,17 @@ int shutdown_command_file_worker_thread(void) {
 
 /* submits an external command for processing */
 int submit_external_command(char const* cmd, int* buffer_items) {
-  int result = OK;
-
-  if (cmd == NULL || external_command_buffer.buffer == NULL) {
+  if (cmd == NULL || !gl_reader) {
     if (buffer_items != NULL)
       *buffer_items = -1;
     return ERROR;
   }
 
-  /* obtain a lock for writing to the buffer */
-  pthread_mutex_lock(&external_command_buffer.buffer_lock);
-
-  if (external_command_buffer.items < config->external_command_buffer_slots()) {
-    /* save the line in the buffer */
-    ((char**)external_command_buffer.buffer)[external_command_buffer.head] =
-        string::dup(cmd);
-
-    /* increment the head counter and items */
-    external_command_buffer.head = (external_command_buffer.head + 1) %
-                                   config->external_command_buffer_slots();
-    external_command_buffer.items++;
-    if (external_command_buffer.items > external_command_buffer.high)
-      external_command_buffer.high = external_command_buffer.items;
-  }
-  /* buffer was full */
-  else
-    result = ERROR;
+  int result = gl_reader->submit(cmd) ? OK : ERROR;
 
   /* return number of items now in buffer */
   if (buffer_items != NULL)
-    *buffer_items = external_command_buffer.items;
-
-  /* release lock on buffer */
-  pthread_mutex_unlock(&external_command_buffer.buffer_lock);
+    *buffer_items = gl_reader->queued();
 
   return result;
 }
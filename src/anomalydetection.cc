@@ -20,6 +20,7 @@
 #include "com/centreon/engine/anomalydetection.hh"
 
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <limits>
 
@@ -33,7 +34,6 @@
 #include "com/centreon/engine/macros/grab_host.hh"
 #include "com/centreon/engine/macros/grab_service.hh"
 #include "com/centreon/engine/neberrors.hh"
-#include "com/centreon/engine/string.hh"
 #include "com/centreon/exceptions/interruption.hh"
 
 using namespace com::centreon::engine;
@@ -551,6 +551,7 @@ int anomalydetection::run_async_check(int check_options,
 
   // Set the execution flag.
   set_is_executing(true);
+  update_orphan_deadline();
 
   std::ostringstream oss;
   oss << "Anomaly detection on metric '" << _metric_name << "', from service '"
@@ -577,17 +578,34 @@ int anomalydetection::run_async_check(int check_options,
                                      : ACTIVE_ONDEMAND_SERVICE_CHECK_STATS,
                      start_time.tv_sec);
 
-  std::string perfdata = string::extract_perfdata(
-      _dependent_service->get_perf_data(), _metric_name);
-
-  std::string without_thresholds(string::remove_thresholds(perfdata));
+  perfdata::metric const* metric(perfdata::find(
+      perfdata::parse(_dependent_service->get_perf_data()), _metric_name));
   std::tuple<service::service_state, double, std::string, double, double> pd =
-      parse_perfdata(without_thresholds, start_time.tv_sec);
-  size_t pos = without_thresholds.find(';');
-  if (pos != std::string::npos)
-    without_thresholds = without_thresholds.substr(pos);
-  else
-    without_thresholds = "";
+      parse_perfdata(metric, start_time.tv_sec);
+
+  /* The metric is copied without its warning and critical thresholds, as
+   * string::remove_thresholds() did: the status of the anomaly detection does
+   * not come from them, the forecasting range is given instead by the
+   * thresholds metrics. Its min and max are kept and also given to the
+   * thresholds metrics. */
+  std::string perfdata;
+  std::string without_thresholds;
+  if (metric) {
+    perfdata.assign(metric->text, metric->text_size);
+    if (!std::isnan(metric->min) || !std::isnan(metric->max)) {
+      char buffer[64];
+      without_thresholds = ";;;";
+      if (!std::isnan(metric->min)) {
+        snprintf(buffer, sizeof(buffer), "%.15g", metric->min);
+        without_thresholds.append(buffer);
+      }
+      if (!std::isnan(metric->max)) {
+        snprintf(buffer, sizeof(buffer), ";%.15g", metric->max);
+        without_thresholds.append(buffer);
+      }
+    }
+    perfdata.append(without_thresholds);
+  }
 
   // Init check result info.
   std::unique_ptr<check_result> check_result_info(
@@ -654,37 +672,31 @@ commands::command* anomalydetection::get_check_command_ptr() const {
 }
 
 /**
- * @brief Parse the given perfdata. The only metric parsed is the one whose name
- * is _metric_name.
+ * @brief Get the status of the metric from the thresholds.
  *
- * @param perfdata A string containing perfdata.
+ * @param metric The metric whose name is _metric_name in the perfdata of the
+ * dependent service, nullptr if there is none.
+ * @param check_time The time of the check.
  *
  * @return A tuple containing the status, the value, its unit, the lower bound
  * and the upper bound
  */
 std::tuple<service::service_state, double, std::string, double, double>
-anomalydetection::parse_perfdata(std::string const& perfdata,
+anomalydetection::parse_perfdata(perfdata::metric const* metric,
                                  time_t check_time) {
   std::lock_guard<std::mutex> lock(_thresholds_m);
-  size_t pos = perfdata.find_last_of("=");
   /* If the perfdata is wrong. */
-  if (pos == std::string::npos) {
+  if (!metric) {
     logger(log_runtime_error, basic)
-        << "Error: Unable to parse perfdata '" << perfdata << "'";
+        << "Error: Unable to parse perfdata '"
+        << _dependent_service->get_perf_data() << "' to get the metric '"
+        << _metric_name << "'";
     return std::make_tuple(service::state_unknown, NAN, "", NAN, NAN);
   }
 
   /* If the perfdata is good. */
-  pos++;
-  char* unit;
-
-  double value = std::strtod(perfdata.c_str() + pos, &unit);
-  char const* end = perfdata.c_str() + perfdata.size() - 1;
-  size_t l = 0;
-  /* If there is a unit, it starts at unit char* */
-  while (unit + l <= end && unit[l] != ' ' && unit[l] != ';')
-    ++l;
-  std::string uom = std::string(unit, l);
+  double value = metric->value;
+  std::string uom(metric->uom);
 
   service::service_state status;
 
@@ -694,7 +706,7 @@ anomalydetection::parse_perfdata(std::string const& perfdata,
       logger(log_info_message, basic) << "The thresholds file is not viable "
                                          "(not available or not readable).";
     }
-    return std::make_tuple(status, value, unit, NAN, NAN);
+    return std::make_tuple(status, value, uom, NAN, NAN);
   }
 
   /* The check time is probably between two timestamps stored in _thresholds.
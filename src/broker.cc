@@ -27,6 +27,7 @@
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/nebmods.hh"
 #include "com/centreon/engine/nebstructs.hh"
+#include "com/centreon/engine/perfdata.hh"
 #include "com/centreon/engine/sehandlers.hh"
 #include "com/centreon/engine/string.hh"
 
@@ -62,6 +63,8 @@ void broker_acknowledgement_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_ACKNOWLEDGEMENT_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_ACKNOWLEDGEMENT_DATA))
+    return;
 
   // Fill struct with relevant data.
   host* temp_host(NULL);
@@ -125,6 +128,8 @@ void broker_adaptive_contact_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_ADAPTIVE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_ADAPTIVE_CONTACT_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_adaptive_contact_data ds;
@@ -162,6 +167,8 @@ void broker_adaptive_dependency_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_ADAPTIVE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_ADAPTIVE_DEPENDENCY_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_adaptive_dependency_data ds;
@@ -192,6 +199,8 @@ void broker_adaptive_escalation_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_ADAPTIVE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_ADAPTIVE_ESCALATION_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_adaptive_escalation_data ds;
@@ -228,6 +237,8 @@ void broker_adaptive_host_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_ADAPTIVE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_ADAPTIVE_HOST_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_adaptive_host_data ds;
@@ -269,6 +280,8 @@ void broker_adaptive_program_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_ADAPTIVE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_ADAPTIVE_PROGRAM_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_adaptive_program_data ds;
@@ -309,6 +322,8 @@ void broker_adaptive_service_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_ADAPTIVE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_ADAPTIVE_SERVICE_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_adaptive_service_data ds;
@@ -344,6 +359,8 @@ void broker_adaptive_timeperiod_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_ADAPTIVE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_ADAPTIVE_TIMEPERIOD_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_adaptive_timeperiod_data ds;
@@ -373,6 +390,8 @@ void broker_aggregated_status_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_STATUS_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_AGGREGATED_STATUS_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_aggregated_status_data ds;
@@ -403,6 +422,8 @@ void broker_command_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_COMMAND_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_COMMAND_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_command_data ds;
@@ -454,6 +475,8 @@ void broker_comment_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_COMMENT_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_COMMENT_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_comment_data ds;
@@ -512,6 +535,8 @@ int broker_contact_notification_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_NOTIFICATIONS))
     return OK;
+  if (!neb_has_callbacks(NEBCALLBACK_CONTACT_NOTIFICATION_DATA))
+    return OK;
 
   // Fill struct with relevant data.
   nebstruct_contact_notification_data ds;
@@ -587,6 +612,8 @@ int broker_contact_notification_method_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_NOTIFICATIONS))
     return OK;
+  if (!neb_has_callbacks(NEBCALLBACK_CONTACT_NOTIFICATION_METHOD_DATA))
+    return OK;
 
   // Get command name/args.
   char* command_buf(NULL);
@@ -661,6 +688,8 @@ void broker_contact_status(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_STATUS_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_CONTACT_STATUS_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_service_status_data ds;
@@ -695,6 +724,8 @@ void broker_custom_variable(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_CUSTOMVARIABLE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_CUSTOM_VARIABLE_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_custom_variable_data ds;
@@ -750,6 +781,8 @@ void broker_downtime_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_DOWNTIME_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_DOWNTIME_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_downtime_data ds;
@@ -820,6 +853,8 @@ int broker_event_handler(int type,
     return OK;
   if (!data)
     return ERROR;
+  if (!neb_has_callbacks(NEBCALLBACK_EVENT_HANDLER_DATA))
+    return OK;
 
   // Get command name/args.
   char* command_buf(NULL);
@@ -897,6 +932,8 @@ void broker_external_command(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_EXTERNALCOMMAND_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_EXTERNAL_COMMAND_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_external_command_data ds;
@@ -939,6 +976,8 @@ void broker_flapping_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_FLAPPING_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_FLAPPING_DATA))
+    return;
   if (!data)
     return;
 
@@ -988,6 +1027,8 @@ void broker_group(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_GROUP_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_GROUP_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_group_data ds;
@@ -1021,6 +1062,8 @@ void broker_group_member(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_GROUP_MEMBER_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_GROUP_MEMBER_DATA))
+    return;
 
   // Fill struct will relevant data.
   nebstruct_group_member_data ds;
@@ -1087,6 +1130,8 @@ int broker_host_check(int type,
     return OK;
   if (!hst)
     return ERROR;
+  if (!neb_has_callbacks(NEBCALLBACK_HOST_CHECK_DATA))
+    return OK;
 
   // Get command name/args.
   char* command_buf(NULL);
@@ -1151,6 +1196,8 @@ void broker_host_status(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_STATUS_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_HOST_STATUS_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_host_status_data ds;
@@ -1185,6 +1232,8 @@ void broker_log_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_LOGGED_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_LOG_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_log_data ds;
@@ -1219,6 +1268,8 @@ void broker_module_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_MODULE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_MODULE_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_module_data ds;
@@ -1272,6 +1323,8 @@ int broker_notification_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_NOTIFICATIONS))
     return OK;
+  if (!neb_has_callbacks(NEBCALLBACK_NOTIFICATION_DATA))
+    return OK;
 
   // Fill struct with relevant data.
   nebstruct_notification_data ds;
@@ -1309,6 +1362,62 @@ int broker_notification_data(int type,
   return (neb_make_callbacks(NEBCALLBACK_NOTIFICATION_DATA, &ds));
 }
 
+/**
+ *  Sends the metrics of a check result to broker. The perfdata are only
+ *  parsed if a module listens to them.
+ *
+ *  @param[in] type      Type.
+ *  @param[in] flags     Flags.
+ *  @param[in] attr      Attributes.
+ *  @param[in] hst       Host checked, nullptr for a service.
+ *  @param[in] svc       Service checked, nullptr for a host.
+ *  @param[in] timestamp Timestamp.
+ */
+void broker_perfdata(int type,
+                     int flags,
+                     int attr,
+                     host* hst,
+                     com::centreon::engine::service* svc,
+                     struct timeval const* timestamp) {
+  // Config check.
+  if (!(config->event_broker_options() &
+        (svc ? BROKER_SERVICE_CHECKS : BROKER_HOST_CHECKS)))
+    return;
+  if (!neb_has_callbacks(NEBCALLBACK_PERFDATA_DATA))
+    return;
+  std::string const& pd(svc ? svc->get_perf_data() : hst->get_perf_data());
+  if (pd.empty())
+    return;
+  std::vector<perfdata::metric> const& metrics(perfdata::parse(pd));
+  if (metrics.empty())
+    return;
+
+  // Fill struct with relevant data.
+  nebstruct_perfdata_data ds;
+  ds.type = type;
+  ds.flags = flags;
+  ds.attr = attr;
+  ds.timestamp = get_broker_timestamp(timestamp);
+  if (svc) {
+    ds.host_id = svc->get_host_id();
+    ds.service_id = svc->get_service_id();
+    ds.host_name = svc->get_hostname().c_str();
+    ds.service_description = svc->get_description().c_str();
+    ds.object_ptr = svc;
+  } else {
+    ds.host_id = hst->get_host_id();
+    ds.service_id = 0;
+    ds.host_name = hst->get_name().c_str();
+    ds.service_description = nullptr;
+    ds.object_ptr = hst;
+  }
+  ds.size = metrics.size();
+  ds.metrics = metrics.data();
+
+  // Make callbacks.
+  neb_make_callbacks(NEBCALLBACK_PERFDATA_DATA, &ds);
+}
+
 /**
  *  Sends program data (starts, restarts, stops, etc.) to broker.
  *
@@ -1324,6 +1433,8 @@ void broker_program_state(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_PROGRAM_STATE))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_PROCESS_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_process_data ds;
@@ -1351,6 +1462,8 @@ void broker_program_status(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_STATUS_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_PROGRAM_STATUS_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_program_status_data ds;
@@ -1412,6 +1525,8 @@ void broker_relation_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_RELATION_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_RELATION_DATA))
+    return;
   if (!hst || !dep_hst)
     return;
 
@@ -1445,6 +1560,8 @@ void broker_retention_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_RETENTION_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_RETENTION_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_retention_data ds;
@@ -1498,6 +1615,8 @@ int broker_service_check(int type,
     return OK;
   if (!svc)
     return ERROR;
+  if (!neb_has_callbacks(NEBCALLBACK_SERVICE_CHECK_DATA))
+    return OK;
 
   // Get command name/args.
   char* command_buf(NULL);
@@ -1563,6 +1682,8 @@ void broker_service_status(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_STATUS_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_SERVICE_STATUS_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_service_status_data ds;
@@ -1603,6 +1724,8 @@ void broker_statechange_data(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_STATECHANGE_DATA))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_STATE_CHANGE_DATA))
+    return;
 
   // Fill struct with relevant data.
   nebstruct_statechange_data ds;
@@ -1666,6 +1789,8 @@ void broker_system_command(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_SYSTEM_COMMANDS))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_SYSTEM_COMMAND_DATA))
+    return;
   if (!cmd)
     return;
 
@@ -1705,6 +1830,8 @@ void broker_timed_event(int type,
   // Config check.
   if (!(config->event_broker_options() & BROKER_TIMED_EVENTS))
     return;
+  if (!neb_has_callbacks(NEBCALLBACK_TIMED_EVENT_DATA))
+    return;
   if (!event)
     return;
 
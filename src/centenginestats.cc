@@ -18,6 +18,9 @@
 ** <http://www.gnu.org/licenses/>.
 */
 
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
@@ -31,6 +34,7 @@
 #include "com/centreon/engine/common.hh"
 #include "com/centreon/engine/notifier.hh"
 #include "com/centreon/engine/objects.hh"
+#include "com/centreon/engine/stats_segment.hh"
 #include "com/centreon/engine/string.hh"
 #include "com/centreon/engine/version.hh"
 #include "com/centreon/exceptions/basic.hh"
@@ -47,6 +51,7 @@ using namespace com::centreon::engine;
 static char* main_config_file(NULL);
 static char* stats_file(NULL);
 static char* status_file(NULL);
+static std::string segment_file;
 
 time_t status_creation_date = 0L;
 char* status_version = NULL;
@@ -196,6 +201,14 @@ int external_commands_last_1min = 0;
 int external_commands_last_5min = 0;
 int external_commands_last_15min = 0;
 
+/* 50th, 95th and 99th percentiles, over the last minutes. */
+double active_service_latency_percentiles[3] = {0.0, 0.0, 0.0};
+double active_service_execution_time_percentiles[3] = {0.0, 0.0, 0.0};
+double passive_service_latency_percentiles[3] = {0.0, 0.0, 0.0};
+double active_host_latency_percentiles[3] = {0.0, 0.0, 0.0};
+double active_host_execution_time_percentiles[3] = {0.0, 0.0, 0.0};
+double passive_host_latency_percentiles[3] = {0.0, 0.0, 0.0};
+
 int total_external_command_buffer_slots = 0;
 int used_external_command_buffer_slots = 0;
 int high_external_command_buffer_slots = 0;
@@ -206,6 +219,8 @@ void get_time_breakdown(unsigned long, int*, int*, int*, int*);
 int read_config_file();
 int read_stats_file();
 int read_status_file();
+int read_stats_segment();
+bool read_percentiles(char const* var, char* val);
 void strip(char*);
 
 /**
@@ -224,6 +239,7 @@ int main(int argc, char* argv[]) {
       {"license", no_argument, 0, 'L'},
       {"config", required_argument, 0, 'c'},
       {"statsfile", required_argument, 0, 's'},
+      {"legacy", no_argument, 0, 'l'},
       {0, 0, 0, 0}};
 #endif  // HAVE_GETOPT_H
 
@@ -238,15 +254,16 @@ int main(int argc, char* argv[]) {
     bool display_help(false);
     bool display_license(false);
     bool error(false);
+    bool legacy(false);
 
     // Get all command line arguments.
     int c;
     while (!error) {
       // Get next flag.
 #ifdef HAVE_GETOPT_H
-      c = getopt_long(argc, argv, "+hVLc:s:", long_options, NULL);
+      c = getopt_long(argc, argv, "+hVLlc:s:", long_options, NULL);
 #else
-      c = getopt(argc, argv, "+hVLc:s:");
+      c = getopt(argc, argv, "+hVLlc:s:");
 #endif  // getopt_long() or getopt()
       if (c == -1)
         break;
@@ -270,6 +287,9 @@ int main(int argc, char* argv[]) {
           stats_file = NULL;
           stats_file = string::dup(optarg);
           break;
+        case 'l':
+          legacy = true;
+          break;
         default:
           error = true;
       }
@@ -319,6 +339,9 @@ int main(int argc, char* argv[]) {
           << "  -s, --statsfile=FILE specifies alternate location of file to "
              "read Centreon\n"
           << "                       Engine performance data from.\n"
+          << "  -l, --legacy         read the status file even if the engine "
+             "publishes its\n"
+          << "                       statistics in memory.\n"
           << std::endl;
       retval = (error ? EXIT_FAILURE : EXIT_SUCCESS);
     }
@@ -339,8 +362,9 @@ int main(int argc, char* argv[]) {
           throw(basic_error()
                 << "Error processing config file '" << main_config_file);
 
-        // Read status file.
-        if (read_status_file() == ERROR) {
+        // Read statistics published by the engine, else the status file.
+        if ((legacy || read_stats_segment() == ERROR) &&
+            read_status_file() == ERROR) {
           char const* msg(strerror(errno));
           throw(basic_error() << "Error reading status file '" << status_file
                               << "': " << msg);
@@ -383,7 +407,9 @@ int display_stats() {
   printf("CURRENT STATUS DATA\n");
   printf("------------------------------------------------------\n");
   printf("Status File:                            %s\n",
-         (stats_file != NULL) ? stats_file : status_file);
+         (stats_file != NULL) ? stats_file
+                              : (!segment_file.empty() ? segment_file.c_str()
+                                                       : status_file));
   time_difference = (current_time - status_creation_date);
   get_time_breakdown(time_difference, &days, &hours, &minutes, &seconds);
   printf("Status File Age:                        %dd %dh %dm %ds\n", days,
@@ -415,6 +441,14 @@ int display_stats() {
   printf("Active Service Execution Time:          %.3f / %.3f / %.3f sec\n",
          min_active_service_execution_time, max_active_service_execution_time,
          average_active_service_execution_time);
+  printf("Active Service Latency p50/95/99:       %.3f / %.3f / %.3f sec\n",
+         active_service_latency_percentiles[0],
+         active_service_latency_percentiles[1],
+         active_service_latency_percentiles[2]);
+  printf("Active Service Exec Time p50/95/99:     %.3f / %.3f / %.3f sec\n",
+         active_service_execution_time_percentiles[0],
+         active_service_execution_time_percentiles[1],
+         active_service_execution_time_percentiles[2]);
   printf("Active Service State Change:            %.3f / %.3f / %.3f %%\n",
          min_active_service_state_change, max_active_service_state_change,
          average_active_service_state_change);
@@ -425,6 +459,10 @@ int display_stats() {
   printf("Passive Service Latency:                %.3f / %.3f / %.3f sec\n",
          min_passive_service_latency, max_passive_service_latency,
          average_passive_service_latency);
+  printf("Passive Service Latency p50/95/99:      %.3f / %.3f / %.3f sec\n",
+         passive_service_latency_percentiles[0],
+         passive_service_latency_percentiles[1],
+         passive_service_latency_percentiles[2]);
   printf("Passive Service State Change:           %.3f / %.3f / %.3f %%\n",
          min_passive_service_state_change, max_passive_service_state_change,
          average_passive_service_state_change);
@@ -451,6 +489,14 @@ int display_stats() {
   printf("Active Host Execution Time:             %.3f / %.3f / %.3f sec\n",
          min_active_host_execution_time, max_active_host_execution_time,
          average_active_host_execution_time);
+  printf("Active Host Latency p50/95/99:          %.3f / %.3f / %.3f sec\n",
+         active_host_latency_percentiles[0],
+         active_host_latency_percentiles[1],
+         active_host_latency_percentiles[2]);
+  printf("Active Host Exec Time p50/95/99:        %.3f / %.3f / %.3f sec\n",
+         active_host_execution_time_percentiles[0],
+         active_host_execution_time_percentiles[1],
+         active_host_execution_time_percentiles[2]);
   printf("Active Host State Change:               %.3f / %.3f / %.3f %%\n",
          min_active_host_state_change, max_active_host_state_change,
          average_active_host_state_change);
@@ -460,6 +506,10 @@ int display_stats() {
   printf("Passive Host Latency:                   %.3f / %.3f / %.3f sec\n",
          min_passive_host_latency, max_passive_host_latency,
          average_passive_host_latency);
+  printf("Passive Host Latency p50/95/99:         %.3f / %.3f / %.3f sec\n",
+         passive_host_latency_percentiles[0],
+         passive_host_latency_percentiles[1],
+         passive_host_latency_percentiles[2]);
   printf("Passive Host State Change:              %.3f / %.3f / %.3f %%\n",
          min_passive_host_state_change, max_passive_host_state_change,
          average_passive_host_state_change);
@@ -570,6 +620,196 @@ int read_config_file() {
   return (OK);
 }
 
+/* read the statistics published by a running engine in its memory mapped
+ * segment, returns ERROR if they are not available */
+int read_stats_segment() {
+  std::string path(stats_segment::path(status_file));
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return (ERROR);
+  void* addr = mmap(NULL, sizeof(stats_segment), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED)
+    return (ERROR);
+
+  stats_segment::payload p;
+  bool ok(static_cast<stats_segment const*>(addr)->read(p));
+  munmap(addr, sizeof(stats_segment));
+
+  /* the segment of a dead engine is as outdated as its status file */
+  if (!ok || (kill(p.pid, 0) && errno != EPERM))
+    return (ERROR);
+
+  segment_file = path;
+  p.version[sizeof(p.version) - 1] = '\0';
+  delete[] status_version;
+  status_version = string::dup(p.version);
+  status_creation_date = p.updated;
+  program_start = p.program_start;
+  nagios_pid = p.pid;
+  total_external_command_buffer_slots = p.total_external_command_buffer_slots;
+  used_external_command_buffer_slots = p.used_external_command_buffer_slots;
+  high_external_command_buffer_slots = p.high_external_command_buffer_slots;
+
+  /* checks counters */
+  struct {
+    int type;
+    int* last[3];
+  } const counters[] = {
+      {ACTIVE_SCHEDULED_SERVICE_CHECK_STATS,
+       {&active_scheduled_service_checks_last_1min,
+        &active_scheduled_service_checks_last_5min,
+        &active_scheduled_service_checks_last_15min}},
+      {ACTIVE_ONDEMAND_SERVICE_CHECK_STATS,
+       {&active_ondemand_service_checks_last_1min,
+        &active_ondemand_service_checks_last_5min,
+        &active_ondemand_service_checks_last_15min}},
+      {PASSIVE_SERVICE_CHECK_STATS,
+       {&passive_service_checks_last_1min, &passive_service_checks_last_5min,
+        &passive_service_checks_last_15min}},
+      {ACTIVE_SCHEDULED_HOST_CHECK_STATS,
+       {&active_scheduled_host_checks_last_1min,
+        &active_scheduled_host_checks_last_5min,
+        &active_scheduled_host_checks_last_15min}},
+      {ACTIVE_ONDEMAND_HOST_CHECK_STATS,
+       {&active_ondemand_host_checks_last_1min,
+        &active_ondemand_host_checks_last_5min,
+        &active_ondemand_host_checks_last_15min}},
+      {PASSIVE_HOST_CHECK_STATS,
+       {&passive_host_checks_last_1min, &passive_host_checks_last_5min,
+        &passive_host_checks_last_15min}},
+      {ACTIVE_CACHED_HOST_CHECK_STATS,
+       {&active_cached_host_checks_last_1min,
+        &active_cached_host_checks_last_5min,
+        &active_cached_host_checks_last_15min}},
+      {ACTIVE_CACHED_SERVICE_CHECK_STATS,
+       {&active_cached_service_checks_last_1min,
+        &active_cached_service_checks_last_5min,
+        &active_cached_service_checks_last_15min}},
+      {EXTERNAL_COMMAND_STATS,
+       {&external_commands_last_1min, &external_commands_last_5min,
+        &external_commands_last_15min}},
+      {PARALLEL_HOST_CHECK_STATS,
+       {&parallel_host_checks_last_1min, &parallel_host_checks_last_5min,
+        &parallel_host_checks_last_15min}},
+      {SERIAL_HOST_CHECK_STATS,
+       {&serial_host_checks_last_1min, &serial_host_checks_last_5min,
+        &serial_host_checks_last_15min}}};
+  for (unsigned int i(0); i < sizeof(counters) / sizeof(*counters); ++i)
+    for (unsigned int j(0); j < 3; ++j)
+      *counters[i].last[j] = p.check_stats[counters[i].type][j];
+
+  /* 02-15-2008 exclude cached checks from total (they were ondemand checks
+   * that never actually executed) */
+  active_host_checks_last_1min = active_scheduled_host_checks_last_1min +
+                                 active_ondemand_host_checks_last_1min;
+  active_host_checks_last_5min = active_scheduled_host_checks_last_5min +
+                                 active_ondemand_host_checks_last_5min;
+  active_host_checks_last_15min = active_scheduled_host_checks_last_15min +
+                                  active_ondemand_host_checks_last_15min;
+  active_service_checks_last_1min = active_scheduled_service_checks_last_1min +
+                                    active_ondemand_service_checks_last_1min;
+  active_service_checks_last_5min = active_scheduled_service_checks_last_5min +
+                                    active_ondemand_service_checks_last_5min;
+  active_service_checks_last_15min =
+      active_scheduled_service_checks_last_15min +
+      active_ondemand_service_checks_last_15min;
+
+  /* services */
+  stats_segment::objects_stats const& svc(p.services);
+  status_service_entries = svc.count;
+  services_checked = svc.checked;
+  services_scheduled = svc.scheduled;
+  active_service_checks = svc.actively_checked;
+  passive_service_checks = svc.passively_checked;
+  min_service_state_change = svc.min_state_change;
+  max_service_state_change = svc.max_state_change;
+  average_service_state_change = svc.average_state_change;
+  min_active_service_latency = svc.active.min_latency;
+  max_active_service_latency = svc.active.max_latency;
+  average_active_service_latency = svc.active.average_latency;
+  min_active_service_execution_time = svc.active.min_execution_time;
+  max_active_service_execution_time = svc.active.max_execution_time;
+  average_active_service_execution_time = svc.active.average_execution_time;
+  min_active_service_state_change = svc.active.min_state_change;
+  max_active_service_state_change = svc.active.max_state_change;
+  average_active_service_state_change = svc.active.average_state_change;
+  active_services_checked_last_1min = svc.active.checks_last[0];
+  active_services_checked_last_5min = svc.active.checks_last[1];
+  active_services_checked_last_15min = svc.active.checks_last[2];
+  active_services_checked_last_1hour = svc.active.checks_last[3];
+  min_passive_service_latency = svc.passive.min_latency;
+  max_passive_service_latency = svc.passive.max_latency;
+  average_passive_service_latency = svc.passive.average_latency;
+  min_passive_service_state_change = svc.passive.min_state_change;
+  max_passive_service_state_change = svc.passive.max_state_change;
+  average_passive_service_state_change = svc.passive.average_state_change;
+  passive_services_checked_last_1min = svc.passive.checks_last[0];
+  passive_services_checked_last_5min = svc.passive.checks_last[1];
+  passive_services_checked_last_15min = svc.passive.checks_last[2];
+  passive_services_checked_last_1hour = svc.passive.checks_last[3];
+  services_ok = svc.states[0];
+  services_warning = svc.states[1];
+  services_critical = svc.states[2];
+  services_unknown = svc.states[3];
+  services_flapping = svc.flapping;
+  services_in_downtime = svc.downtime;
+  for (unsigned int i(0); i < 3; ++i) {
+    active_service_latency_percentiles[i] = svc.active.latency_percentiles[i];
+    active_service_execution_time_percentiles[i] =
+        svc.active.execution_time_percentiles[i];
+    passive_service_latency_percentiles[i] =
+        svc.passive.latency_percentiles[i];
+  }
+
+  /* hosts */
+  stats_segment::objects_stats const& hst(p.hosts);
+  status_host_entries = hst.count;
+  hosts_checked = hst.checked;
+  hosts_scheduled = hst.scheduled;
+  active_host_checks = hst.actively_checked;
+  passive_host_checks = hst.passively_checked;
+  min_host_state_change = hst.min_state_change;
+  max_host_state_change = hst.max_state_change;
+  average_host_state_change = hst.average_state_change;
+  min_active_host_latency = hst.active.min_latency;
+  max_active_host_latency = hst.active.max_latency;
+  average_active_host_latency = hst.active.average_latency;
+  min_active_host_execution_time = hst.active.min_execution_time;
+  max_active_host_execution_time = hst.active.max_execution_time;
+  average_active_host_execution_time = hst.active.average_execution_time;
+  min_active_host_state_change = hst.active.min_state_change;
+  max_active_host_state_change = hst.active.max_state_change;
+  average_active_host_state_change = hst.active.average_state_change;
+  active_hosts_checked_last_1min = hst.active.checks_last[0];
+  active_hosts_checked_last_5min = hst.active.checks_last[1];
+  active_hosts_checked_last_15min = hst.active.checks_last[2];
+  active_hosts_checked_last_1hour = hst.active.checks_last[3];
+  min_passive_host_latency = hst.passive.min_latency;
+  max_passive_host_latency = hst.passive.max_latency;
+  average_passive_host_latency = hst.passive.average_latency;
+  min_passive_host_state_change = hst.passive.min_state_change;
+  max_passive_host_state_change = hst.passive.max_state_change;
+  average_passive_host_state_change = hst.passive.average_state_change;
+  passive_hosts_checked_last_1min = hst.passive.checks_last[0];
+  passive_hosts_checked_last_5min = hst.passive.checks_last[1];
+  passive_hosts_checked_last_15min = hst.passive.checks_last[2];
+  passive_hosts_checked_last_1hour = hst.passive.checks_last[3];
+  hosts_up = hst.states[0];
+  hosts_down = hst.states[1];
+  hosts_unreachable = hst.states[2];
+  hosts_flapping = hst.flapping;
+  hosts_in_downtime = hst.downtime;
+  for (unsigned int i(0); i < 3; ++i) {
+    active_host_latency_percentiles[i] = hst.active.latency_percentiles[i];
+    active_host_execution_time_percentiles[i] =
+        hst.active.execution_time_percentiles[i];
+    passive_host_latency_percentiles[i] = hst.passive.latency_percentiles[i];
+  }
+
+  return (OK);
+}
+
 int read_status_file() {
   char temp_buffer[MAX_INPUT_BUFFER];
   FILE* fp = NULL;
@@ -1050,7 +1290,8 @@ int read_status_file() {
               serial_host_checks_last_5min = atoi(temp_ptr);
             if ((temp_ptr = strtok(NULL, ",")))
               serial_host_checks_last_15min = atoi(temp_ptr);
-          }
+          } else
+            read_percentiles(var, val);
           break;
 
         case STATUS_HOST_DATA:
@@ -1425,6 +1666,35 @@ int read_stats_file() {
   return (OK);
 }
 
+/* read the 50th/95th/99th percentiles status variables, returns false if var
+ * is not one of them */
+bool read_percentiles(char const* var, char* val) {
+  double* percentiles;
+  char* temp_ptr;
+
+  if (!strcmp(var, "active_service_latency_percentiles"))
+    percentiles = active_service_latency_percentiles;
+  else if (!strcmp(var, "active_service_execution_time_percentiles"))
+    percentiles = active_service_execution_time_percentiles;
+  else if (!strcmp(var, "passive_service_latency_percentiles"))
+    percentiles = passive_service_latency_percentiles;
+  else if (!strcmp(var, "active_host_latency_percentiles"))
+    percentiles = active_host_latency_percentiles;
+  else if (!strcmp(var, "active_host_execution_time_percentiles"))
+    percentiles = active_host_execution_time_percentiles;
+  else if (!strcmp(var, "passive_host_latency_percentiles"))
+    percentiles = passive_host_latency_percentiles;
+  else
+    return false;
+
+  temp_ptr = strtok(val, ",");
+  for (int i = 0; i < 3 && temp_ptr; ++i) {
+    percentiles[i] = strtod(temp_ptr, NULL);
+    temp_ptr = strtok(NULL, ",");
+  }
+  return true;
+}
+
 /* strip newline, carriage return, and tab characters from beginning and end of
  * a string */
 void strip(char* buffer) {
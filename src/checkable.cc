@@ -19,13 +19,17 @@
 
 #include "com/centreon/engine/checkable.hh"
 #include <sstream>
+#include "com/centreon/engine/dependency_index.hh"
 #include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/status_stats.hh"
+#include "com/centreon/engine/time_base.hh"
 
 using namespace com::centreon::engine;
 using namespace com::centreon::engine::logging;
 
-checkable::checkable(std::string const& display_name,
+checkable::checkable(state_table& states,
+                     std::string const& display_name,
                      std::string const& check_command,
                      bool checks_enabled,
                      bool accept_passive_checks,
@@ -48,10 +52,10 @@ checkable::checkable(std::string const& display_name,
                      bool obsess_over,
                      std::string const& timezone)
     : check_period_ptr{nullptr},
+      _states{states},
+      _state_id{0},
       _display_name{display_name},
       _check_command{check_command},
-      _check_interval{check_interval},
-      _retry_interval{retry_interval},
       _max_attempts{max_attempts},
       _check_period{check_period},
       _event_handler{event_handler},
@@ -66,28 +70,14 @@ checkable::checkable(std::string const& display_name,
       _high_flap_threshold{high_flap_threshold},
       _obsess_over{obsess_over},
       _timezone{timezone},
-      _checks_enabled{checks_enabled},
-      _accept_passive_checks{accept_passive_checks},
-      _check_freshness{check_freshness},
-      _freshness_threshold{freshness_threshold},
       _check_type{check_active},
-      _current_attempt{0},
-      _has_been_checked{false},
       _scheduled_downtime_depth{0},
       _execution_time{0.0},
       _is_flapping{false},
-      _last_check{0},
-      _latency{0.0},
-      _next_check{0L},
-      _should_be_scheduled{true},
       _state_history_index{0},
-      _last_state_change{0},
-      _last_hard_state_change{0},
-      _state_type{soft},
       _percent_state_change{0.0},
       _event_handler_ptr{nullptr},
-      _check_command_ptr{nullptr},
-      _is_executing{false} {
+      _check_command_ptr{nullptr} {
   if (max_attempts <= 0 || retry_interval <= 0 || freshness_threshold < 0) {
     std::ostringstream oss;
     bool empty{true};
@@ -111,6 +101,27 @@ checkable::checkable(std::string const& display_name,
     throw engine_error() << "Could not register checkable '" << display_name
                          << "'";
   }
+
+  /* Added only once the checkable is valid, the destructor is not called
+   * when the constructor throws. */
+  _state_id = _states.add(this);
+  _states.check_interval[_state_id] = check_interval;
+  _states.retry_interval[_state_id] = retry_interval;
+  _states.freshness_threshold[_state_id] = freshness_threshold;
+  _states.state_type[_state_id] = soft;
+  _states.flags[_state_id] =
+      state_table::should_be_scheduled |
+      (checks_enabled ? state_table::checks_enabled : 0) |
+      (accept_passive_checks ? state_table::accept_passive_checks : 0) |
+      (check_freshness ? state_table::check_freshness : 0);
+  dependency_index::of(_states).invalidate();
+  status_stats::of(_states).invalidate();
+}
+
+checkable::~checkable() noexcept {
+  _states.remove(_state_id);
+  dependency_index::of(_states).invalidate();
+  status_stats::of(_states).invalidate();
 }
 
 std::string const& checkable::get_display_name() const {
@@ -130,35 +141,40 @@ void checkable::set_check_command(std::string const& check_command) {
 }
 
 uint32_t checkable::get_check_interval() const {
-  return _check_interval;
+  return _states.check_interval[_state_id];
 }
 
 void checkable::set_check_interval(uint32_t check_interval) {
-  _check_interval = check_interval;
+  _states.check_interval[_state_id] = check_interval;
+  update_freshness_deadline();
 }
 
 double checkable::get_retry_interval() const {
-  return _retry_interval;
+  return _states.retry_interval[_state_id];
 }
 
 void checkable::set_retry_interval(double retry_interval) {
-  _retry_interval = retry_interval;
+  _states.retry_interval[_state_id] = retry_interval;
+  update_freshness_deadline();
 }
 
 time_t checkable::get_last_state_change() const {
-  return _last_state_change;
+  return time_base::instance().to_wall(_states.last_state_change[_state_id]);
 }
 
 void checkable::set_last_state_change(time_t last_state_change) {
-  _last_state_change = last_state_change;
+  _states.last_state_change[_state_id] =
+      time_base::instance().to_internal(last_state_change);
 }
 
 time_t checkable::get_last_hard_state_change() const {
-  return _last_hard_state_change;
+  return time_base::instance().to_wall(
+      _states.last_hard_state_change[_state_id]);
 }
 
 void checkable::set_last_hard_state_change(time_t last_hard_state_change) {
-  _last_hard_state_change = last_hard_state_change;
+  _states.last_hard_state_change[_state_id] =
+      time_base::instance().to_internal(last_hard_state_change);
 }
 
 int checkable::get_max_attempts() const {
@@ -290,19 +306,21 @@ void checkable::set_state_history_index(uint32_t state_history_index) {
 }
 
 bool checkable::get_checks_enabled() const {
-  return _checks_enabled;
+  return _states.flags[_state_id] & state_table::checks_enabled;
 }
 
 void checkable::set_checks_enabled(bool checks_enabled) {
-  _checks_enabled = checks_enabled;
+  _set_flag(state_table::checks_enabled, checks_enabled);
+  update_freshness_deadline();
 }
 
 bool checkable::get_check_freshness() const {
-  return _check_freshness;
+  return _states.flags[_state_id] & state_table::check_freshness;
 }
 
 void checkable::set_check_freshness(bool check_freshness) {
-  _check_freshness = check_freshness;
+  _set_flag(state_table::check_freshness, check_freshness);
+  update_freshness_deadline();
 }
 
 enum checkable::check_type checkable::get_check_type() const {
@@ -314,23 +332,26 @@ void checkable::set_check_type(checkable::check_type check_type) {
 }
 
 void checkable::set_current_attempt(int attempt) {
-  _current_attempt = attempt;
+  _states.current_attempt[_state_id] = attempt;
 }
 
 int checkable::get_current_attempt() const {
-  return _current_attempt;
+  return _states.current_attempt[_state_id];
 }
 
 void checkable::add_current_attempt(int num) {
-  _current_attempt += num;
+  _states.current_attempt[_state_id] += num;
 }
 
 bool checkable::has_been_checked() const {
-  return _has_been_checked;
+  return _states.flags[_state_id] & state_table::has_been_checked;
 }
 
 void checkable::set_has_been_checked(bool has_been_checked) {
-  _has_been_checked = has_been_checked;
+  if (has_been_checked != this->has_been_checked()) {
+    _set_flag(state_table::has_been_checked, has_been_checked);
+    dependency_index::of(_states).state_changed(_state_id);
+  }
 }
 
 bool checkable::get_event_handler_enabled() const {
@@ -342,11 +363,12 @@ void checkable::set_event_handler_enabled(bool event_handler_enabled) {
 }
 
 bool checkable::get_accept_passive_checks() const {
-  return _accept_passive_checks;
+  return _states.flags[_state_id] & state_table::accept_passive_checks;
 }
 
 void checkable::set_accept_passive_checks(bool accept_passive_checks) {
-  _accept_passive_checks = accept_passive_checks;
+  _set_flag(state_table::accept_passive_checks, accept_passive_checks);
+  update_freshness_deadline();
 }
 
 int checkable::get_scheduled_downtime_depth() const {
@@ -375,11 +397,12 @@ void checkable::set_execution_time(double execution_time) {
 }
 
 int checkable::get_freshness_threshold() const {
-  return _freshness_threshold;
+  return _states.freshness_threshold[_state_id];
 }
 
 void checkable::set_freshness_threshold(int freshness_threshold) {
-  _freshness_threshold = freshness_threshold;
+  _states.freshness_threshold[_state_id] = freshness_threshold;
+  update_freshness_deadline();
 }
 
 bool checkable::get_is_flapping() const {
@@ -391,35 +414,38 @@ void checkable::set_is_flapping(bool is_flapping) {
 }
 
 std::time_t checkable::get_last_check() const {
-  return _last_check;
+  return time_base::instance().to_wall(_states.last_check[_state_id]);
 }
 
 void checkable::set_last_check(time_t last_check) {
-  _last_check = last_check;
+  _states.last_check[_state_id] = time_base::instance().to_internal(last_check);
 }
 
 double checkable::get_latency() const {
-  return _latency;
+  return _states.latency[_state_id];
 }
 
 void checkable::set_latency(double latency) {
-  _latency = latency;
+  _states.latency[_state_id] = latency;
 }
 
 std::time_t checkable::get_next_check() const {
-  return _next_check;
+  return time_base::instance().to_wall(_states.next_check[_state_id]);
 }
 
 void checkable::set_next_check(std::time_t next_check) {
-  _next_check = next_check;
+  _states.next_check[_state_id] = time_base::instance().to_internal(next_check);
 }
 
 enum checkable::state_type checkable::get_state_type() const {
-  return _state_type;
+  return static_cast<state_type>(_states.state_type[_state_id]);
 }
 
 void checkable::set_state_type(enum checkable::state_type state_type) {
-  _state_type = state_type;
+  if (_states.state_type[_state_id] != state_type) {
+    _states.state_type[_state_id] = state_type;
+    dependency_index::of(_states).state_changed(_state_id);
+  }
 }
 
 double checkable::get_percent_state_change() const {
@@ -439,11 +465,11 @@ void checkable::set_obsess_over(bool obsess_over) {
 }
 
 bool checkable::get_should_be_scheduled() const {
-  return _should_be_scheduled;
+  return _states.flags[_state_id] & state_table::should_be_scheduled;
 }
 
 void checkable::set_should_be_scheduled(bool should_be_scheduled) {
-  _should_be_scheduled = should_be_scheduled;
+  _set_flag(state_table::should_be_scheduled, should_be_scheduled);
 }
 
 commands::command* checkable::get_event_handler_ptr() const {
@@ -463,9 +489,20 @@ void checkable::set_check_command_ptr(commands::command* cmd) {
 }
 
 bool checkable::get_is_executing() const {
-  return _is_executing;
+  return _states.flags[_state_id] & state_table::is_executing;
 }
 
 void checkable::set_is_executing(bool is_executing) {
-  _is_executing = is_executing;
+  _set_flag(state_table::is_executing, is_executing);
+}
+
+uint32_t checkable::get_state_id() const noexcept {
+  return _state_id;
+}
+
+void checkable::_set_flag(state_table::flag f, bool value) noexcept {
+  if (value)
+    _states.flags[_state_id] |= f;
+  else
+    _states.flags[_state_id] &= ~f;
 }
@@ -28,6 +28,7 @@
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/macros.hh"
 #include "com/centreon/engine/neberrors.hh"
+#include "com/centreon/engine/nebmods.hh"
 #include "com/centreon/engine/objects.hh"
 #include "com/centreon/engine/shared.hh"
 #include "com/centreon/engine/string.hh"
@@ -154,6 +155,7 @@ void checker::reap() {
               << "Check result queue errors for service " << svc->get_host_id()
               << "/" << svc->get_service_id() << " : " << e.what();
         }
+        svc->update_freshness_deadline();
       }
       // Host check result->
       else {
@@ -168,6 +170,7 @@ void checker::reap() {
               << "Check result queue errors for "
               << "host " << hst->get_host_id() << " : " << e.what();
         }
+        hst->update_freshness_deadline();
       }
 
       delete result;
@@ -194,6 +197,9 @@ void checker::reap() {
   // Reaping finished.
   logger(dbg_checks, basic)
       << "Finished reaping " << reaped_checks << " check results";
+
+  // Send the events of the reaped checks to the batch callbacks.
+  neb_flush_batches(0);
 }
 
 /**
@@ -307,6 +313,7 @@ void checker::run_sync(host* hst,
   hst->process_check_result_3x(host_result, old_plugin_output, check_options,
                                false, use_cached_result,
                                check_timestamp_horizon);
+  hst->update_freshness_deadline();
   if (check_result_code)
     *check_result_code = hst->get_current_state();
 
@@ -327,6 +334,8 @@ void checker::run_sync(host* hst,
                     const_cast<char*>(hst->get_plugin_output().c_str()),
                     const_cast<char*>(hst->get_long_plugin_output().c_str()),
                     const_cast<char*>(hst->get_perf_data().c_str()), nullptr);
+  broker_perfdata(NEBTYPE_PERFDATA_PROCESSED, NEBFLAG_NONE, NEBATTR_NONE, hst,
+                  nullptr, nullptr);
 }
 
 /**************************************
@@ -613,6 +622,24 @@ void checker::add_check_result_to_reap(check_result* check_result) noexcept {
   _to_reap_partial.push_back(check_result);
 }
 
+/**
+ * @brief Same as add_check_result_to_reap() but for many check_results, the
+ * lock is taken only once. results is left empty.
+ *
+ * @param results The check_results already finished.
+ */
+void checker::add_check_results_to_reap(
+    std::deque<check_result*>& results) noexcept {
+  std::lock_guard<std::mutex> lock(_mut_reap);
+  if (_to_reap_partial.empty())
+    std::swap(_to_reap_partial, results);
+  else {
+    _to_reap_partial.insert(_to_reap_partial.end(), results.begin(),
+                            results.end());
+    results.clear();
+  }
+}
+
 /**
  * @brief Notifiers added here will be removed from current checks. This task
  * is necessary because the user could remove a service or a host while a check
@@ -25,120 +25,225 @@
 #include <ctime>
 #include "com/centreon/engine/common.hh"
 #include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/time_base.hh"
+
+using namespace com::centreon::engine::checks;
+
+/* Upper bound of the first histogram bucket, in seconds. */
+static double const histogram_base = 0.001;
+
+/**
+ *  Get the histogram bucket of a duration.
+ *
+ *  @param[in] value Duration in seconds.
+ *
+ *  @return The bucket index.
+ */
+static int histogram_bucket(double value) noexcept {
+  if (!(value >= histogram_base))
+    return 0;
+  int retval = 1 + static_cast<int>(4 * std::log2(value / histogram_base));
+  return retval < stats::histogram_buckets ? retval
+                                           : stats::histogram_buckets - 1;
+}
+
+/**
+ *  Get the upper bound of a histogram bucket.
+ *
+ *  @param[in] bucket The bucket index.
+ *
+ *  @return A duration in seconds.
+ */
+static double histogram_bound(int bucket) noexcept {
+  return histogram_base * std::exp2(bucket / 4.0);
+}
+
+/**
+ *  Default constructor.
+ */
+stats::stats() {
+  reset();
+}
+
+/**
+ *  Get the stats instance.
+ *
+ *  @return A reference to the instance.
+ */
+stats& stats::instance() {
+  static stats instance;
+  return instance;
+}
+
+/**
+ *  Forget all the recorded values.
+ */
+void stats::reset() noexcept {
+  for (slot& s : _slots) {
+    s.minute.store(-1, std::memory_order_relaxed);
+    for (std::atomic<uint32_t>& c : s.checks)
+      c.store(0, std::memory_order_relaxed);
+    for (auto& h : s.timings)
+      for (std::atomic<uint32_t>& b : h)
+        b.store(0, std::memory_order_relaxed);
+  }
+}
+
+/**
+ *  Get the minute of a time in the engine time base, so that a step of the
+ *  wall clock does not make the recorded minutes look stale or in the
+ *  future.
+ *
+ *  @param[in] t A wall-clock time.
+ *
+ *  @return A number of minutes.
+ */
+int64_t stats::_minute_of(time_t t) noexcept {
+  return time_base::instance().to_internal(t) / 60;
+}
+
+/**
+ *  Get the slot of the minute containing t, recycling it if it still
+ *  contains an older minute. Increments made concurrently with a recycling
+ *  may be lost, this is the price of not locking.
+ *
+ *  @param[in] t A wall-clock time.
+ *
+ *  @return The slot or nullptr if t is too old to be recorded.
+ */
+stats::slot* stats::_slot_for(time_t t) noexcept {
+  int64_t minute = _minute_of(t);
+  slot& s = _slots[minute % _slots_count];
+  int64_t current = s.minute.load(std::memory_order_acquire);
+  if (current == minute)
+    return &s;
+  if (current > minute)
+    return nullptr;
+  if (s.minute.compare_exchange_strong(current, minute,
+                                       std::memory_order_acq_rel)) {
+    for (std::atomic<uint32_t>& c : s.checks)
+      c.store(0, std::memory_order_relaxed);
+    for (auto& h : s.timings)
+      for (std::atomic<uint32_t>& b : h)
+        b.store(0, std::memory_order_relaxed);
+    return &s;
+  }
+  return current == minute ? &s : nullptr;
+}
+
+/**
+ *  Records a check.
+ *
+ *  @param[in] check_type Check type.
+ *  @param[in] check_time Time at which the check occurred.
+ */
+void stats::add_check(int check_type, time_t check_time) noexcept {
+  slot* s = _slot_for(check_time);
+  if (s)
+    s->checks[check_type].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ *  Records a latency or an execution time.
+ *
+ *  @param[in] type  The kind of duration.
+ *  @param[in] value The duration in seconds.
+ *  @param[in] now   The current time.
+ */
+void stats::add_timing(timing type, double value, time_t now) noexcept {
+  slot* s = _slot_for(now);
+  if (s)
+    s->timings[type][histogram_bucket(value)].fetch_add(
+        1, std::memory_order_relaxed);
+}
+
+/**
+ *  Count the checks of a type made during the last minutes. The oldest
+ *  minute is weighted by its part in the window.
+ *
+ *  @param[in] check_type Check type.
+ *  @param[in] minutes    Window size, between 1 and CHECK_STATS_BUCKETS.
+ *  @param[in] now        The current time.
+ *
+ *  @return The checks count.
+ */
+uint32_t stats::checks_count(int check_type, int minutes, time_t now) const
+    noexcept {
+  time_t internal = time_base::instance().to_internal(now);
+  int64_t minute = internal / 60;
+  double retval = 0;
+  for (int i = 0; i <= minutes; ++i) {
+    const slot& s = _slots[(minute - i) % _slots_count];
+    if (s.minute.load(std::memory_order_acquire) != minute - i)
+      continue;
+    double count = s.checks[check_type].load(std::memory_order_relaxed);
+    if (i == minutes)
+      retval += std::floor(count * (60 - internal % 60) / 60.0);
+    else
+      retval += count;
+  }
+  return static_cast<uint32_t>(retval);
+}
+
+/**
+ *  Get a percentile of the durations recorded during the last minutes.
+ *
+ *  @param[in] type    The kind of duration.
+ *  @param[in] q       The percentile as a ratio (0.95 for the 95th).
+ *  @param[in] minutes Window size, between 1 and CHECK_STATS_BUCKETS.
+ *  @param[in] now     The current time.
+ *
+ *  @return The upper bound of the bucket containing the percentile, 0 if
+ *          nothing was recorded.
+ */
+double stats::percentile(timing type, double q, int minutes, time_t now) const
+    noexcept {
+  int64_t minute = _minute_of(now);
+  uint64_t histogram[histogram_buckets] = {0};
+  uint64_t total = 0;
+  for (int i = 0; i < minutes; ++i) {
+    const slot& s = _slots[(minute - i) % _slots_count];
+    if (s.minute.load(std::memory_order_acquire) != minute - i)
+      continue;
+    for (int b = 0; b < histogram_buckets; ++b) {
+      uint32_t count = s.timings[type][b].load(std::memory_order_relaxed);
+      histogram[b] += count;
+      total += count;
+    }
+  }
+  if (!total)
+    return 0;
+
+  double target = q * total;
+  uint64_t cumul = 0;
+  for (int b = 0; b < histogram_buckets - 1; ++b) {
+    cumul += histogram[b];
+    if (cumul >= target)
+      return histogram_bound(b);
+  }
+  /* Overflow bucket, we can only give its lower bound. */
+  return histogram_bound(histogram_buckets - 2);
+}
 
 extern "C" {
 /**
- *  Generate 1/5/15 minute stats for a given type of check.
+ *  Generate 1/5/15 minute stats for all the types of check.
  *
  *  @return OK on success.
  */
 int generate_check_stats() {
-  // Do some sanity checks on the age of the stats data before we
-  // start... and get the new current bucket number.
   time_t current_time(time(NULL));
-  int minutes(0);
-  int new_current_bucket(0);
-  minutes = ((unsigned long)current_time - (unsigned long)program_start) / 60;
-  new_current_bucket = minutes % CHECK_STATS_BUCKETS;
+  stats const& s(stats::instance());
   for (unsigned int check_type(0); check_type < MAX_CHECK_STATS_TYPES;
        ++check_type) {
-    // Its been more than 15 minutes since
-    // stats were updated, so clear the stats.
-    if ((((unsigned long)current_time -
-          (unsigned long)check_statistics[check_type].last_update) /
-         60) > CHECK_STATS_BUCKETS) {
-      for (unsigned int x(0); x < CHECK_STATS_BUCKETS; ++x)
-        check_statistics[check_type].bucket[x] = 0;
-      check_statistics[check_type].overflow_bucket = 0;
-    }
-    // Different current bucket number than last time.
-    else if (new_current_bucket !=
-             check_statistics[check_type].current_bucket) {
-      // Clear stats in buckets between last current bucket and new
-      // current bucket - stats haven't been updated in a while.
-      for (unsigned int x(check_statistics[check_type].current_bucket);
-           x < CHECK_STATS_BUCKETS * 2; ++x) {
-        int this_bucket((x + CHECK_STATS_BUCKETS + 1) % CHECK_STATS_BUCKETS);
-        if (this_bucket == new_current_bucket)
-          break;
-
-        // Clear old bucket value.
-        check_statistics[check_type].bucket[this_bucket] = 0;
-      }
-
-      // Update the current bucket number,
-      // push old value to overflow bucket.
-      check_statistics[check_type].overflow_bucket =
-          check_statistics[check_type].bucket[new_current_bucket];
-      check_statistics[check_type].current_bucket = new_current_bucket;
-      check_statistics[check_type].bucket[new_current_bucket] = 0;
-    }
-    // Update last check time.
+    check_statistics[check_type].minute_stats[0] =
+        s.checks_count(check_type, 1, current_time);
+    check_statistics[check_type].minute_stats[1] =
+        s.checks_count(check_type, 5, current_time);
+    check_statistics[check_type].minute_stats[2] =
+        s.checks_count(check_type, 15, current_time);
     check_statistics[check_type].last_update = current_time;
   }
-
-  // Determine weights to use for this/last buckets.
-  int seconds(0);
-  seconds = ((unsigned long)current_time - (unsigned long)program_start) % 60;
-  float this_bucket_weight(seconds / 60.0);
-  float last_bucket_weight((60 - seconds) / 60.0);
-
-  // Update statistics for all check types.
-  for (unsigned int check_type(0); check_type < MAX_CHECK_STATS_TYPES;
-       ++check_type) {
-    // Clear the old statistics.
-    for (unsigned int x(0); x < 3; ++x)
-      check_statistics[check_type].minute_stats[x] = 0;
-
-    // Loop through each bucket.
-    for (unsigned int x(0); x < CHECK_STATS_BUCKETS; ++x) {
-      // Which buckets should we use for this/last bucket?
-      int this_bucket((check_statistics[check_type].current_bucket +
-                       CHECK_STATS_BUCKETS - x) %
-                      CHECK_STATS_BUCKETS);
-      int last_bucket((this_bucket + CHECK_STATS_BUCKETS - 1) %
-                      CHECK_STATS_BUCKETS);
-
-      // Raw/unweighted value for this bucket.
-      int this_bucket_value(check_statistics[check_type].bucket[this_bucket]);
-
-      // Raw/unweighted value for last bucket - use overflow
-      // bucket if last bucket is current bucket.
-      int last_bucket_value;
-      if (last_bucket == check_statistics[check_type].current_bucket)
-        last_bucket_value = check_statistics[check_type].overflow_bucket;
-      else
-        last_bucket_value = check_statistics[check_type].bucket[last_bucket];
-
-      // Determine value by weighting this/last buckets... If this is
-      // the current bucket, use its full value + weighted % of last
-      // bucket.
-      int bucket_value;
-      if (!x)
-        bucket_value = (int)(this_bucket_value +
-                             floor(last_bucket_value * last_bucket_weight));
-      // Otherwise use weighted % of this and last bucket.
-      else
-        bucket_value = (int)(ceil(this_bucket_value * this_bucket_weight) +
-                             floor(last_bucket_value * last_bucket_weight));
-
-      // 1 minute stats.
-      if (!x)
-        check_statistics[check_type].minute_stats[0] = bucket_value;
-
-      // 5 minute stats.
-      if (x < 5)
-        check_statistics[check_type].minute_stats[1] += bucket_value;
-
-      // 15 minute stats.
-      if (x < 15)
-        check_statistics[check_type].minute_stats[2] += bucket_value;
-
-      // Record last update time.
-      check_statistics[check_type].last_update = current_time;
-    }
-  }
-
   return (OK);
 }
 
@@ -148,11 +253,8 @@ int generate_check_stats() {
  *  @return OK on success.
  */
 int init_check_stats() {
+  stats::instance().reset();
   for (unsigned int x(0); x < MAX_CHECK_STATS_TYPES; ++x) {
-    check_statistics[x].current_bucket = 0;
-    for (unsigned int y(0); y < CHECK_STATS_BUCKETS; ++y)
-      check_statistics[x].bucket[y] = 0;
-    check_statistics[x].overflow_bucket = 0;
     for (unsigned int y(0); y < 3; ++y)
       check_statistics[x].minute_stats[y] = 0;
     check_statistics[x].last_update = (time_t)0L;
@@ -173,54 +275,10 @@ int update_check_stats(int check_type, time_t check_time) {
   if ((check_type < 0) || (check_type >= MAX_CHECK_STATS_TYPES))
     return (ERROR);
 
-  // Get current and check time.
-  time_t current_time(time(NULL));
   if (!check_time)
-    check_time = current_time;
-
-  // Do some sanity checks on the age of the stats data before we
-  // start... and get the new current bucket number.
-  unsigned long minutes =
-      ((unsigned long)check_time - (unsigned long)program_start) / 60;
-  int new_current_bucket(minutes % CHECK_STATS_BUCKETS);
-
-  // Its been more than 15 minutes since
-  // stats were updated, so clear the stats.
-  if ((((unsigned long)current_time -
-        (unsigned long)check_statistics[check_type].last_update) /
-       60) > CHECK_STATS_BUCKETS) {
-    for (unsigned int x(0); x < CHECK_STATS_BUCKETS; ++x)
-      check_statistics[check_type].bucket[x] = 0;
-    check_statistics[check_type].overflow_bucket = 0;
-  }
-  // Different current bucket number than last time.
-  else if (new_current_bucket != check_statistics[check_type].current_bucket) {
-    // Clear stats in buckets between last current bucket and new
-    // current bucket - stats haven't been updated in a while.
-    for (unsigned int x(check_statistics[check_type].current_bucket);
-         x < (CHECK_STATS_BUCKETS * 2); ++x) {
-      int this_bucket = (x + CHECK_STATS_BUCKETS + 1) % CHECK_STATS_BUCKETS;
-      if (this_bucket == new_current_bucket)
-        break;
-
-      // Clear old bucket value.
-      check_statistics[check_type].bucket[this_bucket] = 0;
-    }
-
-    // Update the current bucket number,
-    // push old value to overflow bucket.
-    check_statistics[check_type].overflow_bucket =
-        check_statistics[check_type].bucket[new_current_bucket];
-    check_statistics[check_type].current_bucket = new_current_bucket;
-    check_statistics[check_type].bucket[new_current_bucket] = 0;
-  }
-
-  // Increment the value of the current bucket.
-  check_statistics[check_type].bucket[new_current_bucket]++;
-
-  // Record last update time.
-  check_statistics[check_type].last_update = current_time;
+    check_time = time(NULL);
 
+  stats::instance().add_check(check_type, check_time);
   return (OK);
 }
 }
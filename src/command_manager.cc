@@ -24,10 +24,15 @@
 #include <unistd.h>
 
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/stats.hh"
 #include "com/centreon/engine/comment.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
+#include "com/centreon/engine/events/check_scheduler.hh"
+#include "com/centreon/engine/events/loop.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/object_index.hh"
+#include "com/centreon/engine/status_stats.hh"
 
 using namespace com::centreon::engine;
 using namespace com::centreon::engine::logging;
@@ -74,6 +79,43 @@ void command_manager::execute() {
   }
 }
 
+/**
+ * @brief Build a passive check result.
+ *
+ * @param type host_check or service_check.
+ * @param n The host or the service.
+ * @param check_time The time the check was made.
+ * @param now The reception time, used to compute the latency.
+ * @param return_code The check return code.
+ * @param output The check output.
+ *
+ * @return A new check_result.
+ */
+static check_result* new_passive_result(enum check_source type,
+                                        notifier* n,
+                                        time_t check_time,
+                                        const timeval& now,
+                                        uint32_t return_code,
+                                        const std::string& output) {
+  timeval set_tv = {.tv_sec = check_time, .tv_usec = 0};
+
+  check_result* result =
+      new check_result(type, n, checkable::check_passive, CHECK_OPTION_NONE,
+                       false,
+                       static_cast<double>(now.tv_sec - check_time) +
+                           static_cast<double>(now.tv_usec) / 1000000.0,
+                       set_tv, set_tv, false, true, return_code, output);
+
+  /* make sure the return code is within bounds */
+  if (result->get_return_code() < 0 || result->get_return_code() > 3)
+    result->set_return_code(service::state_unknown);
+
+  if (result->get_latency() < 0.0)
+    result->set_latency(0.0);
+
+  return result;
+}
+
 /* submits a passive service check result for later processing */
 int command_manager::process_passive_service_check(
     time_t check_time,
@@ -81,8 +123,6 @@ int command_manager::process_passive_service_check(
     const std::string& svc_description,
     uint32_t return_code,
     const std::string& output) {
-  const std::string* real_host_name = nullptr;
-
   /* skip this service check result if we aren't accepting passive service
    * checks */
   if (!config->accept_passive_service_checks())
@@ -93,22 +133,19 @@ int command_manager::process_passive_service_check(
     return ERROR;
 
   /* find the host by its name or address */
-  host_map::const_iterator it(host::hosts.find(host_name));
-  if (it != host::hosts.end() && it->second)
-    real_host_name = &host_name;
-  else {
-    for (host_map::iterator itt(host::hosts.begin()), end(host::hosts.end());
-         itt != end; ++itt) {
-      if (itt->second && itt->second->get_address() == host_name) {
-        real_host_name = &itt->first;
-        it = itt;
+  host* hst = object_index::find_host(host_name);
+  if (!hst) {
+    for (host_map::iterator it(host::hosts.begin()), end(host::hosts.end());
+         it != end; ++it) {
+      if (it->second && it->second->get_address() == host_name) {
+        hst = it->second.get();
         break;
       }
     }
   }
 
   /* we couldn't find the host */
-  if (real_host_name == nullptr) {
+  if (hst == nullptr) {
     logger(log_runtime_warning, basic)
         << "Warning:  Passive check result was received for service '"
         << svc_description << "' on host '" << host_name
@@ -117,9 +154,8 @@ int command_manager::process_passive_service_check(
   }
 
   /* make sure the service exists */
-  service_map::const_iterator found(
-      service::services.find({*real_host_name, svc_description}));
-  if (found == service::services.end() || !found->second) {
+  service* svc = object_index::find_service(hst->get_name(), svc_description);
+  if (svc == nullptr) {
     logger(log_runtime_warning, basic)
         << "Warning:  Passive check result was received for service '"
         << svc_description << "' on host '" << host_name
@@ -128,29 +164,15 @@ int command_manager::process_passive_service_check(
   }
 
   /* skip this is we aren't accepting passive checks for this service */
-  if (!found->second->get_accept_passive_checks())
+  if (!svc->get_accept_passive_checks())
     return ERROR;
 
   timeval tv;
   gettimeofday(&tv, nullptr);
 
-  timeval set_tv = {.tv_sec = check_time, .tv_usec = 0};
-
-  check_result* result =
-      new check_result(service_check, found->second.get(),
-                       checkable::check_passive, CHECK_OPTION_NONE, false,
-                       static_cast<double>(tv.tv_sec - check_time) +
-                           static_cast<double>(tv.tv_usec) / 1000000.0,
-                       set_tv, set_tv, false, true, return_code, output);
-
-  /* make sure the return code is within bounds */
-  if (result->get_return_code() < 0 || result->get_return_code() > 3)
-    result->set_return_code(service::state_unknown);
-
-  if (result->get_latency() < 0.0)
-    result->set_latency(0.0);
-
-  checks::checker::instance().add_check_result_to_reap(result);
+  checks::checker::instance().add_check_result_to_reap(
+      new_passive_result(service_check, svc, check_time, tv, return_code,
+                         output));
   return OK;
 }
 
@@ -159,8 +181,6 @@ int command_manager::process_passive_host_check(time_t check_time,
                                                 const std::string& host_name,
                                                 uint32_t return_code,
                                                 const std::string& output) {
-  const std::string* real_host_name = nullptr;
-
   /* skip this host check result if we aren't accepting passive host checks */
   if (!config->accept_passive_service_checks())
     return ERROR;
@@ -170,22 +190,19 @@ int command_manager::process_passive_host_check(time_t check_time,
     return ERROR;
 
   /* find the host by its name or address */
-  host_map::const_iterator it(host::hosts.find(host_name));
-  if (it != host::hosts.end() && it->second)
-    real_host_name = &host_name;
-  else {
-    for (host_map::iterator itt(host::hosts.begin()), end(host::hosts.end());
-         itt != end; ++itt) {
-      if (itt->second && itt->second->get_address() == host_name) {
-        real_host_name = &itt->first;
-        it = itt;
+  host* hst = object_index::find_host(host_name);
+  if (!hst) {
+    for (host_map::iterator it(host::hosts.begin()), end(host::hosts.end());
+         it != end; ++it) {
+      if (it->second && it->second->get_address() == host_name) {
+        hst = it->second.get();
         break;
       }
     }
   }
 
   /* we couldn't find the host */
-  if (real_host_name == nullptr) {
+  if (hst == nullptr) {
     logger(log_runtime_warning, basic)
         << "Warning:  Passive check result was received for host '" << host_name
         << "', but the host could not be found!";
@@ -193,35 +210,189 @@ int command_manager::process_passive_host_check(time_t check_time,
   }
 
   /* skip this is we aren't accepting passive checks for this host */
-  if (!it->second->get_accept_passive_checks())
+  if (!hst->get_accept_passive_checks())
     return ERROR;
 
   timeval tv;
   gettimeofday(&tv, nullptr);
-  timeval tv_start;
-  tv_start.tv_sec = check_time;
-  tv_start.tv_usec = 0;
 
-  check_result* result =
-      new check_result(host_check, it->second.get(), checkable::check_passive,
-                       CHECK_OPTION_NONE, false,
-                       static_cast<double>(tv.tv_sec - check_time) +
-                           static_cast<double>(tv.tv_usec) / 1000000.0,
-                       tv_start, tv_start, false, true, return_code, output);
+  checks::checker::instance().add_check_result_to_reap(
+      new_passive_result(host_check, hst, check_time, tv, return_code, output));
+  return OK;
+}
 
-  /* make sure the return code is within bounds */
-  if (result->get_return_code() < 0 || result->get_return_code() > 3)
-    result->set_return_code(service::state_unknown);
+/**
+ * @brief Submit many passive check results at once. Hosts and services are
+ * resolved by name (or address for hosts) when given, else by id. All the
+ * accepted results are given to the checker in one shot. This method must be
+ * called from the main loop.
+ *
+ * @param checks The check results.
+ * @param response One status per check result, in the same order.
+ *
+ * @return The number of accepted check results.
+ */
+int command_manager::process_passive_checks(const Checks& checks,
+                                            ChecksStatus* response) {
+  std::deque<check_result*> results;
+  /* Built only if a host name is not found, to look for it by address. */
+  std::unordered_map<std::string, host*> by_address;
+  bool by_address_built = false;
 
-  if (result->get_latency() < 0.0)
-    result->set_latency(0.0);
+  timeval tv;
+  gettimeofday(&tv, nullptr);
 
-  checks::checker::instance().add_check_result_to_reap(result);
-  return OK;
+  response->mutable_status()->Reserve(checks.checks_size());
+  for (const Check& c : checks.checks()) {
+    bool is_service = !c.svc_desc().empty() || c.service_id();
+    ChecksStatus::Status status = ChecksStatus::ACCEPTED;
+    host* hst = nullptr;
+
+    if (c.host_name().empty() && !c.host_id())
+      status = ChecksStatus::INVALID;
+    else if (c.code() > (is_service ? 3u : 2u))
+      status = ChecksStatus::INVALID;
+    else if (is_service ? !config->accept_passive_service_checks()
+                        : !config->accept_passive_host_checks())
+      status = ChecksStatus::REFUSED;
+    else if (!c.host_name().empty()) {
+      hst = object_index::find_host(c.host_name());
+      if (!hst) {
+        if (!by_address_built) {
+          for (auto& p : host::hosts)
+            if (p.second)
+              by_address.emplace(p.second->get_address(), p.second.get());
+          by_address_built = true;
+        }
+        auto found = by_address.find(c.host_name());
+        if (found != by_address.end())
+          hst = found->second;
+      }
+    } else {
+      host_id_map::const_iterator it(host::hosts_by_id.find(c.host_id()));
+      if (it != host::hosts_by_id.end())
+        hst = it->second.get();
+    }
+
+    if (status == ChecksStatus::ACCEPTED && !hst)
+      status = ChecksStatus::HOST_NOT_FOUND;
+
+    notifier* n = hst;
+    if (status == ChecksStatus::ACCEPTED && is_service) {
+      n = nullptr;
+      if (!c.svc_desc().empty())
+        n = object_index::find_service(hst->get_name(), c.svc_desc());
+      else {
+        service_id_map::const_iterator found(service::services_by_id.find(
+            {hst->get_host_id(), c.service_id()}));
+        if (found != service::services_by_id.end())
+          n = found->second.get();
+      }
+      if (!n)
+        status = ChecksStatus::SERVICE_NOT_FOUND;
+    }
+
+    if (status == ChecksStatus::ACCEPTED && !n->get_accept_passive_checks())
+      status = ChecksStatus::REFUSED;
+
+    if (status == ChecksStatus::ACCEPTED)
+      results.push_back(new_passive_result(
+          is_service ? service_check : host_check, n,
+          google::protobuf::util::TimeUtil::TimestampToSeconds(c.check_time()),
+          tv, c.code(), c.output()));
+    response->add_status(status);
+  }
+
+  logger(dbg_checks, more) << "Passive check results batch: " << results.size()
+                           << " accepted over " << checks.checks_size();
+  response->set_accepted(results.size());
+  int retval = results.size();
+  checks::checker::instance().add_check_results_to_reap(results);
+  return retval;
+}
+
+/**
+ * @brief Fill the last 1/5/15 minutes checks counts of a check type.
+ *
+ * @param field The repeated field to fill.
+ * @param check_type The check type.
+ * @param now The current time.
+ */
+static void add_check_counts(google::protobuf::RepeatedField<uint32_t>* field,
+                             int check_type,
+                             time_t now) {
+  const checks::stats& s = checks::stats::instance();
+  field->Add(s.checks_count(check_type, 1, now));
+  field->Add(s.checks_count(check_type, 5, now));
+  field->Add(s.checks_count(check_type, 15, now));
+}
+
+/**
+ * @brief Fill the latency and execution time percentiles of hosts or
+ * services stats.
+ *
+ * @param type_stats The ServiceTypeStats or HostTypeStats to fill.
+ * @param latency The latency kind.
+ * @param execution_time The execution time kind, timing_max if there is no
+ *                       execution time (passive checks).
+ * @param now The current time.
+ */
+template <typename T>
+static void fill_percentiles(T* type_stats,
+                             checks::stats::timing latency,
+                             checks::stats::timing execution_time,
+                             time_t now) {
+  const checks::stats& s = checks::stats::instance();
+  const int minutes = checks::stats::percentiles_minutes;
+  type_stats->set_p50_latency(s.percentile(latency, 0.50, minutes, now));
+  type_stats->set_p95_latency(s.percentile(latency, 0.95, minutes, now));
+  type_stats->set_p99_latency(s.percentile(latency, 0.99, minutes, now));
+  if (execution_time != checks::stats::timing_max) {
+    type_stats->set_p50_execution_time(
+        s.percentile(execution_time, 0.50, minutes, now));
+    type_stats->set_p95_execution_time(
+        s.percentile(execution_time, 0.95, minutes, now));
+    type_stats->set_p99_execution_time(
+        s.percentile(execution_time, 0.99, minutes, now));
+  }
+}
+
+/**
+ * @brief Get the sections of the statistics asked by a GetStats request.
+ *
+ * @param request The request, "default", "program", "services" or "hosts".
+ *
+ * @return A mask of stats_section, 0 for another request.
+ */
+uint32_t command_manager::stats_sections(std::string const& request) {
+  if (request == "default")
+    return stats_default;
+  else if (request == "program")
+    return stats_program;
+  else if (request == "services")
+    return stats_services;
+  else if (request == "hosts")
+    return stats_hosts;
+  return 0;
 }
 
 int command_manager::get_stats(std::string const& request, Stats* response) {
-  if (request == "default") {
+  if (request == "start")
+    return get_restart_stats(response->mutable_restart_status());
+  fill_stats(stats_sections(request), response);
+  return 0;
+}
+
+/**
+ * @brief Fill some sections of the statistics. The hosts and services ones
+ * are copied from their kept totals. This method must be called from the
+ * main loop.
+ *
+ * @param sections A mask of stats_section.
+ * @param response The statistics to fill.
+ */
+void command_manager::fill_stats(uint32_t sections, Stats* response) {
+  if (sections & stats_program) {
     response->mutable_program_status()->set_modified_host_attributes(
         modified_host_process_attributes);
     response->mutable_program_status()->set_modified_service_attributes(
@@ -286,85 +457,37 @@ int command_manager::get_stats(std::string const& request, Stats* response) {
         high_external_command_buffer_slots);
     response->mutable_program_status()->set_high_external_command_buffer_slots(
         high_external_command_buffer_slots);
-    response->mutable_program_status()->add_active_scheduled_host_check_stats(
-        check_statistics[ACTIVE_SCHEDULED_HOST_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_active_scheduled_host_check_stats(
-        check_statistics[ACTIVE_SCHEDULED_HOST_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_active_scheduled_host_check_stats(
-        check_statistics[ACTIVE_SCHEDULED_HOST_CHECK_STATS].minute_stats[2]);
-    response->mutable_program_status()->add_active_ondemand_host_check_stats(
-        check_statistics[ACTIVE_ONDEMAND_HOST_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_active_ondemand_host_check_stats(
-        check_statistics[ACTIVE_ONDEMAND_HOST_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_active_ondemand_host_check_stats(
-        check_statistics[ACTIVE_ONDEMAND_HOST_CHECK_STATS].minute_stats[2]);
-    response->mutable_program_status()->add_passive_host_check_stats(
-        check_statistics[PASSIVE_HOST_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_passive_host_check_stats(
-        check_statistics[PASSIVE_HOST_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_passive_host_check_stats(
-        check_statistics[PASSIVE_HOST_CHECK_STATS].minute_stats[2]);
-    response->mutable_program_status()
-        ->add_active_scheduled_service_check_stats(
-            check_statistics[ACTIVE_SCHEDULED_SERVICE_CHECK_STATS]
-                .minute_stats[0]);
-    response->mutable_program_status()
-        ->add_active_scheduled_service_check_stats(
-            check_statistics[ACTIVE_SCHEDULED_SERVICE_CHECK_STATS]
-                .minute_stats[1]);
-    response->mutable_program_status()
-        ->add_active_scheduled_service_check_stats(
-            check_statistics[ACTIVE_SCHEDULED_SERVICE_CHECK_STATS]
-                .minute_stats[2]);
-    response->mutable_program_status()->add_active_ondemand_service_check_stats(
-        check_statistics[ACTIVE_ONDEMAND_SERVICE_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_active_ondemand_service_check_stats(
-        check_statistics[ACTIVE_ONDEMAND_SERVICE_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_active_ondemand_service_check_stats(
-        check_statistics[ACTIVE_ONDEMAND_SERVICE_CHECK_STATS].minute_stats[2]);
-    response->mutable_program_status()->add_passive_service_check_stats(
-        check_statistics[PASSIVE_SERVICE_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_passive_service_check_stats(
-        check_statistics[PASSIVE_SERVICE_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_passive_service_check_stats(
-        check_statistics[PASSIVE_SERVICE_CHECK_STATS].minute_stats[2]);
-    response->mutable_program_status()->add_cached_host_check_stats(
-        check_statistics[ACTIVE_CACHED_HOST_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_cached_host_check_stats(
-        check_statistics[ACTIVE_CACHED_HOST_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_cached_host_check_stats(
-        check_statistics[ACTIVE_CACHED_HOST_CHECK_STATS].minute_stats[2]);
-    response->mutable_program_status()->add_cached_service_check_stats(
-        check_statistics[ACTIVE_CACHED_SERVICE_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_cached_service_check_stats(
-        check_statistics[ACTIVE_CACHED_SERVICE_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_cached_service_check_stats(
-        check_statistics[ACTIVE_CACHED_SERVICE_CHECK_STATS].minute_stats[2]);
-    response->mutable_program_status()->add_external_command_stats(
-        check_statistics[EXTERNAL_COMMAND_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_external_command_stats(
-        check_statistics[EXTERNAL_COMMAND_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_external_command_stats(
-        check_statistics[EXTERNAL_COMMAND_STATS].minute_stats[2]);
-    response->mutable_program_status()->add_parallel_host_check_stats(
-        check_statistics[PARALLEL_HOST_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_parallel_host_check_stats(
-        check_statistics[PARALLEL_HOST_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_parallel_host_check_stats(
-        check_statistics[PARALLEL_HOST_CHECK_STATS].minute_stats[2]);
-    response->mutable_program_status()->add_serial_host_check_stats(
-        check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[0]);
-    response->mutable_program_status()->add_serial_host_check_stats(
-        check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[1]);
-    response->mutable_program_status()->add_serial_host_check_stats(
-        check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[2]);
+    time_t now = time(nullptr);
+    ProgramStatus* status = response->mutable_program_status();
+    add_check_counts(status->mutable_active_scheduled_host_check_stats(),
+                     ACTIVE_SCHEDULED_HOST_CHECK_STATS, now);
+    add_check_counts(status->mutable_active_ondemand_host_check_stats(),
+                     ACTIVE_ONDEMAND_HOST_CHECK_STATS, now);
+    add_check_counts(status->mutable_passive_host_check_stats(),
+                     PASSIVE_HOST_CHECK_STATS, now);
+    add_check_counts(status->mutable_active_scheduled_service_check_stats(),
+                     ACTIVE_SCHEDULED_SERVICE_CHECK_STATS, now);
+    add_check_counts(status->mutable_active_ondemand_service_check_stats(),
+                     ACTIVE_ONDEMAND_SERVICE_CHECK_STATS, now);
+    add_check_counts(status->mutable_passive_service_check_stats(),
+                     PASSIVE_SERVICE_CHECK_STATS, now);
+    add_check_counts(status->mutable_cached_host_check_stats(),
+                     ACTIVE_CACHED_HOST_CHECK_STATS, now);
+    add_check_counts(status->mutable_cached_service_check_stats(),
+                     ACTIVE_CACHED_SERVICE_CHECK_STATS, now);
+    add_check_counts(status->mutable_external_command_stats(),
+                     EXTERNAL_COMMAND_STATS, now);
+    add_check_counts(status->mutable_parallel_host_check_stats(),
+                     PARALLEL_HOST_CHECK_STATS, now);
+    add_check_counts(status->mutable_serial_host_check_stats(),
+                     SERIAL_HOST_CHECK_STATS, now);
     response->mutable_program_configuration()->set_hosts_count(
         host::hosts.size());
+  }
+  if (sections & stats_services)
     get_services_stats(response->mutable_services_stats());
+  if (sections & stats_hosts)
     get_hosts_stats(response->mutable_hosts_stats());
-  } else if (request == "start")
-    return get_restart_stats(response->mutable_restart_status());
-  return 0;
 }
 
 void command_manager::schedule_and_propagate_downtime(
@@ -396,424 +519,109 @@ void command_manager::schedule_and_propagate_downtime(
   }
 }
 
+/**
+ * @brief Fill the active or passive hosts or services stats from the kept
+ * totals.
+ *
+ * @param type_stats The ServiceTypeStats or HostTypeStats to fill.
+ * @param totals The totals of the active or passive checks.
+ * @param execution_time False if there is no execution time (passive
+ *                       checks).
+ */
+template <typename T>
+static void fill_check_totals(T* type_stats,
+                              status_stats::check_totals const& totals,
+                              bool execution_time) {
+  type_stats->set_min_latency(totals.min_latency);
+  type_stats->set_max_latency(totals.max_latency);
+  type_stats->set_average_latency(totals.average_latency);
+  if (execution_time) {
+    type_stats->set_min_execution_time(totals.min_execution_time);
+    type_stats->set_max_execution_time(totals.max_execution_time);
+    type_stats->set_average_execution_time(totals.average_execution_time);
+  }
+  type_stats->set_min_state_change(totals.min_state_change);
+  type_stats->set_max_state_change(totals.max_state_change);
+  type_stats->set_average_state_change(totals.average_state_change);
+  type_stats->set_checks_last_1min(totals.checks_last[0]);
+  type_stats->set_checks_last_5min(totals.checks_last[1]);
+  type_stats->set_checks_last_15min(totals.checks_last[2]);
+  type_stats->set_checks_last_1hour(totals.checks_last[3]);
+}
+
 int command_manager::get_services_stats(ServicesStats* sstats) {
   time_t now;
   time(&now);
-  uint32_t checked_services = 0;
-  uint32_t scheduled_services = 0;
-  uint32_t actively_checked = 0;
-  uint32_t passively_checked = 0;
-
-  double global_min_state_change = std::numeric_limits<double>::max(),
-         global_max_state_change = std::numeric_limits<double>::min(),
-         global_avg_state_change = 0;
-
-  double active_min_state_change = std::numeric_limits<double>::max(),
-         active_max_state_change = std::numeric_limits<double>::min(),
-         active_avg_state_change = 0;
-
-  double passive_min_state_change = std::numeric_limits<double>::max(),
-         passive_max_state_change = std::numeric_limits<double>::min(),
-         passive_avg_state_change = 0;
-
-  double active_min_latency = std::numeric_limits<double>::max(),
-         active_max_latency = std::numeric_limits<double>::min(),
-         active_avg_latency = 0;
-
-  double passive_min_latency = std::numeric_limits<double>::max(),
-         passive_max_latency = std::numeric_limits<double>::min(),
-         passive_avg_latency = 0;
-
-  double active_min_execution_time = std::numeric_limits<double>::max(),
-         active_max_execution_time = std::numeric_limits<double>::min(),
-         active_avg_execution_time = 0;
-
-  uint32_t active_checks_last_1min = 0, active_checks_last_5min = 0,
-           active_checks_last_15min = 0, active_checks_last_1hour = 0;
-
-  uint32_t passive_checks_last_1min = 0, passive_checks_last_5min = 0,
-           passive_checks_last_15min = 0, passive_checks_last_1hour = 0;
-
-  uint32_t ok = 0, warning = 0, critical = 0, unknown = 0;
-
-  uint32_t downtime = 0, flapping = 0;
-
-  auto min_max_sum = [](double v, double& min, double& max, double& sum) {
-    sum += v;
-    if (v < min)
-      min = v;
-    if (v > max)
-      max = v;
-  };
-
-  for (auto it = service::services_by_id.begin(),
-            end = service::services_by_id.end();
-       it != end; ++it) {
-    service* svc = it->second.get();
-
-    /******************************** GLOBAL **********************************/
-    min_max_sum(svc->get_percent_state_change(), global_min_state_change,
-                global_max_state_change, global_avg_state_change);
-
-    if (svc->has_been_checked())
-      ++checked_services;
-    if (svc->get_should_be_scheduled())
-      ++scheduled_services;
-
-    switch (svc->get_current_state()) {
-      case service::state_ok:
-        ++ok;
-        break;
-      case service::state_warning:
-        ++warning;
-        break;
-      case service::state_critical:
-        ++critical;
-        break;
-      case service::state_unknown:
-        ++unknown;
-        break;
-    }
-
-    if (svc->is_in_downtime())
-      ++downtime;
-    if (svc->get_is_flapping())
-      ++flapping;
-
-    if (svc->get_check_type() == checkable::check_active) {
-      /****************************** ACTIVE **********************************/
-      ++actively_checked;
-      min_max_sum(svc->get_latency(), active_min_latency, active_max_latency,
-                  active_avg_latency);
-
-      min_max_sum(svc->get_execution_time(), active_min_execution_time,
-                  active_max_execution_time, active_avg_execution_time);
-
-      min_max_sum(svc->get_percent_state_change(), active_min_state_change,
-                  active_max_state_change, active_avg_state_change);
-
-      uint32_t time_diff = now - svc->get_last_check();
-      if (time_diff <= 60)
-        ++active_checks_last_1min;
-      if (time_diff <= 300)
-        ++active_checks_last_5min;
-      if (time_diff <= 900)
-        ++active_checks_last_15min;
-      if (time_diff <= 900)
-        ++active_checks_last_1hour;
-
-    } else {
-      /****************************** PASSIVE *********************************/
-      ++passively_checked;
-      min_max_sum(svc->get_latency(), passive_min_latency, passive_max_latency,
-                  passive_avg_latency);
-
-      min_max_sum(svc->get_percent_state_change(), passive_min_state_change,
-                  passive_max_state_change, passive_avg_state_change);
-
-      uint32_t time_diff = now - svc->get_last_check();
-      if (time_diff <= 60)
-        ++passive_checks_last_1min;
-      if (time_diff <= 300)
-        ++passive_checks_last_5min;
-      if (time_diff <= 900)
-        ++passive_checks_last_15min;
-      if (time_diff <= 900)
-        ++passive_checks_last_1hour;
-    }
-  }
-
-  /********************************* SUMMARY **********************************/
-  size_t size = service::services.size();
-  if (size)
-    global_avg_state_change /= size;
-
-  if (actively_checked) {
-    active_avg_state_change /= actively_checked;
-    active_avg_latency /= actively_checked;
-    active_avg_execution_time /= actively_checked;
-  } else {
-    active_min_state_change = active_max_state_change = 0;
-    active_min_latency = active_max_latency = 0;
-  }
-
-  if (passively_checked) {
-    passive_avg_state_change /= passively_checked;
-    passive_avg_latency /= passively_checked;
-  } else {
-    passive_min_state_change = passive_max_state_change = 0;
-    passive_min_latency = passive_max_latency = 0;
-  }
-
-  sstats->set_services_count(size);
-  sstats->set_checked_services(checked_services);
-  sstats->set_scheduled_services(scheduled_services);
-  sstats->set_actively_checked(actively_checked);
-
-  sstats->set_min_state_change(global_min_state_change);
-  sstats->set_max_state_change(global_max_state_change);
-  sstats->set_average_state_change(global_avg_state_change);
-
-  sstats->mutable_active_services()->set_min_latency(active_min_latency);
-  sstats->mutable_active_services()->set_max_latency(active_max_latency);
-  sstats->mutable_active_services()->set_average_latency(active_avg_latency);
-
-  sstats->mutable_active_services()->set_min_execution_time(
-      active_min_execution_time);
-  sstats->mutable_active_services()->set_max_execution_time(
-      active_max_execution_time);
-  sstats->mutable_active_services()->set_average_execution_time(
-      active_avg_execution_time);
-
-  sstats->mutable_active_services()->set_min_state_change(
-      active_min_state_change);
-  sstats->mutable_active_services()->set_max_state_change(
-      active_max_state_change);
-  sstats->mutable_active_services()->set_average_state_change(
-      active_avg_state_change);
-
-  sstats->mutable_active_services()->set_checks_last_1min(
-      active_checks_last_1min);
-  sstats->mutable_active_services()->set_checks_last_5min(
-      active_checks_last_5min);
-  sstats->mutable_active_services()->set_checks_last_15min(
-      active_checks_last_15min);
-  sstats->mutable_active_services()->set_checks_last_1hour(
-      active_checks_last_1hour);
-
-  sstats->mutable_passive_services()->set_min_latency(passive_min_latency);
-  sstats->mutable_passive_services()->set_max_latency(passive_max_latency);
-  sstats->mutable_passive_services()->set_average_latency(passive_avg_latency);
-
-  sstats->mutable_passive_services()->set_min_state_change(
-      passive_min_state_change);
-  sstats->mutable_passive_services()->set_max_state_change(
-      passive_max_state_change);
-  sstats->mutable_passive_services()->set_average_state_change(
-      passive_avg_state_change);
-
-  sstats->mutable_passive_services()->set_checks_last_1min(
-      passive_checks_last_1min);
-  sstats->mutable_passive_services()->set_checks_last_5min(
-      passive_checks_last_5min);
-  sstats->mutable_passive_services()->set_checks_last_15min(
-      passive_checks_last_15min);
-  sstats->mutable_passive_services()->set_checks_last_1hour(
-      passive_checks_last_1hour);
-
-  sstats->set_ok(ok);
-  sstats->set_warning(warning);
-  sstats->set_critical(critical);
-  sstats->set_unknown(unknown);
-
-  sstats->set_flapping(flapping);
-  sstats->set_downtime(downtime);
+  status_stats::totals totals;
+  status_stats::services().get(now, totals);
+
+  sstats->set_services_count(totals.count);
+  sstats->set_checked_services(totals.checked);
+  sstats->set_scheduled_services(totals.scheduled);
+  sstats->set_actively_checked(totals.active.count);
+  sstats->set_passively_checked(totals.passive.count);
+
+  sstats->set_min_state_change(totals.min_state_change);
+  sstats->set_max_state_change(totals.max_state_change);
+  sstats->set_average_state_change(totals.average_state_change);
+
+  fill_check_totals(sstats->mutable_active_services(), totals.active, true);
+  fill_check_totals(sstats->mutable_passive_services(), totals.passive,
+                    false);
+  fill_percentiles(sstats->mutable_active_services(),
+                   checks::stats::active_service_latency,
+                   checks::stats::active_service_execution_time, now);
+  fill_percentiles(sstats->mutable_passive_services(),
+                   checks::stats::passive_service_latency,
+                   checks::stats::timing_max, now);
+
+  sstats->set_ok(totals.states[service::state_ok]);
+  sstats->set_warning(totals.states[service::state_warning]);
+  sstats->set_critical(totals.states[service::state_critical]);
+  sstats->set_unknown(totals.states[service::state_unknown]);
+
+  sstats->set_flapping(totals.flapping);
+  sstats->set_downtime(totals.downtime);
+
+  events::check_scheduler& scheduler = events::check_scheduler::instance();
+  sstats->set_achieved_check_rate(scheduler.achieved_rate(now));
+  sstats->set_configured_check_rate(scheduler.configured_rate());
+  sstats->set_admission_rate(scheduler.admission_rate());
+  sstats->set_ready_checks(events::loop::instance().ready_checks());
   return 0;
 }
 
 int command_manager::get_hosts_stats(HostsStats* hstats) {
   time_t now;
   time(&now);
-  uint32_t checked_hosts = 0;
-  uint32_t scheduled_hosts = 0;
-  uint32_t actively_checked = 0;
-  uint32_t passively_checked = 0;
-
-  double global_min_state_change = std::numeric_limits<double>::max(),
-         global_max_state_change = std::numeric_limits<double>::min(),
-         global_avg_state_change = 0;
-
-  double active_min_state_change = std::numeric_limits<double>::max(),
-         active_max_state_change = std::numeric_limits<double>::min(),
-         active_avg_state_change = 0;
-
-  double passive_min_state_change = std::numeric_limits<double>::max(),
-         passive_max_state_change = std::numeric_limits<double>::min(),
-         passive_avg_state_change = 0;
-
-  double active_min_latency = std::numeric_limits<double>::max(),
-         active_max_latency = std::numeric_limits<double>::min(),
-         active_avg_latency = 0;
-
-  double passive_min_latency = std::numeric_limits<double>::max(),
-         passive_max_latency = std::numeric_limits<double>::min(),
-         passive_avg_latency = 0;
-
-  double active_min_execution_time = std::numeric_limits<double>::max(),
-         active_max_execution_time = std::numeric_limits<double>::min(),
-         active_avg_execution_time = 0;
-
-  uint32_t active_checks_last_1min = 0, active_checks_last_5min = 0,
-           active_checks_last_15min = 0, active_checks_last_1hour = 0;
-
-  uint32_t passive_checks_last_1min = 0, passive_checks_last_5min = 0,
-           passive_checks_last_15min = 0, passive_checks_last_1hour = 0;
-
-  uint32_t up = 0, down = 0, unreachable = 0;
-
-  uint32_t downtime = 0, flapping = 0;
-
-  auto min_max_sum = [](double v, double& min, double& max, double& sum) {
-    sum += v;
-    if (v < min)
-      min = v;
-    if (v > max)
-      max = v;
-  };
-
-  for (auto it = host::hosts_by_id.begin(), end = host::hosts_by_id.end();
-       it != end; ++it) {
-    host* hst = it->second.get();
-
-    /******************************** GLOBAL **********************************/
-    min_max_sum(hst->get_percent_state_change(), global_min_state_change,
-                global_max_state_change, global_avg_state_change);
-
-    if (hst->has_been_checked())
-      ++checked_hosts;
-    if (hst->get_should_be_scheduled())
-      ++scheduled_hosts;
-
-    switch (hst->get_current_state()) {
-      case host::state_up:
-        ++up;
-        break;
-      case host::state_down:
-        ++down;
-        break;
-      case host::state_unreachable:
-        ++unreachable;
-        break;
-    }
-
-    if (hst->is_in_downtime())
-      ++downtime;
-    if (hst->get_is_flapping())
-      ++flapping;
-
-    if (hst->get_check_type() == checkable::check_active) {
-      /****************************** ACTIVE **********************************/
-      ++actively_checked;
-      min_max_sum(hst->get_latency(), active_min_latency, active_max_latency,
-                  active_avg_latency);
-
-      min_max_sum(hst->get_execution_time(), active_min_execution_time,
-                  active_max_execution_time, active_avg_execution_time);
-
-      min_max_sum(hst->get_percent_state_change(), active_min_state_change,
-                  active_max_state_change, active_avg_state_change);
-
-      uint32_t time_diff = now - hst->get_last_check();
-      if (time_diff <= 60)
-        ++active_checks_last_1min;
-      if (time_diff <= 300)
-        ++active_checks_last_5min;
-      if (time_diff <= 900)
-        ++active_checks_last_15min;
-      if (time_diff <= 900)
-        ++active_checks_last_1hour;
-
-    } else {
-      /****************************** PASSIVE *********************************/
-      ++passively_checked;
-      min_max_sum(hst->get_latency(), passive_min_latency, passive_max_latency,
-                  passive_avg_latency);
-
-      min_max_sum(hst->get_percent_state_change(), passive_min_state_change,
-                  passive_max_state_change, passive_avg_state_change);
-
-      uint32_t time_diff = now - hst->get_last_check();
-      if (time_diff <= 60)
-        ++passive_checks_last_1min;
-      if (time_diff <= 300)
-        ++passive_checks_last_5min;
-      if (time_diff <= 900)
-        ++passive_checks_last_15min;
-      if (time_diff <= 900)
-        ++passive_checks_last_1hour;
-    }
-  }
-
-  /********************************* SUMMARY **********************************/
-  size_t size = host::hosts.size();
-  if (size)
-    global_avg_state_change /= size;
-
-  if (actively_checked) {
-    active_avg_state_change /= actively_checked;
-    active_avg_latency /= actively_checked;
-    active_avg_execution_time /= actively_checked;
-  } else {
-    active_min_state_change = active_max_state_change = 0;
-    active_min_latency = active_max_latency = 0;
-  }
-
-  if (passively_checked) {
-    passive_avg_state_change /= passively_checked;
-    passive_avg_latency /= passively_checked;
-  } else {
-    passive_min_state_change = passive_max_state_change = 0;
-    passive_min_latency = passive_max_latency = 0;
-  }
-
-  hstats->set_hosts_count(size);
-  hstats->set_checked_hosts(checked_hosts);
-  hstats->set_scheduled_hosts(scheduled_hosts);
-  hstats->set_actively_checked(actively_checked);
-
-  hstats->set_min_state_change(global_min_state_change);
-  hstats->set_max_state_change(global_max_state_change);
-  hstats->set_average_state_change(global_avg_state_change);
-
-  hstats->mutable_active_hosts()->set_min_latency(active_min_latency);
-  hstats->mutable_active_hosts()->set_max_latency(active_max_latency);
-  hstats->mutable_active_hosts()->set_average_latency(active_avg_latency);
-
-  hstats->mutable_active_hosts()->set_min_execution_time(
-      active_min_execution_time);
-  hstats->mutable_active_hosts()->set_max_execution_time(
-      active_max_execution_time);
-  hstats->mutable_active_hosts()->set_average_execution_time(
-      active_avg_execution_time);
-
-  hstats->mutable_active_hosts()->set_min_state_change(active_min_state_change);
-  hstats->mutable_active_hosts()->set_max_state_change(active_max_state_change);
-  hstats->mutable_active_hosts()->set_average_state_change(
-      active_avg_state_change);
-
-  hstats->mutable_active_hosts()->set_checks_last_1min(active_checks_last_1min);
-  hstats->mutable_active_hosts()->set_checks_last_5min(active_checks_last_5min);
-  hstats->mutable_active_hosts()->set_checks_last_15min(
-      active_checks_last_15min);
-  hstats->mutable_active_hosts()->set_checks_last_1hour(
-      active_checks_last_1hour);
-
-  hstats->mutable_passive_hosts()->set_min_latency(passive_min_latency);
-  hstats->mutable_passive_hosts()->set_max_latency(passive_max_latency);
-  hstats->mutable_passive_hosts()->set_average_latency(passive_avg_latency);
-
-  hstats->mutable_passive_hosts()->set_min_state_change(
-      passive_min_state_change);
-  hstats->mutable_passive_hosts()->set_max_state_change(
-      passive_max_state_change);
-  hstats->mutable_passive_hosts()->set_average_state_change(
-      passive_avg_state_change);
-
-  hstats->mutable_passive_hosts()->set_checks_last_1min(
-      passive_checks_last_1min);
-  hstats->mutable_passive_hosts()->set_checks_last_5min(
-      passive_checks_last_5min);
-  hstats->mutable_passive_hosts()->set_checks_last_15min(
-      passive_checks_last_15min);
-  hstats->mutable_passive_hosts()->set_checks_last_1hour(
-      passive_checks_last_1hour);
-
-  hstats->set_up(up);
-  hstats->set_down(down);
-  hstats->set_unreachable(unreachable);
-
-  hstats->set_flapping(flapping);
-  hstats->set_downtime(downtime);
+  status_stats::totals totals;
+  status_stats::hosts().get(now, totals);
+
+  hstats->set_hosts_count(totals.count);
+  hstats->set_checked_hosts(totals.checked);
+  hstats->set_scheduled_hosts(totals.scheduled);
+  hstats->set_actively_checked(totals.active.count);
+  hstats->set_passively_checked(totals.passive.count);
+
+  hstats->set_min_state_change(totals.min_state_change);
+  hstats->set_max_state_change(totals.max_state_change);
+  hstats->set_average_state_change(totals.average_state_change);
+
+  fill_check_totals(hstats->mutable_active_hosts(), totals.active, true);
+  fill_check_totals(hstats->mutable_passive_hosts(), totals.passive, false);
+  fill_percentiles(hstats->mutable_active_hosts(),
+                   checks::stats::active_host_latency,
+                   checks::stats::active_host_execution_time, now);
+  fill_percentiles(hstats->mutable_passive_hosts(),
+                   checks::stats::passive_host_latency,
+                   checks::stats::timing_max, now);
+
+  hstats->set_up(totals.states[host::state_up]);
+  hstats->set_down(totals.states[host::state_down]);
+  hstats->set_unreachable(totals.states[host::state_unreachable]);
+
+  hstats->set_flapping(totals.flapping);
+  hstats->set_downtime(totals.downtime);
   return 0;
 }
 
@@ -78,6 +78,24 @@ raw::~raw() noexcept {
 uint64_t raw::run(std::string const& processed_cmd,
                   nagios_macros& macros,
                   uint32_t timeout) {
+  // Setup environnement macros if is necessary.
+  environment env;
+  _build_environment_macros(macros, env);
+  return run(processed_cmd, env, timeout);
+}
+
+/**
+ *  Run a command with an environment already built.
+ *
+ *  @param[in] args    The command arguments.
+ *  @param[in] env     The command environment.
+ *  @param[in] timeout The command timeout.
+ *
+ *  @return The command id.
+ */
+uint64_t raw::run(std::string const& processed_cmd,
+                  environment& env,
+                  uint32_t timeout) {
   logger(dbg_commands, basic)
       << "raw::run: cmd='" << processed_cmd << "', timeout=" << timeout;
 
@@ -93,10 +111,6 @@ uint64_t raw::run(std::string const& processed_cmd,
   logger(dbg_commands, basic)
       << "raw::run: id=" << command_id << ", process=" << p;
 
-  // Setup environnement macros if is necessary.
-  environment env;
-  _build_environment_macros(macros, env);
-
   try {
     // Start process.
     p->exec(processed_cmd.c_str(), env.data(), timeout);
@@ -433,6 +447,17 @@ void raw::_build_custom_service_macro_environment(nagios_macros& macros,
   }
 }
 
+/**
+ *  Build the environment of a command that will be run later, when the
+ *  macros will not be available anymore.
+ *
+ *  @param[in,out] macros  The macros data struct.
+ *  @param[out]    env     The environment to fill.
+ */
+void raw::build_environment(nagios_macros& macros, environment& env) {
+  _build_environment_macros(macros, env);
+}
+
 /**
  *  Build all macro environemnt variable.
  *
@@ -0,0 +1,411 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/commands/system_runner.hh"
+
+#include <cassert>
+#include <chrono>
+
+#include "com/centreon/engine/broker.hh"
+#include "com/centreon/engine/commands/raw.hh"
+#include "com/centreon/engine/exceptions/error.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/service.hh"
+#include "com/centreon/engine/utils.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+using namespace com::centreon::engine::logging;
+
+system_runner* system_runner::_instance = nullptr;
+
+/* Commands that would have to wait behind this number of queued ones are
+ * dropped, so that a storm cannot grow the queue without limit. */
+static size_t const max_waiting_commands = 10000;
+
+/**
+ * @brief Get instance of the system_runner singleton.
+ *
+ * @return This singleton.
+ */
+system_runner& system_runner::instance() {
+  /* Like the checker, we need to control when this singleton is destroyed:
+   * running commands have to be waited before the process manager stops. */
+  assert(_instance);
+  return *_instance;
+}
+
+void system_runner::init() {
+  if (!_instance)
+    _instance = new system_runner();
+}
+
+void system_runner::deinit() {
+  if (_instance) {
+    delete _instance;
+    _instance = nullptr;
+  }
+}
+
+/**
+ * @brief Default constructor.
+ */
+system_runner::system_runner()
+    : _raw{new raw("system", "system", this)} {}
+
+/**
+ * @brief Destructor. Commands still running are waited and their callbacks
+ * are called.
+ */
+system_runner::~system_runner() noexcept {
+  try {
+    _wait_all();
+  } catch (std::exception const& e) {
+    logger(log_runtime_warning, basic)
+        << "Warning: cannot wait for running system commands: " << e.what();
+  }
+  _raw.reset();
+}
+
+/**
+ * @brief Tell if commands are run in the background.
+ *
+ * @return true if max_concurrent_system_commands is not 0.
+ */
+bool system_runner::is_async() const noexcept {
+  return config && config->max_parallel_system_commands() > 0;
+}
+
+/**
+ * @brief Run a system command. This method must be called from the main
+ * loop, it never waits for a free slot: the command is queued if the limits
+ * are reached. It throws an exception if the command cannot be started at
+ * once or if too many commands are already queued, in that case the
+ * callback is not called.
+ *
+ * @param mac The macros used to build the command environment.
+ * @param cmd The processed command line.
+ * @param timeout The command timeout in seconds.
+ * @param max_output_length The output is truncated to this size if not 0.
+ * @param cb The function called with the result of the command.
+ * @param group The group of the command, limited to
+ * max_concurrent_notifications_per_command running commands if not empty.
+ */
+void system_runner::run(nagios_macros* mac,
+                        std::string const& cmd,
+                        int timeout,
+                        unsigned int max_output_length,
+                        callback cb,
+                        std::string const& group) {
+  logger(dbg_functions, basic) << "system_runner::run()";
+
+  if (!is_async()) {
+    int early_timeout;
+    double exectime;
+    std::string output;
+    int result = my_system_r(mac, cmd, timeout, &early_timeout, &exectime,
+                             output, max_output_length);
+    cb(result, early_timeout, exectime, output);
+    return;
+  }
+
+  // if no command was passed, return with no error.
+  if (cmd.empty()) {
+    cb(service::state_ok, false, 0.0, "");
+    return;
+  }
+
+  logger(dbg_commands, more) << "Running command '" << cmd
+                             << "' in background...";
+
+  /* Waiting commands go first, this one waits behind them if no slot is
+   * left. */
+  _start_waiting();
+
+  pending p{cmd, group, timeval(), timeout, max_output_length, std::move(cb)};
+  environment env;
+  raw::build_environment(*mac, env);
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_waiting.size() >= max_waiting_commands &&
+        (_running.size() >= config->max_parallel_system_commands() ||
+         _group_is_full(group)))
+      throw engine_error() << max_waiting_commands
+                           << " system commands already queued, command "
+                              "dropped";
+    if (_running.size() >= config->max_parallel_system_commands()) {
+      logger(dbg_commands, more)
+          << "Max concurrent system commands ("
+          << config->max_parallel_system_commands()
+          << ") reached, command queued";
+      _waiting.push_back(waiting{std::move(p), std::move(env)});
+      return;
+    }
+    if (_group_is_full(group)) {
+      logger(dbg_commands, more)
+          << "Max concurrent commands '" << group << "' ("
+          << config->max_parallel_notifications_per_command()
+          << ") reached, command queued";
+      _waiting.push_back(waiting{std::move(p), std::move(env)});
+      return;
+    }
+    if (!group.empty())
+      ++_running_by_group[group];
+  }
+  _start(std::move(p), env);
+}
+
+/**
+ * @brief Call the callbacks of the finished commands. This method must be
+ * called from the main loop.
+ */
+void system_runner::reap() {
+  _start_waiting();
+
+  std::deque<std::pair<pending, result>> done;
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_done.empty())
+      return;
+    std::swap(done, _done);
+  }
+
+  logger(dbg_functions, basic) << "system_runner::reap()";
+
+  for (auto& d : done) {
+    pending& p = d.first;
+    result const& res = d.second;
+
+    timeval end_time;
+    end_time.tv_sec = res.end_time.to_seconds();
+    end_time.tv_usec =
+        res.end_time.to_useconds() - end_time.tv_sec * 1000000ull;
+    double exectime = (res.end_time - res.start_time).to_seconds();
+    bool early_timeout = res.exit_status == process::timeout;
+    std::string output;
+    if (p.max_output_length > 0)
+      output = res.output.substr(0, p.max_output_length - 1);
+    else
+      output = res.output;
+
+    logger(dbg_commands, more) << com::centreon::logging::setprecision(3)
+                               << "Execution time=" << exectime
+                               << " sec, early timeout=" << early_timeout
+                               << ", result=" << res.exit_code
+                               << ", output=" << output;
+
+    // send event broker.
+    broker_system_command(NEBTYPE_SYSTEM_COMMAND_END, NEBFLAG_NONE,
+                          NEBATTR_NONE, p.start_time, end_time, exectime,
+                          p.timeout, early_timeout, res.exit_code,
+                          const_cast<char*>(p.cmd.c_str()),
+                          const_cast<char*>(output.c_str()), nullptr);
+
+    try {
+      p.cb(res.exit_code, early_timeout, exectime, output);
+    } catch (std::exception const& e) {
+      logger(log_runtime_error, basic)
+          << "Error: completion of the command '" << p.cmd
+          << "' failed: " << e.what();
+    }
+  }
+}
+
+/**
+ * @brief Count the commands currently running in the background.
+ *
+ * @return A number.
+ */
+size_t system_runner::running() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _running.size();
+}
+
+/**
+ * @brief Count the commands waiting for a free slot in their group.
+ *
+ * @return A number.
+ */
+size_t system_runner::queued() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _waiting.size();
+}
+
+/**
+ * @brief Called by the process manager thread when a command is over. The
+ * result is stored until the main loop reaps it.
+ *
+ * @param res The command result.
+ */
+void system_runner::finished(result const& res) noexcept {
+  std::lock_guard<std::mutex> lock(_mtx);
+  auto it = _running.find(res.command_id);
+  if (it == _running.end()) {
+    logger(log_runtime_warning, basic)
+        << "Warning: system command " << res.command_id
+        << " finished but was not expected";
+    return;
+  }
+  if (!it->second.group.empty()) {
+    auto group = _running_by_group.find(it->second.group);
+    if (group != _running_by_group.end() && --group->second == 0)
+      _running_by_group.erase(group);
+  }
+  _done.emplace_back(std::move(it->second), res);
+  _running.erase(it);
+  _cv.notify_all();
+}
+
+/**
+ * @brief Report a queued command that could not be started. Its caller has
+ * already returned, so the failure is given to the callback as an unknown
+ * result, after the SYSTEM_COMMAND_END matching the SYSTEM_COMMAND_START
+ * already sent.
+ *
+ * @param p The command.
+ * @param error The error message, used as output.
+ */
+void system_runner::_failed(pending& p, std::string const& error) {
+  timeval end_time;
+  gettimeofday(&end_time, nullptr);
+  std::string output;
+  if (p.max_output_length > 0)
+    output = error.substr(0, p.max_output_length - 1);
+  else
+    output = error;
+
+  broker_system_command(NEBTYPE_SYSTEM_COMMAND_END, NEBFLAG_NONE,
+                        NEBATTR_NONE, p.start_time, end_time, 0.0, p.timeout,
+                        false, service::state_unknown,
+                        const_cast<char*>(p.cmd.c_str()),
+                        const_cast<char*>(output.c_str()), nullptr);
+
+  try {
+    p.cb(service::state_unknown, false, 0.0, output);
+  } catch (std::exception const& e) {
+    logger(log_runtime_error, basic)
+        << "Error: completion of the command '" << p.cmd
+        << "' failed: " << e.what();
+  }
+}
+
+/**
+ * @brief Tell if the group has already its maximum of running commands. The
+ * mutex must be locked.
+ *
+ * @param group The group name.
+ *
+ * @return true if a command of this group has to wait.
+ */
+bool system_runner::_group_is_full(std::string const& group) const {
+  uint32_t limit = config->max_parallel_notifications_per_command();
+  if (group.empty() || limit == 0)
+    return false;
+  auto found = _running_by_group.find(group);
+  return found != _running_by_group.end() && found->second >= limit;
+}
+
+/**
+ * @brief Start a command whose group slot is already taken. On failure, the
+ * slot is released and the exception is forwarded.
+ *
+ * @param p The command to start.
+ * @param env Its environment.
+ */
+void system_runner::_start(pending&& p, environment& env) {
+  gettimeofday(&p.start_time, nullptr);
+
+  // send event broker.
+  broker_system_command(NEBTYPE_SYSTEM_COMMAND_START, NEBFLAG_NONE,
+                        NEBATTR_NONE, p.start_time, timeval(), 0.0, p.timeout,
+                        false, service::state_ok,
+                        const_cast<char*>(p.cmd.c_str()), nullptr, nullptr);
+
+  /* The lock is kept while starting the process so that finished() cannot
+   * look for the command before it is registered. */
+  std::lock_guard<std::mutex> lock(_mtx);
+  try {
+    uint64_t id = _raw->run(p.cmd, env, p.timeout);
+    _running.emplace(id, std::move(p));
+  } catch (...) {
+    if (!p.group.empty()) {
+      auto group = _running_by_group.find(p.group);
+      if (group != _running_by_group.end() && --group->second == 0)
+        _running_by_group.erase(group);
+    }
+    throw;
+  }
+}
+
+/**
+ * @brief Start the waiting commands, in their arrival order, as long as
+ * max_parallel_system_commands is not reached. Commands whose group is full
+ * are left in the queue.
+ */
+void system_runner::_start_waiting() {
+  std::deque<waiting> ready;
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    uint32_t limit = config ? config->max_parallel_system_commands() : 0;
+    size_t used = _running.size();
+    for (auto it = _waiting.begin();
+         it != _waiting.end() && (limit == 0 || used < limit);) {
+      if (_group_is_full(it->p.group))
+        ++it;
+      else {
+        if (!it->p.group.empty())
+          ++_running_by_group[it->p.group];
+        ready.push_back(std::move(*it));
+        it = _waiting.erase(it);
+        ++used;
+      }
+    }
+  }
+
+  for (waiting& w : ready) {
+    try {
+      _start(std::move(w.p), w.env);
+    } catch (std::exception const& e) {
+      logger(log_runtime_error, basic)
+          << "Error: can't execute queued command line '" << w.p.cmd
+          << "' : " << e.what();
+      _failed(w.p, e.what());
+    }
+  }
+}
+
+/**
+ * @brief Wait for all the running and queued commands and call their
+ * callbacks. This is only done when the runner is destroyed, the main loop
+ * is over. Callbacks are called as soon as their command is over, and the
+ * state is checked again every second.
+ */
+void system_runner::_wait_all() {
+  for (;;) {
+    _start_waiting();
+    reap();
+    std::unique_lock<std::mutex> lock(_mtx);
+    if (_running.empty() && _waiting.empty() && _done.empty())
+      break;
+    _cv.wait_for(lock, std::chrono::seconds(1),
+                 [this] { return !_done.empty() || _running.empty(); });
+  }
+}
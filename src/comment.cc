@@ -19,6 +19,7 @@
 */
 
 #include "com/centreon/engine/comment.hh"
+#include <algorithm>
 #include "com/centreon/engine/broker.hh"
 
 using namespace com::centreon::engine;
@@ -57,12 +58,14 @@ comment::comment(comment::type comment_type,
       _host_id{host_id},
       _service_id{service_id},
       _author{author},
-      _comment_data{comment_data} {
+      _comment_data{comment_data},
+      _prev_of_object{nullptr},
+      _next_of_object{nullptr} {
   bool is_added = true;
 
   if (!comment_id) {
     _comment_id = _next_comment_id;
-    _next_comment_id = 1llu;
+    _next_comment_id = comments.first_free_id();
     while (comments.find(_next_comment_id) != comments.end() ||
            _next_comment_id == _comment_id)
       _next_comment_id++;
@@ -109,95 +112,23 @@ bool comment::delete_comment(uint64_t comment_id) {
 }
 
 void comment::delete_host_comments(uint64_t host_id) {
-  comment_map::iterator it(comments.begin());
-
-  while (it != comments.end()) {
-    if (it->second->get_comment_type() == comment::host &&
-        it->second->get_host_id() == host_id) {
-      broker_comment_data(
-          NEBTYPE_COMMENT_DELETE, NEBFLAG_NONE, NEBATTR_NONE,
-          it->second->get_comment_type(), it->second->get_entry_type(),
-          host_id, 0, it->second->get_entry_time(),
-          it->second->get_author().c_str(),
-          it->second->get_comment_data().c_str(), it->second->get_persistent(),
-          it->second->get_source(), it->second->get_expires(),
-          it->second->get_expire_time(), it->first, nullptr);
-      it = comments.erase(it);
-    } else
-      it++;
-  }
+  _delete_object_comments(comment::host, host_id, 0, false);
 }
 
 void comment::delete_service_comments(uint64_t host_id, uint64_t service_id) {
-  comment_map::iterator it(comments.begin());
-
-  while (it != comments.end()) {
-    if (it->second->get_comment_type() == comment::service &&
-        it->second->get_host_id() == host_id &&
-        it->second->get_service_id() == service_id) {
-      broker_comment_data(
-          NEBTYPE_COMMENT_DELETE, NEBFLAG_NONE, NEBATTR_NONE,
-          it->second->get_comment_type(), it->second->get_entry_type(),
-          host_id, service_id,
-          it->second->get_entry_time(), it->second->get_author().c_str(),
-          it->second->get_comment_data().c_str(), it->second->get_persistent(),
-          it->second->get_source(), it->second->get_expires(),
-          it->second->get_expire_time(), it->first, nullptr);
-      it = comments.erase(it);
-    } else
-      it++;
-  }
+  _delete_object_comments(comment::service, host_id, service_id, false);
 }
 
 /* deletes all non-persistent acknowledgement comments for a particular host */
 void comment::delete_host_acknowledgement_comments(engine::host* hst) {
-  comment_map::iterator it(comments.begin());
-
-  while (it != comments.end()) {
-    if (it->second->get_comment_type() == comment::host &&
-        it->second->get_host_id() == hst->get_host_id() &&
-        it->second->get_entry_type() ==
-            com::centreon::engine::comment::acknowledgment &&
-        !it->second->get_persistent()) {
-      broker_comment_data(
-          NEBTYPE_COMMENT_DELETE, NEBFLAG_NONE, NEBATTR_NONE,
-          it->second->get_comment_type(), it->second->get_entry_type(),
-          it->second->get_host_id(), 0,
-          it->second->get_entry_time(), it->second->get_author().c_str(),
-          it->second->get_comment_data().c_str(), it->second->get_persistent(),
-          it->second->get_source(), it->second->get_expires(),
-          it->second->get_expire_time(), it->first, nullptr);
-      it = comments.erase(it);
-    } else
-      it++;
-  }
+  _delete_object_comments(comment::host, hst->get_host_id(), 0, true);
 }
 
 /* deletes all non-persistent acknowledgement comments for a particular service
  */
 void comment::delete_service_acknowledgement_comments(::service* svc) {
-  comment_map::iterator it(comments.begin());
-
-  while (it != comments.end()) {
-    if (it->second->get_comment_type() == comment::service &&
-        it->second->get_host_id() == svc->get_host_id() &&
-        it->second->get_service_id() == svc->get_service_id() &&
-        it->second->get_entry_type() ==
-            com::centreon::engine::comment::acknowledgment &&
-        !it->second->get_persistent()) {
-      broker_comment_data(
-          NEBTYPE_COMMENT_DELETE, NEBFLAG_NONE, NEBATTR_NONE,
-          it->second->get_comment_type(), it->second->get_entry_type(),
-          it->second->get_host_id(),
-          it->second->get_service_id(),
-          it->second->get_entry_time(), it->second->get_author().c_str(),
-          it->second->get_comment_data().c_str(), it->second->get_persistent(),
-          it->second->get_source(), it->second->get_expires(),
-          it->second->get_expire_time(), it->first, nullptr);
-      it = comments.erase(it);
-    } else
-      it++;
-  }
+  _delete_object_comments(comment::service, svc->get_host_id(),
+                          svc->get_service_id(), true);
 }
 
 /* checks for an expired comment (and removes it) */
@@ -209,6 +140,47 @@ void comment::remove_if_expired_comment(uint64_t comment_id) {
     delete_comment(comment_id);
 }
 
+/**
+ *  Delete the comments of a host or of a service, by increasing id as when
+ *  they were all stored in a map.
+ *
+ *  @param[in] comment_type      comment::host or comment::service.
+ *  @param[in] host_id           The host id.
+ *  @param[in] service_id        The service id, 0 for a host.
+ *  @param[in] acknowledgements  Only delete the non-persistent
+ *                               acknowledgement comments.
+ */
+void comment::_delete_object_comments(comment::type comment_type,
+                                      uint64_t host_id,
+                                      uint64_t service_id,
+                                      bool acknowledgements) {
+  std::vector<comment*> found;
+  comments.of_object(host_id, service_id, found);
+  found.erase(std::remove_if(found.begin(), found.end(),
+                             [comment_type, acknowledgements](comment* cmt) {
+                               return cmt->get_comment_type() != comment_type ||
+                                      (acknowledgements &&
+                                       (cmt->get_entry_type() !=
+                                            comment::acknowledgment ||
+                                        cmt->get_persistent()));
+                             }),
+              found.end());
+  std::sort(found.begin(), found.end(), [](comment* a, comment* b) {
+    return a->get_comment_id() < b->get_comment_id();
+  });
+
+  for (comment* cmt : found) {
+    broker_comment_data(
+        NEBTYPE_COMMENT_DELETE, NEBFLAG_NONE, NEBATTR_NONE,
+        cmt->get_comment_type(), cmt->get_entry_type(), host_id, service_id,
+        cmt->get_entry_time(), cmt->get_author().c_str(),
+        cmt->get_comment_data().c_str(), cmt->get_persistent(),
+        cmt->get_source(), cmt->get_expires(), cmt->get_expire_time(),
+        cmt->get_comment_id(), nullptr);
+    comments.erase(cmt->get_comment_id());
+  }
+}
+
 comment::type comment::get_comment_type() const {
   return _comment_type;
 }
@@ -339,3 +311,178 @@ std::ostream& operator<<(std::ostream& os, comment const& obj) {
         "}\n";
   return (os);
 }
+
+/**
+ *  Constructor.
+ */
+comment_store::comment_store() : _free_hint{1} {}
+
+/**
+ *  Get the first comment, by id.
+ *
+ *  @return An iterator.
+ */
+comment_store::iterator comment_store::begin() const noexcept {
+  return _comments.begin();
+}
+
+/**
+ *  Remove all the comments.
+ */
+void comment_store::clear() noexcept {
+  _free_hint = 1;
+  _by_object.clear();
+  _comments.clear();
+}
+
+/**
+ *  Tell if there is no comment.
+ *
+ *  @return True if the store is empty.
+ */
+bool comment_store::empty() const noexcept {
+  return _comments.empty();
+}
+
+/**
+ *  Get the end of the comments.
+ *
+ *  @return An iterator.
+ */
+comment_store::iterator comment_store::end() const noexcept {
+  return _comments.end();
+}
+
+/**
+ *  Remove a comment.
+ *
+ *  @param[in] it  The comment.
+ *
+ *  @return The next comment.
+ */
+comment_store::iterator comment_store::erase(iterator it) {
+  _free_hint = std::min(_free_hint, it->first);
+  if (it->second)
+    _unlink(it->second.get());
+  return _comments.erase(it);
+}
+
+/**
+ *  Remove a comment.
+ *
+ *  @param[in] comment_id  The comment id.
+ *
+ *  @return 1 if the comment was removed, 0 if it does not exist.
+ */
+size_t comment_store::erase(uint64_t comment_id) {
+  iterator it(_comments.find(comment_id));
+  if (it == _comments.end())
+    return 0;
+  erase(it);
+  return 1;
+}
+
+/**
+ *  Find a comment.
+ *
+ *  @param[in] comment_id  The comment id.
+ *
+ *  @return An iterator, end() if the comment does not exist.
+ */
+comment_store::iterator comment_store::find(uint64_t comment_id) const {
+  return _comments.find(comment_id);
+}
+
+/**
+ *  Get the smallest id not used by a comment. Ids are given from 1, so only
+ *  the ids above the last removed one are looked at.
+ *
+ *  @return An id.
+ */
+uint64_t comment_store::first_free_id() {
+  while (_comments.find(_free_hint) != _comments.end())
+    ++_free_hint;
+  return _free_hint;
+}
+
+/**
+ *  Add a comment, unless a comment already has its id.
+ *
+ *  @param[in] value  The comment id and the comment.
+ *
+ *  @return The comment with this id, and true if it was added.
+ */
+std::pair<comment_store::iterator, bool> comment_store::insert(
+    value_type const& value) {
+  std::pair<iterator, bool> retval(_comments.insert(value));
+  comment* cmt(value.second.get());
+  if (retval.second && cmt) {
+    comment*& first(_by_object[_key(cmt)]);
+    cmt->_prev_of_object = nullptr;
+    cmt->_next_of_object = first;
+    if (first)
+      first->_prev_of_object = cmt;
+    first = cmt;
+  }
+  return retval;
+}
+
+/**
+ *  Get the comments of a host, or of a service, in no particular order.
+ *
+ *  @param[in]  host_id     The host id.
+ *  @param[in]  service_id  The service id, 0 for a host.
+ *  @param[out] comments    The comments.
+ */
+void comment_store::of_object(uint64_t host_id,
+                              uint64_t service_id,
+                              std::vector<comment*>& comments) const {
+  std::unordered_map<object_key, comment*, object_hash>::const_iterator it(
+      _by_object.find({host_id, service_id}));
+  if (it != _by_object.end())
+    for (comment* cmt = it->second; cmt; cmt = cmt->_next_of_object)
+      comments.push_back(cmt);
+}
+
+/**
+ *  Get the number of comments.
+ *
+ *  @return A number.
+ */
+size_t comment_store::size() const noexcept {
+  return _comments.size();
+}
+
+/**
+ *  Get the key of the comment list of a comment.
+ *
+ *  @param[in] cmt  The comment.
+ *
+ *  @return The host id, and the service id for a service comment.
+ */
+comment_store::object_key comment_store::_key(comment const* cmt) noexcept {
+  return {cmt->get_host_id(),
+          cmt->get_comment_type() == comment::host ? 0 : cmt->get_service_id()};
+}
+
+/**
+ *  Remove a comment from the list of its host or service.
+ *
+ *  @param[in] cmt  The comment.
+ */
+void comment_store::_unlink(comment* cmt) noexcept {
+  if (cmt->_prev_of_object)
+    cmt->_prev_of_object->_next_of_object = cmt->_next_of_object;
+  else {
+    std::unordered_map<object_key, comment*, object_hash>::iterator it(
+        _by_object.find(_key(cmt)));
+    if (cmt->_next_of_object)
+      it->second = cmt->_next_of_object;
+    else
+      _by_object.erase(it);
+  }
+  if (cmt->_next_of_object)
+    cmt->_next_of_object->_prev_of_object = cmt->_prev_of_object;
+  cmt->_prev_of_object = nullptr;
+  cmt->_next_of_object = nullptr;
+}
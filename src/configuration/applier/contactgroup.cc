@@ -95,7 +95,7 @@ void applier::contactgroup::add_object(configuration::contactgroup const& obj) {
       throw engine_error() << "Error: Cannot resolve contact group "
                            << obj.contactgroup_name() << "'";
     } else {
-      cg->get_members().insert({ct_it->first, ct_it->second.get()});
+      cg->add_member(ct_it->second.get());
       timeval tv(get_broker_timestamp(nullptr));
       broker_group(NEBTYPE_CONTACTGROUP_ADD, NEBFLAG_NONE, NEBATTR_NONE,
                    cg.get(), &tv);
@@ -176,8 +176,7 @@ void applier::contactgroup::modify_object(
         throw engine_error() << "Error: Cannot resolve contact group "
                              << obj.contactgroup_name() << "'";
       } else {
-        it_obj->second->get_members().insert(
-            {ct_it->first, ct_it->second.get()});
+        it_obj->second->add_member(ct_it->second.get());
         timeval tv(get_broker_timestamp(nullptr));
         broker_group(NEBTYPE_CONTACTGROUP_ADD, NEBFLAG_NONE, NEBATTR_NONE,
                      it_obj->second.get(), &tv);
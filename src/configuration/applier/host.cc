@@ -29,6 +29,7 @@
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
 #include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/host_graph.hh"
 
 using namespace com::centreon;
 using namespace com::centreon::engine;
@@ -387,6 +388,7 @@ void applier::host::modify_object(configuration::host const& obj) {
                              &tv);
     }
     it_obj->second->parent_hosts.clear();
+    host_graph::instance().invalidate();
 
     // Create parents.
     for (set_string::const_iterator it(obj.parents().begin()),
@@ -21,6 +21,8 @@
 #include <syslog.h>
 #include <cassert>
 #include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/logging/async_file.hh"
+#include "com/centreon/engine/logging/broker.hh"
 #include "com/centreon/engine/logging/debug_file.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/logging/engine.hh"
@@ -37,6 +39,11 @@ void applier::logging::apply(state& config) {
   if (verify_config || test_scheduling)
     return;
 
+  // Asynchronous log files are created again when this option changes.
+  bool async_changed(config.log_async() != _async);
+  _async = config.log_async();
+  engine::logging::broker::batch(_async);
+
   // Syslog.
   if (config.use_syslog() && !_syslog)
     _add_syslog();
@@ -46,7 +53,7 @@ void applier::logging::apply(state& config) {
   // Standard log file.
   if (config.log_file() == "")
     _del_log_file();
-  else if (!_log || config.log_file() != _log->filename()) {
+  else if (!_log || config.log_file() != _log_file || async_changed) {
     _add_log_file(config);
     _del_stdout();
     _del_stderr();
@@ -59,7 +66,7 @@ void applier::logging::apply(state& config) {
     _debug_level = config.debug_level();
     _debug_verbosity = config.debug_verbosity();
     _debug_max_size = config.max_debug_file_size();
-  } else if (!_debug || config.debug_file() != _debug->filename() ||
+  } else if (!_debug || config.debug_file() != _debug_file || async_changed ||
              config.debug_level() != _debug_level ||
              config.debug_verbosity() != _debug_verbosity ||
              config.max_debug_file_size() != _debug_max_size)
@@ -83,6 +90,8 @@ void applier::logging::clear() {
   _del_log_file();
   _del_debug();
 
+  _async = false;
+  engine::logging::broker::batch(false);
   _debug = nullptr;
   _debug_level = 0;
   _debug_max_size = 0;
@@ -99,7 +108,8 @@ void applier::logging::clear() {
  *  Default constructor.
  */
 applier::logging::logging()
-    : _debug(NULL),
+    : _async(false),
+      _debug(NULL),
       _debug_level(0),
       _debug_max_size(0),
       _debug_verbosity(0),
@@ -117,7 +127,8 @@ applier::logging::logging()
  *  @param[in] config The initial confiuration.
  */
 applier::logging::logging(state& config)
-    : _debug(NULL),
+    : _async(false),
+      _debug(NULL),
       _debug_level(0),
       _debug_max_size(0),
       _debug_verbosity(0),
@@ -164,6 +175,7 @@ void applier::logging::_add_stdout() {
         engine::logging::log_service_notification);
     com::centreon::logging::engine::instance().add(_stdout, type,
                                                    engine::logging::most);
+    engine::logging::mask::update();
   }
 }
 
@@ -177,6 +189,7 @@ void applier::logging::_add_stderr() {
                             engine::logging::log_runtime_warning);
     com::centreon::logging::engine::instance().add(_stderr, type,
                                                    engine::logging::most);
+    engine::logging::mask::update();
   }
 }
 /**
@@ -188,6 +201,7 @@ void applier::logging::_add_syslog() {
         new com::centreon::logging::syslogger("centreon-engine", LOG_USER);
     com::centreon::logging::engine::instance().add(
         _syslog, engine::logging::log_all, engine::logging::basic);
+    engine::logging::mask::update();
   }
 }
 
@@ -196,10 +210,15 @@ void applier::logging::_add_syslog() {
  */
 void applier::logging::_add_log_file(state const& config) {
   _del_log_file();
-  _log = new com::centreon::logging::file(config.log_file(), true,
-                                          config.log_pid());
+  if (_async)
+    _log = new engine::logging::async_file(config.log_file(), config.log_pid());
+  else
+    _log = new com::centreon::logging::file(config.log_file(), true,
+                                            config.log_pid());
+  _log_file = config.log_file();
   com::centreon::logging::engine::instance().add(_log, engine::logging::log_all,
                                                  engine::logging::most);
+  engine::logging::mask::update();
 }
 
 /**
@@ -210,10 +229,21 @@ void applier::logging::_add_debug(state const& config) {
   _debug_level = (config.debug_level() << 32) | engine::logging::log_all;
   _debug_verbosity = config.debug_verbosity();
   _debug_max_size = config.max_debug_file_size();
-  _debug = new com::centreon::engine::logging::debug_file(config.debug_file(),
-                                                          _debug_max_size);
+  if (_async)
+    _debug = new engine::logging::async_file(config.debug_file(), true,
+                                             _debug_max_size);
+  else
+    _debug = new engine::logging::debug_file(config.debug_file(),
+                                             _debug_max_size);
+  _debug_file = config.debug_file();
   com::centreon::logging::engine::instance().add(_debug, _debug_level,
                                                  _debug_verbosity);
+  engine::logging::mask::update();
+#ifdef CCE_NO_DEBUG_LOGS
+  logger(engine::logging::log_config_warning, engine::logging::basic)
+      << "Warning: this engine is built without debug logs, only the "
+         "standard logs are written in the debug file";
+#endif  // CCE_NO_DEBUG_LOGS
 }
 
 /**
@@ -222,6 +252,7 @@ void applier::logging::_add_debug(state const& config) {
 void applier::logging::_del_syslog() {
   if (_syslog) {
     com::centreon::logging::engine::instance().remove(_syslog);
+    engine::logging::mask::update();
     delete _syslog;
     _syslog = NULL;
   }
@@ -233,6 +264,7 @@ void applier::logging::_del_syslog() {
 void applier::logging::_del_log_file() {
   if (_log) {
     com::centreon::logging::engine::instance().remove(_log);
+    engine::logging::mask::update();
     delete _log;
     _log = NULL;
   }
@@ -244,6 +276,7 @@ void applier::logging::_del_log_file() {
 void applier::logging::_del_debug() {
   if (_debug) {
     com::centreon::logging::engine::instance().remove(_debug);
+    engine::logging::mask::update();
     delete _debug;
     _debug = NULL;
   }
@@ -255,6 +288,7 @@ void applier::logging::_del_debug() {
 void applier::logging::_del_stdout() {
   if (_stdout) {
     com::centreon::logging::engine::instance().remove(_stdout);
+    engine::logging::mask::update();
     delete _stdout;
     _stdout = NULL;
   }
@@ -266,6 +300,7 @@ void applier::logging::_del_stdout() {
 void applier::logging::_del_stderr() {
   if (_stderr) {
     com::centreon::logging::engine::instance().remove(_stderr);
+    engine::logging::mask::update();
     delete _stderr;
     _stderr = NULL;
   }
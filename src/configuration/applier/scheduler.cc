@@ -18,13 +18,16 @@
 */
 
 #include "com/centreon/engine/configuration/applier/scheduler.hh"
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
+#include <unordered_set>
 #include "com/centreon/engine/configuration/applier/difference.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/deleter/listmember.hh"
-#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/events/check_placement.hh"
+#include "com/centreon/engine/events/check_scheduler.hh"
 #include "com/centreon/engine/events/loop.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
@@ -200,6 +203,11 @@ void applier::scheduler::apply(
       _schedule_service_events(new_services);
     }
   }
+
+  // Index the objects for the freshness and orphan checks, with the new
+  // settings and the retained states.
+  engine::host::rebuild_check_deadlines();
+  engine::service::rebuild_check_deadlines();
 }
 
 /**
@@ -598,6 +606,7 @@ void applier::scheduler::_calculate_service_inter_check_delay(
       // the user specified a delay, so don't try to calculate one.
       break;
 
+    case configuration::state::icd_even:
     case configuration::state::icd_smart:
     default:
       // be smart and calculate the best delay to use to
@@ -843,6 +852,104 @@ applier::scheduler::_get_anomalydetections(set_anomalydetection const& ad_cfg,
   return retval;
 }
 
+/**
+ *  Spread the first checks of services with the check placement, according
+ *  to the execution times measured for their commands or kept in the
+ *  retention. Services already scheduled and not in the list are taken into
+ *  account, so that on reload the new checks fill the gaps. Those starting
+ *  in an overloaded second are placed again and their check is rescheduled.
+ *
+ *  @param[in] services  The services to schedule.
+ *  @param[in] now       The current time.
+ */
+void applier::scheduler::_place_service_checks(
+    std::vector<engine::service*> const& services,
+    time_t now) {
+  events::check_scheduler& measures(events::check_scheduler::instance());
+  uint32_t const interval_length(_config->interval_length());
+
+  std::unordered_set<engine::service const*> to_place;
+  uint32_t horizon(0);
+  for (engine::service* svc : services) {
+    if (svc->get_execution_time() > 0)
+      measures.seed_execution_time(svc, svc->get_execution_time());
+    if (svc->get_should_be_scheduled()) {
+      to_place.insert(svc);
+      horizon = std::max(horizon, svc->get_check_interval() * interval_length);
+    }
+  }
+
+  events::check_placement placement(
+      horizon, scheduling_info.max_service_check_spread * 60);
+  std::vector<std::pair<engine::service*, size_t> > scheduled;
+  for (service_id_map::const_iterator
+           it(engine::service::services_by_id.begin()),
+       end(engine::service::services_by_id.end());
+       it != end; ++it) {
+    engine::service* svc(it->second.get());
+    if (svc->get_should_be_scheduled() && !to_place.count(svc) &&
+        svc->get_next_check() >= now)
+      scheduled.emplace_back(
+          svc, placement.add_scheduled(
+                   svc->get_check_interval() * interval_length,
+                   svc->get_next_check() - now,
+                   measures.expected_execution_time(svc)));
+  }
+
+  std::vector<std::pair<engine::service*, size_t> > placed;
+  placed.reserve(to_place.size());
+  for (engine::service* svc : services)
+    if (svc->get_should_be_scheduled())
+      placed.emplace_back(
+          svc, placement.add(svc->get_check_interval() * interval_length,
+                             measures.expected_execution_time(svc)));
+  placement.place();
+
+  // Move the checks of the services already scheduled that were placed
+  // again, they are scheduled with the other services otherwise.
+  size_t const new_checks(placed.size());
+  for (std::pair<engine::service*, size_t> const& p : scheduled)
+    if (placement.moved(p.second))
+      placed.push_back(p);
+
+  for (size_t i(0); i < placed.size(); ++i) {
+    engine::service& svc(*placed[i].first);
+    svc.set_next_check(now + placement.phase(placed[i].second));
+
+    // Make sure the service can actually be scheduled when we want.
+    {
+      timezone_locker lock(svc.get_timezone());
+      if (!check_time_against_period(svc.get_next_check(),
+                                     svc.check_period_ptr)) {
+        time_t next_valid_time(0);
+        get_next_valid_time(svc.get_next_check(), &next_valid_time,
+                            svc.check_period_ptr);
+        svc.set_next_check(next_valid_time);
+      }
+    }
+
+    if (!scheduling_info.first_service_check ||
+        svc.get_next_check() < scheduling_info.first_service_check)
+      scheduling_info.first_service_check = svc.get_next_check();
+    if (svc.get_next_check() > scheduling_info.last_service_check)
+      scheduling_info.last_service_check = svc.get_next_check();
+
+    if (i >= new_checks) {
+      events::loop::instance().remove_events(
+          events::loop::low, timed_event::EVENT_SERVICE_CHECK, &svc);
+      timed_event* evt(new timed_event(
+          timed_event::EVENT_SERVICE_CHECK, svc.get_next_check(), false, 0,
+          nullptr, true, (void*)&svc, nullptr, svc.get_check_options()));
+      events::loop::instance().schedule(evt, false);
+    }
+  }
+
+  logger(dbg_events, more) << "Placed " << new_checks
+                           << " service checks and moved "
+                           << placed.size() - new_checks
+                           << " over " << placement.horizon() << " sec";
+}
+
 /**
  *  Remove misc event.
  *
@@ -982,7 +1089,10 @@ void applier::scheduler::_schedule_service_events(
   int current_interleave_block(0);
   unsigned int const end(services.size());
 
-  if (scheduling_info.service_interleave_factor > 0) {
+  if (_config->service_inter_check_delay_method() ==
+      configuration::state::icd_even)
+    _place_service_checks(services, now);
+  else if (scheduling_info.service_interleave_factor > 0) {
     int interleave_block_index(0);
     for (unsigned int i(0); i < end; ++i) {
       engine::service& svc(*services[i]);
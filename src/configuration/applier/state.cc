@@ -47,13 +47,16 @@
 #include "com/centreon/engine/configuration/applier/servicegroup.hh"
 #include "com/centreon/engine/configuration/applier/timeperiod.hh"
 #include "com/centreon/engine/configuration/command.hh"
+#include "com/centreon/engine/dependency_index.hh"
 #include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging.hh"
 #include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/nebmods.hh"
 #include "com/centreon/engine/objects.hh"
 #include "com/centreon/engine/retention/applier/state.hh"
 #include "com/centreon/engine/retention/state.hh"
+#include "com/centreon/engine/snapshot.hh"
 #include "com/centreon/engine/version.hh"
 #include "com/centreon/engine/xpddefault.hh"
 #include "com/centreon/engine/xsddefault.hh"
@@ -366,6 +369,7 @@ void applier::state::_apply(configuration::state const& new_cfg) {
   config->illegal_object_chars(new_cfg.illegal_object_chars());
   config->illegal_output_chars(new_cfg.illegal_output_chars());
   config->interval_length(new_cfg.interval_length());
+  config->log_async(new_cfg.log_async());
   config->log_event_handlers(new_cfg.log_event_handlers());
   config->log_external_commands(new_cfg.log_external_commands());
   config->log_file(new_cfg.log_file());
@@ -379,7 +383,10 @@ void applier::state::_apply(configuration::state const& new_cfg) {
   config->max_debug_file_size(new_cfg.max_debug_file_size());
   config->max_host_check_spread(new_cfg.max_host_check_spread());
   config->max_log_file_size(new_cfg.max_log_file_size());
+  config->max_parallel_notifications_per_command(
+      new_cfg.max_parallel_notifications_per_command());
   config->max_parallel_service_checks(new_cfg.max_parallel_service_checks());
+  config->max_parallel_system_commands(new_cfg.max_parallel_system_commands());
   config->max_service_check_spread(new_cfg.max_service_check_spread());
   config->notification_timeout(new_cfg.notification_timeout());
   config->obsess_over_hosts(new_cfg.obsess_over_hosts());
@@ -419,13 +426,18 @@ void applier::state::_apply(configuration::state const& new_cfg) {
   config->service_perfdata_file_template(
       new_cfg.service_perfdata_file_template());
   config->sleep_time(new_cfg.sleep_time());
-  config->soft_state_dependencies(new_cfg.soft_state_dependencies());
+  if (config->soft_state_dependencies() != new_cfg.soft_state_dependencies()) {
+    config->soft_state_dependencies(new_cfg.soft_state_dependencies());
+    dependency_index::hosts().invalidate();
+    dependency_index::services().invalidate();
+  }
   config->state_retention_file(new_cfg.state_retention_file());
   config->status_file(new_cfg.status_file());
   config->status_update_interval(new_cfg.status_update_interval());
   config->time_change_threshold(new_cfg.time_change_threshold());
   config->translate_passive_host_checks(
       new_cfg.translate_passive_host_checks());
+  config->use_adaptive_check_scheduler(new_cfg.use_adaptive_check_scheduler());
   config->use_large_installation_tweaks(
       new_cfg.use_large_installation_tweaks());
   config->instance_heartbeat_interval(new_cfg.instance_heartbeat_interval());
@@ -1044,6 +1056,9 @@ void applier::state::_processing(configuration::state& new_cfg,
   // Timing.
   struct timeval tv[5];
 
+  // Batched broker events point to objects that may be removed.
+  neb_flush_batches(0);
+
   // Call prelauch broker event the first time to run applier state.
   if (!has_already_been_loaded)
     broker_program_state(NEBTYPE_PROCESS_PRELAUNCH, NEBFLAG_NONE, NEBATTR_NONE,
@@ -1316,6 +1331,9 @@ void applier::state::_processing(configuration::state& new_cfg,
     // Check for circular paths between hosts.
     pre_flight_circular_check(&config_warnings, &config_errors);
 
+    // Groups may have changed, snapshot lookup tables must be rebuilt.
+    snapshot::instance().invalidate();
+
     // Call start broker event the first time to run applier state.
     if (!has_already_been_loaded) {
       neb_load_all_modules();
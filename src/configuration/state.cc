@@ -133,6 +133,7 @@ std::unordered_map<std::string, state::setter_func> const state::_setters{
     {"interval_length", SETTER(unsigned int, interval_length)},
     {"lock_file", SETTER(std::string const&, _set_lock_file)},
     {"log_archive_path", SETTER(std::string const&, _set_log_archive_path)},
+    {"log_async", SETTER(bool, log_async)},
     {"log_event_handlers", SETTER(bool, log_event_handlers)},
     {"log_external_commands", SETTER(bool, log_external_commands)},
     {"log_file", SETTER(std::string const&, log_file)},
@@ -151,6 +152,10 @@ std::unordered_map<std::string, state::setter_func> const state::_setters{
      SETTER(unsigned int, max_check_reaper_time)},
     {"max_concurrent_checks",
      SETTER(unsigned int, max_parallel_service_checks)},
+    {"max_concurrent_notifications_per_command",
+     SETTER(unsigned int, max_parallel_notifications_per_command)},
+    {"max_concurrent_system_commands",
+     SETTER(unsigned int, max_parallel_system_commands)},
     {"max_debug_file_size", SETTER(unsigned long, max_debug_file_size)},
     {"max_host_check_spread", SETTER(unsigned int, max_host_check_spread)},
     {"max_log_file_size", SETTER(unsigned long, max_log_file_size)},
@@ -224,6 +229,8 @@ std::unordered_map<std::string, state::setter_func> const state::_setters{
     {"time_change_threshold", SETTER(unsigned int, time_change_threshold)},
     {"translate_passive_host_checks",
      SETTER(bool, translate_passive_host_checks)},
+    {"use_adaptive_check_scheduler",
+     SETTER(bool, use_adaptive_check_scheduler)},
     {"use_aggressive_host_checking",
      SETTER(bool, use_aggressive_host_checking)},
     {"use_agressive_host_checking", SETTER(bool, use_aggressive_host_checking)},
@@ -300,6 +307,7 @@ static std::string const default_host_perfdata_file_template(
 static std::string const default_illegal_object_chars("");
 static std::string const default_illegal_output_chars("`~$&|'\"<>");
 static unsigned int const default_interval_length(60);
+static bool const default_log_async(false);
 static bool const default_log_event_handlers(true);
 static bool const default_log_external_commands(true);
 static std::string const default_log_file(DEFAULT_LOG_FILE);
@@ -314,7 +322,9 @@ static unsigned int const default_max_check_reaper_time(30);
 static unsigned long const default_max_debug_file_size(1000000);
 static unsigned int const default_max_host_check_spread(5);
 static unsigned long const default_max_log_file_size(0);
+static unsigned int const default_max_parallel_notifications_per_command(0);
 static unsigned int const default_max_parallel_service_checks(0);
+static unsigned int const default_max_parallel_system_commands(0);
 static unsigned int const default_max_service_check_spread(5);
 static unsigned int const default_notification_timeout(30);
 static bool const default_obsess_over_hosts(false);
@@ -353,6 +363,7 @@ static std::string const default_status_file(DEFAULT_STATUS_FILE);
 static unsigned int const default_status_update_interval(60);
 static unsigned int const default_time_change_threshold(900);
 static bool const default_translate_passive_host_checks(false);
+static bool const default_use_adaptive_check_scheduler(false);
 static bool const default_use_large_installation_tweaks(false);
 static uint32_t const default_instance_heartbeat_interval(30);
 static bool const default_use_regexp_matches(false);
@@ -420,6 +431,7 @@ state::state()
       _illegal_object_chars(default_illegal_object_chars),
       _illegal_output_chars(default_illegal_output_chars),
       _interval_length(default_interval_length),
+      _log_async(default_log_async),
       _log_event_handlers(default_log_event_handlers),
       _log_external_commands(default_log_external_commands),
       _log_file(default_log_file),
@@ -434,7 +446,10 @@ state::state()
       _max_debug_file_size(default_max_debug_file_size),
       _max_host_check_spread(default_max_host_check_spread),
       _max_log_file_size(default_max_log_file_size),
+      _max_parallel_notifications_per_command(
+          default_max_parallel_notifications_per_command),
       _max_parallel_service_checks(default_max_parallel_service_checks),
+      _max_parallel_system_commands(default_max_parallel_system_commands),
       _max_service_check_spread(default_max_service_check_spread),
       _notification_timeout(default_notification_timeout),
       _obsess_over_hosts(default_obsess_over_hosts),
@@ -477,6 +492,7 @@ state::state()
       _status_update_interval(default_status_update_interval),
       _time_change_threshold(default_time_change_threshold),
       _translate_passive_host_checks(default_translate_passive_host_checks),
+      _use_adaptive_check_scheduler(default_use_adaptive_check_scheduler),
       _use_large_installation_tweaks(default_use_large_installation_tweaks),
       _instance_heartbeat_interval(default_instance_heartbeat_interval),
       _use_regexp_matches(default_use_regexp_matches),
@@ -576,6 +592,7 @@ state& state::operator=(state const& right) {
     _illegal_object_chars = right._illegal_object_chars;
     _illegal_output_chars = right._illegal_output_chars;
     _interval_length = right._interval_length;
+    _log_async = right._log_async;
     _log_event_handlers = right._log_event_handlers;
     _log_external_commands = right._log_external_commands;
     _log_file = right._log_file;
@@ -591,7 +608,10 @@ state& state::operator=(state const& right) {
     _max_debug_file_size = right._max_debug_file_size;
     _max_host_check_spread = right._max_host_check_spread;
     _max_log_file_size = right._max_log_file_size;
+    _max_parallel_notifications_per_command =
+        right._max_parallel_notifications_per_command;
     _max_parallel_service_checks = right._max_parallel_service_checks;
+    _max_parallel_system_commands = right._max_parallel_system_commands;
     _max_service_check_spread = right._max_service_check_spread;
     _notification_timeout = right._notification_timeout;
     _obsess_over_hosts = right._obsess_over_hosts;
@@ -641,6 +661,7 @@ state& state::operator=(state const& right) {
     _time_change_threshold = right._time_change_threshold;
     _translate_passive_host_checks = right._translate_passive_host_checks;
     _users = right._users;
+    _use_adaptive_check_scheduler = right._use_adaptive_check_scheduler;
     _use_large_installation_tweaks = right._use_large_installation_tweaks;
     _use_regexp_matches = right._use_regexp_matches;
     _use_retained_program_state = right._use_retained_program_state;
@@ -726,6 +747,7 @@ bool state::operator==(state const& right) const noexcept {
       _illegal_object_chars == right._illegal_object_chars &&
       _illegal_output_chars == right._illegal_output_chars &&
       _interval_length == right._interval_length &&
+      _log_async == right._log_async &&
       _log_event_handlers == right._log_event_handlers &&
       _log_external_commands == right._log_external_commands &&
       _log_file == right._log_file &&
@@ -741,7 +763,10 @@ bool state::operator==(state const& right) const noexcept {
       _max_debug_file_size == right._max_debug_file_size &&
       _max_host_check_spread == right._max_host_check_spread &&
       _max_log_file_size == right._max_log_file_size &&
+      _max_parallel_notifications_per_command ==
+          right._max_parallel_notifications_per_command &&
       _max_parallel_service_checks == right._max_parallel_service_checks &&
+      _max_parallel_system_commands == right._max_parallel_system_commands &&
       _max_service_check_spread == right._max_service_check_spread &&
       _notification_timeout == right._notification_timeout &&
       _obsess_over_hosts == right._obsess_over_hosts &&
@@ -793,6 +818,7 @@ bool state::operator==(state const& right) const noexcept {
       _time_change_threshold == right._time_change_threshold &&
       _translate_passive_host_checks == right._translate_passive_host_checks &&
       _users == right._users &&
+      _use_adaptive_check_scheduler == right._use_adaptive_check_scheduler &&
       _use_large_installation_tweaks == right._use_large_installation_tweaks &&
       _use_regexp_matches == right._use_regexp_matches &&
       _use_retained_program_state == right._use_retained_program_state &&
@@ -2225,6 +2251,24 @@ void state::interval_length(unsigned int value) {
     _interval_length = value;
 }
 
+/**
+ *  Get log_async value.
+ *
+ *  @return The log_async value.
+ */
+bool state::log_async() const noexcept {
+  return _log_async;
+}
+
+/**
+ *  Set log_async value.
+ *
+ *  @param[in] value The new log_async value.
+ */
+void state::log_async(bool value) {
+  _log_async = value;
+}
+
 /**
  *  Get log_event_handlers value.
  *
@@ -2487,6 +2531,25 @@ void state::max_log_file_size(unsigned long value) {
   _max_log_file_size = value;
 }
 
+/**
+ *  Get max_parallel_notifications_per_command value.
+ *
+ *  @return The max_parallel_notifications_per_command value.
+ */
+unsigned int state::max_parallel_notifications_per_command() const noexcept {
+  return _max_parallel_notifications_per_command;
+}
+
+/**
+ *  Set max_parallel_notifications_per_command value. 0 means no limit other
+ *  than max_parallel_system_commands.
+ *
+ *  @param[in] value The new max_parallel_notifications_per_command value.
+ */
+void state::max_parallel_notifications_per_command(unsigned int value) {
+  _max_parallel_notifications_per_command = value;
+}
+
 /**
  *  Get max_parallel_service_checks value.
  *
@@ -2505,6 +2568,26 @@ void state::max_parallel_service_checks(unsigned int value) {
   _max_parallel_service_checks = value;
 }
 
+/**
+ *  Get max_parallel_system_commands value.
+ *
+ *  @return The max_parallel_system_commands value.
+ */
+unsigned int state::max_parallel_system_commands() const noexcept {
+  return _max_parallel_system_commands;
+}
+
+/**
+ *  Set max_parallel_system_commands value. 0 means that notifications,
+ *  event handlers, OCSP/OCHP and performance data commands are run
+ *  synchronously.
+ *
+ *  @param[in] value The new max_parallel_system_commands value.
+ */
+void state::max_parallel_system_commands(unsigned int value) {
+  _max_parallel_system_commands = value;
+}
+
 /**
  *  Get max_service_check_spread value.
  *
@@ -3548,6 +3631,26 @@ void state::user(unsigned int key, std::string const& value) {
 }
 
 
+/**
+ *  Get use_adaptive_check_scheduler value.
+ *
+ *  @return The use_adaptive_check_scheduler value.
+ */
+bool state::use_adaptive_check_scheduler() const noexcept {
+  return _use_adaptive_check_scheduler;
+}
+
+/**
+ *  Set use_adaptive_check_scheduler value. When enabled, service checks are
+ *  admitted by events::check_scheduler instead of being nudged when
+ *  max_concurrent_checks is reached.
+ *
+ *  @param[in] value The new use_adaptive_check_scheduler value.
+ */
+void state::use_adaptive_check_scheduler(bool value) {
+  _use_adaptive_check_scheduler = value;
+}
+
 /**
  *  Set use_aggressive_host_checking value. This function is still there just
  *  to warn the user. It should be removed soon.
@@ -4135,14 +4238,17 @@ void state::_set_service_inter_check_delay_method(std::string const& value) {
     _service_inter_check_delay_method = icd_dumb;
   else if (value == "s")
     _service_inter_check_delay_method = icd_smart;
+  else if (value == "e")
+    _service_inter_check_delay_method = icd_even;
   else {
     _service_inter_check_delay_method = icd_user;
     if (!string::to(value.c_str(), scheduling_info.service_inter_check_delay) ||
         scheduling_info.service_inter_check_delay <= 0.0)
       throw(engine_error()
             << "Invalid value for service_inter_check_delay_method, "
-            << "must be one of 'n' (none), 'd' (dumb), 's' (smart) or "
-            << "a strictly positive value (" << value << " provided)");
+            << "must be one of 'n' (none), 'd' (dumb), 's' (smart), "
+            << "'e' (even) or a strictly positive value (" << value
+            << " provided)");
   }
 }
 
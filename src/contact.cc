@@ -621,9 +621,13 @@ contact::contact()
       _host_notifications_enabled{false},
       _service_notifications_enabled{false},
       _host_notification_period_ptr{nullptr},
-      _service_notification_period_ptr{nullptr} {}
+      _service_notification_period_ptr{nullptr} {
+  notifier::invalidate_contacts_cache();
+}
 
-contact::~contact() {}
+contact::~contact() {
+  notifier::invalidate_contacts_cache();
+}
 
 void contact::set_notify_on(notifier::notifier_type type, uint32_t notif) {
   _notify_on[type] = notif;
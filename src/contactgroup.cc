@@ -27,6 +27,7 @@
 #include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/notifier.hh"
 #include "com/centreon/engine/string.hh"
 
 using namespace com::centreon;
@@ -80,11 +81,28 @@ contactgroup& contactgroup::operator=(contactgroup const& other) {
 /**
  * Destructor.
  */
-contactgroup::~contactgroup() { _members.clear(); }
+contactgroup::~contactgroup() {
+  _members.clear();
+  notifier::invalidate_contacts_cache();
+}
 
 std::string const& contactgroup::get_name() const { return _name; }
 
-void contactgroup::clear_members() { _members.clear(); }
+/**
+ *  Add a contact to the members. Notifiers will flatten their contacts
+ *  again.
+ *
+ * @param cntct The contact to add.
+ */
+void contactgroup::add_member(contact* cntct) {
+  _members.insert({cntct->get_name(), cntct});
+  notifier::invalidate_contacts_cache();
+}
+
+void contactgroup::clear_members() {
+  _members.clear();
+  notifier::invalidate_contacts_cache();
+}
 
 contact_map_unsafe& contactgroup::get_members() { return _members; }
 
@@ -110,6 +128,9 @@ std::ostream& operator<<(std::ostream& os, contactgroup_map_unsafe const& obj) {
 void contactgroup::resolve(int& w __attribute__((unused)), int& e) {
   int errors{0};
 
+  /* Members may have changed, notifiers have to flatten them again. */
+  notifier::invalidate_contacts_cache();
+
   for (contact_map_unsafe::iterator it{_members.begin()}, end{_members.end()};
        it != end;
        ++it) {
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/dependency_index.hh"
+
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/hostdependency.hh"
+#include "com/centreon/engine/service.hh"
+#include "com/centreon/engine/servicedependency.hh"
+#include "com/centreon/engine/state_table.hh"
+
+using namespace com::centreon::engine;
+
+namespace {
+struct edge {
+  uint32_t dependent;
+  uint32_t master;
+  dependency* dep;
+};
+
+checkable const* dependent_of(hostdependency const& dep) {
+  return dep.dependent_host_ptr;
+}
+
+checkable const* dependent_of(servicedependency const& dep) {
+  return dep.dependent_service_ptr;
+}
+
+checkable const* master_of(hostdependency const& dep) {
+  return dep.master_host_ptr;
+}
+
+checkable const* master_of(servicedependency const& dep) {
+  return dep.master_service_ptr;
+}
+
+/**
+ *  Append the resolved dependencies of a map, in its order.
+ *
+ *  @param[in]  deps   The dependency map.
+ *  @param[out] edges  The dependencies.
+ */
+template <typename M>
+void collect(M const& deps, std::vector<edge>& edges) {
+  for (typename M::value_type const& p : deps) {
+    checkable const* dependent(dependent_of(*p.second));
+    checkable const* master(master_of(*p.second));
+    if (dependent && master)
+      edges.push_back(
+          {dependent->get_state_id(), master->get_state_id(), p.second.get()});
+  }
+}
+}  // namespace
+
+/**
+ *  Constructor. The index is built on its first use.
+ *
+ *  @param[in] states  The state table of the dependent and master objects.
+ */
+dependency_index::dependency_index(state_table const& states)
+    : _states(states), _valid{false} {}
+
+/**
+ *  Get the dependencies of an object, of all types.
+ *
+ *  @param[in] id  The state table id of the object.
+ *
+ *  @return The dependencies, in the order of the dependency map.
+ */
+dependency_index::range dependency_index::dependencies(uint32_t id) {
+  if (!_valid)
+    _build();
+  if (id >= _verdicts[0].size())
+    return {nullptr, nullptr};
+  return {_dependencies.data() + _offsets[id],
+          _dependencies.data() + _offsets[id + 1]};
+}
+
+/**
+ *  Get the kept result of the dependencies of an object.
+ *
+ *  @param[in] id    The state table id of the object.
+ *  @param[in] type  The dependency type.
+ *
+ *  @return unknown if the dependencies must be evaluated.
+ */
+dependency_index::verdict dependency_index::get_verdict(
+    uint32_t id,
+    dependency::types type) {
+  if (!_valid)
+    _build();
+  if (id >= _verdicts[type - 1].size())
+    return unknown;
+  return static_cast<verdict>(_verdicts[type - 1][id]);
+}
+
+/**
+ *  Get the host dependencies.
+ *
+ *  @return The index.
+ */
+dependency_index& dependency_index::hosts() {
+  static dependency_index* instance(
+      new dependency_index(state_table::hosts()));
+  return *instance;
+}
+
+/**
+ *  Rebuild the index on its next use.
+ */
+void dependency_index::invalidate() noexcept {
+  _valid = false;
+}
+
+/**
+ *  Get the dependencies of the objects of a state table.
+ *
+ *  @param[in] states  state_table::hosts() or state_table::services().
+ *
+ *  @return The index.
+ */
+dependency_index& dependency_index::of(state_table const& states) {
+  return &states == &state_table::hosts() ? hosts() : services();
+}
+
+/**
+ *  Get the service dependencies.
+ *
+ *  @return The index.
+ */
+dependency_index& dependency_index::services() {
+  static dependency_index* instance(
+      new dependency_index(state_table::services()));
+  return *instance;
+}
+
+/**
+ *  Keep the result of the dependencies of an object until the state of one
+ *  of its masters changes.
+ *
+ *  @param[in] id          The state table id of the object.
+ *  @param[in] type        The dependency type.
+ *  @param[in] authorized  The result.
+ */
+void dependency_index::set_verdict(uint32_t id,
+                                   dependency::types type,
+                                   bool authorized) {
+  if (!_valid)
+    _build();
+  if (id < _verdicts[type - 1].size())
+    _verdicts[type - 1][id] = authorized ? dependency_index::authorized
+                                         : dependency_index::blocked;
+}
+
+/**
+ *  Forget the results depending on the state of an object: those of its
+ *  dependents, and of the objects inheriting from them. An object without
+ *  result cannot be inherited by an object with a result, so the walk stops
+ *  there.
+ *
+ *  @param[in] id  The state table id of the object.
+ */
+void dependency_index::state_changed(uint32_t id) {
+  if (!_valid || id >= _verdicts[0].size() ||
+      _dependent_offsets[id] == _dependent_offsets[id + 1])
+    return;
+
+  std::vector<uint32_t> pending{id};
+  while (!pending.empty()) {
+    uint32_t master = pending.back();
+    pending.pop_back();
+    for (uint32_t e = _dependent_offsets[master];
+         e < _dependent_offsets[master + 1]; ++e) {
+      uint32_t dependent = _dependents[e];
+      bool known = false;
+      for (std::vector<uint8_t>& verdicts : _verdicts)
+        if (verdicts[dependent] != unknown) {
+          verdicts[dependent] = unknown;
+          known = true;
+        }
+      if (known)
+        pending.push_back(dependent);
+    }
+  }
+}
+
+/**
+ *  Build the dependency arrays from the dependency map, with no kept
+ *  result.
+ */
+void dependency_index::_build() {
+  std::vector<edge> edges;
+  if (&_states == &state_table::hosts())
+    collect(hostdependency::hostdependencies, edges);
+  else
+    collect(servicedependency::servicedependencies, edges);
+
+  uint32_t size = _states.size();
+  _offsets.assign(size + 1, 0);
+  _dependent_offsets.assign(size + 1, 0);
+  for (edge const& e : edges) {
+    ++_offsets[e.dependent + 1];
+    ++_dependent_offsets[e.master + 1];
+  }
+  for (uint32_t id = 0; id < size; ++id) {
+    _offsets[id + 1] += _offsets[id];
+    _dependent_offsets[id + 1] += _dependent_offsets[id];
+  }
+
+  /* Counting sort: the dependencies of an object keep the map order. */
+  _dependencies.resize(edges.size());
+  _dependents.resize(edges.size());
+  std::vector<uint32_t> pos(_offsets.begin(), _offsets.end() - 1);
+  std::vector<uint32_t> dependent_pos(_dependent_offsets.begin(),
+                                      _dependent_offsets.end() - 1);
+  for (edge const& e : edges) {
+    _dependencies[pos[e.dependent]++] = e.dep;
+    _dependents[dependent_pos[e.master]++] = e.dependent;
+  }
+
+  for (std::vector<uint8_t>& verdicts : _verdicts)
+    verdicts.assign(size, unknown);
+  _valid = true;
+}
@@ -39,6 +39,7 @@ escalation::escalation(uint32_t first_notification,
           (notification_interval < 0) ? 0 : notification_interval},
       _escalation_period{escalation_period},
       _escalate_on{escalate_on},
+      _flattened_contacts_generation{0},
       _uuid{uuid} {}
 
 std::string const& escalation::get_escalation_period() const {
@@ -89,6 +90,21 @@ contactgroup_map_unsafe& escalation::get_contactgroups() {
   return _contact_groups;
 }
 
+/**
+ *  Get the members of the contact groups of this escalation, without
+ *  duplicates. The list is only built again after a configuration change.
+ *
+ * @return A list of contacts.
+ */
+std::vector<contact*> const& escalation::get_flattened_contacts() {
+  if (_flattened_contacts_generation != notifier::get_contacts_generation()) {
+    _flattened_contacts.clear();
+    notifier::flatten_contacts(nullptr, _contact_groups, _flattened_contacts);
+    _flattened_contacts_generation = notifier::get_contacts_generation();
+  }
+  return _flattened_contacts;
+}
+
 /**
  *  This method is called by a notifier to know if this escalation is touched
  *  by the notification to send.
@@ -116,6 +132,9 @@ bool escalation::is_viable(int state __attribute__((unused)),
 
 void escalation::resolve(int& w __attribute__((unused)), int& e) {
   int errors{0};
+
+  /* Contact groups are resolved again, so is the flattened list. */
+  _flattened_contacts_generation = 0;
   // Find the timeperiod.
   if (!get_escalation_period().empty()) {
     timeperiod_map::const_iterator it{
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/events/check_placement.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::events;
+
+/* Loads are sums of costs, compared with some tolerance. */
+static double const load_epsilon = 1e-6;
+
+uint32_t const check_placement::max_horizon;
+
+/**
+ *  Constructor.
+ *
+ *  @param[in] horizon  Length of the time considered in seconds, usually the
+ *                      longest check interval. It is bounded by max_horizon.
+ *  @param[in] spread   The first checks are placed in the spread seconds
+ *                      following now, 0 for no limit.
+ */
+check_placement::check_placement(uint32_t horizon, uint32_t spread)
+    : _horizon{std::max(1u, std::min(horizon, max_horizon))},
+      _spread{spread ? spread : _horizon},
+      _load(_horizon, 0.0) {}
+
+/**
+ *  Add a check to place.
+ *
+ *  @param[in] interval  Its check interval in seconds.
+ *  @param[in] cost      Its expected execution time in seconds.
+ *
+ *  @return Its index, given to phase() once the checks are placed.
+ */
+size_t check_placement::add(uint32_t interval, double cost) {
+  /* A check whose interval is longer than the horizon runs once every
+   * interval / horizon horizons. */
+  if (interval > _horizon)
+    cost = cost * _horizon / interval;
+  _checks.push_back({interval, 0, cost, false, false});
+  return _checks.size() - 1;
+}
+
+/**
+ *  Add the load of a check that is already scheduled.
+ *
+ *  @param[in] interval  Its check interval in seconds.
+ *  @param[in] offset    Seconds before its next check.
+ *  @param[in] cost      Its expected execution time in seconds.
+ */
+void check_placement::add_load(uint32_t interval,
+                               uint32_t offset,
+                               double cost) {
+  if (interval > _horizon)
+    cost = cost * _horizon / interval;
+  uint32_t period = _period(interval);
+  _add_occurrences(offset % period, period, cost);
+}
+
+/**
+ *  Add a check that is already scheduled, and that place() may move if it
+ *  starts in an overloaded second.
+ *
+ *  @param[in] interval  Its check interval in seconds.
+ *  @param[in] offset    Seconds before its next check.
+ *  @param[in] cost      Its expected execution time in seconds.
+ *
+ *  @return Its index, given to moved() and phase() once the checks are
+ *          placed.
+ */
+size_t check_placement::add_scheduled(uint32_t interval,
+                                      uint32_t offset,
+                                      double cost) {
+  if (interval > _horizon)
+    cost = cost * _horizon / interval;
+  uint32_t period = _period(interval);
+  _checks.push_back({interval, offset % period, cost, true, false});
+  _add_occurrences(offset % period, period, cost);
+  return _checks.size() - 1;
+}
+
+/**
+ *  Get the expected number of checks running during each second of the
+ *  horizon, for the checks already scheduled and the checks placed.
+ *
+ *  @return The concurrency of each second.
+ */
+std::vector<double> const& check_placement::concurrency() const noexcept {
+  return _load;
+}
+
+/**
+ *  Get the horizon.
+ *
+ *  @return A duration in seconds.
+ */
+uint32_t check_placement::horizon() const noexcept {
+  return _horizon;
+}
+
+/**
+ *  Tell if place() moved a check added with add_scheduled().
+ *
+ *  @param[in] idx  The index returned by add_scheduled().
+ *
+ *  @return True if its phase changed.
+ */
+bool check_placement::moved(size_t idx) const noexcept {
+  return _checks[idx].moved;
+}
+
+/**
+ *  Get the phase chosen for a check by place().
+ *
+ *  @param[in] idx  The index returned by add().
+ *
+ *  @return Seconds before its first check.
+ */
+uint32_t check_placement::phase(size_t idx) const noexcept {
+  return _checks[idx].phase;
+}
+
+/**
+ *  Choose the phase of the checks added with add(), and of the checks added
+ *  with add_scheduled() that start in a second loaded over the target.
+ */
+void check_placement::place() {
+  double const target = _target();
+  for (check& c : _checks)
+    if (c.scheduled) {
+      uint32_t period = _period(c.interval);
+      if (_phase_load(c.phase, period) > target + load_epsilon) {
+        _add_occurrences(c.phase, period, -c.cost);
+        c.moved = true;
+      }
+    }
+
+  std::vector<size_t> order;
+  order.reserve(_checks.size());
+  for (size_t i = 0; i < _checks.size(); ++i)
+    if (!_checks[i].scheduled || _checks[i].moved)
+      order.push_back(i);
+  std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    uint32_t pa = _period(_checks[a].interval);
+    uint32_t pb = _period(_checks[b].interval);
+    if (pa != pb)
+      return pa < pb;
+    if (_checks[a].cost != _checks[b].cost)
+      return _checks[a].cost > _checks[b].cost;
+    return a < b;
+  });
+
+  typedef std::pair<double, uint32_t> slot;
+  for (size_t first = 0; first < order.size();) {
+    uint32_t period = _period(_checks[order[first]].interval);
+    uint32_t range = std::min(period, _spread);
+
+    std::vector<slot> slots(range);
+    for (uint32_t phase = 0; phase < range; ++phase)
+      slots[phase] = {_phase_load(phase, period), phase};
+    std::priority_queue<slot, std::vector<slot>, std::greater<slot>> heap(
+        std::greater<slot>(), std::move(slots));
+
+    size_t end = first;
+    for (; end < order.size() &&
+           _period(_checks[order[end]].interval) == period;
+         ++end) {
+      /* A check running over several seconds also loads the following
+       * phases, so the load of the least loaded phase may be outdated. As
+       * loads only grow, a phase whose load is still the same is the least
+       * loaded one. */
+      slot s = heap.top();
+      heap.pop();
+      double load = _phase_load(s.second, period);
+      while (load > s.first) {
+        heap.push({load, s.second});
+        s = heap.top();
+        heap.pop();
+        load = _phase_load(s.second, period);
+      }
+
+      check& c = _checks[order[end]];
+      if (c.scheduled)
+        c.moved = c.phase != s.second;
+      c.phase = s.second;
+      _add_occurrences(c.phase, period, c.cost);
+      heap.push({_phase_load(c.phase, period), c.phase});
+    }
+    first = end;
+  }
+}
+
+/**
+ *  Add a check to the load of the seconds it runs, at each of its
+ *  occurrences in the horizon. A check of cost c takes one check slot
+ *  during c seconds.
+ *
+ *  @param[in] phase   Seconds before its first occurrence.
+ *  @param[in] period  Seconds between two occurrences.
+ *  @param[in] cost    Its cost, negative to take the check out.
+ */
+void check_placement::_add_occurrences(uint32_t phase,
+                                       uint32_t period,
+                                       double cost) {
+  for (uint32_t t = phase; t < _horizon; t += period) {
+    uint32_t second = t;
+    double left = std::fabs(cost);
+    while (left > 0) {
+      double part = std::min(left, 1.0);
+      _load[second] += cost < 0 ? -part : part;
+      left -= part;
+      if (++second == _horizon)
+        second = 0;
+    }
+  }
+}
+
+/**
+ *  Get the load of a phase: the highest load of the seconds where a check
+ *  of this phase starts.
+ *
+ *  @param[in] phase   The phase.
+ *  @param[in] period  Seconds between two occurrences.
+ *
+ *  @return The load.
+ */
+double check_placement::_phase_load(uint32_t phase,
+                                    uint32_t period) const noexcept {
+  double retval = 0;
+  for (uint32_t t = phase; t < _horizon; t += period)
+    retval = std::max(retval, _load[t]);
+  return retval;
+}
+
+/**
+ *  Get the period of a check in the horizon.
+ *
+ *  @param[in] interval  Its check interval in seconds.
+ *
+ *  @return The interval, or the horizon if the interval is longer.
+ */
+uint32_t check_placement::_period(uint32_t interval) const noexcept {
+  return interval && interval < _horizon ? interval : _horizon;
+}
+
+/**
+ *  Get the load over which a second is overloaded: the average load of the
+ *  horizon once all the checks are placed, rounded up to whole check slots.
+ *
+ *  @return The target load.
+ */
+double check_placement::_target() const noexcept {
+  double load = std::accumulate(_load.begin(), _load.end(), 0.0);
+  for (check const& c : _checks)
+    if (!c.scheduled)
+      load += c.cost * _horizon / _period(c.interval);
+  return std::ceil(load / _horizon - load_epsilon);
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/events/check_scheduler.hh"
+
+#include <algorithm>
+
+#include "com/centreon/engine/checks/stats.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/service.hh"
+#include "com/centreon/engine/state_table.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::events;
+
+/* Smoothing factor of the execution time averages. */
+static double const average_weight = 0.2;
+/* Execution time assumed before any check is measured. */
+static double const default_execution_time = 1.0;
+/* A check never costs less than this, in seconds. */
+static double const min_execution_time = 0.01;
+/* Part of the slots that can be filled at once by a burst of checks. */
+static double const burst_ratio = 0.25;
+
+/**
+ *  Get the check scheduler.
+ *
+ *  @return The singleton.
+ */
+check_scheduler& check_scheduler::instance() {
+  static check_scheduler instance;
+  return instance;
+}
+
+/**
+ *  Constructor.
+ */
+check_scheduler::check_scheduler()
+    : _mean{default_execution_time}, _tokens{0}, _last_refill{0} {}
+
+/**
+ *  Take into account the execution time of an active check.
+ *
+ *  @param[in] svc             The checked service.
+ *  @param[in] execution_time  Its execution time in seconds.
+ */
+void check_scheduler::add_execution_time(service const* svc,
+                                         double execution_time) {
+  execution_time = std::max(execution_time, min_execution_time);
+  double* average = _command_average(svc, true);
+  if (*average == 0)
+    *average = execution_time;
+  else
+    *average += average_weight * (execution_time - *average);
+  _mean += average_weight * (execution_time - _mean);
+}
+
+/**
+ *  Decide if a service check can be run now. If so, its cost is taken from
+ *  the bucket.
+ *
+ *  @param[in] svc  The service.
+ *  @param[in] now  A monotonic time in seconds.
+ *
+ *  @return True if the check can be run.
+ */
+bool check_scheduler::admit(service const* svc, double now) {
+  unsigned int slots = config->max_parallel_service_checks();
+  if (!slots)
+    return true;
+  if (currently_running_service_checks >= slots)
+    return false;
+
+  double burst = std::max(slots * _mean * burst_ratio, _mean);
+  if (_last_refill == 0)
+    _tokens = burst;
+  else
+    _tokens = std::min(burst, _tokens + (now - _last_refill) * slots);
+  _last_refill = now;
+
+  /* An expensive check is admitted on credit, so that it is not starved by
+   * the cheap ones. */
+  if (_tokens <= 0)
+    return false;
+  _tokens -= expected_execution_time(svc);
+  return true;
+}
+
+/**
+ *  Get the active service checks run per second during the last minute.
+ *
+ *  @param[in] now  The current time.
+ *
+ *  @return A rate.
+ */
+double check_scheduler::achieved_rate(time_t now) const noexcept {
+  return checks::stats::instance().checks_count(
+             ACTIVE_SCHEDULED_SERVICE_CHECK_STATS, 1, now) /
+         60.0;
+}
+
+/**
+ *  Get the number of service checks per second admitted by the bucket with
+ *  the current execution times.
+ *
+ *  @return A rate, 0 if max_concurrent_checks does not limit the checks.
+ */
+double check_scheduler::admission_rate() const noexcept {
+  return config->max_parallel_service_checks() / _mean;
+}
+
+/**
+ *  Get the number of active service checks per second asked by the check
+ *  intervals of the services.
+ *
+ *  @return A rate.
+ */
+double check_scheduler::configured_rate() const {
+  uint16_t const wanted =
+      state_table::should_be_scheduled | state_table::checks_enabled;
+  state_table const& states = state_table::services();
+  double retval = 0;
+  for (uint32_t i = 0, size = states.size(); i < size; ++i)
+    if ((states.flags[i] & wanted) == wanted && states.check_interval[i])
+      retval += 1.0 / states.check_interval[i];
+  return retval / config->interval_length();
+}
+
+/**
+ *  Get the execution time expected for the next check of a service: the
+ *  average of its command, or of all the checks if the command was never
+ *  measured.
+ *
+ *  @param[in] svc  The service.
+ *
+ *  @return A duration in seconds.
+ */
+double check_scheduler::expected_execution_time(service const* svc) {
+  double* average = _command_average(svc, false);
+  return average && *average != 0 ? *average : _mean;
+}
+
+/**
+ *  Get the share of the check slots time used by the next check of a
+ *  service, used to spread checks in adjust_check_scheduling().
+ *
+ *  @param[in] svc  The service.
+ *
+ *  @return A duration in seconds.
+ */
+double check_scheduler::projected_overhead(service const* svc) {
+  unsigned int slots = config->max_parallel_service_checks();
+  return expected_execution_time(svc) / (slots ? slots : 1);
+}
+
+/**
+ *  Forget the measured execution times and fill the bucket.
+ */
+void check_scheduler::reset() {
+  _averages.clear();
+  _mean = default_execution_time;
+  _tokens = 0;
+  _last_refill = 0;
+}
+
+/**
+ *  Take into account an execution time known from a previous run, the
+ *  retention for example. It is ignored if the command was already
+ *  measured.
+ *
+ *  @param[in] svc             The service.
+ *  @param[in] execution_time  Its execution time in seconds.
+ */
+void check_scheduler::seed_execution_time(service const* svc,
+                                          double execution_time) {
+  double* average = _command_average(svc, true);
+  if (*average == 0)
+    *average = std::max(execution_time, min_execution_time);
+}
+
+/**
+ *  Get the average execution time of the command of a service.
+ *
+ *  @param[in] svc     The service.
+ *  @param[in] create  Create the average if it does not exist yet.
+ *
+ *  @return The average, 0 if it was just created, nullptr if it does not
+ *          exist and create is false.
+ */
+double* check_scheduler::_command_average(service const* svc, bool create) {
+  std::string const& command = svc->get_check_command();
+  _key.assign(command, 0, command.find('!'));
+  if (create)
+    return &_averages[_key];
+  std::unordered_map<std::string, double>::iterator it = _averages.find(_key);
+  return it == _averages.end() ? nullptr : &it->second;
+}
@@ -30,11 +30,17 @@
 #include <thread>
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/command_manager.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/configuration/parser.hh"
+#include "com/centreon/engine/events/check_scheduler.hh"
 #include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/logging/broker.hh"
 #include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/nebmods.hh"
+#include "com/centreon/engine/snapshot.hh"
 #include "com/centreon/engine/statusdata.hh"
+#include "com/centreon/engine/time_base.hh"
 #include "com/centreon/logging/engine.hh"
 
 using namespace com::centreon::engine;
@@ -60,8 +66,11 @@ void loop::clear() {
     delete ev;
     ev = nullptr;
   }
+  for (timed_event* ev : _ready_checks)
+    delete ev;
   _event_list_low.clear();
   _event_list_high.clear();
+  _ready_checks.clear();
 
   _need_reload = 0;
   _reload_running = false;
@@ -78,12 +87,14 @@ void loop::run() {
       << "Configuration loaded, main loop starting.";
 
   // Initialize some time members.
-  time(&_last_time);
+  time_t now(time(nullptr));
+  time_base::instance().start(now);
   _last_status_update = 0L;
+  _last_snapshot = 0L;
 
   // Initialize fake "sleep" event.
   _sleep_event.event_type = timed_event::EVENT_SLEEP;
-  _sleep_event.run_time = _last_time;
+  _sleep_event.run_time = now;
   _sleep_event.recurring = false;
   _sleep_event.event_interval = 0L;
   _sleep_event.compensate_for_time_change = false;
@@ -93,13 +104,18 @@ void loop::run() {
   _sleep_event.event_options = 0;
 
   _dispatching();
+  snapshot::instance().clear();
   clear();
 }
 
 /**
  *  Default constructor.
  */
-loop::loop() : _need_reload(0), _reload_running(false) {}
+loop::loop()
+    : _last_status_update(0L),
+      _last_snapshot(0L),
+      _need_reload(0),
+      _reload_running(false) {}
 
 static void apply_conf(std::atomic<bool>* reloading) {
   logger(log_info_message, more) << "Starting to reload configuration.";
@@ -131,7 +147,8 @@ void loop::_dispatching() {
       break;
 
     // If we don't have any events to handle, exit.
-    if (_event_list_high.empty() && _event_list_low.empty()) {
+    if (_event_list_high.empty() && _event_list_low.empty() &&
+        _ready_checks.empty()) {
       logger(log_runtime_error, basic)
           << "There aren't any events that need to be handled! "
           << "Exiting...";
@@ -163,22 +180,16 @@ void loop::_dispatching() {
 
     configuration::applier::state::instance().lock();
 
-    // Hey, wait a second...  we traveled back in time!
-    if (current_time < _last_time)
-      compensate_for_system_time_change(
-          static_cast<unsigned long>(_last_time),
-          static_cast<unsigned long>(current_time));
-    // Else if the time advanced over the specified threshold,
-    // try and compensate...
-    else if ((current_time - _last_time) >=
-             static_cast<time_t>(config->time_change_threshold()))
+    // Hey, wait a second...  we traveled back in time, or forward over the
+    // specified threshold! The wall clock is compared to the monotonic
+    // clock, so a loop blocked for a while is not a time change.
+    int64_t step(time_base::instance().detect_step(
+        current_time, config->time_change_threshold()));
+    if (step)
       compensate_for_system_time_change(
-          static_cast<unsigned long>(_last_time),
+          static_cast<unsigned long>(current_time - step),
           static_cast<unsigned long>(current_time));
 
-    // Keep track of the last time.
-    _last_time = current_time;
-
     // Log messages about event lists.
     logger(dbg_events, more) << "** Event Check Loop";
     if (!_event_list_high.empty())
@@ -195,7 +206,8 @@ void loop::_dispatching() {
       logger(dbg_events, more) << "No low priority events are scheduled...";
     logger(dbg_events, more)
         << "Current/Max Service Checks: " << currently_running_service_checks
-        << '/' << config->max_parallel_service_checks();
+        << '/' << config->max_parallel_service_checks() << " ("
+        << _ready_checks.size() << " ready)";
 
     // Update status information occassionally - NagVis watches the
     // NDOUtils DB to see if Engine is alive.
@@ -204,6 +216,25 @@ void loop::_dispatching() {
       update_program_status(false);
     }
 
+    // Publish the read-only view used by enginerpc every second.
+    if (current_time != _last_snapshot) {
+      _last_snapshot = current_time;
+      snapshot::instance().publish();
+    }
+
+    // Complete notifications, event handlers... run in the background.
+    commands::system_runner::instance().reap();
+
+    // Send the logs stored by the broker backend (log_async).
+    logging::broker::flush();
+
+    // Send the broker events batched for too long.
+    neb_flush_batches(100);
+
+    // Run the service checks waiting for the adaptive check scheduler.
+    if (!_ready_checks.empty())
+      _run_ready_checks();
+
     // Handle high priority events.
     bool run_event(true);
     if (!_event_list_high.empty() &&
@@ -234,12 +265,14 @@ void loop::_dispatching() {
       if ((*_event_list_low.begin())->event_type ==
           timed_event::EVENT_SERVICE_CHECK) {
         int nudge_seconds(0);
+        bool deferred(false);
         service* temp_service(
             static_cast<service*>((*_event_list_low.begin())->event_data));
 
         // Don't run a service check if we're already maxed out on the
         // number of parallel service checks...
-        if (config->max_parallel_service_checks() != 0 &&
+        if (!config->use_adaptive_check_scheduler() &&
+            config->max_parallel_service_checks() != 0 &&
             (currently_running_service_checks >=
              config->max_parallel_service_checks())) {
           // Move it at least 5 seconds (to overcome the current peak),
@@ -273,9 +306,24 @@ void loop::_dispatching() {
         // Forced checks override normal check logic.
         if (temp_service->get_check_options() & CHECK_OPTION_FORCE_EXECUTION)
           run_event = true;
+        // The adaptive scheduler keeps the checks it cannot admit yet in the
+        // ready queue, instead of delaying them.
+        else if (run_event && config->use_adaptive_check_scheduler() &&
+                 !check_scheduler::instance().admit(
+                     temp_service,
+                     std::chrono::duration<double>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count())) {
+          run_event = false;
+          deferred = true;
+        }
 
+        if (deferred) {
+          _ready_checks.push_back(*_event_list_low.begin());
+          _event_list_low.pop_front();
+        }
         // Reschedule the check if we can't run it now.
-        if (!run_event) {
+        else if (!run_event) {
           // Remove the service check from the event queue and
           // reschedule it for a later time. Since event was not
           // executed, it needs to be remove()'ed to maintain sync with
@@ -308,6 +356,12 @@ void loop::_dispatching() {
           temp_service->update_status();
           run_event = false;
         }
+
+        // Go on with the next events.
+        if (deferred) {
+          configuration::applier::state::instance().unlock();
+          continue;
+        }
       }
       // Run a few checks before executing a host check...
       else if (timed_event::EVENT_HOST_CHECK ==
@@ -429,6 +483,39 @@ void loop::_dispatching() {
   }
 }
 
+/**
+ *  Run the service checks of the ready queue while the adaptive check
+ *  scheduler admits them. If the scheduler was disabled or service checks
+ *  were stopped in the meantime, they go back to the low priority list.
+ */
+void loop::_run_ready_checks() {
+  if (!config->use_adaptive_check_scheduler() ||
+      !config->execute_service_checks()) {
+    for (timed_event* evt : _ready_checks)
+      add_event(evt, events::loop::low);
+    _ready_checks.clear();
+    return;
+  }
+
+  check_scheduler& scheduler(check_scheduler::instance());
+  double now(std::chrono::duration<double>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+                 .count());
+  while (!_ready_checks.empty()) {
+    timed_event* evt(_ready_checks.front());
+    if (!scheduler.admit(static_cast<service*>(evt->event_data), now))
+      break;
+    _ready_checks.pop_front();
+
+    logger(dbg_events, more) << "Running ready service check...";
+    evt->handle_timed_event();
+    if (evt->recurring)
+      reschedule_event(evt, events::loop::low);
+    else
+      delete evt;
+  }
+}
+
 /**
  *  Adjusts scheduling of host and service checks.
  */
@@ -446,6 +533,7 @@ void loop::adjust_check_scheduling() {
   time_t last_check_time(0L);
   host* hst(nullptr);
   com::centreon::engine::service* svc(nullptr);
+  bool adaptive(config->use_adaptive_check_scheduler());
 
   logger(dbg_functions, basic) << "adjust_check_scheduling()";
 
@@ -460,7 +548,8 @@ void loop::adjust_check_scheduling() {
   time_t last_window_time(first_window_time +
                           config->auto_rescheduling_window());
 
-  // get current scheduling data.
+  // get current scheduling data. The checks of the ready queue are already
+  // due, they are before the window and are left to the adaptive scheduler.
   for (timed_event_list::iterator it{_event_list_low.begin()},
        end{_event_list_low.end()};
        it != end; ++it) {
@@ -505,8 +594,11 @@ void loop::adjust_check_scheduling() {
 
       // calculate time needed to perform check.
       // NOTE: service check execution time is not taken into
-      // account, as service checks are run in parallel.
-      last_check_exec_time = projected_service_check_overhead;
+      // account, as service checks are run in parallel, unless the
+      // adaptive scheduler gives the share of the slots it uses.
+      last_check_exec_time =
+          adaptive ? check_scheduler::instance().projected_overhead(svc)
+                   : projected_service_check_overhead;
       total_check_exec_time += last_check_exec_time;
     } else
       continue;
@@ -574,7 +666,10 @@ void loop::adjust_check_scheduling() {
 
       // NOTE: service check execution time is not taken into
       // account, as service checks are run in parallel.
-      current_exec_time = projected_service_check_overhead * exec_time_factor;
+      current_exec_time =
+          (adaptive ? check_scheduler::instance().projected_overhead(svc)
+                    : projected_service_check_overhead) *
+          exec_time_factor;
       time_t new_run_time = compute_new_run_time(
           current_exec_time_offset, current_icd_offset, first_window_time);
       (*it)->run_time = new_run_time;
@@ -630,116 +725,31 @@ void loop::compensate_for_system_time_change(unsigned long last_time,
       << (time_difference < 0 ? "backwards" : "forwards")
       << " in time) has been detected.  Compensating...";
 
-  // adjust the next run time for all high priority timed events.
-  for (auto it = _event_list_high.begin(), end = _event_list_high.end();
-       it != end; ++it) {
-    // skip special events that occur at specific times...
-    if (!(*it)->compensate_for_time_change)
-      continue;
-
-    // use custom timing function.
-    if ((*it)->timing_func) {
-      union {
-        time_t (*func)(void);
-        void* data;
-      } timing;
-      timing.data = (*it)->timing_func;
-      (*it)->run_time = (*timing.func)();
-    }
-
-    // else use standard adjustment.
-    else
-      (*it)->run_time =
-          adjust_timestamp_for_time_change(time_difference, (*it)->run_time);
-  }
-
-  // resort event list (some events may be out of order at this point).
-  resort_event_list(events::loop::high);
-
-  // adjust the next run time for all low priority timed events.
-  for (auto it = _event_list_low.begin(), end = _event_list_low.end();
-       it != end; ++it) {
-    // skip special events that occur at specific times...
-    if (!(*it)->compensate_for_time_change)
-      continue;
-
-    // use custom timing function.
-    if ((*it)->timing_func) {
-      union {
-        time_t (*func)(void);
-        void* data;
-      } timing;
-      timing.data = (*it)->timing_func;
-      (*it)->run_time = (*timing.func)();
-    }
+  // adjust the next run time of the timed events.
+  for (timed_event* evt : _shift_event_list(_event_list_high, time_difference))
+    add_event(evt, events::loop::high);
+  for (timed_event* evt : _shift_event_list(_event_list_low, time_difference))
+    add_event(evt, events::loop::low);
 
-    // else use standard adjustment.
-    else
-      (*it)->run_time =
-          adjust_timestamp_for_time_change(time_difference, (*it)->run_time);
-  }
+  // the ready queue is run in order of arrival, its events only keep their
+  // run time for their next schedule.
+  for (timed_event* evt : _ready_checks)
+    if (evt->compensate_for_time_change)
+      evt->run_time =
+          adjust_timestamp_for_time_change(time_difference, evt->run_time);
 
-  // resort event list (some events may be out of order at this point).
-  resort_event_list(events::loop::low);
+  // the check, state and notification times of hosts and services and the
+  // freshness deadlines are in the engine time base, they all move at once.
+  time_base::instance().shift(time_difference);
 
-  // adjust service timestamps.
+  // update the status data of services and hosts.
   for (service_map::iterator it(service::services.begin()),
        end(service::services.end());
-       it != end; ++it) {
-    it->second->set_last_notification(adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_notification()));
-    it->second->set_last_check(adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_check()));
-    it->second->set_next_check(adjust_timestamp_for_time_change(
-        time_difference, it->second->get_next_check()));
-    it->second->set_last_state_change(adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_state_change()));
-    it->second->set_last_hard_state_change(adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_hard_state_change()));
-
-    it->second->set_initial_notif_time(adjust_timestamp_for_time_change(
-        time_difference, it->second->get_initial_notif_time()));
-    it->second->set_last_acknowledgement(adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_acknowledgement()));
-
-    // recalculate next re-notification time.
-    it->second->set_next_notification(it->second->get_next_notification_time(
-        it->second->get_last_notification()));
-
-    // update the status data.
+       it != end; ++it)
     it->second->update_status();
-  }
-
-  // adjust host timestamps.
-  for (host_map::iterator it(com::centreon::engine::host::hosts.begin()),
-       end(com::centreon::engine::host::hosts.end());
-       it != end; ++it) {
-    time_t last_host_notif{adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_notification())};
-    time_t last_check{adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_check())};
-    time_t next_check{adjust_timestamp_for_time_change(
-        time_difference, it->second->get_next_check())};
-    time_t last_state_change{adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_state_change())};
-    time_t last_hard_state_change{adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_hard_state_change())};
-    time_t last_state_history_update{adjust_timestamp_for_time_change(
-        time_difference, it->second->get_last_state_history_update())};
-
-    it->second->set_last_notification(last_host_notif);
-    it->second->set_last_check(last_check);
-    it->second->set_next_check(next_check);
-    it->second->set_last_state_change(last_state_change);
-    it->second->set_last_hard_state_change(last_hard_state_change);
-    it->second->set_last_state_history_update(last_state_history_update);
-    // recalculate next re-notification time.
-    it->second->set_next_notification(it->second->get_next_notification_time(
-        it->second->get_last_notification()));
-
-    // update the status data.
+  for (host_map::iterator it(host::hosts.begin()), end(host::hosts.end());
+       it != end; ++it)
     it->second->update_status();
-  }
 
   // adjust program timestamps.
   program_start =
@@ -752,6 +762,45 @@ void loop::compensate_for_system_time_change(unsigned long last_time,
   update_program_status(false);
 }
 
+/**
+ *  Move the events of a list after a system time change. A same shift keeps
+ *  the order of the list, so only the events with their own timing, or run
+ *  at a specific time, are taken out to be added again.
+ *
+ *  @param[in,out] list             The event list.
+ *  @param[in]     time_difference  The time change, in seconds.
+ *
+ *  @return The events taken out of the list.
+ */
+std::vector<timed_event*> loop::_shift_event_list(timed_event_list& list,
+                                                  long time_difference) {
+  std::vector<timed_event*> retval;
+  timed_event_list shifted;
+  for (timed_event* evt : list) {
+    // skip special events that occur at specific times...
+    if (!evt->compensate_for_time_change)
+      retval.push_back(evt);
+    // use custom timing function.
+    else if (evt->timing_func) {
+      union {
+        time_t (*func)(void);
+        void* data;
+      } timing;
+      timing.data = evt->timing_func;
+      evt->run_time = (*timing.func)();
+      retval.push_back(evt);
+    }
+    // else use standard adjustment.
+    else {
+      evt->run_time =
+          adjust_timestamp_for_time_change(time_difference, evt->run_time);
+      shifted.push_back(evt);
+    }
+  }
+  list.swap(shifted);
+  return retval;
+}
+
 /**
  *  Add an event to list ordered by execution time.
  *
@@ -840,9 +889,10 @@ void loop::remove_event(timed_event* event, loop::priority priority) {
       }
     }
   };
-  if (priority == loop::low)
+  if (priority == loop::low) {
     eraser(_event_list_low, event);
-  else
+    eraser(_ready_checks, event);
+  } else
     eraser(_event_list_high, event);
 }
 
@@ -855,11 +905,18 @@ void loop::remove_events(loop::priority priority,
   else
     list = &_event_list_high;
 
-  for (auto it = list->begin(), end = list->end(); it != end; ++it)
-    if ((*it)->event_type == event_type && (*it)->event_data == data) {
-      delete *it;
-      list->erase(it);
+  auto eraser = [event_type, data](timed_event_list& l) {
+    for (auto it = l.begin(); it != l.end();) {
+      if ((*it)->event_type == event_type && (*it)->event_data == data) {
+        delete *it;
+        it = l.erase(it);
+      } else
+        ++it;
     }
+  };
+  eraser(*list);
+  if (priority == loop::low)
+    eraser(_ready_checks);
 }
 
 timed_event* loop::find_event(loop::priority priority,
@@ -879,9 +936,24 @@ timed_event* loop::find_event(loop::priority priority,
     if ((*it)->event_type == event_type && (*it)->event_data == data)
       return *it;
 
+  if (priority == loop::low)
+    for (timed_event* evt : _ready_checks)
+      if (evt->event_type == event_type && evt->event_data == data)
+        return evt;
+
   return nullptr;
 }
 
+/**
+ *  Get the number of service checks waiting for the adaptive check
+ *  scheduler.
+ *
+ *  @return A number.
+ */
+size_t loop::ready_checks() const noexcept {
+  return _ready_checks.size();
+}
+
 /**
  *  Reschedule an event in order of execution time.
  *
@@ -936,6 +1008,8 @@ void loop::resort_event_list(loop::priority priority) {
   else
     list = &_event_list_high;
 
+  // the ready queue is not sorted, its checks are run in order of arrival
+  // once the adaptive scheduler admits them.
   std::sort(list->begin(), list->end(),
             [](timed_event* const& first, timed_event* const& second) {
               return first->run_time < second->run_time;
@@ -21,15 +21,101 @@
 */
 
 #include "com/centreon/engine/events/sched_info.hh"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <sstream>
+#include "com/centreon/engine/events/check_placement.hh"
+#include "com/centreon/engine/events/check_scheduler.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/service.hh"
 #include "com/centreon/engine/statusdata.hh"
 #include "com/centreon/engine/string.hh"
 
 using namespace com::centreon::engine;
 using namespace com::centreon::engine::logging;
 
+/**
+ *  Displays the expected number of service checks running at once during
+ *  the longest check interval (one hour at most), with the current
+ *  schedule and with the even spread placement.
+ */
+static void display_service_check_load() {
+  time_t const now(time(nullptr));
+  uint32_t const interval_length(config->interval_length());
+  events::check_scheduler& measures(events::check_scheduler::instance());
+
+  uint32_t horizon(0);
+  for (service_map::const_iterator it(service::services.begin()),
+       end(service::services.end());
+       it != end; ++it) {
+    service const& svc(*it->second);
+    if (svc.get_should_be_scheduled()) {
+      if (svc.get_execution_time() > 0)
+        measures.seed_execution_time(&svc, svc.get_execution_time());
+      horizon = std::max(horizon, svc.get_check_interval() * interval_length);
+    }
+  }
+  if (!horizon)
+    return;
+
+  uint32_t const spread(scheduling_info.max_service_check_spread * 60);
+  events::check_placement current(horizon, spread);
+  events::check_placement even(horizon, spread);
+  for (service_map::const_iterator it(service::services.begin()),
+       end(service::services.end());
+       it != end; ++it) {
+    service const& svc(*it->second);
+    if (!svc.get_should_be_scheduled())
+      continue;
+    uint32_t interval(svc.get_check_interval() * interval_length);
+    double cost(measures.expected_execution_time(&svc));
+    time_t next_check(std::max(svc.get_next_check(), now));
+    current.add_load(interval, next_check - now, cost);
+    even.add(interval, cost);
+  }
+  even.place();
+
+  std::vector<double> const load(current.concurrency());
+  std::vector<double> const even_load(even.concurrency());
+  double const even_peak(
+      *std::max_element(even_load.begin(), even_load.end()));
+
+  // One row per bucket, 30 rows at most.
+  uint32_t const bucket((load.size() + 29) / 30);
+  double peak(0);
+  double total(0);
+  for (double l : load) {
+    peak = std::max(peak, l);
+    total += l;
+  }
+
+  std::ostringstream oss;
+  oss << "SERVICE CHECK LOAD\n"
+      << "------------------\n"
+      << "Expected concurrent checks, by " << bucket << " sec:\n";
+  for (size_t first(0); first < load.size(); first += bucket) {
+    size_t last(std::min<size_t>(first + bucket, load.size()));
+    double row_peak(*std::max_element(load.begin() + first,
+                                      load.begin() + last));
+    char line[64];
+    snprintf(line, sizeof(line), "  +%5lus  %9.1f  ",
+             static_cast<unsigned long>(first), row_peak);
+    oss << line
+        << std::string(peak > 0 ? static_cast<size_t>(40 * row_peak / peak)
+                                : 0,
+                       '#')
+        << "\n";
+  }
+  oss << "Average concurrent checks:          " << total / load.size() << "\n"
+      << "Peak concurrent checks:             " << peak << "\n"
+      << "Peak with even spread ('e'):        " << even_peak << "\n";
+  if (config->max_parallel_service_checks())
+    oss << "Check slots:                        "
+        << config->max_parallel_service_checks() << "\n";
+  logger(log_info_message, basic) << oss.str();
+}
 
 /**
  *  Displays service check scheduling information.
@@ -102,7 +188,11 @@ void display_scheduling_info() {
         << "Service inter-check delay method:   SMART\n"
         << "Average service check interval:     "
         << scheduling_info.average_service_check_interval << " sec\n";
-  } else
+  } else if (config->service_inter_check_delay_method() ==
+             configuration::state::icd_even)
+    logger(log_info_message, basic)
+        << "Service inter-check delay method:   EVEN SPREAD\n";
+  else
     logger(log_info_message, basic)
         << "Service inter-check delay method:   USER-SUPPLIED VALUE\n";
   logger(log_info_message, basic)
@@ -129,6 +219,8 @@ void display_scheduling_info() {
       << "Last scheduled check:               "
       << ctime(&scheduling_info.last_service_check) << "\n";
 
+  display_service_check_load();
+
   // Check processing information.
   logger(log_info_message, basic)
       << "CHECK PROCESSING INFORMATION\n"
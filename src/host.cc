@@ -24,12 +24,16 @@
 
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/stats.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/dependency_index.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
 #include "com/centreon/engine/events/loop.hh"
 #include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/flapping.hh"
 #include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/host_graph.hh"
 #include "com/centreon/engine/logging.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/macros.hh"
@@ -39,8 +43,11 @@
 #include "com/centreon/engine/objects.hh"
 #include "com/centreon/engine/sehandlers.hh"
 #include "com/centreon/engine/shared.hh"
+#include "com/centreon/engine/snapshot.hh"
+#include "com/centreon/engine/status_stats.hh"
 #include "com/centreon/engine/statusdata.hh"
 #include "com/centreon/engine/string.hh"
+#include "com/centreon/engine/time_base.hh"
 #include "com/centreon/engine/timezone_locker.hh"
 #include "com/centreon/engine/xpddefault.hh"
 #include "com/centreon/exceptions/interruption.hh"
@@ -59,6 +66,8 @@ std::array<std::pair<uint32_t, std::string>, 3> const host::tab_host_states{
 
 host_map host::hosts;
 host_id_map host::hosts_by_id;
+deadline_queue<host> host::_freshness_queue;
+deadline_queue<host> host::_orphan_queue;
 
 /*
  *  @param[in] name                          Host name.
@@ -249,14 +258,12 @@ host::host(uint64_t host_id,
       _last_time_down{0},
       _last_time_unreachable{0},
       _last_time_up{0},
-      _last_state_history_update{0},
       _total_services{0},
       _total_service_check_interval{0},
       _circular_path_checked{false},
       _contains_circular_path{false},
       _last_state{initial_state},
       _last_hard_state{initial_state},
-      _current_state{initial_state},
       _initial_state{initial_state} {
   // Make sure we have the data we need.
   if (name.empty() || address.empty()) {
@@ -280,6 +287,10 @@ host::host(uint64_t host_id,
   // Duplicate string vars.
   _alias = !alias.empty() ? alias : name;
 
+  // The host graph does not know this host yet, so it must not be updated
+  // by its initial state.
+  host_graph::instance().invalidate();
+  set_current_state(initial_state);
   set_current_attempt(initial_state == host::state_up ? 1 : max_attempts);
   set_modified_attributes(MODATTR_NONE);
   set_state_type(hard);
@@ -289,6 +300,15 @@ host::host(uint64_t host_id,
                 (flap_detection_on_up > 0 ? up : 0));
 }
 
+/**
+ *  Destructor.
+ */
+host::~host() noexcept {
+  _freshness_queue.erase(this);
+  _orphan_queue.erase(this);
+  host_graph::instance().invalidate();
+}
+
 uint64_t host::get_host_id(void) const {
   return _id;
 }
@@ -303,6 +323,7 @@ void host::add_child_host(host* child) {
     throw engine_error() << "add child link called with nullptr ptr";
 
   child_hosts.insert({child->get_name(), child});
+  host_graph::instance().invalidate();
 
   // Notify event broker.
   timeval tv(get_broker_timestamp(nullptr));
@@ -326,6 +347,7 @@ void host::add_parent_host(std::string const& host_name) {
   }
 
   parent_hosts.insert({host_name, nullptr});
+  host_graph::instance().invalidate();
 }
 
 std::string const& host::get_name() const {
@@ -473,11 +495,13 @@ void host::set_should_reschedule_current_check(bool should_reschedule) {
 }
 
 time_t host::get_last_state_history_update() const {
-  return _last_state_history_update;
+  return time_base::instance().to_wall(
+      _states.last_state_history_update[_state_id]);
 }
 
 void host::set_last_state_history_update(time_t last_state_history_update) {
-  _last_state_history_update = last_state_history_update;
+  _states.last_state_history_update[_state_id] =
+      time_base::instance().to_internal(last_state_history_update);
 }
 
 int host::get_total_services() const {
@@ -514,11 +538,17 @@ void host::set_contains_circular_path(bool contains_circular_path) {
 }
 
 enum host::host_state host::get_current_state() const {
-  return _current_state;
+  return static_cast<host_state>(_states.current_state[_state_id]);
 }
 
 void host::set_current_state(enum host::host_state current_state) {
-  _current_state = current_state;
+  if (_states.current_state[_state_id] == current_state)
+    return;
+  bool was_up(_states.current_state[_state_id] == host::state_up);
+  _states.current_state[_state_id] = current_state;
+  if (was_up != (current_state == host::state_up))
+    host_graph::instance().state_changed(this, !was_up);
+  dependency_index::hosts().state_changed(_state_id);
 }
 
 enum host::host_state host::get_last_state() const {
@@ -534,7 +564,10 @@ enum host::host_state host::get_last_hard_state() const {
 }
 
 void host::set_last_hard_state(enum host::host_state last_hard_state) {
-  _last_hard_state = last_hard_state;
+  if (_last_hard_state != last_hard_state) {
+    _last_hard_state = last_hard_state;
+    dependency_index::hosts().state_changed(_state_id);
+  }
 }
 
 enum host::host_state host::get_initial_state() const {
@@ -546,11 +579,11 @@ void host::set_initial_state(enum host::host_state current_state) {
 }
 
 bool host::recovered() const {
-  return _current_state == host::state_up;
+  return get_current_state() == host::state_up;
 }
 
 int host::get_current_state_int() const {
-  return static_cast<int>(_current_state);
+  return static_cast<int>(get_current_state());
 }
 
 std::ostream& operator<<(std::ostream& os, host_map_unsafe const& obj) {
@@ -1075,15 +1108,13 @@ int number_of_immediate_parent_hosts(com::centreon::engine::host* hst) {
  *
  *  @param[in] hst Target host.
  *
- *  @return Number of total child hosts.
+ *  @return Number of distinct hosts below the host, at any depth.
  */
 int number_of_total_child_hosts(com::centreon::engine::host* hst) {
-  int children(0);
-  for (host_map::iterator it{host::hosts.begin()}, end{host::hosts.end()};
-       it != end; ++it)
-    if (is_host_immediate_child_of_host(hst, it->second.get()))
-      children += number_of_total_child_hosts(it->second.get()) + 1;
-  return children;
+  /* Every host is a descendant of a top-level host. */
+  if (!hst)
+    return host::hosts.size();
+  return host_graph::instance().count(hst, host_graph::children);
 }
 
 /**
@@ -1093,15 +1124,12 @@ int number_of_total_child_hosts(com::centreon::engine::host* hst) {
  *
  *  @param[in] hst Target host.
  *
- *  @return Number of total parent hosts.
+ *  @return Number of distinct hosts above the host, at any depth.
  */
 int number_of_total_parent_hosts(com::centreon::engine::host* hst) {
-  int parents(0);
-  for (host_map::iterator it{host::hosts.begin()}, end{host::hosts.end()};
-       it != end; ++it)
-    if (is_host_immediate_parent_of_host(hst, it->second.get()))
-      parents += number_of_total_parent_hosts(it->second.get()) + 1;
-  return parents;
+  if (!hst)
+    return 0;
+  return host_graph::instance().count(hst, host_graph::parents);
 }
 
 /**
@@ -1315,12 +1343,25 @@ int host::handle_async_check_result_3x(check_result* queued_check_result) {
   /* update the execution time for this check (millisecond resolution) */
   set_execution_time(execution_time);
 
+  /* feed the latency and execution time percentiles */
+  if (queued_check_result->get_check_type() == check_active) {
+    checks::stats::instance().add_timing(checks::stats::active_host_latency,
+                                         get_latency(), current_time);
+    checks::stats::instance().add_timing(
+        checks::stats::active_host_execution_time, execution_time,
+        current_time);
+  } else
+    checks::stats::instance().add_timing(checks::stats::passive_host_latency,
+                                         get_latency(), current_time);
+
   /* set the checked flag */
   set_has_been_checked(true);
 
   /* clear the execution flag if this was an active check */
-  if (queued_check_result->get_check_type() == check_active)
+  if (queued_check_result->get_check_type() == check_active) {
     set_is_executing(false);
+    _orphan_queue.erase(this);
+  }
 
   /* get the last check time */
   set_last_check(queued_check_result->get_start_time().tv_sec);
@@ -1342,12 +1383,11 @@ int host::handle_async_check_result_3x(check_result* queued_check_result) {
   /* parse check output to get: (1) short output, (2) long output, (3) perf data
    */
 
-  std::string output{queued_check_result->get_output()};
   std::string plugin_output;
   std::string long_plugin_output;
   std::string perf_data;
-  parse_check_output(output, plugin_output, long_plugin_output, perf_data, true,
-                     false);
+  parse_check_output(queued_check_result->get_output(), plugin_output,
+                     long_plugin_output, perf_data, true, false);
   set_plugin_output(plugin_output);
   set_long_plugin_output(long_plugin_output);
   set_perf_data(perf_data);
@@ -1478,6 +1518,8 @@ int host::handle_async_check_result_3x(check_result* queued_check_result) {
                     const_cast<char*>(get_plugin_output().c_str()),
                     const_cast<char*>(get_long_plugin_output().c_str()),
                     const_cast<char*>(get_perf_data().c_str()), nullptr);
+  broker_perfdata(NEBTYPE_PERFDATA_PROCESSED, NEBFLAG_NONE, NEBATTR_NONE, this,
+                  nullptr, nullptr);
   return OK;
 }
 
@@ -1675,6 +1717,7 @@ int host::run_async_check(int check_options,
 
   // Set the execution flag.
   set_is_executing(true);
+  update_orphan_deadline();
 
   // Get command object.
   commands::command* cmd = get_check_command_ptr();
@@ -2100,9 +2143,13 @@ void host::clear_flap(double percent_change,
 }
 
 /**
- * @brief Updates host status info. Data are sent to event broker.
+ * @brief Updates host status info. Data are sent to event broker, the host
+ * is marked for the next snapshot publication and its part of the hosts
+ * statistics is updated.
  */
 void host::update_status() {
+  snapshot::instance().host_changed(this);
+  status_stats::hosts().update(*this);
   broker_host_status(NEBTYPE_HOSTSTATUS_UPDATE, NEBFLAG_NONE, NEBATTR_NONE,
                      this, nullptr);
 }
@@ -2353,8 +2400,6 @@ int host::notify_contact(nagios_macros* mac,
                          int escalated) {
   std::string raw_command;
   std::string processed_command;
-  int early_timeout = false;
-  double exectime;
   struct timeval start_time, end_time;
   struct timeval method_start_time, method_end_time;
   int macro_options = STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS;
@@ -2420,9 +2465,9 @@ int host::notify_contact(nagios_macros* mac,
     /* log the notification to program log file */
     if (config->log_notifications()) {
       char const* host_state_str("UP");
-      if ((unsigned int)_current_state < tab_host_states.size())
+      if ((unsigned int)get_current_state() < tab_host_states.size())
         // sizeof(tab_host_state_str) / sizeof(*tab_host_state_str))
-        host_state_str = tab_host_states[_current_state].second.c_str();
+        host_state_str = tab_host_states[get_current_state()].second.c_str();
 
       char const* notification_str("");
       if ((unsigned int)type < tab_notification_str.size())
@@ -2451,24 +2496,27 @@ int host::notify_contact(nagios_macros* mac,
 
     /* run the notification command */
     try {
-      std::string out;
-      my_system_r(mac, processed_command, config->notification_timeout(),
-                  &early_timeout, &exectime, out, 0);
+      std::string contact_name(cntct->get_name());
+      commands::system_runner::instance().run(
+          mac, processed_command, config->notification_timeout(), 0,
+          [processed_command, contact_name](int, bool early_timeout, double,
+                                            std::string const&) {
+            /* check to see if the notification timed out */
+            if (early_timeout) {
+              logger(log_host_notification | log_runtime_warning, basic)
+                  << "Warning: Contact '" << contact_name
+                  << "' host notification command '" << processed_command
+                  << "' timed out after " << config->notification_timeout()
+                  << " seconds";
+            }
+          },
+          cmd->get_name());
     } catch (std::exception const& e) {
       logger(log_runtime_error, basic)
           << "Error: can't execute host notification '" << cntct->get_name()
           << "' : " << e.what();
     }
 
-    /* check to see if the notification timed out */
-    if (early_timeout) {
-      logger(log_host_notification | log_runtime_warning, basic)
-          << "Warning: Contact '" << cntct->get_name()
-          << "' host notification command '" << processed_command
-          << "' timed out after " << config->notification_timeout()
-          << " seconds";
-    }
-
     /* get end time */
     gettimeofday(&method_end_time, nullptr);
 
@@ -2624,21 +2672,14 @@ bool host::is_valid_escalation_for_notification(escalation const* e,
   return true;
 }
 
-/* checks to see if a hosts's check results are fresh */
-bool host::is_result_fresh(time_t current_time, int log_this) {
-  time_t expiration_time = 0L;
-  int freshness_threshold = 0;
-  int days = 0;
-  int hours = 0;
-  int minutes = 0;
-  int seconds = 0;
-  int tdays = 0;
-  int thours = 0;
-  int tminutes = 0;
-  int tseconds = 0;
-
-  logger(dbg_checks, most) << "Checking freshness of host '" << _name << "'...";
-
+/**
+ *  Compute the time after which the results of this host are stale.
+ *
+ *  @param[out] freshness_threshold  The freshness threshold used.
+ *
+ *  @return The expiration time.
+ */
+time_t host::_freshness_expiration(int& freshness_threshold) const {
   /* use user-supplied freshness threshold or auto-calculate a freshness
    * threshold to use? */
   if (get_freshness_threshold() == 0) {
@@ -2653,16 +2694,12 @@ bool host::is_result_fresh(time_t current_time, int log_this) {
   } else
     freshness_threshold = get_freshness_threshold();
 
-  logger(dbg_checks, most) << "Freshness thresholds: host="
-                           << get_freshness_threshold()
-                           << ", use=" << freshness_threshold;
-
   /* calculate expiration time */
   /* CHANGED 11/10/05 EG - program start is only used in expiration time
    * calculation if > last check AND active checks are enabled, so active checks
    * can become stale immediately upon program startup */
   if (!has_been_checked())
-    expiration_time = (time_t)(event_start + freshness_threshold);
+    return (time_t)(event_start + freshness_threshold);
   /* CHANGED 06/19/07 EG - Per Ton's suggestion (and user requests), only use
    * program start time over last check if no specific threshold has been set by
    * user.  Otheriwse use it.  Problems can occur if Engine is restarted more
@@ -2671,11 +2708,32 @@ bool host::is_result_fresh(time_t current_time, int log_this) {
    * suggested by Altinity */
   else if (get_checks_enabled() && event_start > get_last_check() &&
            get_freshness_threshold() == 0)
-    expiration_time =
-        (time_t)(event_start + freshness_threshold +
-                 (config->max_host_check_spread() * config->interval_length()));
+    return (time_t)(event_start + freshness_threshold +
+                    (config->max_host_check_spread() *
+                     config->interval_length()));
   else
-    expiration_time = (time_t)(get_last_check() + freshness_threshold);
+    return (time_t)(get_last_check() + freshness_threshold);
+}
+
+/* checks to see if a hosts's check results are fresh */
+bool host::is_result_fresh(time_t current_time, int log_this) {
+  int freshness_threshold = 0;
+  int days = 0;
+  int hours = 0;
+  int minutes = 0;
+  int seconds = 0;
+  int tdays = 0;
+  int thours = 0;
+  int tminutes = 0;
+  int tseconds = 0;
+
+  logger(dbg_checks, most) << "Checking freshness of host '" << _name << "'...";
+
+  time_t expiration_time = _freshness_expiration(freshness_threshold);
+
+  logger(dbg_checks, most) << "Freshness thresholds: host="
+                           << get_freshness_threshold()
+                           << ", use=" << freshness_threshold;
 
   logger(dbg_checks, most) << "HBC: " << has_been_checked()
                            << ", PS: " << program_start
@@ -2813,7 +2871,8 @@ int host::process_check_result_3x(enum host::host_state new_state,
                                   unsigned long check_timestamp_horizon) {
   com::centreon::engine::host* master_host = nullptr;
   host* temp_host;
-  std::list<host*> check_hostlist;
+  std::vector<host*> check_hostlist;
+  host_graph& graph(host_graph::instance());
   host::host_state parent_state = host::state_up;
   time_t current_time = 0L;
   time_t next_check = 0L;
@@ -2824,6 +2883,19 @@ int host::process_check_result_3x(enum host::host_state new_state,
 
   logger(dbg_functions, basic) << "process_host_check_result_3x()";
 
+  /* each host is queued at most once, whatever the paths leading to it */
+  graph.begin_visit();
+  graph.visit(this);
+  auto propagate = [this, &graph, &check_hostlist](
+                       host_graph::direction dir,
+                       bool (*filter)(host const* neighbour)) {
+    size_t first(check_hostlist.size());
+    graph.neighbours(this, dir, filter, check_hostlist);
+    for (size_t i = first; i < check_hostlist.size(); ++i)
+      logger(dbg_checks, more)
+          << "Check of host '" << check_hostlist[i]->get_name() << "' queued.";
+  };
+
   logger(dbg_checks, more)
       << "HOST: " << _name << ", ATTEMPT=" << get_current_attempt() << "/"
       << get_max_attempts() << ", CHECK TYPE="
@@ -2854,14 +2926,14 @@ int host::process_check_result_3x(enum host::host_state new_state,
   }
 
   /******* HOST WAS DOWN/UNREACHABLE INITIALLY *******/
-  if (_current_state != host::state_up) {
+  if (get_current_state() != host::state_up) {
     logger(dbg_checks, more) << "Host was DOWN/UNREACHABLE.";
 
     /***** HOST IS NOW UP *****/
     /* the host just recovered! */
     if (new_state == host::state_up) {
       /* set the current state */
-      _current_state = host::state_up;
+      set_current_state(host::state_up);
 
       /* set the state type */
       /* set state type to HARD for passive checks and active checks that were
@@ -2886,34 +2958,18 @@ int host::process_check_result_3x(enum host::host_state new_state,
        * somewhere and we should catch the recovery as soon as possible */
       logger(dbg_checks, more) << "Propagating checks to parent host(s)...";
 
-      for (host_map_unsafe::iterator it{parent_hosts.begin()},
-           end{parent_hosts.end()};
-           it != end; it++) {
-        if (!it->second)
-          continue;
-        if (it->second->get_current_state() != host::state_up) {
-          logger(dbg_checks, more)
-              << "Check of parent host '" << it->first << "' queued.";
-          check_hostlist.push_back(it->second);
-        }
-      }
+      propagate(host_graph::parents, [](host const* neighbour) {
+        return neighbour->get_current_state() != host::state_up;
+      });
 
       /* propagate checks to immediate children if they are not already UP */
       /* we do this because children may currently be UNREACHABLE, but may (as a
        * result of this recovery) switch to UP or DOWN states */
       logger(dbg_checks, more) << "Propagating checks to child host(s)...";
 
-      for (host_map_unsafe::iterator it{child_hosts.begin()},
-           end{child_hosts.end()};
-           it != end; it++) {
-        if (!it->second)
-          continue;
-        if (it->second->get_current_state() != host::state_up) {
-          logger(dbg_checks, more)
-              << "Check of child host '" << it->first << "' queued.";
-          check_hostlist.push_back(it->second);
-        }
-      }
+      propagate(host_graph::children, [](host const* neighbour) {
+        return neighbour->get_current_state() != host::state_up;
+      });
     }
 
     /***** HOST IS STILL DOWN/UNREACHABLE *****/
@@ -2948,13 +3004,14 @@ int host::process_check_result_3x(enum host::host_state new_state,
       /* make a determination of the host's state */
       /* translate host state between DOWN/UNREACHABLE (only for passive checks
        * if enabled) */
-      _current_state = new_state;
+      set_current_state(new_state);
       if (get_check_type() == check_active ||
           config->translate_passive_host_checks())
-        _current_state = determine_host_reachability();
+        set_current_state(determine_host_reachability());
 
       /* reschedule the next check if the host state changed */
-      if (_last_state != _current_state || _last_hard_state != _current_state) {
+      if (_last_state != get_current_state() ||
+          _last_hard_state != get_current_state()) {
         reschedule_check = true;
 
         /* schedule a re-check of the host at the retry interval because we
@@ -2984,7 +3041,7 @@ int host::process_check_result_3x(enum host::host_state new_state,
       logger(dbg_checks, more) << "Host is still UP.";
 
       /* set the current state */
-      _current_state = host::state_up;
+      set_current_state(host::state_up);
 
       /* set the state type */
       set_state_type(hard);
@@ -3049,7 +3106,7 @@ int host::process_check_result_3x(enum host::host_state new_state,
                   << "Parent host is UP, so this one is DOWN.";
 
               /* set the current state */
-              _current_state = host::state_down;
+              set_current_state(host::state_down);
               break;
             }
           }
@@ -3058,25 +3115,25 @@ int host::process_check_result_3x(enum host::host_state new_state,
             /* host has no parents, so its up */
             if (parent_hosts.empty()) {
               logger(dbg_checks, more) << "Host has no parents, so it's DOWN.";
-              _current_state = host::state_down;
+              set_current_state(host::state_down);
             } else {
               /* no parents were up, so this host is UNREACHABLE */
               logger(dbg_checks, more)
                   << "No parents were UP, so this host is UNREACHABLE.";
-              _current_state = host::state_unreachable;
+              set_current_state(host::state_unreachable);
             }
           }
         }
         /* set the host state for passive checks */
         else {
           /* set the state */
-          _current_state = new_state;
+          set_current_state(new_state);
 
           /* translate host state between DOWN/UNREACHABLE for passive checks
            * (if enabled) */
           /* make a determination of the host's state */
           if (config->translate_passive_host_checks())
-            _current_state = determine_host_reachability();
+            set_current_state(determine_host_reachability());
         }
 
         /* propagate checks to immediate children if they are not UNREACHABLE */
@@ -3084,17 +3141,9 @@ int host::process_check_result_3x(enum host::host_state new_state,
         logger(dbg_checks, more)
             << "Propagating check to immediate non-UNREACHABLE child hosts...";
 
-        for (host_map_unsafe::iterator it{child_hosts.begin()},
-             end{child_hosts.end()};
-             it != end; it++) {
-          if (!it->second)
-            continue;
-          if (it->second->get_current_state() != host::state_unreachable) {
-            logger(dbg_checks, more)
-                << "Check of child host '" << it->first << "' queued.";
-            check_hostlist.push_back(it->second);
-          }
-        }
+        propagate(host_graph::children, [](host const* neighbour) {
+          return neighbour->get_current_state() != host::state_unreachable;
+        });
       }
       /***** MAX ATTEMPTS > 1 *****/
       else {
@@ -3118,10 +3167,10 @@ int host::process_check_result_3x(enum host::host_state new_state,
          */
         /* translate host state between DOWN/UNREACHABLE (for passive checks
          * only if enabled) */
-        _current_state = new_state;
+        set_current_state(new_state);
         if (get_check_type() == check_active ||
             config->translate_passive_host_checks())
-          _current_state = determine_host_reachability();
+          set_current_state(determine_host_reachability());
 
         /* reschedule a check of the host */
         reschedule_check = true;
@@ -3149,17 +3198,9 @@ int host::process_check_result_3x(enum host::host_state new_state,
             << "Propagating checks to immediate parent hosts that "
                "are UP...";
 
-        for (host_map_unsafe::iterator it{parent_hosts.begin()},
-             end{parent_hosts.end()};
-             it != end; it++) {
-          if (it->second == nullptr)
-            continue;
-          if (it->second->get_current_state() == host::state_up) {
-            check_hostlist.push_back(it->second);
-            logger(dbg_checks, more)
-                << "Check of host '" << it->first << "' queued.";
-          }
-        }
+        propagate(host_graph::parents, [](host const* neighbour) {
+          return neighbour->get_current_state() == host::state_up;
+        });
 
         /* propagate checks to immediate children if they are not UNREACHABLE */
         /* we do this because we may now be blocking the route to child hosts */
@@ -3167,17 +3208,9 @@ int host::process_check_result_3x(enum host::host_state new_state,
             << "Propagating checks to immediate non-UNREACHABLE "
                "child hosts...";
 
-        for (host_map_unsafe::iterator it{child_hosts.begin()},
-             end{child_hosts.end()};
-             it != end; it++) {
-          if (!it->second)
-            continue;
-          if (it->second->get_current_state() != host::state_unreachable) {
-            logger(dbg_checks, more)
-                << "Check of child host '" << it->first << "' queued.";
-            check_hostlist.push_back(it->second);
-          }
-        }
+        propagate(host_graph::children, [](host const* neighbour) {
+          return neighbour->get_current_state() != host::state_unreachable;
+        });
 
         /* check dependencies on second to last host check */
         if (config->enable_predictive_host_dependency_checks() &&
@@ -3198,10 +3231,12 @@ int host::process_check_result_3x(enum host::host_state new_state,
             if (temp_dependency->dependent_host_ptr == this &&
                 temp_dependency->master_host_ptr != nullptr) {
               master_host = (host*)temp_dependency->master_host_ptr;
-              logger(dbg_checks, more)
-                  << "Check of host '" << master_host->get_name()
-                  << "' queued.";
-              check_hostlist.push_back(master_host);
+              if (graph.visit(master_host)) {
+                logger(dbg_checks, more)
+                    << "Check of host '" << master_host->get_name()
+                    << "' queued.";
+                check_hostlist.push_back(master_host);
+              }
             }
           }
         }
@@ -3213,7 +3248,7 @@ int host::process_check_result_3x(enum host::host_state new_state,
                            << ", Attempt=" << get_current_attempt() << "/"
                            << get_max_attempts() << ", Type="
                            << (get_state_type() == hard ? "HARD" : "SOFT")
-                           << ", Final State=" << _current_state;
+                           << ", Final State=" << get_current_state();
 
   /* handle the host state */
   handle_state();
@@ -3222,21 +3257,21 @@ int host::process_check_result_3x(enum host::host_state new_state,
                            << ", Attempt=" << get_current_attempt() << "/"
                            << get_max_attempts() << ", Type="
                            << (get_state_type() == hard ? "HARD" : "SOFT")
-                           << ", Final State=" << _current_state;
+                           << ", Final State=" << get_current_state();
 
   /******************** POST-PROCESSING STUFF *********************/
 
   /* if the plugin output differs from previous check and no state change, log
    * the current state/output if state stalking is enabled */
-  if (_last_state == _current_state &&
+  if (_last_state == get_current_state() &&
       old_plugin_output == get_plugin_output()) {
-    if (_current_state == host::state_up && get_stalk_on(up))
+    if (get_current_state() == host::state_up && get_stalk_on(up))
       log_event();
 
-    else if (_current_state == host::state_down && get_stalk_on(down))
+    else if (get_current_state() == host::state_down && get_stalk_on(down))
       log_event();
 
-    else if (_current_state == host::state_unreachable &&
+    else if (get_current_state() == host::state_unreachable &&
              get_stalk_on(unreachable))
       log_event();
   }
@@ -3274,7 +3309,7 @@ int host::process_check_result_3x(enum host::host_state new_state,
     /* hosts with non-recurring intervals do not get rescheduled if we're in a
      * HARD or UP state */
     if (get_check_interval() == 0 &&
-        (get_state_type() == hard || _current_state == host::state_up))
+        (get_state_type() == hard || get_current_state() == host::state_up))
       set_should_be_scheduled(false);
 
     /* host with active checks disabled do not get rescheduled */
@@ -3296,7 +3331,7 @@ int host::process_check_result_3x(enum host::host_state new_state,
   /* run async checks of all hosts we added above */
   /* don't run a check if one is already executing or we can get by with a
    * cached state */
-  for (std::list<host*>::iterator it{check_hostlist.begin()},
+  for (std::vector<host*>::iterator it{check_hostlist.begin()},
        end{check_hostlist.end()};
        it != end; ++it) {
     run_async_check = true;
@@ -3338,10 +3373,10 @@ enum host::host_state host::determine_host_reachability() {
   logger(dbg_functions, basic) << "determine_host_reachability()";
 
   logger(dbg_checks, most) << "Determining state of host '" << _name
-                           << "': current state=" << _current_state;
+                           << "': current state=" << get_current_state();
 
   /* host is UP - no translation needed */
-  if (_current_state == host::state_up) {
+  if (get_current_state() == host::state_up) {
     state = host::state_up;
     logger(dbg_checks, most) << "Host is UP, no state translation needed.";
   }
@@ -3352,23 +3387,13 @@ enum host::host_state host::determine_host_reachability() {
     logger(dbg_checks, most) << "Host has no parents, so it is DOWN.";
   }
 
-  /* check all parent hosts to see if we're DOWN or UNREACHABLE */
+  /* the number of UP parents is maintained by the host graph */
   else {
-    for (host_map_unsafe::iterator it{parent_hosts.begin()},
-         end{parent_hosts.end()};
-         it != end; it++) {
-      if (!it->second)
-        continue;
-
-      /* bail out as soon as we find one parent host that is UP */
-      if (it->second->get_current_state() == host::state_up) {
-        is_host_present = true;
-        /* set the current state */
-        state = host::state_down;
-        logger(dbg_checks, most) << "At least one parent (" << it->first
-                                 << ") is up, so host is DOWN.";
-        break;
-      }
+    if (host_graph::instance().up_parents(this) > 0) {
+      is_host_present = true;
+      /* set the current state */
+      state = host::state_down;
+      logger(dbg_checks, most) << "At least one parent is up, so host is DOWN.";
     }
     /* no parents were up, so this host is UNREACHABLE */
     if (!is_host_present) {
@@ -3399,25 +3424,30 @@ std::list<hostgroup*>& host::get_parent_groups() {
 bool host::authorized_by_dependencies(dependency::types dependency_type) const {
   logger(dbg_functions, basic) << "host::authorized_by_dependencies()";
 
-  auto p(hostdependency::hostdependencies.equal_range(_name));
-  for (hostdependency_mmap::const_iterator it{p.first}, end{p.second};
-       it != end; ++it) {
-    hostdependency* dep{it->second.get()};
+  dependency_index& index(dependency_index::hosts());
+  dependency_index::verdict cached(index.get_verdict(_state_id,
+                                                     dependency_type));
+  if (cached != dependency_index::unknown)
+    return cached == dependency_index::authorized;
+
+  /* A result depending on the current time is not kept. */
+  bool timed(false);
+  bool authorized(true);
+  for (dependency* d : index.dependencies(_state_id)) {
+    hostdependency* dep{static_cast<hostdependency*>(d)};
     /* Only check dependencies of the desired type (notification or execution)
      */
     if (dep->get_dependency_type() != dependency_type)
       continue;
 
-    /* Find the host we depend on */
-    if (!dep->master_host_ptr)
-      continue;
-
     /* Skip this dependency if it has a timepriod and the current time is
      * not valid */
-    time_t current_time{std::time(nullptr)};
-    if (!dep->get_dependency_period().empty() &&
-        !check_time_against_period(current_time, dep->dependency_period_ptr))
-      return true;
+    if (!dep->get_dependency_period().empty()) {
+      timed = true;
+      time_t current_time{std::time(nullptr)};
+      if (!check_time_against_period(current_time, dep->dependency_period_ptr))
+        break;
+    }
 
     /* Get the status to use (use last hard state if it's currently in a soft
      * state) */
@@ -3428,21 +3458,28 @@ bool host::authorized_by_dependencies(dependency::types dependency_type) const {
             : dep->master_host_ptr->get_current_state();
 
     /* Is the host we depend on in state that fails the dependency tests? */
-    if (dep->get_fail_on(state))
-      return false;
-
-    if (state == host::state_up && !dep->master_host_ptr->has_been_checked() &&
-        dep->get_fail_on_pending())
-      return false;
+    if (dep->get_fail_on(state) ||
+        (state == host::state_up && !dep->master_host_ptr->has_been_checked() &&
+         dep->get_fail_on_pending())) {
+      authorized = false;
+      break;
+    }
 
     /* Immediate dependencies ok at this point - check parent dependencies if
      * necessary */
     if (dep->get_inherits_parent()) {
-      if (!dep->master_host_ptr->authorized_by_dependencies(dependency_type))
-        return false;
+      authorized =
+          dep->master_host_ptr->authorized_by_dependencies(dependency_type);
+      if (index.get_verdict(dep->master_host_ptr->get_state_id(),
+                            dependency_type) == dependency_index::unknown)
+        timed = true;
+      if (!authorized)
+        break;
     }
   }
-  return true;
+  if (!timed)
+    index.set_verdict(_state_id, dependency_type, authorized);
+  return authorized;
 }
 
 /* check freshness of host results */
@@ -3461,46 +3498,58 @@ void host::check_result_freshness() {
 
   /* get the current time */
   time(&current_time);
-
-  /* check all hosts... */
-  for (host_map::iterator it{host::hosts.begin()}, end{host::hosts.end()};
-       it != end; ++it) {
-    /* skip hosts we shouldn't be checking for freshness */
-    if (!it->second->get_check_freshness())
+  time_t const retry_time(current_time +
+                          config->host_freshness_check_interval());
+
+  time_base const& tb(time_base::instance());
+
+  /* check the hosts whose results may be stale... */
+  std::vector<host*> due;
+  _freshness_queue.pop_due(tb.to_internal(current_time), due);
+  for (host* hst : due) {
+    /* skip hosts we shouldn't be checking for freshness, they come back in
+     * the queue when their settings change */
+    if (!hst->get_check_freshness())
       continue;
 
     /* skip hosts that have both active and passive checks disabled */
-    if (!it->second->get_checks_enabled() &&
-        !it->second->get_accept_passive_checks())
+    if (!hst->get_checks_enabled() && !hst->get_accept_passive_checks())
       continue;
 
     /* skip hosts that are currently executing (problems here will be caught by
-     * orphaned host check) */
-    if (it->second->get_is_executing())
-      continue;
-
-    /* skip hosts that are already being freshened */
-    if (it->second->get_is_being_freshened())
+     * orphaned host check) or that are already being freshened, until the
+     * next freshness check */
+    if (hst->get_is_executing() || hst->get_is_being_freshened()) {
+      _freshness_queue.set(hst, tb.to_internal(retry_time));
       continue;
+    }
 
     // See if the time is right...
     {
-      timezone_locker lock(it->second->get_timezone());
-      if (!check_time_against_period(current_time,
-                                     it->second->check_period_ptr))
+      timezone_locker lock(hst->get_timezone());
+      if (!check_time_against_period(current_time, hst->check_period_ptr)) {
+        time_t next_valid_time(0);
+        get_next_valid_time(current_time, &next_valid_time,
+                            hst->check_period_ptr);
+        _freshness_queue.set(
+            hst, tb.to_internal(next_valid_time > current_time ? next_valid_time
+                                                               : retry_time));
         continue;
+      }
     }
 
     /* the results for the last check of this host are stale */
-    if (!it->second->is_result_fresh(current_time, true)) {
+    if (!hst->is_result_fresh(current_time, true)) {
       /* set the freshen flag */
-      it->second->set_is_being_freshened(true);
+      hst->set_is_being_freshened(true);
 
       /* schedule an immediate forced check of the host */
-      it->second->schedule_check(
+      hst->schedule_check(
           current_time,
           CHECK_OPTION_FORCE_EXECUTION | CHECK_OPTION_FRESHNESS_CHECK);
-    }
+      _freshness_queue.set(hst, tb.to_internal(retry_time));
+    } else
+      hst->update_freshness_deadline();
   }
 }
 
@@ -3517,7 +3566,7 @@ void host::adjust_check_attempt(bool is_active) {
                            << _name
                            << "': current attempt=" << get_current_attempt()
                            << "/" << get_max_attempts()
-                           << ", state=" << _current_state
+                           << ", state=" << get_current_state()
                            << ", state type=" << get_state_type();
 
   /* if host is in a hard state, reset current attempt number */
@@ -3527,7 +3576,7 @@ void host::adjust_check_attempt(bool is_active) {
   /* if host is in a soft UP state, reset current attempt number (active checks
    * only) */
   else if (is_active && get_state_type() == notifier::soft &&
-           _current_state == host::state_up)
+           get_current_state() == host::state_up)
     set_current_attempt(1);
 
   /* increment current attempt number */
@@ -3548,50 +3597,110 @@ void host::check_for_orphaned() {
   /* get the current time */
   time(&current_time);
 
-  /* check all hosts... */
-  for (host_map::iterator it{host::hosts.begin()}, end{host::hosts.end()};
-       it != end; ++it) {
+  time_base const& tb(time_base::instance());
+
+  /* check the executing hosts whose results should be there by now... */
+  std::vector<host*> due;
+  _orphan_queue.pop_due(tb.to_internal(current_time), due);
+  for (host* hst : due) {
     /* skip hosts that don't have a set check interval (on-demand checks are
      * missed by the orphan logic) */
-    if (it->second->get_next_check() == (time_t)0L)
+    if (hst->get_next_check() == (time_t)0L)
       continue;
 
     /* skip hosts that are not currently executing */
-    if (!it->second->get_is_executing())
+    if (!hst->get_is_executing())
       continue;
 
     /* determine the time at which the check results should have come in (allow
      * 10 minutes slack time) */
-    expected_time = (time_t)(
-        it->second->get_next_check() + it->second->get_latency() +
-        config->host_check_timeout() + config->check_reaper_interval() + 600);
+    expected_time = hst->_orphan_expected_time();
+
+    /* the check was rescheduled in the meantime */
+    if (expected_time >= current_time) {
+      _orphan_queue.set(hst, tb.to_internal(expected_time + 1));
+      continue;
+    }
 
     /* this host was supposed to have executed a while ago, but for some reason
      * the results haven't come back in... */
-    if (expected_time < current_time) {
-      /* log a warning */
-      logger(log_runtime_warning, basic)
-          << "Warning: The check of host '" << it->second->get_name()
-          << "' looks like it was orphaned (results never came back).  "
-             "I'm scheduling an immediate check of the host...";
+    /* log a warning */
+    logger(log_runtime_warning, basic)
+        << "Warning: The check of host '" << hst->get_name()
+        << "' looks like it was orphaned (results never came back).  "
+           "I'm scheduling an immediate check of the host...";
 
-      logger(dbg_checks, more)
-          << "Host '" << it->second->get_name()
-          << "' was orphaned, so we're scheduling an immediate check...";
+    logger(dbg_checks, more)
+        << "Host '" << hst->get_name()
+        << "' was orphaned, so we're scheduling an immediate check...";
 
-      /* decrement the number of running host checks */
-      if (currently_running_host_checks > 0)
-        currently_running_host_checks--;
+    /* decrement the number of running host checks */
+    if (currently_running_host_checks > 0)
+      currently_running_host_checks--;
 
-      /* disable the executing flag */
-      it->second->set_is_executing(false);
+    /* disable the executing flag */
+    hst->set_is_executing(false);
 
-      /* schedule an immediate check of the host */
-      it->second->schedule_check(current_time, CHECK_OPTION_ORPHAN_CHECK);
-    }
+    /* schedule an immediate check of the host */
+    hst->schedule_check(current_time, CHECK_OPTION_ORPHAN_CHECK);
   }
 }
 
+/**
+ *  Index all the hosts by the time their results become stale and the
+ *  executing ones by the time their results are late. Called once the
+ *  configuration and the retention are applied.
+ */
+void host::rebuild_check_deadlines() {
+  _freshness_queue.clear();
+  _orphan_queue.clear();
+  for (host_map::iterator it{host::hosts.begin()}, end{host::hosts.end()};
+       it != end; ++it) {
+    it->second->update_freshness_deadline();
+    if (it->second->get_is_executing())
+      it->second->update_orphan_deadline();
+  }
+}
+
+/**
+ *  Index the host by the time its results become stale, so that
+ *  check_result_freshness() only looks at the hosts that are due. It is
+ *  called after each check result and when the freshness settings change.
+ */
+void host::update_freshness_deadline() {
+  if (!get_check_freshness() ||
+      (!get_checks_enabled() && !get_accept_passive_checks()))
+    _freshness_queue.erase(this);
+  else {
+    int freshness_threshold;
+    /* Results are stale once the expiration time is passed. */
+    time_t expiration(_freshness_expiration(freshness_threshold));
+    _freshness_queue.set(this,
+                         time_base::instance().to_internal(expiration + 1));
+  }
+}
+
+/**
+ *  Index the host by the time the result of its running check is late, so
+ *  that check_for_orphaned() only looks at the late checks.
+ */
+void host::update_orphan_deadline() {
+  _orphan_queue.set(
+      this, time_base::instance().to_internal(_orphan_expected_time() + 1));
+}
+
+/**
+ *  Get the time at which the result of the running check should have come
+ *  in, with 10 minutes of slack time.
+ *
+ *  @return A time.
+ */
+time_t host::_orphan_expected_time() const {
+  return (time_t)(get_next_check() + get_latency() +
+                  config->host_check_timeout() +
+                  config->check_reaper_interval() + 600);
+}
+
 std::string const& host::get_current_state_as_string() const {
   return tab_host_states[get_current_state()].second;
 }
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/host_graph.hh"
+
+#include <algorithm>
+
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/state_table.hh"
+
+using namespace com::centreon::engine;
+
+/**
+ *  Constructor. The graph is built on its first use.
+ */
+host_graph::host_graph() : _valid{false}, _visit{0} {}
+
+/**
+ *  Start a new visit: the hosts visited before can be visited again.
+ */
+void host_graph::begin_visit() noexcept {
+  if (++_visit == 0) {
+    std::fill(_visited.begin(), _visited.end(), 0);
+    _visit = 1;
+  }
+}
+
+/**
+ *  Count the distinct ancestors or descendants of a host, with a breadth
+ *  first search. This starts a new visit.
+ *
+ *  @param[in] hst  The host.
+ *  @param[in] dir  parents for the ancestors, children for the descendants.
+ *
+ *  @return A number of hosts.
+ */
+uint32_t host_graph::count(host const* hst, direction dir) {
+  uint32_t start = _index(hst);
+  std::vector<uint32_t> const& offsets(dir == parents ? _parent_offsets
+                                                      : _child_offsets);
+  std::vector<uint32_t> const& edges(dir == parents ? _parents : _children);
+
+  begin_visit();
+  std::vector<uint32_t> queue{start};
+  _visited[start] = _visit;
+  for (size_t i = 0; i < queue.size(); ++i)
+    for (uint32_t e = offsets[queue[i]]; e < offsets[queue[i] + 1]; ++e)
+      if (_visited[edges[e]] != _visit) {
+        _visited[edges[e]] = _visit;
+        queue.push_back(edges[e]);
+      }
+  return queue.size() - 1;
+}
+
+/**
+ *  Get the topology of the hosts.
+ *
+ *  @return The graph.
+ */
+host_graph& host_graph::instance() {
+  static host_graph instance;
+  return instance;
+}
+
+/**
+ *  Rebuild the graph on its next use. Called when hosts are created or
+ *  destroyed and when their parents change.
+ */
+void host_graph::invalidate() noexcept {
+  _valid = false;
+}
+
+/**
+ *  Append the parents or the children of a host accepted by a filter and
+ *  not visited yet, and mark them as visited.
+ *
+ *  @param[in]     hst      The host.
+ *  @param[in]     dir      The neighbours to look at.
+ *  @param[in]     filter   Tells if a neighbour is a target.
+ *  @param[in,out] targets  The targets.
+ */
+void host_graph::neighbours(host const* hst,
+                            direction dir,
+                            bool (*filter)(host const* neighbour),
+                            std::vector<host*>& targets) {
+  uint32_t id = _index(hst);
+  std::vector<uint32_t> const& offsets(dir == parents ? _parent_offsets
+                                                      : _child_offsets);
+  std::vector<uint32_t> const& edges(dir == parents ? _parents : _children);
+  state_table const& states(state_table::hosts());
+  for (uint32_t e = offsets[id]; e < offsets[id + 1]; ++e) {
+    host* neighbour = static_cast<host*>(states.object[edges[e]]);
+    if (filter(neighbour) && visit(neighbour))
+      targets.push_back(neighbour);
+  }
+}
+
+/**
+ *  Update the number of UP parents of the children of a host that went UP
+ *  or that is not UP anymore.
+ *
+ *  @param[in] hst  The host.
+ *  @param[in] up   True if the host is now UP.
+ */
+void host_graph::state_changed(host const* hst, bool up) {
+  if (!_valid)
+    return;
+  uint32_t id = hst->get_state_id();
+  if (id + 1 >= _child_offsets.size())
+    return;
+  for (uint32_t e = _child_offsets[id]; e < _child_offsets[id + 1]; ++e) {
+    if (up)
+      ++_up_parents[_children[e]];
+    else if (_up_parents[_children[e]])
+      --_up_parents[_children[e]];
+  }
+}
+
+/**
+ *  Get the number of UP parents of a host.
+ *
+ *  @param[in] hst  The host.
+ *
+ *  @return A number of hosts.
+ */
+uint32_t host_graph::up_parents(host const* hst) {
+  return _up_parents[_index(hst)];
+}
+
+/**
+ *  Mark a host as visited.
+ *
+ *  @param[in] hst  The host.
+ *
+ *  @return False if the host was already visited.
+ */
+bool host_graph::visit(host const* hst) {
+  uint32_t id = _index(hst);
+  if (_visited[id] == _visit)
+    return false;
+  _visited[id] = _visit;
+  return true;
+}
+
+/**
+ *  Build the adjacency arrays from the parent_hosts maps, and count the UP
+ *  parents of each host.
+ */
+void host_graph::_build() {
+  state_table const& states(state_table::hosts());
+  uint32_t size = states.size();
+  _parent_offsets.assign(size + 1, 0);
+  _child_offsets.assign(size + 1, 0);
+  _up_parents.assign(size, 0);
+  _visited.assign(size, 0);
+  _visit = 1;
+
+  for (uint32_t id = 0; id < size; ++id) {
+    host const* hst = static_cast<host const*>(states.object[id]);
+    if (!hst)
+      continue;
+    for (host_map_unsafe::const_iterator it(hst->parent_hosts.begin()),
+         end(hst->parent_hosts.end());
+         it != end; ++it)
+      if (it->second) {
+        ++_parent_offsets[id + 1];
+        ++_child_offsets[it->second->get_state_id() + 1];
+      }
+  }
+  for (uint32_t id = 0; id < size; ++id) {
+    _parent_offsets[id + 1] += _parent_offsets[id];
+    _child_offsets[id + 1] += _child_offsets[id];
+  }
+
+  _parents.resize(_parent_offsets[size]);
+  _children.resize(_child_offsets[size]);
+  std::vector<uint32_t> child_pos(_child_offsets.begin(),
+                                  _child_offsets.end() - 1);
+  for (uint32_t id = 0; id < size; ++id) {
+    host const* hst = static_cast<host const*>(states.object[id]);
+    if (!hst)
+      continue;
+    uint32_t parent_pos = _parent_offsets[id];
+    for (host_map_unsafe::const_iterator it(hst->parent_hosts.begin()),
+         end(hst->parent_hosts.end());
+         it != end; ++it)
+      if (it->second) {
+        uint32_t parent = it->second->get_state_id();
+        _parents[parent_pos++] = parent;
+        _children[child_pos[parent]++] = id;
+        if (it->second->get_current_state() == host::state_up)
+          ++_up_parents[id];
+      }
+  }
+  _valid = true;
+}
+
+/**
+ *  Get the index of a host, building the graph if needed.
+ *
+ *  @param[in] hst  The host.
+ *
+ *  @return The index.
+ */
+uint32_t host_graph::_index(host const* hst) {
+  if (!_valid)
+    _build();
+  return hst->get_state_id();
+}
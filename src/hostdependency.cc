@@ -21,6 +21,7 @@
 #include <array>
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
+#include "com/centreon/engine/dependency_index.hh"
 #include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
@@ -69,7 +70,16 @@ hostdependency::hostdependency(std::string const& dependent_hostname,
       dependent_host_ptr{nullptr},
       _fail_on_up{fail_on_up},
       _fail_on_down{fail_on_down},
-      _fail_on_unreachable{fail_on_unreachable} {}
+      _fail_on_unreachable{fail_on_unreachable} {
+  dependency_index::hosts().invalidate();
+}
+
+/**
+ *  Destructor.
+ */
+hostdependency::~hostdependency() noexcept {
+  dependency_index::hosts().invalidate();
+}
 
 bool hostdependency::get_fail_on(int state) const {
   std::array<bool, 3> retval{_fail_on_up, _fail_on_down, _fail_on_unreachable};
@@ -278,6 +288,9 @@ void hostdependency::resolve(int& w, int& e) {
       dependency_period_ptr = it->second.get();
   }
 
+  // The dependency index is built from the resolved pointers.
+  dependency_index::hosts().invalidate();
+
   // Add errors.
   if (errors) {
     e += errors;
@@ -0,0 +1,450 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/logging/async_file.hh"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "com/centreon/engine/exceptions/error.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::logging;
+
+/* Each async_file has its own id so that a thread never confuses the ring
+ * of a destroyed file with the one of a new file at the same address. */
+static std::atomic<uint64_t> next_id{1};
+
+/**
+ *  @class async_file::ring
+ *  @brief Lines written by one thread and not yet written in the file.
+ *
+ *  Only the owner thread moves head, only the writer thread moves tail. Both
+ *  are never wrapped, their value modulo capacity is the position in data.
+ *  orphaned is set when the owner thread exits, the writer thread then drops
+ *  the ring once it is empty.
+ */
+class async_file::ring {
+ public:
+  static uint32_t const capacity = 1u << 18;
+
+  std::atomic<uint64_t> head{0};
+  /* Keep head and tail in different cache lines. */
+  char padding[64 - sizeof(std::atomic<uint64_t>)];
+  std::atomic<uint64_t> tail{0};
+  std::atomic<bool> orphaned{false};
+  char data[capacity];
+};
+
+/**
+ *  @struct async_file::thread_rings
+ *  @brief Rings of a thread, one per file.
+ *
+ *  Rings are owned by the files, so they are marked as orphaned when their
+ *  thread exits.
+ */
+struct async_file::thread_rings {
+  std::vector<std::pair<uint64_t, std::weak_ptr<ring>>> rings;
+
+  ~thread_rings() {
+    for (auto& p : rings) {
+      std::shared_ptr<ring> r(p.second.lock());
+      if (r)
+        r->orphaned.store(true, std::memory_order_release);
+    }
+  }
+};
+
+/**
+ *  Constructor. The file is opened and the writer thread is started.
+ *
+ *  @param[in] path      Path to the file.
+ *  @param[in] show_pid  Write the process id on each line.
+ *  @param[in] max_size  Maximum file size, 0 for no limit.
+ */
+async_file::async_file(std::string const& path,
+                       bool show_pid,
+                       uint64_t max_size)
+    : backend(false, show_pid, com::centreon::logging::second, false),
+      _path{path},
+      _max_size{max_size},
+      _id{next_id++},
+      _fd{-1},
+      _size{0},
+      _drained{0},
+      _closed{false},
+      _reopen{false},
+      _stop{false} {
+  _open_file();
+  if (_fd < 0) {
+    char const* msg(strerror(errno));
+    throw engine_error() << "Cannot open log file '" << _path << "': " << msg;
+  }
+  _writer = std::thread(&async_file::_write_loop, this);
+}
+
+/**
+ *  Destructor. Lines still buffered are written before the file is closed.
+ *  The file must have been removed from the logging engine.
+ */
+async_file::~async_file() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    _stop = true;
+  }
+  _cv.notify_one();
+  _writer.join();
+}
+
+/**
+ *  Write the buffered lines and close the file.
+ */
+void async_file::close() noexcept {
+  try {
+    flush();
+    {
+      std::lock_guard<std::mutex> lock(_m);
+      _closed = true;
+      _reopen = true;
+    }
+    flush();
+  } catch (std::exception const&) {
+  }
+}
+
+/**
+ *  Get the path of the file.
+ *
+ *  @return The path.
+ */
+std::string const& async_file::filename() const noexcept {
+  return _path;
+}
+
+/**
+ *  Wait until the lines logged before this call are written.
+ */
+void async_file::flush() {
+  std::unique_lock<std::mutex> lock(_m);
+  /* The next pass may have started before this call. */
+  uint64_t target = _drained + 2;
+  _cv.notify_one();
+  _drained_cv.wait(lock,
+                   [this, target] { return _drained >= target || _stop; });
+}
+
+/**
+ *  Copy a message into the ring of the calling thread. When the ring is
+ *  full, the writer thread is woken up and the caller waits for it.
+ *
+ *  @param[in] types    Logging types.
+ *  @param[in] verbose  Verbosity level.
+ *  @param[in] msg      Message to log.
+ *  @param[in] size     Message length.
+ */
+void async_file::log(uint64_t types,
+                     uint32_t verbose,
+                     char const* msg,
+                     uint32_t size) noexcept {
+  (void)types;
+  (void)verbose;
+  thread_local std::string buffer;
+
+  ring* r;
+  try {
+    _build_line(buffer, msg, size);
+    r = &_thread_ring();
+  } catch (std::exception const&) {
+    return;
+  }
+
+  uint64_t len = std::min<uint64_t>(buffer.size(), ring::capacity);
+  uint64_t head = r->head.load(std::memory_order_relaxed);
+  auto has_room = [r, head, len] {
+    return ring::capacity - (head - r->tail.load(std::memory_order_acquire)) >=
+           len;
+  };
+  if (!has_room()) {
+    /* Tails are moved before _drained is incremented, under the lock. */
+    try {
+      std::unique_lock<std::mutex> lock(_m);
+      _cv.notify_one();
+      _drained_cv.wait(lock, [this, &has_room] { return has_room() || _stop; });
+      if (!has_room())
+        return;
+    } catch (std::exception const&) {
+      return;
+    }
+  }
+
+  uint32_t pos = head % ring::capacity;
+  uint32_t first = std::min<uint64_t>(len, ring::capacity - pos);
+  memcpy(r->data + pos, buffer.data(), first);
+  memcpy(r->data, buffer.data() + first, len - first);
+  r->head.store(head + len, std::memory_order_release);
+
+  /* The writer thread wakes up regularly, it is only hurried when the ring
+   * is getting full. */
+  if (head + len - r->tail.load(std::memory_order_relaxed) >
+      ring::capacity / 2)
+    _cv.notify_one();
+}
+
+/**
+ *  Open the file closed by close().
+ */
+void async_file::open() {
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    _closed = false;
+    _reopen = true;
+  }
+  _cv.notify_one();
+}
+
+/**
+ *  Close and open again the file, after a log rotation for example.
+ */
+void async_file::reopen() {
+  {
+    std::lock_guard<std::mutex> lock(_m);
+    _reopen = true;
+  }
+  _cv.notify_one();
+}
+
+/**
+ *  Get the ring of the calling thread, it is created on the first call.
+ *
+ *  @return The ring.
+ */
+async_file::ring& async_file::_thread_ring() {
+  static thread_local thread_rings local;
+  std::vector<std::pair<uint64_t, std::weak_ptr<ring>>>& rings(local.rings);
+  for (auto it = rings.begin(); it != rings.end();) {
+    if (it->first == _id)
+      return *it->second.lock();
+    if (it->second.expired())
+      it = rings.erase(it);
+    else
+      ++it;
+  }
+
+  std::shared_ptr<ring> r(std::make_shared<ring>());
+  {
+    std::lock_guard<std::mutex> lock(_rings_m);
+    _rings.push_back(r);
+  }
+  rings.emplace_back(_id, r);
+  return *r;
+}
+
+/**
+ *  Build the lines of a message with the same header as
+ *  com::centreon::logging::file.
+ *
+ *  @param[out] buffer  The lines.
+ *  @param[in]  msg     Message to log.
+ *  @param[in]  size    Message length.
+ */
+void async_file::_build_line(std::string& buffer,
+                             char const* msg,
+                             uint32_t size) const {
+  char header[64];
+  int len = 0;
+  timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  switch (_show_timestamp) {
+    case com::centreon::logging::second:
+      len = snprintf(header, sizeof(header), "[%lld] ",
+                     static_cast<long long>(now.tv_sec));
+      break;
+    case com::centreon::logging::millisecond:
+      len = snprintf(header, sizeof(header), "[%lld] ",
+                     static_cast<long long>(now.tv_sec) * 1000 +
+                         now.tv_nsec / 1000000);
+      break;
+    case com::centreon::logging::microsecond:
+      len = snprintf(header, sizeof(header), "[%lld] ",
+                     static_cast<long long>(now.tv_sec) * 1000000 +
+                         now.tv_nsec / 1000);
+      break;
+    default:
+      break;
+  }
+  if (_show_pid)
+    len += snprintf(header + len, sizeof(header) - len, "[%d] ", getpid());
+  if (_show_thread_id)
+    len += snprintf(header + len, sizeof(header) - len, "[%lu] ",
+                    static_cast<unsigned long>(pthread_self()));
+
+  buffer.clear();
+  if (!msg)
+    return;
+  uint32_t last = 0;
+  for (uint32_t i = 0; i <= size; ++i) {
+    if (i == size || msg[i] == '\n') {
+      if (i != last || i != size) {
+        buffer.append(header, len);
+        buffer.append(msg + last, i - last);
+        buffer.push_back('\n');
+      }
+      last = i + 1;
+    }
+  }
+}
+
+/**
+ *  Write the content of all the rings with one writev() call and rotate the
+ *  file if needed. Called by the writer thread.
+ */
+void async_file::_drain() {
+  std::vector<iovec> iov;
+  std::vector<std::pair<ring*, uint64_t>> heads;
+  bool orphans = false;
+  {
+    /* Rings are only removed by this thread, so their pointers stay valid
+     * once the lock is released. */
+    std::lock_guard<std::mutex> lock(_rings_m);
+    for (std::shared_ptr<ring> const& r : _rings) {
+      orphans = orphans || r->orphaned.load(std::memory_order_relaxed);
+      uint64_t head = r->head.load(std::memory_order_acquire);
+      uint64_t tail = r->tail.load(std::memory_order_relaxed);
+      if (head == tail)
+        continue;
+      uint32_t pos = tail % ring::capacity;
+      uint64_t len = head - tail;
+      uint32_t first = std::min<uint64_t>(len, ring::capacity - pos);
+      iov.push_back({r->data + pos, first});
+      if (len > first)
+        iov.push_back({r->data, static_cast<size_t>(len - first)});
+      heads.emplace_back(r.get(), head);
+    }
+  }
+  if (orphans)
+    _drop_orphans();
+  if (heads.empty())
+    return;
+
+  /* Lines are lost if the file cannot be written, as with
+   * com::centreon::logging::file. */
+  size_t idx = 0;
+  while (_fd >= 0 && idx < iov.size()) {
+    int count = std::min<size_t>(iov.size() - idx, IOV_MAX);
+    ssize_t written = ::writev(_fd, &iov[idx], count);
+    if (written < 0 && errno == EINTR)
+      continue;
+    if (written <= 0)
+      break;
+    _size += written;
+    size_t left = written;
+    while (idx < iov.size() && left >= iov[idx].iov_len) {
+      left -= iov[idx].iov_len;
+      ++idx;
+    }
+    if (idx < iov.size()) {
+      iov[idx].iov_base = static_cast<char*>(iov[idx].iov_base) + left;
+      iov[idx].iov_len -= left;
+    }
+  }
+
+  for (std::pair<ring*, uint64_t> const& h : heads)
+    h.first->tail.store(h.second, std::memory_order_release);
+
+  if (_fd >= 0 && _max_size && _size > _max_size) {
+    ::close(_fd);
+    ::rename(_path.c_str(), (_path + ".old").c_str());
+    _open_file();
+  }
+}
+
+/**
+ *  Release the empty rings of the exited threads. The ring may still have
+ *  been filled between the orphaned flag and its last line, so the flag is
+ *  read before head. Called by the writer thread.
+ */
+void async_file::_drop_orphans() {
+  std::lock_guard<std::mutex> lock(_rings_m);
+  _rings.erase(
+      std::remove_if(_rings.begin(), _rings.end(),
+                     [](std::shared_ptr<ring> const& r) {
+                       return r->orphaned.load(std::memory_order_acquire) &&
+                              r->head.load(std::memory_order_acquire) ==
+                                  r->tail.load(std::memory_order_relaxed);
+                     }),
+      _rings.end());
+}
+
+/**
+ *  Open the file in append mode. Called by the constructor and then by the
+ *  writer thread.
+ */
+void async_file::_open_file() {
+  _fd = ::open(_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  _size = 0;
+  struct stat st;
+  if (_fd >= 0 && !fstat(_fd, &st))
+    _size = st.st_size;
+}
+
+/**
+ *  Writer thread: empties the rings every 20ms or when a ring is getting
+ *  full, until the destructor stops it.
+ */
+void async_file::_write_loop() {
+  std::unique_lock<std::mutex> lock(_m);
+  for (;;) {
+    if (_reopen) {
+      _reopen = false;
+      bool closed = _closed;
+      lock.unlock();
+      if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+      }
+      if (!closed)
+        _open_file();
+      lock.lock();
+    }
+    bool stop = _stop;
+    lock.unlock();
+    _drain();
+    lock.lock();
+    ++_drained;
+    _drained_cv.notify_all();
+    if (stop)
+      break;
+    _cv.wait_for(lock, std::chrono::milliseconds(20));
+  }
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+}
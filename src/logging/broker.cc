@@ -27,6 +27,16 @@
 using namespace com::centreon;
 using namespace com::centreon::engine::logging;
 
+std::atomic_bool broker::_batch{false};
+std::mutex broker::_pending_m;
+std::vector<broker::pending_log> broker::_pending;
+uint32_t broker::_dropped = 0;
+size_t const broker::max_pending;
+
+/* Set while flush() sends messages, messages logged by the modules then
+ * are not sent again to the broker. */
+static thread_local bool flushing = false;
+
 /**
  *  Default constructor.
  */
@@ -93,6 +103,22 @@ void broker::log(uint64_t types,
   (void)verbose;
   std::lock_guard<std::recursive_mutex> lock(_lock);
 
+  if (_batch) {
+    if (message && _enable && !flushing &&
+        _thread_id != std::this_thread::get_id()) {
+      try {
+        std::lock_guard<std::mutex> pending_lock(_pending_m);
+        if (_pending.size() < max_pending)
+          _pending.push_back(
+              {types, time(nullptr), std::string(message, size)});
+        else
+          ++_dropped;
+      } catch (std::exception const&) {
+      }
+    }
+    return;
+  }
+
   if (_thread_id != std::this_thread::get_id()) {
     // Broker is only notified of non-debug log messages.
     if (message && _enable) {
@@ -125,3 +151,47 @@ void broker::reopen() {
   std::lock_guard<std::recursive_mutex> lock(_lock);
   _enable = true;
 }
+
+/**
+ *  Enable or disable the batch mode.
+ *
+ *  @param[in] enable  True to store messages until flush() is called.
+ */
+void broker::batch(bool enable) noexcept {
+  _batch = enable;
+}
+
+/**
+ *  Send the stored messages to the broker. This method must be called from
+ *  the main loop.
+ */
+void broker::flush() {
+  std::vector<pending_log> pending;
+  uint32_t dropped;
+  {
+    std::lock_guard<std::mutex> lock(_pending_m);
+    if (_pending.empty())
+      return;
+    std::swap(pending, _pending);
+    dropped = _dropped;
+    _dropped = 0;
+  }
+
+  flushing = true;
+  for (pending_log& p : pending)
+    broker_log_data(NEBTYPE_LOG_DATA, NEBFLAG_NONE, NEBATTR_NONE,
+                    &p.message[0], p.types, p.time, nullptr);
+  flushing = false;
+
+  if (dropped)
+    logger(log_runtime_warning, basic)
+        << "Warning: " << dropped
+        << " log messages were not sent to the broker, more than "
+        << max_pending << " were waiting";
+
+  /* Give the buffer back to keep its capacity. */
+  pending.clear();
+  std::lock_guard<std::mutex> lock(_pending_m);
+  if (_pending.empty())
+    std::swap(pending, _pending);
+}
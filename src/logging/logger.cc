@@ -0,0 +1,41 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/logging/logger.hh"
+
+#include "com/centreon/logging/engine.hh"
+
+using namespace com::centreon::engine::logging;
+
+std::atomic<uint64_t> mask::_types[most + 1];
+
+/**
+ *  Read again the types logged by the backends of the logging engine. The
+ *  engine does not give them, so each type is asked to it.
+ */
+void mask::update() noexcept {
+  com::centreon::logging::engine& e(com::centreon::logging::engine::instance());
+  for (uint32_t verbose = basic; verbose <= most; ++verbose) {
+    uint64_t types = 0;
+    for (uint32_t i = 0; i < 64; ++i)
+      if (e.is_log(1ull << i, verbose))
+        types |= 1ull << i;
+    _types[verbose].store(types, std::memory_order_relaxed);
+  }
+}
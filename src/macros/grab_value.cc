@@ -24,6 +24,7 @@
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/macros.hh"
+#include "com/centreon/engine/object_index.hh"
 #include "com/centreon/engine/string.hh"
 
 using namespace com::centreon::engine;
@@ -61,11 +62,9 @@ static int handle_host_macro(nagios_macros* mac,
     // or use saved host pointer.
     host* hst = nullptr;
 
-    if (!arg1.empty()) {
-      host_map::const_iterator it(host::hosts.find(arg1));
-      if (it != host::hosts.end())
-        hst = it->second.get();
-    } else
+    if (!arg1.empty())
+      hst = object_index::find_host(arg1);
+    else
       hst = mac->host_ptr;
 
     if (hst)
@@ -192,25 +191,25 @@ static int handle_service_macro(nagios_macros* mac,
       if (!mac->host_ptr)
         retval = ERROR;
       else if (!arg2.empty()) {
-        service_map::const_iterator found(
-            service::services.find({mac->host_ptr->get_name(), arg2}));
+        service* svc(
+            object_index::find_service(mac->host_ptr->get_name(), arg2));
 
-        if (found == service::services.end() || !found->second)
+        if (!svc)
           retval = ERROR;
         else
           // Get the service macro value.
-          retval = grab_standard_service_macro_r(
-              mac, macro_type, found->second.get(), output, free_macro);
+          retval = grab_standard_service_macro_r(mac, macro_type, svc, output,
+                                                 free_macro);
       } else
         retval = ERROR;
     } else if (!arg1.empty() && !arg2.empty()) {
       // On-demand macro with both host and service name.
-      service_map::const_iterator found(service::services.find({arg1, arg2}));
+      service* svc(object_index::find_service(arg1, arg2));
 
-      if (found != service::services.end() && found->second)
+      if (svc)
         // Get the service macro value.
-        retval = grab_standard_service_macro_r(
-            mac, macro_type, found->second.get(), output, free_macro);
+        retval = grab_standard_service_macro_r(mac, macro_type, svc, output,
+                                               free_macro);
       // Else we have a service macro with a
       // servicegroup name and a delimiter...
       else {
@@ -33,6 +33,7 @@
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/broker/loader.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/config.hh"
 #include "com/centreon/engine/configuration/applier/logging.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
@@ -170,6 +171,7 @@ int main(int argc, char* argv[]) {
 
     // Checker init
     checks::checker::init();
+    commands::system_runner::init();
 
     // Just display the license.
     if (display_license) {
@@ -375,6 +377,7 @@ int main(int argc, char* argv[]) {
         // Add broker backend.
         com::centreon::logging::engine::instance().add(
             &backend_broker_log, logging::log_all, logging::basic);
+        logging::mask::update();
 
         // Apply configuration.
         configuration::applier::state::instance().apply(config, state);
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/name_table.hh"
+
+#include <cstring>
+
+using namespace com::centreon::engine;
+
+/**
+ *  Get the name table.
+ *
+ *  @return The singleton.
+ */
+name_table& name_table::instance() {
+  static name_table instance;
+  return instance;
+}
+
+/**
+ *  Constructor.
+ */
+name_table::name_table() : _slots(1024, 0) {}
+
+/**
+ *  Find the id of a name.
+ *
+ *  @param[in] name  The name, not necessarily null-terminated.
+ *  @param[in] len   Its length.
+ *
+ *  @return The id, 0 if the name is not in the table.
+ */
+uint32_t name_table::find(char const* name, size_t len) const noexcept {
+  uint32_t h = _hash(name, len);
+  size_t mask = _slots.size() - 1;
+  for (size_t i = h & mask;; i = (i + 1) & mask) {
+    uint64_t slot = _slots[i];
+    if (!slot)
+      return 0;
+    if (slot >> 32 == h) {
+      uint32_t id = static_cast<uint32_t>(slot);
+      std::string const& n = _names[id - 1];
+      if (n.size() == len && !memcmp(n.data(), name, len))
+        return id;
+    }
+  }
+}
+
+/**
+ *  Find the id of a name.
+ *
+ *  @param[in] name  The name.
+ *
+ *  @return The id, 0 if the name is not in the table.
+ */
+uint32_t name_table::find(std::string const& name) const noexcept {
+  return find(name.data(), name.size());
+}
+
+/**
+ *  Get the id of a name, the name is added if needed.
+ *
+ *  @param[in] name  The name.
+ *
+ *  @return The id.
+ */
+uint32_t name_table::intern(std::string const& name) {
+  uint32_t id = find(name);
+  if (id)
+    return id;
+
+  if ((_names.size() + 1) * 2 > _slots.size())
+    _grow();
+  _names.push_back(name);
+  id = _names.size();
+  uint32_t h = _hash(name.data(), name.size());
+  size_t mask = _slots.size() - 1;
+  size_t i = h & mask;
+  while (_slots[i])
+    i = (i + 1) & mask;
+  _slots[i] = static_cast<uint64_t>(h) << 32 | id;
+  return id;
+}
+
+/**
+ *  Get the name of an id.
+ *
+ *  @param[in] id  An id given by intern().
+ *
+ *  @return The name, an empty string for 0.
+ */
+std::string const& name_table::name(uint32_t id) const noexcept {
+  static std::string const empty;
+  return id ? _names[id - 1] : empty;
+}
+
+/**
+ *  Get the number of names.
+ *
+ *  @return A number.
+ */
+size_t name_table::size() const noexcept {
+  return _names.size();
+}
+
+/**
+ *  Hash a name (FNV-1a). The hash is never 0 so that a slot is never 0.
+ *
+ *  @param[in] name  The name.
+ *  @param[in] len   Its length.
+ *
+ *  @return The hash.
+ */
+uint32_t name_table::_hash(char const* name, size_t len) noexcept {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; ++i) {
+    h ^= static_cast<unsigned char>(name[i]);
+    h *= 16777619u;
+  }
+  return h ? h : 1;
+}
+
+/**
+ *  Double the size of the open addressing table.
+ */
+void name_table::_grow() {
+  std::vector<uint64_t> slots(_slots.size() * 2, 0);
+  size_t mask = slots.size() - 1;
+  for (uint64_t slot : _slots) {
+    if (!slot)
+      continue;
+    size_t i = (slot >> 32) & mask;
+    while (slots[i])
+      i = (i + 1) & mask;
+    slots[i] = slot;
+  }
+  _slots.swap(slots);
+}
@@ -21,17 +21,217 @@
 #include "com/centreon/engine/nebmods.hh"
 #include <cerrno>
 #include <cstdio>
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <deque>
+#include <memory>
+#include <string>
 #include "com/centreon/engine/broker/loader.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/neberrors.hh"
+#include "com/centreon/engine/nebstructs.hh"
 #include "com/centreon/engine/utils.hh"
 
 using namespace com::centreon;
 using namespace com::centreon::engine;
 using namespace com::centreon::engine::logging;
 
+std::vector<neb_callback_func> const* neb_dispatch_table[NEBCALLBACK_NUMITEMS];
+std::vector<neb_callback_func> const*
+    neb_batch_dispatch_table[NEBCALLBACK_NUMITEMS];
+
+namespace {
+/* A batch callback, batch_callbacks are sorted by priority. */
+struct batch_callback {
+  neb_callback_func func;
+  void* module_handle;
+  int priority;
+};
+
+/**
+ *  @class batched_event
+ *  @brief An event waiting for its batch to be sent.
+ */
+class batched_event {
+ public:
+  virtual ~batched_event() noexcept = default;
+  virtual void* data() noexcept = 0;
+};
+
+/**
+ *  @class batched
+ *  @brief A copy of an event structure, its strings are copied too since the
+ *  originals do not live until the batch is sent.
+ */
+template <typename T>
+class batched : public batched_event {
+  /* A deque does not move its strings when it grows. */
+  std::deque<std::string> _strings;
+
+ public:
+  T ds;
+
+  explicit batched(void* data) : ds(*static_cast<T*>(data)) {}
+  void* data() noexcept override { return &ds; }
+
+  /**
+   *  Replace a string of the structure by a copy.
+   *
+   *  @param[in,out] str  The string.
+   */
+  template <typename C>
+  void keep(C*& str) {
+    if (str) {
+      _strings.emplace_back(str);
+      str = &_strings.back()[0];
+    }
+  }
+};
+
+std::vector<batch_callback> batch_callbacks[NEBCALLBACK_NUMITEMS];
+std::vector<std::unique_ptr<batched_event>>
+    pending_events[NEBCALLBACK_NUMITEMS];
+/* When the oldest pending event was queued. */
+std::chrono::steady_clock::time_point oldest_pending_event;
+bool has_pending_events = false;
+}  // namespace
+
+/* Dispatch arrays replaced while callbacks could still be made with them.
+ * They are freed with the callback list. */
+static std::deque<std::unique_ptr<std::vector<neb_callback_func> const>>
+    retired_dispatch_tables;
+
+/**
+ *  Build again the dispatch array of a callback type from its list.
+ *
+ *  @param[in] callback_type  The callback type.
+ */
+static void neb_rebuild_dispatch_table(int callback_type) {
+  std::unique_ptr<std::vector<neb_callback_func>> table;
+  if (neb_callback_list[callback_type]) {
+    table.reset(new std::vector<neb_callback_func>);
+    for (nebcallback* cb = neb_callback_list[callback_type]; cb;
+         cb = cb->next) {
+      union {
+        neb_callback_func func;
+        void* data;
+      } callback;
+      callback.data = cb->callback_func;
+      table->push_back(callback.func);
+    }
+  }
+  if (neb_dispatch_table[callback_type])
+    retired_dispatch_tables.emplace_back(neb_dispatch_table[callback_type]);
+  neb_dispatch_table[callback_type] = table.release();
+}
+
+/**
+ *  Build again the batch dispatch array of a callback type.
+ *
+ *  @param[in] callback_type  The callback type.
+ */
+static void neb_rebuild_batch_dispatch_table(int callback_type) {
+  std::unique_ptr<std::vector<neb_callback_func>> table;
+  if (!batch_callbacks[callback_type].empty()) {
+    table.reset(new std::vector<neb_callback_func>);
+    for (batch_callback const& cb : batch_callbacks[callback_type])
+      table->push_back(cb.func);
+  }
+  if (neb_batch_dispatch_table[callback_type])
+    retired_dispatch_tables.emplace_back(
+        neb_batch_dispatch_table[callback_type]);
+  neb_batch_dispatch_table[callback_type] = table.release();
+}
+
+/**
+ *  Free the dispatch arrays and drop the pending events.
+ */
+static void neb_free_dispatch_tables() {
+  for (int x = 0; x < NEBCALLBACK_NUMITEMS; x++) {
+    delete neb_dispatch_table[x];
+    neb_dispatch_table[x] = nullptr;
+    delete neb_batch_dispatch_table[x];
+    neb_batch_dispatch_table[x] = nullptr;
+    batch_callbacks[x].clear();
+    pending_events[x].clear();
+  }
+  has_pending_events = false;
+  retired_dispatch_tables.clear();
+}
+
+/**
+ *  Tell if the events of a callback type can be batched.
+ *
+ *  @param[in] callback_type  The callback type.
+ *
+ *  @return True if they can.
+ */
+static bool neb_can_batch(int callback_type) {
+  switch (callback_type) {
+    case NEBCALLBACK_SERVICE_CHECK_DATA:
+    case NEBCALLBACK_HOST_CHECK_DATA:
+    case NEBCALLBACK_SERVICE_STATUS_DATA:
+    case NEBCALLBACK_HOST_STATUS_DATA:
+    case NEBCALLBACK_STATE_CHANGE_DATA:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ *  Copy an event so that it can be sent later in a batch.
+ *
+ *  @param[in] callback_type  The callback type, neb_can_batch() must be true.
+ *  @param[in] data           The event structure.
+ *
+ *  @return The copy.
+ */
+static std::unique_ptr<batched_event> neb_copy_event(int callback_type,
+                                                     void* data) {
+  switch (callback_type) {
+    case NEBCALLBACK_SERVICE_CHECK_DATA: {
+      std::unique_ptr<batched<nebstruct_service_check_data>> e(
+          new batched<nebstruct_service_check_data>(data));
+      e->keep(e->ds.command_name);
+      e->keep(e->ds.command_args);
+      e->keep(e->ds.command_line);
+      e->keep(e->ds.output);
+      e->keep(e->ds.long_output);
+      e->keep(e->ds.perf_data);
+      return e;
+    }
+    case NEBCALLBACK_HOST_CHECK_DATA: {
+      std::unique_ptr<batched<nebstruct_host_check_data>> e(
+          new batched<nebstruct_host_check_data>(data));
+      e->keep(e->ds.host_name);
+      e->keep(e->ds.command_name);
+      e->keep(e->ds.command_args);
+      e->keep(e->ds.command_line);
+      e->keep(e->ds.output);
+      e->keep(e->ds.long_output);
+      e->keep(e->ds.perf_data);
+      return e;
+    }
+    case NEBCALLBACK_SERVICE_STATUS_DATA:
+      return std::unique_ptr<batched_event>(
+          new batched<nebstruct_service_status_data>(data));
+    case NEBCALLBACK_HOST_STATUS_DATA:
+      return std::unique_ptr<batched_event>(
+          new batched<nebstruct_host_status_data>(data));
+    default: {
+      std::unique_ptr<batched<nebstruct_statechange_data>> e(
+          new batched<nebstruct_statechange_data>(data));
+      e->keep(e->ds.host_name);
+      e->keep(e->ds.service_description);
+      e->keep(e->ds.output);
+      return e;
+    }
+  }
+}
+
 /****************************************************************************/
 /****************************************************************************/
 /* INITIALIZATION/CLEANUP FUNCTIONS                                         */
@@ -365,6 +565,7 @@ int neb_register_callback(int callback_type,
       }
     }
   }
+  neb_rebuild_dispatch_table(callback_type);
   return OK;
 }
 
@@ -377,6 +578,16 @@ int neb_deregister_module_callbacks(void* mod) {
 
   for (int callback_type = 0; callback_type < NEBCALLBACK_NUMITEMS;
        callback_type++) {
+    std::vector<batch_callback>& batch(batch_callbacks[callback_type]);
+    size_t size = batch.size();
+    batch.erase(std::remove_if(batch.begin(), batch.end(),
+                               [mod](batch_callback const& cb) {
+                                 return cb.module_handle == mod;
+                               }),
+                batch.end());
+    if (batch.size() != size)
+      neb_rebuild_batch_dispatch_table(callback_type);
+
     for (nebcallback* temp_callback = neb_callback_list[callback_type];
          temp_callback != nullptr; temp_callback = next_callback) {
       next_callback = temp_callback->next;
@@ -396,50 +607,92 @@ int neb_deregister_module_callbacks(void* mod) {
 /* allows a module to deregister a callback function */
 int neb_deregister_callback(int callback_type,
                             int (*callback_func)(int, void*)) {
-  nebcallback* temp_callback = NULL;
-  nebcallback* last_callback = NULL;
-  nebcallback* next_callback = NULL;
-
   if (!callback_func)
     return NEBERROR_NOCALLBACKFUNC;
 
-  /* find the callback to remove */
-  for (temp_callback = last_callback = neb_callback_list[callback_type];
-       temp_callback != NULL; temp_callback = next_callback) {
-    next_callback = temp_callback->next;
+  /* make sure the callback type is within bounds */
+  if (callback_type < 0 || callback_type >= NEBCALLBACK_NUMITEMS)
+    return NEBERROR_CALLBACKBOUNDS;
 
-    /* we found it */
+  /* find the callback to remove */
+  nebcallback** link = &neb_callback_list[callback_type];
+  for (; *link != nullptr; link = &(*link)->next) {
     union {
       void* data;
       int (*code)(int, void*);
     } temp_callback_func;
-    temp_callback_func.data = temp_callback->callback_func;
+    temp_callback_func.data = (*link)->callback_func;
     if (temp_callback_func.code == callback_func)
       break;
-
-    last_callback = temp_callback;
   }
 
   /* we couldn't find the callback */
-  if (temp_callback == nullptr)
+  if (*link == nullptr)
     return NEBERROR_CALLBACKNOTFOUND;
 
-  else {
-    /* only one item in the list */
-    if (temp_callback != last_callback->next)
-      neb_callback_list[callback_type] = nullptr;
-    else
-      last_callback->next = next_callback;
-    delete temp_callback;
-  }
+  nebcallback* temp_callback = *link;
+  *link = temp_callback->next;
+  delete temp_callback;
+  neb_rebuild_dispatch_table(callback_type);
+
+  return OK;
+}
+
+/* allows a module to receive the events of a type by batch */
+int neb_register_batch_callback(int callback_type,
+                                void* mod_handle,
+                                int priority,
+                                int (*callback_func)(int, void*)) {
+  if (callback_func == nullptr)
+    return NEBERROR_NOCALLBACKFUNC;
+
+  if (mod_handle == nullptr)
+    return NEBERROR_NOMODULEHANDLE;
+
+  /* make sure the callback type is within bounds */
+  if (callback_type < 0 || callback_type >= NEBCALLBACK_NUMITEMS)
+    return NEBERROR_CALLBACKBOUNDS;
+
+  if (!neb_can_batch(callback_type))
+    return NEBERROR_CALLBACKNOBATCH;
+
+  /* sorted by priority (first come, first served for same priority) */
+  std::vector<batch_callback>& batch(batch_callbacks[callback_type]);
+  batch.insert(std::upper_bound(batch.begin(), batch.end(), priority,
+                                [](int p, batch_callback const& cb) {
+                                  return p < cb.priority;
+                                }),
+               batch_callback{callback_func, mod_handle, priority});
+  neb_rebuild_batch_dispatch_table(callback_type);
+  return OK;
+}
+
+/* allows a module to deregister a batch callback function */
+int neb_deregister_batch_callback(int callback_type,
+                                  int (*callback_func)(int, void*)) {
+  if (!callback_func)
+    return NEBERROR_NOCALLBACKFUNC;
 
+  /* make sure the callback type is within bounds */
+  if (callback_type < 0 || callback_type >= NEBCALLBACK_NUMITEMS)
+    return NEBERROR_CALLBACKBOUNDS;
+
+  std::vector<batch_callback>& batch(batch_callbacks[callback_type]);
+  auto it = std::find_if(
+      batch.begin(), batch.end(),
+      [callback_func](batch_callback const& cb) {
+        return cb.func == callback_func;
+      });
+  if (it == batch.end())
+    return NEBERROR_CALLBACKNOTFOUND;
+
+  batch.erase(it);
+  neb_rebuild_batch_dispatch_table(callback_type);
   return OK;
 }
 
 /* make callbacks to modules */
 int neb_make_callbacks(int callback_type, void* data) {
-  nebcallback* temp_callback;
-  nebcallback* next_callback;
   int cbresult = 0;
   int total_callbacks = 0;
 
@@ -447,20 +700,34 @@ int neb_make_callbacks(int callback_type, void* data) {
   if (callback_type < 0 || callback_type >= NEBCALLBACK_NUMITEMS)
     return ERROR;
 
+  /* keep a copy of the event for the batch callbacks */
+  if (neb_batch_dispatch_table[callback_type]) {
+    try {
+      pending_events[callback_type].push_back(
+          neb_copy_event(callback_type, data));
+      if (!has_pending_events) {
+        has_pending_events = true;
+        oldest_pending_event = std::chrono::steady_clock::now();
+      }
+    } catch (std::exception const& e) {
+      logger(log_runtime_error, basic)
+          << "Error: cannot keep event of type " << callback_type
+          << " for batch callbacks: " << e.what();
+    }
+  }
+
+  /* nothing to do if no module subscribed to this type */
+  std::vector<neb_callback_func> const* callbacks(
+      neb_dispatch_table[callback_type]);
+  if (!callbacks)
+    return cbresult;
+
   logger(dbg_eventbroker, more)
       << "Making callbacks (type " << callback_type << ")...";
 
   /* make the callbacks... */
-  for (temp_callback = neb_callback_list[callback_type]; temp_callback != NULL;
-       temp_callback = next_callback) {
-    next_callback = temp_callback->next;
-
-    union {
-      int (*func)(int, void*);
-      void* data;
-    } neb;
-    neb.data = temp_callback->callback_func;
-    cbresult = (*neb.func)(callback_type, data);
+  for (neb_callback_func func : *callbacks) {
+    cbresult = (*func)(callback_type, data);
 
     total_callbacks++;
     logger(dbg_eventbroker, most)
@@ -481,11 +748,51 @@ int neb_make_callbacks(int callback_type, void* data) {
   return cbresult;
 }
 
+/* send the pending events to the batch callbacks if the oldest one is
+ * older than max_delay_ms */
+int neb_flush_batches(int max_delay_ms) {
+  if (!has_pending_events)
+    return OK;
+  if (max_delay_ms > 0 &&
+      std::chrono::steady_clock::now() - oldest_pending_event <
+          std::chrono::milliseconds(max_delay_ms))
+    return OK;
+  has_pending_events = false;
+
+  std::vector<void*> events;
+  for (int callback_type = 0; callback_type < NEBCALLBACK_NUMITEMS;
+       callback_type++) {
+    if (pending_events[callback_type].empty())
+      continue;
+
+    /* events queued by the callbacks are sent with the next batch */
+    std::vector<std::unique_ptr<batched_event>> batch;
+    std::swap(batch, pending_events[callback_type]);
+    std::vector<neb_callback_func> const* callbacks(
+        neb_batch_dispatch_table[callback_type]);
+    if (!callbacks)
+      continue;
+
+    events.clear();
+    for (std::unique_ptr<batched_event>& e : batch)
+      events.push_back(e->data());
+    nebstruct_batch_data ds{callback_type, events.size(), events.data()};
+
+    logger(dbg_eventbroker, more)
+        << "Making batch callbacks (type " << callback_type << ", "
+        << events.size() << " events)...";
+    for (neb_callback_func func : *callbacks)
+      (*func)(callback_type, &ds);
+  }
+  return OK;
+}
+
 /* initialize callback list */
 int neb_init_callback_list() {
   /* initialize list pointers */
   for (int x = 0; x < NEBCALLBACK_NUMITEMS; x++)
     neb_callback_list[x] = nullptr;
+  neb_free_dispatch_tables();
   return OK;
 }
 
@@ -503,6 +810,7 @@ int neb_free_callback_list() {
 
     neb_callback_list[x] = nullptr;
   }
+  neb_free_dispatch_tables();
 
   return OK;
 }
@@ -55,11 +55,11 @@ notification::notification(notifier* parent,
  * @brief Execute the notification, that is to say, for each contact to
  * notify, the notification is sent to him.
  *
- * @param to_notify the set of contact to notify.
+ * @param to_notify the contacts to notify.
  *
  * @return OK on success, ERROR otherwise.
  */
-int notification::execute(std::unordered_set<contact*> const& to_notify) {
+int notification::execute(std::vector<contact*> const& to_notify) {
   uint32_t contacts_notified{0};
 
   struct timeval start_time;
@@ -227,8 +227,7 @@ uint32_t notification::get_notification_interval() const {
  * @return a boolean.
  */
 bool notification::sent_to(const std::string& user) const {
-  return std::find(_notified_contact.begin(), _notified_contact.end(), user) !=
-         _notified_contact.end();
+  return _notified_contact.count(user) > 0;
 }
 
 /**
@@ -19,6 +19,7 @@
 
 #include "com/centreon/engine/notifier.hh"
 
+#include <algorithm>
 #include <cassert>
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks/checker.hh"
@@ -31,6 +32,7 @@
 #include "com/centreon/engine/macros.hh"
 #include "com/centreon/engine/neberrors.hh"
 #include "com/centreon/engine/notification.hh"
+#include "com/centreon/engine/time_base.hh"
 #include "com/centreon/engine/timezone_locker.hh"
 #include "com/centreon/engine/utils.hh"
 
@@ -62,6 +64,7 @@ std::array<notifier::is_viable, 6> const notifier::_is_notification_viable{{
 }};
 
 uint64_t notifier::_next_notification_id{1L};
+uint64_t notifier::_contacts_generation{1L};
 
 notifier::notifier(notifier::notifier_type notifier_type,
                    std::string const& display_name,
@@ -96,7 +99,9 @@ notifier::notifier(notifier::notifier_type notifier_type,
                    bool retain_status_information,
                    bool retain_nonstatus_information,
                    bool is_volatile)
-    : checkable{display_name,
+    : checkable{notifier_type == host_notification ? state_table::hosts()
+                                                   : state_table::services(),
+                display_name,
                 check_command,
                 checks_enabled,
                 accept_passive_checks,
@@ -125,16 +130,12 @@ notifier::notifier(notifier::notifier_type notifier_type,
       _last_event_id{0},
       _current_problem_id{0},
       _last_problem_id{0},
-      _initial_notif_time{0},
       _acknowledgement_timeout{0},
-      _last_acknowledgement{0},
       _out_notification_type{notify},
       _current_notifications{0},
       _notification_interval{notification_interval},
       _modified_attributes{0},
       _current_notification_id{0UL},
-      _next_notification{0UL},
-      _last_notification{0UL},
       _notification_period{notification_period},
       _notification_period_ptr{nullptr},
       _first_notification_delay{first_notification_delay},
@@ -144,7 +145,6 @@ notifier::notifier(notifier::notifier_type notifier_type,
       _has_been_checked{false},
       _no_more_notifications{false},
       _flapping_comment_id{0},
-      _check_options{CHECK_OPTION_NONE},
       _acknowledgement_type{ACKNOWLEDGEMENT_NONE},
       _retain_status_information{retain_status_information},
       _retain_nonstatus_information{retain_nonstatus_information},
@@ -152,6 +152,7 @@ notifier::notifier(notifier::notifier_type notifier_type,
       _is_volatile{is_volatile},
       _notification_to_interval_on_timeperiod_in{false},
       _notification_number{0},
+      _flattened_contacts_generation{0},
       _notification{{}},
       _state_history{{}},
       _pending_flex_downtime{0} {
@@ -330,20 +331,21 @@ bool notifier::_is_notification_viable_normal(reason_type type
   if (_notification[cat_normal]) {
     /* In the case of a state change, we don't care of the notification interval
      * and we notify as soon as we can */
-    if (get_last_hard_state_change() <= _last_notification) {
+    time_t last_notification = get_last_notification();
+    if (get_last_hard_state_change() <= last_notification) {
       if (notification_interval == 0) {
         logger(dbg_notifications, more)
             << "This notifier problem has already been sent at "
-            << _last_notification
+            << last_notification
             << " so, since the notification interval is 0, it won't be sent"
             << " anymore";
         return false;
       } else if (notification_interval > 0) {
-        if (_last_notification +
+        if (last_notification +
                 notification_interval * config->interval_length() >
             now) {
           logger(dbg_notifications, more)
-              << "This notifier problem has been sent at " << _last_notification
+              << "This notifier problem has been sent at " << last_notification
               << " so it won't be sent until "
               << (notification_interval * config->interval_length());
           return false;
@@ -665,15 +667,16 @@ bool notifier::_is_notification_viable_custom(reason_type type
  * @param[out] notification_interval
  * @param[out] escalated
  *
- * @return A set of contacts to notify.
+ * @return The contacts to notify, without duplicates.
  */
-std::unordered_set<contact*> notifier::get_contacts_to_notify(
+std::vector<contact*> notifier::get_contacts_to_notify(
     notification_category cat,
     reason_type type,
     uint32_t& notification_interval,
     bool& escalated) {
-  std::unordered_set<contact*> retval;
+  std::vector<contact*> retval;
   escalated = false;
+  bool several_escalations = false;
   uint32_t notif_interv{_notification_interval};
 
   /* Let's start looking at escalations */
@@ -681,6 +684,7 @@ std::unordered_set<contact*> notifier::get_contacts_to_notify(
     if (e->is_viable(get_current_state_int(), _notification_number)) {
       /* Among escalations, we choose the smallest notification interval. */
       if (escalated) {
+        several_escalations = true;
         if (e->get_notification_interval() < notif_interv)
           notif_interv = e->get_notification_interval();
       } else {
@@ -690,53 +694,91 @@ std::unordered_set<contact*> notifier::get_contacts_to_notify(
         notif_interv = e->get_notification_interval();
       }
 
-      /* For each contact group, we also add its contacts. */
-      for (contactgroup_map_unsafe::const_iterator
-               cgit{e->get_contactgroups().begin()},
-           cgend{e->get_contactgroups().end()};
-           cgit != cgend; ++cgit) {
-        for (contact_map_unsafe::const_iterator
-                 cit{cgit->second->get_members().begin()},
-             cend{cgit->second->get_members().end()};
-             cit != cend; ++cit) {
-          assert(cit->second);
-          if (cit->second->should_be_notified(cat, type, *this))
-            retval.insert(cit->second);
-        }
-      }
+      /* Contacts of the escalation contact groups. */
+      for (contact* c : e->get_flattened_contacts())
+        if (c->should_be_notified(cat, type, *this))
+          retval.push_back(c);
     }
   }
 
-  if (!escalated) {
-    /* Construction of the set containing contacts to notify. We don't know
-     * for the moment if those contacts accept notification. */
-    for (contact_map_unsafe::const_iterator it{get_contacts().begin()},
-         end{get_contacts().end()};
-         it != end; ++it) {
-      assert(it->second);
-      if (it->second->should_be_notified(cat, type, *this))
-        retval.insert(it->second);
-    }
+  /* A contact can belong to several escalations. */
+  if (several_escalations) {
+    std::sort(retval.begin(), retval.end());
+    retval.erase(std::unique(retval.begin(), retval.end()), retval.end());
+  }
 
-    /* For each contact group, we also add its contacts. */
-    for (contactgroup_map_unsafe::const_iterator
-             it{get_contactgroups().begin()},
-         end{get_contactgroups().end()};
-         it != end; ++it) {
-      for (contact_map_unsafe::const_iterator
-               cit{it->second->get_members().begin()},
-           cend{it->second->get_members().end()};
-           cit != cend; ++cit) {
-        assert(cit->second);
-        if (cit->second->should_be_notified(cat, type, *this))
-          retval.insert(cit->second);
-      }
-    }
+  if (!escalated) {
+    /* Contacts and contact groups members. We don't know for the moment if
+     * those contacts accept notification. */
+    for (contact* c : get_flattened_contacts())
+      if (c->should_be_notified(cat, type, *this))
+        retval.push_back(c);
   }
   notification_interval = notif_interv;
   return retval;
 }
 
+/**
+ * @brief Get the contacts of this notifier and the members of its contact
+ * groups, without duplicates. The list is only built again after a
+ * configuration change.
+ *
+ * @return A list of contacts.
+ */
+std::vector<contact*> const& notifier::get_flattened_contacts() {
+  if (_flattened_contacts_generation != _contacts_generation) {
+    _flattened_contacts.clear();
+    flatten_contacts(&_contacts, _contact_groups, _flattened_contacts);
+    _flattened_contacts_generation = _contacts_generation;
+  }
+  return _flattened_contacts;
+}
+
+/**
+ * @brief Fill a list with contacts and contact groups members, without
+ * duplicates.
+ *
+ * @param contacts Contacts to add, may be null.
+ * @param contactgroups Contact groups whose members are added.
+ * @param[out] retval The list to fill.
+ */
+void notifier::flatten_contacts(
+    std::unordered_map<std::string, contact*> const* contacts,
+    contactgroup_map_unsafe const& contactgroups,
+    std::vector<contact*>& retval) {
+  std::unordered_set<contact*> seen;
+  if (contacts)
+    for (auto const& p : *contacts) {
+      assert(p.second);
+      if (seen.insert(p.second).second)
+        retval.push_back(p.second);
+    }
+  for (auto const& cg : contactgroups)
+    for (auto const& p : cg.second->get_members()) {
+      assert(p.second);
+      if (seen.insert(p.second).second)
+        retval.push_back(p.second);
+    }
+}
+
+/**
+ * @brief Tell notifiers and escalations that contacts or contact groups have
+ * changed, so their flattened contacts lists have to be built again.
+ */
+void notifier::invalidate_contacts_cache() noexcept {
+  ++_contacts_generation;
+}
+
+/**
+ * @brief Accessor to the contacts generation, incremented each time contacts
+ * or contact groups change.
+ *
+ * @return The generation.
+ */
+uint64_t notifier::get_contacts_generation() noexcept {
+  return _contacts_generation;
+}
+
 notifier::notification_category notifier::get_category(reason_type type) {
   if (type == 99)
     return cat_custom;
@@ -772,7 +814,7 @@ int notifier::notify(notifier::reason_type type,
   /* What are the contacts to notify? */
   uint32_t notification_interval;
   bool escalated;
-  std::unordered_set<contact*> to_notify{
+  std::vector<contact*> to_notify{
       get_contacts_to_notify(cat, type, notification_interval, escalated)};
 
   _current_notification_id = _next_notification_id++;
@@ -785,7 +827,7 @@ int notifier::notify(notifier::reason_type type,
 
   if (retval == OK) {
     if (!to_notify.empty())
-      _last_notification = std::time(nullptr);
+      set_last_notification(std::time(nullptr));
 
     /* The notification has been sent.
      * Should we increment the notification number? */
@@ -834,27 +876,30 @@ uint64_t notifier::get_current_notification_id() const noexcept {
 }
 
 time_t notifier::get_next_notification() const noexcept {
-  return _next_notification;
+  return time_base::instance().to_wall(_states.next_notification[_state_id]);
 }
 
 void notifier::set_next_notification(time_t next_notification) noexcept {
-  _next_notification = next_notification;
+  _states.next_notification[_state_id] =
+      time_base::instance().to_internal(next_notification);
 }
 
 time_t notifier::get_last_notification() const noexcept {
-  return _last_notification;
+  return time_base::instance().to_wall(_states.last_notification[_state_id]);
 }
 
 void notifier::set_last_notification(time_t last_notification) noexcept {
-  _last_notification = last_notification;
+  _states.last_notification[_state_id] =
+      time_base::instance().to_internal(last_notification);
 }
 
 void notifier::set_initial_notif_time(time_t notif_time) noexcept {
-  _initial_notif_time = notif_time;
+  _states.initial_notif_time[_state_id] =
+      time_base::instance().to_internal(notif_time);
 }
 
 time_t notifier::get_initial_notif_time() const noexcept {
-  return _initial_notif_time;
+  return time_base::instance().to_wall(_states.initial_notif_time[_state_id]);
 }
 
 void notifier::set_acknowledgement_timeout(int timeout) noexcept {
@@ -862,11 +907,13 @@ void notifier::set_acknowledgement_timeout(int timeout) noexcept {
 }
 
 void notifier::set_last_acknowledgement(time_t ack) noexcept {
-  _last_acknowledgement = ack;
+  _states.last_acknowledgement[_state_id] =
+      time_base::instance().to_internal(ack);
 }
 
 time_t notifier::get_last_acknowledgement() const noexcept {
-  return _last_acknowledgement;
+  return time_base::instance().to_wall(
+      _states.last_acknowledgement[_state_id]);
 }
 
 uint32_t notifier::get_notification_interval(void) const noexcept {
@@ -1014,11 +1061,11 @@ void notifier::set_flapping_comment_id(uint64_t comment_id) noexcept {
 }
 
 int notifier::get_check_options(void) const noexcept {
-  return _check_options;
+  return _states.check_options[_state_id];
 }
 
 void notifier::set_check_options(int option) noexcept {
-  _check_options = option;
+  _states.check_options[_state_id] = option;
 }
 
 int notifier::get_acknowledgement_type(void) const noexcept {
@@ -1153,6 +1200,9 @@ void notifier::resolve(int& w, int& e) {
   /* This list will be filled in {hostescalation,serviceescalation}::resolve */
   _escalations.clear();
 
+  /* Contacts are resolved again, so is the flattened list. */
+  _flattened_contacts_generation = 0;
+
   /* check the event handler command */
   if (!get_event_handler().empty()) {
     size_t pos{get_event_handler().find_first_of('!')};
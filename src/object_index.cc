@@ -0,0 +1,148 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/object_index.hh"
+
+#include "com/centreon/engine/contact.hh"
+#include "com/centreon/engine/contactgroup.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/hostgroup.hh"
+#include "com/centreon/engine/service.hh"
+#include "com/centreon/engine/servicegroup.hh"
+
+using namespace com::centreon::engine;
+
+namespace {
+/**
+ *  Find an object in one of the maps of the objects.
+ *
+ *  @param[in] map  The map of the object type.
+ *  @param[in] key  The key of the object.
+ *
+ *  @return The object, nullptr if not found.
+ */
+template <typename M>
+typename M::mapped_type::element_type* find_in(
+    M const& map,
+    typename M::key_type const& key) {
+  typename M::const_iterator found(map.find(key));
+  return found == map.end() ? nullptr : found->second.get();
+}
+}  // namespace
+
+/**
+ *  Find a contact.
+ *
+ *  @param[in] name  The contact name.
+ *
+ *  @return The contact, nullptr if not found.
+ */
+contact* object_index::find_contact(std::string const& name) {
+  return find_in(contact::contacts, name);
+}
+
+/**
+ *  Find a contact group.
+ *
+ *  @param[in] name  The contact group name.
+ *
+ *  @return The contact group, nullptr if not found.
+ */
+contactgroup* object_index::find_contactgroup(std::string const& name) {
+  return find_in(contactgroup::contactgroups, name);
+}
+
+/**
+ *  Find a host.
+ *
+ *  @param[in] name  The host name, not necessarily null-terminated.
+ *  @param[in] len   Its length.
+ *
+ *  @return The host, nullptr if not found.
+ */
+host* object_index::find_host(char const* name, size_t len) {
+  return find_in(host::hosts, std::string(name, len));
+}
+
+/**
+ *  Find a host.
+ *
+ *  @param[in] name  The host name.
+ *
+ *  @return The host, nullptr if not found.
+ */
+host* object_index::find_host(std::string const& name) {
+  return find_in(host::hosts, name);
+}
+
+/**
+ *  Find a host group.
+ *
+ *  @param[in] name  The host group name.
+ *
+ *  @return The host group, nullptr if not found.
+ */
+hostgroup* object_index::find_hostgroup(std::string const& name) {
+  return find_in(hostgroup::hostgroups, name);
+}
+
+/**
+ *  Find a service.
+ *
+ *  @param[in] host_name        The host name, not necessarily
+ *                              null-terminated.
+ *  @param[in] host_len         Its length.
+ *  @param[in] description      The service description, not necessarily
+ *                              null-terminated.
+ *  @param[in] description_len  Its length.
+ *
+ *  @return The service, nullptr if not found.
+ */
+service* object_index::find_service(char const* host_name,
+                                    size_t host_len,
+                                    char const* description,
+                                    size_t description_len) {
+  return find_in(service::services,
+                 {std::string(host_name, host_len),
+                  std::string(description, description_len)});
+}
+
+/**
+ *  Find a service.
+ *
+ *  @param[in] host_name    The host name.
+ *  @param[in] description  The service description.
+ *
+ *  @return The service, nullptr if not found.
+ */
+service* object_index::find_service(std::string const& host_name,
+                                    std::string const& description) {
+  return find_in(service::services, {host_name, description});
+}
+
+/**
+ *  Find a service group.
+ *
+ *  @param[in] name  The service group name.
+ *
+ *  @return The service group, nullptr if not found.
+ */
+servicegroup* object_index::find_servicegroup(std::string const& name) {
+  return find_in(servicegroup::servicegroups, name);
+}
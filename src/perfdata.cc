@@ -0,0 +1,269 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/perfdata.hh"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+using namespace com::centreon::engine;
+
+namespace {
+/* Metrics of the last perfdata parsed by a thread. */
+struct arena {
+  std::vector<perfdata::metric> metrics;
+  /* Offsets of the label and of the unit of each metric in strings. */
+  std::vector<std::pair<size_t, size_t>> offsets;
+  std::string strings;
+};
+}  // namespace
+
+/**
+ *  Tell if a character separates two metrics.
+ *
+ *  @param[in] c  The character.
+ *
+ *  @return True if c is a white space.
+ */
+static inline bool is_space(char c) noexcept {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ *  Parse a number filling a whole field.
+ *
+ *  @param[in] begin  Beginning of the field.
+ *  @param[in] end    End of the field, on a character that cannot be part of
+ *                    a number.
+ *
+ *  @return The number, NAN if the field is empty or invalid.
+ */
+static double parse_number(char const* begin, char const* end) noexcept {
+  if (begin == end || is_space(*begin))
+    return NAN;
+  char* number_end;
+  double retval = strtod(begin, &number_end);
+  return number_end == end ? retval : NAN;
+}
+
+/**
+ *  Parse a threshold range: [@]start:end, start being 0 when omitted, end
+ *  being infinite when omitted and start being -infinite when it is '~'.
+ *
+ *  @param[in]  begin     Beginning of the range.
+ *  @param[in]  end       End of the range.
+ *  @param[out] low       Start of the range, NAN if there is no range.
+ *  @param[out] high      End of the range, NAN if there is no range.
+ *  @param[out] inverted  1 if the alert is inside the range.
+ */
+static void parse_range(char const* begin,
+                        char const* end,
+                        double& low,
+                        double& high,
+                        char& inverted) noexcept {
+  low = NAN;
+  high = NAN;
+  inverted = 0;
+  if (begin != end && *begin == '@') {
+    inverted = 1;
+    ++begin;
+  }
+  if (begin == end) {
+    inverted = 0;
+    return;
+  }
+
+  char const* colon =
+      static_cast<char const*>(memchr(begin, ':', end - begin));
+  if (!colon) {
+    low = 0;
+    high = parse_number(begin, end);
+  } else {
+    if (colon == begin)
+      low = 0;
+    else if (colon - begin == 1 && *begin == '~')
+      low = -std::numeric_limits<double>::infinity();
+    else
+      low = parse_number(begin, colon);
+    if (colon + 1 == end)
+      high = std::numeric_limits<double>::infinity();
+    else
+      high = parse_number(colon + 1, end);
+  }
+
+  if (std::isnan(low) || std::isnan(high)) {
+    low = NAN;
+    high = NAN;
+    inverted = 0;
+  }
+}
+
+/**
+ *  Find a metric by its label.
+ *
+ *  @param[in] metrics  Metrics returned by parse().
+ *  @param[in] label    The label, without quotes nor data source type.
+ *
+ *  @return The metric or nullptr if there is none with this label.
+ */
+perfdata::metric const* perfdata::find(std::vector<metric> const& metrics,
+                                       std::string const& label) noexcept {
+  for (metric const& m : metrics)
+    if (label == m.label)
+      return &m;
+  return nullptr;
+}
+
+/**
+ *  Cut a perfdata string into metrics. A metric is written
+ *  'label'=value[uom];[warn];[crit];[min];[max], the quotes being only needed
+ *  when the label contains spaces. The label can be prefixed by its data
+ *  source type, as in d[label]. Invalid metrics are skipped.
+ *
+ *  @param[in] perfdata  The perfdata. It must not be modified while the
+ *                       metrics are used.
+ *
+ *  @return The metrics, valid until the next call in this thread.
+ */
+std::vector<perfdata::metric> const& perfdata::parse(
+    std::string const& perfdata) {
+  thread_local arena a;
+  a.metrics.clear();
+  a.offsets.clear();
+  a.strings.clear();
+
+  char const* p = perfdata.c_str();
+  char const* const end = p + perfdata.size();
+  for (;;) {
+    while (p < end && is_space(*p))
+      ++p;
+    if (p == end)
+      break;
+
+    /* Label, a quote is written twice in a quoted label. */
+    char const* text = p;
+    size_t label_offset = a.strings.size();
+    bool valid = false;
+    if (*p == '\'') {
+      ++p;
+      for (;;) {
+        char const* quote =
+            static_cast<char const*>(memchr(p, '\'', end - p));
+        if (!quote) {
+          p = end;
+          break;
+        }
+        a.strings.append(p, quote);
+        p = quote + 1;
+        if (p < end && *p == '\'') {
+          a.strings.push_back('\'');
+          ++p;
+        } else {
+          valid = p < end && *p == '=';
+          break;
+        }
+      }
+    } else {
+      while (p < end && *p != '=' && !is_space(*p))
+        ++p;
+      a.strings.append(text, p);
+      valid = p < end && *p == '=' && p != text;
+    }
+
+    /* Value, 'U' means that the value is unknown. */
+    metric m;
+    if (valid) {
+      ++p;
+      if (*p == 'U') {
+        m.value = NAN;
+        ++p;
+      } else if (is_space(*p))
+        valid = false;
+      else {
+        char* value_end;
+        m.value = strtod(p, &value_end);
+        valid = value_end != p;
+        p = value_end;
+      }
+    }
+
+    if (!valid) {
+      a.strings.resize(label_offset);
+      while (p < end && !is_space(*p))
+        ++p;
+      continue;
+    }
+
+    /* Data source type. */
+    m.data_source_type = 'g';
+    size_t label_size = a.strings.size() - label_offset;
+    char const* label = a.strings.data() + label_offset;
+    if (label_size > 3 && label[1] == '[' && label[label_size - 1] == ']' &&
+        label[0] && strchr("acdg", label[0])) {
+      m.data_source_type = label[0];
+      a.strings.pop_back();
+      a.strings.erase(label_offset, 2);
+    }
+    a.strings.push_back('\0');
+
+    /* Unit. */
+    size_t uom_offset = a.strings.size();
+    char const* uom = p;
+    while (p < end && *p != ';' && !is_space(*p))
+      ++p;
+    a.strings.append(uom, p);
+    a.strings.push_back('\0');
+    m.text = text;
+    m.text_size = p - text;
+
+    /* Thresholds, min and max. */
+    char const* fields[4][2];
+    int count = 0;
+    for (; count < 4 && p < end && *p == ';'; ++count) {
+      fields[count][0] = ++p;
+      while (p < end && *p != ';' && !is_space(*p))
+        ++p;
+      fields[count][1] = p;
+    }
+    while (p < end && !is_space(*p))
+      ++p;
+    for (int i = count; i < 4; ++i)
+      fields[i][0] = fields[i][1] = p;
+
+    parse_range(fields[0][0], fields[0][1], m.warning_low, m.warning,
+                m.warning_inverted);
+    parse_range(fields[1][0], fields[1][1], m.critical_low, m.critical,
+                m.critical_inverted);
+    m.min = parse_number(fields[2][0], fields[2][1]);
+    m.max = parse_number(fields[3][0], fields[3][1]);
+
+    a.metrics.push_back(m);
+    a.offsets.emplace_back(label_offset, uom_offset);
+  }
+
+  /* The strings do not move anymore. */
+  for (size_t i = 0; i < a.metrics.size(); ++i) {
+    a.metrics[i].label = a.strings.data() + a.offsets[i].first;
+    a.metrics[i].uom = a.strings.data() + a.offsets[i].second;
+  }
+  return a.metrics;
+}
@@ -21,6 +21,7 @@
 #include "com/centreon/engine/sehandlers.hh"
 #include <sstream>
 #include "com/centreon/engine/broker.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/comment.hh"
 #include "com/centreon/engine/downtimes/downtime.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
@@ -44,8 +45,6 @@ int obsessive_compulsive_host_check_processor(
     com::centreon::engine::host* hst) {
   std::string raw_command;
   std::string processed_command;
-  int early_timeout = false;
-  double exectime = 0.0;
   int macro_options = STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS;
   nagios_macros* mac(get_global_macros());
 
@@ -92,9 +91,18 @@ int obsessive_compulsive_host_check_processor(
 
   /* run the command */
   try {
-    std::string tmp;
-    my_system_r(mac, processed_command, config->ochp_timeout(), &early_timeout,
-                &exectime, tmp, 0);
+    std::string host_name(hst->get_name());
+    commands::system_runner::instance().run(
+        mac, processed_command, config->ochp_timeout(), 0,
+        [processed_command, host_name](int, bool early_timeout, double,
+                                       std::string const&) {
+          /* check to see if the command timed out */
+          if (early_timeout)
+            logger(log_runtime_warning, basic)
+                << "Warning: OCHP command '" << processed_command
+                << "' for host '" << host_name << "' timed out after "
+                << config->ochp_timeout() << " seconds";
+        });
   } catch (std::exception const& e) {
     logger(log_runtime_error, basic)
         << "Error: can't execute compulsive host processor command line '"
@@ -102,16 +110,101 @@ int obsessive_compulsive_host_check_processor(
   }
   clear_volatile_macros_r(mac);
 
-  /* check to see if the command timed out */
-  if (early_timeout == true)
-    logger(log_runtime_warning, basic)
-        << "Warning: OCHP command '" << processed_command << "' for host '"
-        << hst->get_name() << "' timed out after " << config->ochp_timeout()
-        << " seconds";
-
   return OK;
 }
 
+/******************************************************************/
+/********************* EVENT HANDLER COMMANDS *********************/
+/******************************************************************/
+
+/* key used to find again a service once its event handler is over */
+static std::pair<std::string, std::string> object_key(
+    com::centreon::engine::service const* svc) {
+  return {svc->get_hostname(), svc->get_description()};
+}
+
+/* key used to find again a host once its event handler is over */
+static std::string object_key(com::centreon::engine::host const* hst) {
+  return hst->get_name();
+}
+
+static com::centreon::engine::service* find_object(
+    std::pair<std::string, std::string> const& key) {
+  service_map::const_iterator it(service::services.find(key));
+  return it == service::services.end() ? nullptr : it->second.get();
+}
+
+static com::centreon::engine::host* find_object(std::string const& key) {
+  host_map::const_iterator it(host::hosts.find(key));
+  return it == host::hosts.end() ? nullptr : it->second.get();
+}
+
+/**
+ *  Run an event handler command and send its end to the broker once it is
+ *  over. When system commands are run in the background, the object may
+ *  have been removed by a reload in the meantime, it is then looked up
+ *  again by its name and the end is not sent if it does not exist anymore.
+ *
+ *  @param[in] mac               Macros used by the command.
+ *  @param[in] type              Event handler type.
+ *  @param[in] obj               Host or service.
+ *  @param[in] handler           Event handler name.
+ *  @param[in] processed_command Command line to run.
+ *  @param[in] start_time        Time sent in the start broker event.
+ *  @param[in] error_label       Label used in the error message.
+ *  @param[in] warning_label     Label used in the timeout warning.
+ */
+template <typename T>
+static void run_event_handler_command(nagios_macros* mac,
+                                      unsigned int type,
+                                      T* obj,
+                                      std::string const& handler,
+                                      std::string const& processed_command,
+                                      timeval const& start_time,
+                                      char const* error_label,
+                                      char const* warning_label) {
+  commands::system_runner& runner(commands::system_runner::instance());
+  bool async(runner.is_async());
+  auto key(object_key(obj));
+  commands::system_runner::callback completed(
+      [=](int result, bool early_timeout, double exectime,
+          std::string const& output) {
+        /* check to see if the event handler timed out */
+        if (early_timeout)
+          logger(log_event_handler | log_runtime_warning, basic)
+              << "Warning: " << warning_label << " command '"
+              << processed_command << "' timed out after "
+              << config->event_handler_timeout() << " seconds";
+
+        T* o(async ? find_object(key) : obj);
+        if (!o)
+          return;
+
+        /* get end time */
+        timeval end_time;
+        gettimeofday(&end_time, nullptr);
+
+        /* send event data to broker */
+        broker_event_handler(
+            NEBTYPE_EVENTHANDLER_END, NEBFLAG_NONE, NEBATTR_NONE, type,
+            (void*)o, o->get_current_state(), o->get_state_type(),
+            start_time, end_time, exectime, config->event_handler_timeout(),
+            early_timeout, result, handler.c_str(),
+            const_cast<char*>(processed_command.c_str()),
+            const_cast<char*>(output.c_str()), nullptr);
+      });
+
+  try {
+    runner.run(mac, processed_command, config->event_handler_timeout(), 0,
+               completed);
+  } catch (std::exception const& e) {
+    logger(log_runtime_error, basic)
+        << "Error: can't execute " << error_label << " command line '"
+        << processed_command << "' : " << e.what();
+    completed(0, false, 0.0, "");
+  }
+}
+
 /******************************************************************/
 /**************** SERVICE EVENT HANDLER FUNCTIONS *****************/
 /******************************************************************/
@@ -122,7 +215,6 @@ int run_global_service_event_handler(nagios_macros* mac,
   std::string raw_command;
   std::string processed_command;
   std::string processed_logentry;
-  std::string command_output;
   int early_timeout = false;
   double exectime = 0.0;
   int result = 0;
@@ -200,36 +292,11 @@ int run_global_service_event_handler(nagios_macros* mac,
   }
 
   /* run the command */
-  try {
-    result =
-        my_system_r(mac, processed_command, config->event_handler_timeout(),
-                    &early_timeout, &exectime, command_output, 0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-        << "Error: can't execute global service event handler "
-           "command line '"
-        << processed_command << "' : " << e.what();
-  }
-
-  /* check to see if the event handler timed out */
-  if (early_timeout == true)
-    logger(log_event_handler | log_runtime_warning, basic)
-        << "Warning: Global service event handler command '"
-        << processed_command << "' timed out after "
-        << config->event_handler_timeout() << " seconds";
-
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* send event data to broker */
-  broker_event_handler(NEBTYPE_EVENTHANDLER_END, NEBFLAG_NONE, NEBATTR_NONE,
-                       GLOBAL_SERVICE_EVENTHANDLER, (void*)svc,
-                       svc->get_current_state(), svc->get_state_type(),
-                       start_time, end_time, exectime,
-                       config->event_handler_timeout(), early_timeout, result,
-                       config->global_service_event_handler().c_str(),
-                       const_cast<char*>(processed_command.c_str()),
-                       const_cast<char*>(command_output.c_str()), nullptr);
+  run_event_handler_command(mac, GLOBAL_SERVICE_EVENTHANDLER, svc,
+                            config->global_service_event_handler(),
+                            processed_command, start_time,
+                            "global service event handler",
+                            "Global service event handler");
 
   return OK;
 }
@@ -240,7 +307,6 @@ int run_service_event_handler(nagios_macros* mac,
   std::string raw_command;
   std::string processed_command;
   std::string processed_logentry;
-  std::string command_output;
   int early_timeout = false;
   double exectime = 0.0;
   int result = 0;
@@ -312,35 +378,10 @@ int run_service_event_handler(nagios_macros* mac,
   }
 
   /* run the command */
-  try {
-    result =
-        my_system_r(mac, processed_command, config->event_handler_timeout(),
-                    &early_timeout, &exectime, command_output, 0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-        << "Error: can't execute service event handler command line '"
-        << processed_command << "' : " << e.what();
-  }
-
-  /* check to see if the event handler timed out */
-  if (early_timeout == true)
-    logger(log_event_handler | log_runtime_warning, basic)
-        << "Warning: Service event handler command '" << processed_command
-        << "' timed out after " << config->event_handler_timeout()
-        << " seconds";
-
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* send event data to broker */
-  broker_event_handler(NEBTYPE_EVENTHANDLER_END, NEBFLAG_NONE, NEBATTR_NONE,
-                       SERVICE_EVENTHANDLER, (void*)svc,
-                       svc->get_current_state(), svc->get_state_type(),
-                       start_time, end_time, exectime,
-                       config->event_handler_timeout(), early_timeout, result,
-                       svc->get_event_handler().c_str(),
-                       const_cast<char*>(processed_command.c_str()),
-                       const_cast<char*>(command_output.c_str()), nullptr);
+  run_event_handler_command(mac, SERVICE_EVENTHANDLER, svc,
+                            svc->get_event_handler(), processed_command,
+                            start_time, "service event handler",
+                            "Service event handler");
 
   return OK;
 }
@@ -394,7 +435,6 @@ int run_global_host_event_handler(nagios_macros* mac,
   std::string raw_command;
   std::string processed_command;
   std::string processed_logentry;
-  std::string command_output;
   int early_timeout = false;
   double exectime = 0.0;
   int result = 0;
@@ -469,35 +509,11 @@ int run_global_host_event_handler(nagios_macros* mac,
   }
 
   /* run the command */
-  try {
-    result =
-        my_system_r(mac, processed_command, config->event_handler_timeout(),
-                    &early_timeout, &exectime, command_output, 0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-        << "Error: can't execute global host event handler command line '"
-        << processed_command << "' : " << e.what();
-  }
-
-  /* check for a timeout in the execution of the event handler command */
-  if (early_timeout == true)
-    logger(log_event_handler | log_runtime_warning, basic)
-        << "Warning: Global host event handler command '" << processed_command
-        << "' timed out after " << config->event_handler_timeout()
-        << " seconds";
-
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* send event data to broker */
-  broker_event_handler(NEBTYPE_EVENTHANDLER_END, NEBFLAG_NONE, NEBATTR_NONE,
-                       GLOBAL_HOST_EVENTHANDLER, (void*)hst,
-                       hst->get_current_state(), hst->get_state_type(),
-                       start_time, end_time, exectime,
-                       config->event_handler_timeout(), early_timeout, result,
-                       config->global_host_event_handler().c_str(),
-                       const_cast<char*>(processed_command.c_str()),
-                       const_cast<char*>(command_output.c_str()), nullptr);
+  run_event_handler_command(mac, GLOBAL_HOST_EVENTHANDLER, hst,
+                            config->global_host_event_handler(),
+                            processed_command, start_time,
+                            "global host event handler",
+                            "Global host event handler");
 
   return OK;
 }
@@ -508,7 +524,6 @@ int run_host_event_handler(nagios_macros* mac,
   std::string raw_command;
   std::string processed_command;
   std::string processed_logentry;
-  std::string command_output;
   int early_timeout = false;
   double exectime = 0.0;
   int result = 0;
@@ -577,34 +592,10 @@ int run_host_event_handler(nagios_macros* mac,
   }
 
   /* run the command */
-  try {
-    result =
-        my_system_r(mac, processed_command, config->event_handler_timeout(),
-                    &early_timeout, &exectime, command_output, 0);
-  } catch (std::exception const& e) {
-    logger(log_runtime_error, basic)
-        << "Error: can't execute host event handler command line '"
-        << processed_command << "' : " << e.what();
-  }
-
-  /* check to see if the event handler timed out */
-  if (early_timeout == true)
-    logger(log_event_handler | log_runtime_warning, basic)
-        << "Warning: Host event handler command '" << processed_command
-        << "' timed out after " << config->event_handler_timeout()
-        << " seconds";
-
-  /* get end time */
-  gettimeofday(&end_time, nullptr);
-
-  /* send event data to broker */
-  broker_event_handler(NEBTYPE_EVENTHANDLER_END, NEBFLAG_NONE, NEBATTR_NONE,
-                       HOST_EVENTHANDLER, (void*)hst, hst->get_current_state(),
-                       hst->get_state_type(), start_time, end_time, exectime,
-                       config->event_handler_timeout(), early_timeout, result,
-                       hst->get_event_handler().c_str(),
-                       const_cast<char*>(processed_command.c_str()),
-                       const_cast<char*>(command_output.c_str()), nullptr);
+  run_event_handler_command(mac, HOST_EVENTHANDLER, hst,
+                            hst->get_event_handler(), processed_command,
+                            start_time, "host event handler",
+                            "Host event handler");
 
   return OK;
 }
@@ -23,8 +23,12 @@
 
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/checks/checker.hh"
+#include "com/centreon/engine/checks/stats.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/deleter/listmember.hh"
+#include "com/centreon/engine/dependency_index.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
+#include "com/centreon/engine/events/check_scheduler.hh"
 #include "com/centreon/engine/events/loop.hh"
 #include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/flapping.hh"
@@ -35,12 +39,16 @@
 #include "com/centreon/engine/macros.hh"
 #include "com/centreon/engine/macros/grab_host.hh"
 #include "com/centreon/engine/macros/grab_service.hh"
+#include "com/centreon/engine/name_table.hh"
 #include "com/centreon/engine/neberrors.hh"
 #include "com/centreon/engine/notification.hh"
 #include "com/centreon/engine/objects.hh"
 #include "com/centreon/engine/sehandlers.hh"
 #include "com/centreon/engine/shared.hh"
+#include "com/centreon/engine/snapshot.hh"
+#include "com/centreon/engine/status_stats.hh"
 #include "com/centreon/engine/string.hh"
+#include "com/centreon/engine/time_base.hh"
 #include "com/centreon/engine/timezone_locker.hh"
 #include "com/centreon/exceptions/interruption.hh"
 #include "compatibility/xpddefault.h"
@@ -59,6 +67,8 @@ std::array<std::pair<uint32_t, std::string>, 4> const
 
 service_map service::services;
 service_id_map service::services_by_id;
+deadline_queue<service> service::_freshness_queue;
+deadline_queue<service> service::_orphan_queue;
 
 service::service(std::string const& hostname,
                  std::string const& description,
@@ -126,8 +136,8 @@ service::service(std::string const& hostname,
                is_volatile},
       _host_id{0},
       _service_id{0},
-      _hostname{hostname},
-      _description{description},
+      _hostname_id{name_table::instance().intern(hostname)},
+      _description_id{name_table::instance().intern(description)},
       _process_performance_data{0},
       _check_flapping_recovery_notification{0},
       _last_time_ok{0},
@@ -135,14 +145,22 @@ service::service(std::string const& hostname,
       _last_time_unknown{0},
       _last_time_critical{0},
       _initial_state{initial_state},
-      _current_state{initial_state},
       _last_hard_state{initial_state},
       _last_state{initial_state},
       _host_ptr{nullptr},
       _host_problem_at_last_check{false} {
+  set_current_state(initial_state);
   set_current_attempt(initial_state == service::state_ok ? 1 : max_attempts);
 }
 
+/**
+ *  Destructor.
+ */
+service::~service() noexcept {
+  _freshness_queue.erase(this);
+  _orphan_queue.erase(this);
+}
+
 time_t service::get_last_time_ok() const {
   return _last_time_ok;
 }
@@ -176,11 +194,14 @@ void service::set_last_time_critical(time_t last_time) {
 }
 
 enum service::service_state service::get_current_state() const {
-  return _current_state;
+  return static_cast<service_state>(_states.current_state[_state_id]);
 }
 
 void service::set_current_state(enum service::service_state current_state) {
-  _current_state = current_state;
+  if (_states.current_state[_state_id] != current_state) {
+    _states.current_state[_state_id] = current_state;
+    dependency_index::services().state_changed(_state_id);
+  }
 }
 
 enum service::service_state service::get_last_state() const {
@@ -196,7 +217,10 @@ enum service::service_state service::get_last_hard_state() const {
 }
 
 void service::set_last_hard_state(enum service::service_state last_hard_state) {
-  _last_hard_state = last_hard_state;
+  if (_last_hard_state != last_hard_state) {
+    _last_hard_state = last_hard_state;
+    dependency_index::services().state_changed(_state_id);
+  }
 }
 
 enum service::service_state service::get_initial_state() const {
@@ -224,11 +248,11 @@ void service::set_check_flapping_recovery_notification(bool check) {
 }
 
 bool service::recovered() const {
-  return _current_state == service::state_ok;
+  return get_current_state() == service::state_ok;
 }
 
 int service::get_current_state_int() const {
-  return static_cast<int>(_current_state);
+  return static_cast<int>(get_current_state());
 }
 
 /**
@@ -895,20 +919,32 @@ uint64_t service::get_service_id() const {
 }
 
 void service::set_hostname(std::string const& name) {
-  _hostname = name;
+  _hostname_id = name_table::instance().intern(name);
 }
 
 /**
- * @brief Get the hostname of the host associated with this downtime.
+ * @brief Get the hostname of the host associated with this service. The
+ * name lives in the name table: like the objects themselves, it must not be
+ * read while the configuration is applied, that is from the main loop or
+ * from a thread synchronized with it.
  *
  * @return A string reference to the host name.
  */
 std::string const& service::get_hostname() const {
-  return _hostname;
+  return name_table::instance().name(_hostname_id);
+}
+
+/**
+ * @brief Get the id of the host name in the name table.
+ *
+ * @return An id.
+ */
+uint32_t service::get_hostname_id() const {
+  return _hostname_id;
 }
 
 void service::set_description(std::string const& desc) {
-  _description = desc;
+  _description_id = name_table::instance().intern(desc);
 }
 
 /**
@@ -917,7 +953,16 @@ void service::set_description(std::string const& desc) {
  * @return A string reference to the description.
  */
 std::string const& service::get_description() const {
-  return _description;
+  return name_table::instance().name(_description_id);
+}
+
+/**
+ * @brief Get the id of the description in the name table.
+ *
+ * @return An id.
+ */
+uint32_t service::get_description_id() const {
+  return _description_id;
 }
 
 /**
@@ -994,10 +1039,10 @@ int service::handle_async_check_result(check_result* queued_check_result) {
     execution_time = 0.0;
 
   logger(dbg_checks, basic)
-      << "** Handling check result for service '" << _description
-      << "' on host '" << _hostname << "'...";
+      << "** Handling check result for service '" << get_description()
+      << "' on host '" << get_hostname() << "'...";
   logger(dbg_checks, more)
-      << "HOST: " << _hostname << ", SERVICE: " << _description
+      << "HOST: " << get_hostname() << ", SERVICE: " << get_description()
       << ", CHECK TYPE: "
       << (queued_check_result->get_check_type() == check_active ? "Active"
                                                                 : "Passive")
@@ -1041,8 +1086,10 @@ int service::handle_async_check_result(check_result* queued_check_result) {
     set_is_being_freshened(false);
 
   /* clear the execution flag if this was an active check */
-  if (queued_check_result->get_check_type() == check_active)
+  if (queued_check_result->get_check_type() == check_active) {
     set_is_executing(false);
+    _orphan_queue.erase(this);
+  }
 
   /* DISCARD INVALID FRESHNESS CHECK RESULTS */
   /* If a services goes stale, Engine will initiate a forced check in
@@ -1067,6 +1114,19 @@ int service::handle_async_check_result(check_result* queued_check_result) {
 
   set_execution_time(execution_time);
 
+  /* feed the latency and execution time percentiles */
+  if (queued_check_result->get_check_type() == check_active) {
+    checks::stats::instance().add_timing(checks::stats::active_service_latency,
+                                         get_latency(), current_time);
+    checks::stats::instance().add_timing(
+        checks::stats::active_service_execution_time, execution_time,
+        current_time);
+    events::check_scheduler::instance().add_execution_time(this,
+                                                           execution_time);
+  } else
+    checks::stats::instance().add_timing(
+        checks::stats::passive_service_latency, get_latency(), current_time);
+
   /* get the last check time */
   set_last_check(queued_check_result->get_start_time().tv_sec);
 
@@ -1085,7 +1145,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
   reschedule_check = queued_check_result->get_reschedule_check();
 
   /* save the old service status info */
-  _last_state = _current_state;
+  _last_state = get_current_state();
 
   /* save old plugin output */
   old_plugin_output = get_plugin_output();
@@ -1096,19 +1156,19 @@ int service::handle_async_check_result(check_result* queued_check_result) {
    */
   if (!queued_check_result->get_exited_ok()) {
     logger(log_runtime_warning, basic)
-        << "Warning:  Check of service '" << _description << "' on host '"
-        << _hostname << "' did not exit properly!";
+        << "Warning:  Check of service '" << get_description() << "' on host '"
+        << get_hostname() << "' did not exit properly!";
 
     set_plugin_output("(Service check did not exit properly)");
-    _current_state = service::state_unknown;
+    set_current_state(service::state_unknown);
   }
   /* make sure the return code is within bounds */
   else if (queued_check_result->get_return_code() < 0 ||
            queued_check_result->get_return_code() > 3) {
     logger(log_runtime_warning, basic)
         << "Warning: return (code of " << queued_check_result->get_return_code()
-        << " for check of service '" << _description << "' on host '"
-        << _hostname << "' was out of bounds."
+        << " for check of service '" << get_description() << "' on host '"
+        << get_hostname() << "' was out of bounds."
         << (queued_check_result->get_return_code() == 126
                 ? "Make sure the plugin you're trying to run is executable."
                 : (queued_check_result->get_return_code() == 127
@@ -1127,7 +1187,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
         << ')';
 
     set_plugin_output(oss.str());
-    _current_state = service::state_unknown;
+    set_current_state(service::state_unknown);
   }
   /* else the return code is okay... */
   else {
@@ -1135,12 +1195,11 @@ int service::handle_async_check_result(check_result* queued_check_result) {
      * parse check output to get: (1) short output, (2) long output,
      * (3) perf data
      */
-    std::string output{queued_check_result->get_output()};
     std::string plugin_output;
     std::string long_plugin_output;
     std::string perf_data;
-    parse_check_output(output, plugin_output, long_plugin_output, perf_data,
-                       true, false);
+    parse_check_output(queued_check_result->get_output(), plugin_output,
+                       long_plugin_output, perf_data, true, false);
 
     set_long_plugin_output(long_plugin_output);
     set_perf_data(perf_data);
@@ -1169,12 +1228,12 @@ int service::handle_async_check_result(check_result* queued_check_result) {
         << (get_perf_data().empty() ? "NULL" : get_perf_data());
 
     /* grab the return code */
-    _current_state = static_cast<service::service_state>(
-        queued_check_result->get_return_code());
+    set_current_state(static_cast<service::service_state>(
+        queued_check_result->get_return_code()));
   }
 
   /* record the last state time */
-  switch (_current_state) {
+  switch (get_current_state()) {
     case service::state_ok:
       set_last_time_ok(get_last_check());
       break;
@@ -1202,13 +1261,14 @@ int service::handle_async_check_result(check_result* queued_check_result) {
   if (get_check_type() == check_passive) {
     if (config->log_passive_checks())
       logger(log_passive_check, basic)
-          << "PASSIVE SERVICE CHECK: " << _hostname << ";" << _description
-          << ";" << _current_state << ";" << get_plugin_output();
+          << "PASSIVE SERVICE CHECK: " << get_hostname() << ";"
+          << get_description() << ";" << get_current_state() << ";"
+          << get_plugin_output();
   }
 
   host* hst{get_host_ptr()};
   /* if the service check was okay... */
-  if (_current_state == service::state_ok) {
+  if (get_current_state() == service::state_ok) {
     /* if the host has never been checked before, verify its status
      * only do this if 1) the initial state was set to non-UP or 2) the host
      * is not scheduled to be checked soon (next 5 minutes)
@@ -1225,7 +1285,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
     }
   }
 
-  if (_last_state == state_ok && _current_state != _last_state)
+  if (_last_state == state_ok && get_current_state() != _last_state)
     set_current_attempt(1);
   else if (get_state_type() == soft &&
            get_current_attempt() < get_max_attempts())
@@ -1235,12 +1295,12 @@ int service::handle_async_check_result(check_result* queued_check_result) {
                            << (get_state_type() == soft ? "SOFT" : "HARD")
                            << "  CA: " << get_current_attempt()
                            << "  MA: " << get_max_attempts()
-                           << "  CS: " << _current_state
+                           << "  CS: " << get_current_state()
                            << "  LS: " << _last_state
                            << "  LHS: " << _last_hard_state;
 
   /* check for a state change (either soft or hard) */
-  if (_current_state != _last_state) {
+  if (get_current_state() != _last_state) {
     logger(dbg_checks, most) << "Service has changed state since last check!";
     state_change = true;
   }
@@ -1251,7 +1311,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
    * attempt gets reset to 1 if this check is not made, the service recovery
    * looks like a soft recovery instead of a hard one
    */
-  if (_host_problem_at_last_check && _current_state == service::state_ok) {
+  if (_host_problem_at_last_check && get_current_state() == service::state_ok) {
     logger(dbg_checks, most) << "Service had a HARD STATE CHANGE!!";
     hard_state_change = true;
   }
@@ -1261,7 +1321,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
    * reached
    */
   if (get_current_attempt() >= get_max_attempts() &&
-      (_current_state != _last_hard_state ||
+      (get_current_state() != _last_hard_state ||
        get_last_state_change() > get_last_hard_state_change())) {
     logger(dbg_checks, most) << "Service had a HARD STATE CHANGE!!";
     hard_state_change = true;
@@ -1290,7 +1350,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
       /* remove any non-persistant comments associated with the ack */
       comment::delete_service_acknowledgement_comments(this);
     } else if (this->get_acknowledgement_type() == ACKNOWLEDGEMENT_STICKY &&
-               _current_state == service::state_ok) {
+               get_current_state() == service::state_ok) {
       set_problem_has_been_acknowledged(false);
       set_acknowledgement_type(ACKNOWLEDGEMENT_NONE);
 
@@ -1340,7 +1400,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
 
     /* clear the problem id when transitioning from a problem state to an OK
      * state */
-    if (_current_state == service::state_ok) {
+    if (get_current_state() == service::state_ok) {
       set_last_problem_id(get_current_problem_id());
       set_current_problem_id(0L);
     }
@@ -1351,7 +1411,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
   /**************************************/
 
   /* if the service is up and running OK... */
-  if (_current_state == service::state_ok) {
+  if (get_current_state() == service::state_ok) {
     logger(dbg_checks, more) << "Service is OK.";
 
     /* reset the acknowledgement flag (this should already have been done, but
@@ -1450,7 +1510,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
     /* reset all service variables because its okay now... */
     _host_problem_at_last_check = false;
 
-    _last_hard_state = service::state_ok;
+    set_last_hard_state(service::state_ok);
     set_last_notification(static_cast<time_t>(0));
     set_next_notification(static_cast<time_t>(0));
     set_problem_has_been_acknowledged(false);
@@ -1565,7 +1625,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
 
       /* "fake" a hard state change for the service - well, its not really fake,
        * but it didn't get caught earlier... */
-      if (_last_hard_state != _current_state)
+      if (_last_hard_state != get_current_state())
         hard_state_change = true;
 
       /* update last state change times */
@@ -1574,7 +1634,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
       if (hard_state_change) {
         set_last_hard_state_change(get_last_check());
         set_state_type(hard);
-        _last_hard_state = _current_state;
+        set_last_hard_state(get_current_state());
       }
 
       /* put service into a hard state without attempting check retries and
@@ -1665,7 +1725,8 @@ int service::handle_async_check_result(check_result* queued_check_result) {
          * execution */
         /* we do this because we might be sending out a notification soon and we
          * want the dependency logic to be accurate */
-        std::pair<std::string, std::string> id({_hostname, _description});
+        std::pair<std::string, std::string> id(
+            {get_hostname(), get_description()});
         auto p(servicedependency::servicedependencies.equal_range(id));
         for (servicedependency_mmap::const_iterator it{p.first}, end{p.second};
              it != end; ++it) {
@@ -1735,7 +1796,7 @@ int service::handle_async_check_result(check_result* queued_check_result) {
         handle_service_event();
 
       /* save the last hard state */
-      _last_hard_state = _current_state;
+      set_last_hard_state(get_current_state());
 
       /* reschedule the next check at the regular interval */
       if (reschedule_check)
@@ -1790,18 +1851,18 @@ int service::handle_async_check_result(check_result* queued_check_result) {
    * plugin output changed since last check, log it now.. */
   if (get_state_type() == hard && !state_change && !state_was_logged &&
       old_plugin_output != get_plugin_output()) {
-    if ((_current_state == service::state_ok && get_stalk_on(ok)))
+    if ((get_current_state() == service::state_ok && get_stalk_on(ok)))
       log_event();
 
-    else if ((_current_state == service::state_warning &&
+    else if ((get_current_state() == service::state_warning &&
               get_stalk_on(warning)))
       log_event();
 
-    else if ((_current_state == service::state_unknown &&
+    else if ((get_current_state() == service::state_unknown &&
               get_stalk_on(unknown)))
       log_event();
 
-    else if ((_current_state == service::state_critical &&
+    else if ((get_current_state() == service::state_critical &&
               get_stalk_on(critical)))
       log_event();
   }
@@ -1814,6 +1875,8 @@ int service::handle_async_check_result(check_result* queued_check_result) {
       get_execution_time(), config->service_check_timeout(),
       queued_check_result->get_early_timeout(),
       queued_check_result->get_return_code(), nullptr, nullptr);
+  broker_perfdata(NEBTYPE_PERFDATA_PROCESSED, NEBFLAG_NONE, NEBATTR_NONE,
+                  nullptr, this, nullptr);
 
   if (!(reschedule_check && get_should_be_scheduled() && has_been_checked()) ||
       !get_checks_enabled()) {
@@ -1871,15 +1934,16 @@ int service::log_event() {
 
   uint32_t log_options{NSLOG_SERVICE_UNKNOWN};
   char const* state{"UNKNOWN"};
-  if (_current_state >= 0 &&
-      (unsigned int)_current_state < tab_service_states.size()) {
-    log_options = tab_service_states[_current_state].first;
-    state = tab_service_states[_current_state].second.c_str();
+  if (get_current_state() >= 0 &&
+      (unsigned int)get_current_state() < tab_service_states.size()) {
+    log_options = tab_service_states[get_current_state()].first;
+    state = tab_service_states[get_current_state()].second.c_str();
   }
   std::string const& state_type{tab_state_type[get_state_type()]};
 
   logger(log_options, basic)
-      << "SERVICE ALERT: " << _hostname << ";" << _description << ";" << state
+      << "SERVICE ALERT: " << get_hostname() << ";" << get_description()
+      << ";" << state
       << ";" << state_type << ";" << get_current_attempt() << ";"
       << get_plugin_output();
   return OK;
@@ -1907,13 +1971,13 @@ void service::check_for_flapping(bool update,
   logger(dbg_functions, basic) << "check_for_flapping()";
 
   logger(dbg_flapping, more)
-      << "Checking service '" << _description << "' on host '" << _hostname
-      << "' for flapping...";
+      << "Checking service '" << get_description() << "' on host '"
+      << get_hostname() << "' for flapping...";
 
   /* if this is a soft service state and not a soft recovery, don't record this
    * in the history */
   /* only hard states and soft recoveries get recorded for flap detection */
-  if (get_state_type() == soft && _current_state != service::state_ok)
+  if (get_state_type() == soft && get_current_state() != service::state_ok)
     return;
 
   /* what threshold values should we use (global or service-specific)? */
@@ -1928,12 +1992,13 @@ void service::check_for_flapping(bool update,
 
   /* should we update state history for this state? */
   if (update_history) {
-    if ((_current_state == service::state_ok && !get_flap_detection_on(ok)) ||
-        (_current_state == service::state_warning &&
+    if ((get_current_state() == service::state_ok &&
+         !get_flap_detection_on(ok)) ||
+        (get_current_state() == service::state_warning &&
          !get_flap_detection_on(warning)) ||
-        (_current_state == service::state_unknown &&
+        (get_current_state() == service::state_unknown &&
          !get_flap_detection_on(unknown)) ||
-        (_current_state == service::state_critical &&
+        (get_current_state() == service::state_critical &&
          !get_flap_detection_on(critical)) ||
         (get_host_ptr()->get_current_state() != host::state_up))
       update_history = false;
@@ -1942,7 +2007,7 @@ void service::check_for_flapping(bool update,
   /* record current service state */
   if (update_history) {
     /* record the current state in the state history */
-    get_state_history()[get_state_history_index()] = _current_state;
+    get_state_history()[get_state_history_index()] = get_current_state();
 
     /* increment state history index to next available slot */
     set_state_history_index(get_state_history_index() + 1);
@@ -2007,7 +2072,7 @@ void service::check_for_flapping(bool update,
   /* else we're above the upper bound, so we are flapping */
   else if (curved_percent_change >= high_threshold) {
     /* start flapping on !OK states which makes more sense */
-    if ((_current_state != service::state_ok) || get_is_flapping())
+    if ((get_current_state() != service::state_ok) || get_is_flapping())
       is_flapping = true;
   }
   logger(dbg_flapping, more)
@@ -2033,7 +2098,7 @@ int service::handle_service_event() {
 
   /* send event data to broker */
   broker_statechange_data(NEBTYPE_STATECHANGE_END, NEBFLAG_NONE, NEBATTR_NONE,
-                          SERVICE_STATECHANGE, (void*)this, _current_state,
+                          SERVICE_STATECHANGE, (void*)this, get_current_state(),
                           get_state_type(), get_current_attempt(),
                           get_max_attempts(), nullptr);
 
@@ -2072,8 +2137,6 @@ int service::obsessive_compulsive_service_check_processor() {
   std::string raw_command;
   std::string processed_command;
   host* temp_host{get_host_ptr()};
-  int early_timeout = false;
-  double exectime = 0.0;
   int macro_options = STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS;
   nagios_macros* mac(get_global_macros());
 
@@ -2123,9 +2186,20 @@ int service::obsessive_compulsive_service_check_processor() {
 
   /* run the command */
   try {
-    std::string tmp;
-    my_system_r(mac, processed_command, config->ocsp_timeout(), &early_timeout,
-                &exectime, tmp, 0);
+    std::string description(get_description());
+    std::string host_name(get_hostname());
+    commands::system_runner::instance().run(
+        mac, processed_command, config->ocsp_timeout(), 0,
+        [processed_command, description, host_name](
+            int, bool early_timeout, double, std::string const&) {
+          /* check to see if the command timed out */
+          if (early_timeout)
+            logger(log_runtime_warning, basic)
+                << "Warning: OCSP command '" << processed_command
+                << "' for service '" << description << "' on host '"
+                << host_name << "' timed out after " << config->ocsp_timeout()
+                << " seconds";
+        });
   } catch (std::exception const& e) {
     logger(log_runtime_error, basic)
         << "Error: can't execute compulsive service processor command line '"
@@ -2134,13 +2208,6 @@ int service::obsessive_compulsive_service_check_processor() {
 
   clear_volatile_macros_r(mac);
 
-  /* check to see if the command timed out */
-  if (early_timeout == true)
-    logger(log_runtime_warning, basic)
-        << "Warning: OCSP command '" << processed_command << "' for service '"
-        << _description << "' on host '" << _hostname << "' timed out after "
-        << config->ocsp_timeout() << " seconds";
-
   return OK;
 }
 
@@ -2169,8 +2236,8 @@ int service::run_scheduled_check(int check_options, double latency) {
 
   logger(dbg_functions, basic) << "run_scheduled_service_check()";
   logger(dbg_checks, basic)
-      << "Attempting to run scheduled check of service '" << _description
-      << "' on host '" << _hostname << "': check options=" << check_options
+      << "Attempting to run scheduled check of service '" << get_description()
+      << "' on host '" << get_hostname() << "': check options=" << check_options
       << ", latency=" << latency;
 
   /* attempt to run the check */
@@ -2212,8 +2279,9 @@ int service::run_scheduled_check(int check_options, double latency) {
                                   next_valid_time, this->check_period_ptr)) {
           set_next_check((time_t)(next_valid_time + 60 * 60 * 24 * 7));
           logger(log_runtime_warning, basic)
-              << "Warning: Check of service '" << _description << "' on host '"
-              << _hostname
+              << "Warning: Check of service '" << get_description()
+              << "' on host '"
+              << get_hostname()
               << "' could not be "
                  "rescheduled properly. Scheduling check for next week...";
           logger(dbg_checks, more)
@@ -2336,6 +2404,7 @@ int service::run_async_check(int check_options,
 
   // Set the execution flag.
   set_is_executing(true);
+  update_orphan_deadline();
 
   // Get command object.
   commands::command* cmd = get_check_command_ptr();
@@ -2421,8 +2490,8 @@ bool service::schedule_check(time_t check_time, int options) {
   logger(dbg_checks, basic)
       << "Scheduling a "
       << (options & CHECK_OPTION_FORCE_EXECUTION ? "forced" : "non-forced")
-      << ", active check of service '" << _description << "' on host '"
-      << _hostname << "' @ " << my_ctime(&check_time);
+      << ", active check of service '" << get_description() << "' on host '"
+      << get_hostname() << "' @ " << my_ctime(&check_time);
 
   // Don't schedule a check if active checks
   // of this service are disabled.
@@ -2539,13 +2608,15 @@ void service::set_flap(double percent_change,
                        int allow_flapstart_notification) {
   logger(dbg_functions, basic) << "set_service_flap()";
 
-  logger(dbg_flapping, more) << "Service '" << _description << "' on host '"
-                             << _hostname << "' started flapping!";
+  logger(dbg_flapping, more)
+      << "Service '" << get_description() << "' on host '" << get_hostname()
+      << "' started flapping!";
 
   /* log a notice - this one is parsed by the history CGI */
   logger(log_runtime_warning, basic)
       << com::centreon::logging::setprecision(1)
-      << "SERVICE FLAPPING ALERT: " << _hostname << ";" << _description
+      << "SERVICE FLAPPING ALERT: " << get_hostname() << ";"
+      << get_description()
       << ";STARTED; Service appears to have started flapping ("
       << percent_change << "% change >= " << high_threshold << "% threshold)";
 
@@ -2589,13 +2660,15 @@ void service::clear_flap(double percent_change,
                          double low_threshold) {
   logger(dbg_functions, basic) << "clear_service_flap()";
 
-  logger(dbg_flapping, more) << "Service '" << _description << "' on host '"
-                             << _hostname << "' stopped flapping.";
+  logger(dbg_flapping, more)
+      << "Service '" << get_description() << "' on host '" << get_hostname()
+      << "' stopped flapping.";
 
   /* log a notice - this one is parsed by the history CGI */
   logger(log_info_message, basic)
       << com::centreon::logging::setprecision(1)
-      << "SERVICE FLAPPING ALERT: " << _hostname << ";" << _description
+      << "SERVICE FLAPPING ALERT: " << get_hostname() << ";"
+      << get_description()
       << ";STOPPED; Service appears to have stopped flapping ("
       << percent_change << "% change < " << low_threshold << "% threshold)";
 
@@ -2626,8 +2699,8 @@ void service::enable_flap_detection() {
   logger(dbg_functions, basic) << "service::enable_flap_detection()";
 
   logger(dbg_flapping, more)
-      << "Enabling flap detection for service '" << _description
-      << "' on host '" << _hostname << "'.";
+      << "Enabling flap detection for service '" << get_description()
+      << "' on host '" << get_hostname() << "'.";
 
   /* nothing to do... */
   if (get_flap_detection_enabled())
@@ -2658,8 +2731,8 @@ void service::disable_flap_detection() {
   logger(dbg_functions, basic) << "disable_service_flap_detection()";
 
   logger(dbg_flapping, more)
-      << "Disabling flap detection for service '" << _description
-      << "' on host '" << _hostname << "'.";
+      << "Disabling flap detection for service '" << get_description()
+      << "' on host '" << get_hostname() << "'.";
 
   /* nothing to do... */
   if (!get_flap_detection_enabled())
@@ -2681,9 +2754,13 @@ void service::disable_flap_detection() {
 }
 
 /**
- * @brief Updates service status info. Send data to event broker.
+ * @brief Updates service status info. Send data to event broker, mark the
+ * service for the next snapshot publication and update its part of the
+ * services statistics.
  */
 void service::update_status() {
+  snapshot::instance().service_changed(this);
+  status_stats::services().update(*this);
   broker_service_status(NEBTYPE_SERVICESTATUS_UPDATE, NEBFLAG_NONE,
                         NEBATTR_NONE, this, nullptr);
 }
@@ -2700,7 +2777,7 @@ bool service::verify_check_viability(int check_options,
   logger(dbg_functions, basic) << "check_service_check_viability()";
 
   /* get the check interval to use if we need to reschedule the check */
-  if (get_state_type() == soft && _current_state != service::state_ok)
+  if (get_state_type() == soft && get_current_state() != service::state_ok)
     check_interval =
         static_cast<int>(get_retry_interval() * config->interval_length());
   else
@@ -2772,8 +2849,6 @@ int service::notify_contact(nagios_macros* mac,
                             int escalated) {
   std::string raw_command;
   std::string processed_command;
-  int early_timeout = false;
-  double exectime;
   struct timeval start_time, end_time;
   struct timeval method_start_time, method_end_time;
   int macro_options = STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS;
@@ -2839,8 +2914,9 @@ int service::notify_contact(nagios_macros* mac,
     /* log the notification to program log file */
     if (config->log_notifications()) {
       char const* service_state_str("UNKNOWN");
-      if ((unsigned int)_current_state < tab_service_states.size())
-        service_state_str = tab_service_states[_current_state].second.c_str();
+      if ((unsigned int)get_current_state() < tab_service_states.size())
+        service_state_str =
+            tab_service_states[get_current_state()].second.c_str();
 
       char const* notification_str("");
       if ((unsigned int)type < tab_notification_str.size())
@@ -2870,24 +2946,27 @@ int service::notify_contact(nagios_macros* mac,
 
     /* run the notification command */
     try {
-      std::string tmp;
-      my_system_r(mac, processed_command, config->notification_timeout(),
-                  &early_timeout, &exectime, tmp, 0);
+      std::string contact_name(cntct->get_name());
+      commands::system_runner::instance().run(
+          mac, processed_command, config->notification_timeout(), 0,
+          [processed_command, contact_name](int, bool early_timeout, double,
+                                            std::string const&) {
+            /* check to see if the notification command timed out */
+            if (early_timeout) {
+              logger(log_service_notification | log_runtime_warning, basic)
+                  << "Warning: Contact '" << contact_name
+                  << "' service notification command '" << processed_command
+                  << "' timed out after " << config->notification_timeout()
+                  << " seconds";
+            }
+          },
+          cmd->get_name());
     } catch (std::exception const& e) {
       logger(log_runtime_error, basic)
           << "Error: can't execute service notification '" << cntct->get_name()
           << "' : " << e.what();
     }
 
-    /* check to see if the notification command timed out */
-    if (early_timeout) {
-      logger(log_service_notification | log_runtime_warning, basic)
-          << "Warning: Contact '" << cntct->get_name()
-          << "' service notification command '" << processed_command
-          << "' timed out after " << config->notification_timeout()
-          << " seconds";
-    }
-
     /* get end time */
     gettimeofday(&method_end_time, nullptr);
 
@@ -2915,11 +2994,11 @@ int service::notify_contact(nagios_macros* mac,
 
 void service::update_notification_flags() {
   /* update notifications flags */
-  if (_current_state == service::state_unknown)
+  if (get_current_state() == service::state_unknown)
     add_notified_on(unknown);
-  else if (_current_state == service::state_warning)
+  else if (get_current_state() == service::state_warning)
     add_notified_on(warning);
-  else if (_current_state == service::state_critical)
+  else if (get_current_state() == service::state_critical)
     add_notified_on(critical);
 }
 
@@ -2942,7 +3021,7 @@ bool service::is_valid_escalation_for_notification(escalation const* e,
    * if this is a recovery, really we check for who got notified about a
    * previous problem
    */
-  if (_current_state == service::state_ok)
+  if (get_current_state() == service::state_ok)
     notification_number = get_notification_number() - 1;
   else
     notification_number = get_notification_number();
@@ -2974,42 +3053,33 @@ bool service::is_valid_escalation_for_notification(escalation const* e,
     return false;
 
   /* skip this escalation if the state options don't match */
-  if (_current_state == service::state_ok && !e->get_escalate_on(ok))
+  if (get_current_state() == service::state_ok && !e->get_escalate_on(ok))
     return false;
-  else if (_current_state == service::state_warning &&
+  else if (get_current_state() == service::state_warning &&
            !e->get_escalate_on(warning))
     return false;
-  else if (_current_state == service::state_unknown &&
+  else if (get_current_state() == service::state_unknown &&
            !e->get_escalate_on(unknown))
     return false;
-  else if (_current_state == service::state_critical &&
+  else if (get_current_state() == service::state_critical &&
            !e->get_escalate_on(critical))
     return false;
 
   return true;
 }
 
-/* tests whether or not a service's check results are fresh */
-bool service::is_result_fresh(time_t current_time, int log_this) {
-  int freshness_threshold;
-  time_t expiration_time = 0L;
-  int days = 0;
-  int hours = 0;
-  int minutes = 0;
-  int seconds = 0;
-  int tdays = 0;
-  int thours = 0;
-  int tminutes = 0;
-  int tseconds = 0;
-
-  logger(dbg_checks, most) << "Checking freshness of service '"
-                           << this->get_description() << "' on host '"
-                           << this->get_hostname() << "'...";
-
+/**
+ *  Compute the time after which the results of this service are stale.
+ *
+ *  @param[out] freshness_threshold  The freshness threshold used.
+ *
+ *  @return The expiration time.
+ */
+time_t service::_freshness_expiration(int& freshness_threshold) const {
   /* use user-supplied freshness threshold or auto-calculate a freshness
    * threshold to use? */
   if (get_freshness_threshold() == 0) {
-    if (get_state_type() == hard || this->_current_state == service::state_ok)
+    if (get_state_type() == hard || get_current_state() == service::state_ok)
       freshness_threshold = static_cast<int>(
           (get_check_interval() * config->interval_length()) + get_latency() +
           config->additional_freshness_latency());
@@ -3020,10 +3090,6 @@ bool service::is_result_fresh(time_t current_time, int log_this) {
   } else
     freshness_threshold = this->get_freshness_threshold();
 
-  logger(dbg_checks, most) << "Freshness thresholds: service="
-                           << this->get_freshness_threshold()
-                           << ", use=" << freshness_threshold;
-
   /* calculate expiration time */
   /* CHANGED 11/10/05 EG - program start is only used in expiration time
    * calculation if > last check AND active checks are enabled, so active checks
@@ -3031,7 +3097,7 @@ bool service::is_result_fresh(time_t current_time, int log_this) {
   /* CHANGED 02/25/06 SG - passive checks also become stale, so remove
    * dependence on active check logic */
   if (!this->has_been_checked())
-    expiration_time = (time_t)(event_start + freshness_threshold);
+    return (time_t)(event_start + freshness_threshold);
   /* CHANGED 06/19/07 EG - Per Ton's suggestion (and user requests), only use
    * program start time over last check if no specific threshold has been set by
    * user.  Otheriwse use it.  Problems can occur if Engine is restarted more
@@ -3042,11 +3108,34 @@ bool service::is_result_fresh(time_t current_time, int log_this) {
    * suggested by Altinity */
   else if (this->get_checks_enabled() && event_start > get_last_check() &&
            this->get_freshness_threshold() == 0)
-    expiration_time = (time_t)(
+    return (time_t)(
         event_start + freshness_threshold +
         (config->max_service_check_spread() * config->interval_length()));
   else
-    expiration_time = (time_t)(get_last_check() + freshness_threshold);
+    return (time_t)(get_last_check() + freshness_threshold);
+}
+
+/* tests whether or not a service's check results are fresh */
+bool service::is_result_fresh(time_t current_time, int log_this) {
+  int freshness_threshold;
+  int days = 0;
+  int hours = 0;
+  int minutes = 0;
+  int seconds = 0;
+  int tdays = 0;
+  int thours = 0;
+  int tminutes = 0;
+  int tseconds = 0;
+
+  logger(dbg_checks, most) << "Checking freshness of service '"
+                           << this->get_description() << "' on host '"
+                           << this->get_hostname() << "'...";
+
+  time_t expiration_time = _freshness_expiration(freshness_threshold);
+
+  logger(dbg_checks, most) << "Freshness thresholds: service="
+                           << this->get_freshness_threshold()
+                           << ", use=" << freshness_threshold;
 
   logger(dbg_checks, most) << "HBC: " << this->has_been_checked()
                            << ", PS: " << program_start
@@ -3155,26 +3244,30 @@ bool service::authorized_by_dependencies(
     dependency::types dependency_type) const {
   logger(dbg_functions, basic) << "service::authorized_by_dependencies()";
 
-  auto p(servicedependency::servicedependencies.equal_range(
-      {_hostname, _description}));
-  for (servicedependency_mmap::const_iterator it{p.first}, end{p.second};
-       it != end; ++it) {
-    servicedependency* dep{it->second.get()};
+  dependency_index& index(dependency_index::services());
+  dependency_index::verdict cached(index.get_verdict(_state_id,
+                                                     dependency_type));
+  if (cached != dependency_index::unknown)
+    return cached == dependency_index::authorized;
+
+  /* A result depending on the current time is not kept. */
+  bool timed(false);
+  bool authorized(true);
+  for (dependency* d : index.dependencies(_state_id)) {
+    servicedependency* dep{static_cast<servicedependency*>(d)};
     /* Only check dependencies of the desired type (notification or execution)
      */
     if (dep->get_dependency_type() != dependency_type)
       continue;
 
-    /* Find the service we depend on */
-    if (!dep->master_service_ptr)
-      continue;
-
     /* Skip this dependency if it has a timepriod and the the current time is
      * not valid */
-    time_t current_time{std::time(nullptr)};
-    if (!dep->get_dependency_period().empty() &&
-        !check_time_against_period(current_time, dep->dependency_period_ptr))
-      return true;
+    if (!dep->get_dependency_period().empty()) {
+      timed = true;
+      time_t current_time{std::time(nullptr)};
+      if (!check_time_against_period(current_time, dep->dependency_period_ptr))
+        break;
+    }
 
     /* Get the status to use (use last hard state if it's currently in a soft
      * state) */
@@ -3185,22 +3278,29 @@ bool service::authorized_by_dependencies(
             : dep->master_service_ptr->get_current_state();
 
     /* Is the service we depend on in state that fails the dependency tests? */
-    if (dep->get_fail_on(state))
-      return false;
-
-    if (state == service::state_ok &&
-        !dep->master_service_ptr->has_been_checked() &&
-        dep->get_fail_on_pending())
-      return false;
+    if (dep->get_fail_on(state) ||
+        (state == service::state_ok &&
+         !dep->master_service_ptr->has_been_checked() &&
+         dep->get_fail_on_pending())) {
+      authorized = false;
+      break;
+    }
 
     /* Immediate dependencies ok at this point - check parent dependencies if
      * necessary */
     if (dep->get_inherits_parent()) {
-      if (!dep->master_service_ptr->authorized_by_dependencies(dependency_type))
-        return false;
+      authorized =
+          dep->master_service_ptr->authorized_by_dependencies(dependency_type);
+      if (index.get_verdict(dep->master_service_ptr->get_state_id(),
+                            dependency_type) == dependency_index::unknown)
+        timed = true;
+      if (!authorized)
+        break;
     }
   }
-  return true;
+  if (!timed)
+    index.set_verdict(_state_id, dependency_type, authorized);
+  return authorized;
 }
 
 /* check for services that never returned from a check... */
@@ -3213,46 +3313,50 @@ void service::check_for_orphaned() {
   /* get the current time */
   time(&current_time);
 
-  /* check all services... */
-  for (service_map::iterator it(service::services.begin()),
-       end(service::services.end());
-       it != end; ++it) {
+  time_base const& tb(time_base::instance());
+
+  /* check the executing services whose results should be there by now... */
+  std::vector<service*> due;
+  _orphan_queue.pop_due(tb.to_internal(current_time), due);
+  for (service* svc : due) {
     /* skip services that are not currently executing */
-    if (!it->second->get_is_executing())
+    if (!svc->get_is_executing())
       continue;
 
     /* determine the time at which the check results should have come in (allow
      * 10 minutes slack time) */
-    expected_time =
-        (time_t)(it->second->get_next_check() + it->second->get_latency() +
-                 config->service_check_timeout() +
-                 config->check_reaper_interval() + 600);
+    expected_time = svc->_orphan_expected_time();
+
+    /* the check was rescheduled in the meantime */
+    if (expected_time >= current_time) {
+      _orphan_queue.set(svc, tb.to_internal(expected_time + 1));
+      continue;
+    }
 
     /* this service was supposed to have executed a while ago, but for some
      * reason the results haven't come back in... */
-    if (expected_time < current_time) {
-      /* log a warning */
-      logger(log_runtime_warning, basic)
-          << "Warning: The check of service '" << it->first.second
-          << "' on host '" << it->first.first
-          << "' looks like it was orphaned "
-             "(results never came back).  I'm scheduling an immediate check "
-             "of the service...";
+    /* log a warning */
+    logger(log_runtime_warning, basic)
+        << "Warning: The check of service '" << svc->get_description()
+        << "' on host '" << svc->get_hostname()
+        << "' looks like it was orphaned "
+           "(results never came back).  I'm scheduling an immediate check "
+           "of the service...";
 
-      logger(dbg_checks, more)
-          << "Service '" << it->first.second << "' on host '" << it->first.first
-          << "' was orphaned, so we're scheduling an immediate check...";
+    logger(dbg_checks, more)
+        << "Service '" << svc->get_description() << "' on host '"
+        << svc->get_hostname()
+        << "' was orphaned, so we're scheduling an immediate check...";
 
-      /* decrement the number of running service checks */
-      if (currently_running_service_checks > 0)
-        currently_running_service_checks--;
+    /* decrement the number of running service checks */
+    if (currently_running_service_checks > 0)
+      currently_running_service_checks--;
 
-      /* disable the executing flag */
-      it->second->set_is_executing(false);
+    /* disable the executing flag */
+    svc->set_is_executing(false);
 
-      /* schedule an immediate check of the service */
-      it->second->schedule_check(current_time, CHECK_OPTION_ORPHAN_CHECK);
-    }
+    /* schedule an immediate check of the service */
+    svc->schedule_check(current_time, CHECK_OPTION_ORPHAN_CHECK);
   }
 }
 
@@ -3271,57 +3375,124 @@ void service::check_result_freshness() {
   }
   /* get the current time */
   time(&current_time);
-
-  /* check all services... */
-  for (service_map::iterator it(service::services.begin()),
-       end(service::services.end());
-       it != end; ++it) {
-    /* skip services we shouldn't be checking for freshness */
-    if (!it->second->get_check_freshness())
-      continue;
-
-    /* skip services that are currently executing (problems here will be caught
-     * by orphaned service check) */
-    if (it->second->get_is_executing())
+  time_t const retry_time(current_time +
+                          config->service_freshness_check_interval());
+
+  time_base const& tb(time_base::instance());
+
+  /* check the services whose results may be stale... */
+  std::vector<service*> due;
+  _freshness_queue.pop_due(tb.to_internal(current_time), due);
+  for (service* svc : due) {
+    /* skip services we shouldn't be checking for freshness, they come back
+     * in the queue when their settings change */
+    if (!svc->get_check_freshness())
       continue;
 
     /* skip services that have both active and passive checks disabled */
-    if (!it->second->get_checks_enabled() &&
-        !it->second->get_accept_passive_checks())
+    if (!svc->get_checks_enabled() && !svc->get_accept_passive_checks())
       continue;
 
-    /* skip services that are already being freshened */
-    if (it->second->get_is_being_freshened())
+    /* skip services that are currently executing (problems here will be caught
+     * by orphaned service check) or that are already being freshened, until
+     * the next freshness check */
+    if (svc->get_is_executing() || svc->get_is_being_freshened()) {
+      _freshness_queue.set(svc, tb.to_internal(retry_time));
       continue;
+    }
 
     // See if the time is right...
     {
-      timezone_locker lock(it->second->get_timezone());
-      if (!check_time_against_period(current_time,
-                                     it->second->check_period_ptr))
+      timezone_locker lock(svc->get_timezone());
+      if (!check_time_against_period(current_time, svc->check_period_ptr)) {
+        time_t next_valid_time(0);
+        get_next_valid_time(current_time, &next_valid_time,
+                            svc->check_period_ptr);
+        _freshness_queue.set(
+            svc, tb.to_internal(next_valid_time > current_time ? next_valid_time
+                                                               : retry_time));
         continue;
+      }
     }
 
     /* EXCEPTION */
     /* don't check freshness of services without regular check intervals if
      * we're using auto-freshness threshold */
-    if (it->second->get_check_interval() == 0 &&
-        it->second->get_freshness_threshold() == 0)
+    if (svc->get_check_interval() == 0 && svc->get_freshness_threshold() == 0)
       continue;
 
     /* the results for the last check of this service are stale! */
-    if (!it->second->is_result_fresh(current_time, true)) {
+    if (!svc->is_result_fresh(current_time, true)) {
       /* set the freshen flag */
-      it->second->set_is_being_freshened(true);
+      svc->set_is_being_freshened(true);
 
       /* schedule an immediate forced check of the service */
-      it->second->schedule_check(
+      svc->schedule_check(
           current_time,
           CHECK_OPTION_FORCE_EXECUTION | CHECK_OPTION_FRESHNESS_CHECK);
-    }
+      _freshness_queue.set(svc, tb.to_internal(retry_time));
+    } else
+      svc->update_freshness_deadline();
+  }
+}
+
+/**
+ *  Index all the services by the time their results become stale and the
+ *  executing ones by the time their results are late. Called once the
+ *  configuration and the retention are applied.
+ */
+void service::rebuild_check_deadlines() {
+  _freshness_queue.clear();
+  _orphan_queue.clear();
+  for (service_map::iterator it(service::services.begin()),
+       end(service::services.end());
+       it != end; ++it) {
+    it->second->update_freshness_deadline();
+    if (it->second->get_is_executing())
+      it->second->update_orphan_deadline();
+  }
+}
+
+/**
+ *  Index the service by the time its results become stale, so that
+ *  check_result_freshness() only looks at the services that are due. It is
+ *  called after each check result and when the freshness settings change.
+ */
+void service::update_freshness_deadline() {
+  if (!get_check_freshness() ||
+      (!get_checks_enabled() && !get_accept_passive_checks()) ||
+      (get_check_interval() == 0 && get_freshness_threshold() == 0))
+    _freshness_queue.erase(this);
+  else {
+    int freshness_threshold;
+    /* Results are stale once the expiration time is passed. */
+    time_t expiration(_freshness_expiration(freshness_threshold));
+    _freshness_queue.set(this,
+                         time_base::instance().to_internal(expiration + 1));
   }
 }
 
+/**
+ *  Index the service by the time the result of its running check is late,
+ *  so that check_for_orphaned() only looks at the late checks.
+ */
+void service::update_orphan_deadline() {
+  _orphan_queue.set(
+      this, time_base::instance().to_internal(_orphan_expected_time() + 1));
+}
+
+/**
+ *  Get the time at which the result of the running check should have come
+ *  in, with 10 minutes of slack time.
+ *
+ *  @return A time.
+ */
+time_t service::_orphan_expected_time() const {
+  return (time_t)(get_next_check() + get_latency() +
+                  config->service_check_timeout() +
+                  config->check_reaper_interval() + 600);
+}
+
 std::string const& service::get_current_state_as_string() const {
   return tab_service_states[get_current_state()].second;
 }
@@ -3358,22 +3529,22 @@ void service::resolve(int& w, int& e) {
     notifier::resolve(warnings, errors);
   } catch (std::exception const& e) {
     logger(log_verification_error, basic)
-        << "Error: Service description '" << _description << "' of host '"
-        << _hostname << "' has problem in its notifier part: " << e.what();
+        << "Error: Service description '" << get_description() << "' of host '"
+        << get_hostname() << "' has problem in its notifier part: " << e.what();
   }
 
   {
     /* check for a valid host */
-    host_map::const_iterator it{host::hosts.find(_hostname)};
+    host_map::const_iterator it{host::hosts.find(get_hostname())};
 
     /* we couldn't find an associated host! */
 
     if (it == host::hosts.end() || !it->second) {
       logger(log_verification_error, basic)
-          << "Error: Host '" << _hostname
+          << "Error: Host '" << get_hostname()
           << "' specified in service "
              "'"
-          << _description << "' not defined anywhere!";
+          << get_description() << "' not defined anywhere!";
       errors++;
       set_host_ptr(nullptr);
     } else {
@@ -3383,7 +3554,7 @@ void service::resolve(int& w, int& e) {
       /* add a reverse link from the host to the service for faster lookups
        * later
        */
-      it->second->services.insert({{_hostname, _description}, this});
+      it->second->services.insert({{get_hostname(), get_description()}, this});
 
       // Notify event broker.
       timeval tv(get_broker_timestamp(NULL));
@@ -3396,8 +3567,9 @@ void service::resolve(int& w, int& e) {
   if (get_notifications_enabled() && get_notify_on(notifier::ok) &&
       !get_notify_on(notifier::warning) && !get_notify_on(notifier::critical)) {
     logger(log_verification_error, basic)
-        << "Warning: Recovery notification option in service '" << _description
-        << "' for host '" << _hostname
+        << "Warning: Recovery notification option in service '"
+        << get_description()
+        << "' for host '" << get_hostname()
         << "' doesn't make any sense - specify warning and /or critical "
            "options as well";
     warnings++;
@@ -3407,7 +3579,8 @@ void service::resolve(int& w, int& e) {
   if (get_notifications_enabled() && get_notification_interval() &&
       get_notification_interval() < get_check_interval()) {
     logger(log_verification_error, basic)
-        << "Warning: Service '" << _description << "' on host '" << _hostname
+        << "Warning: Service '" << get_description() << "' on host '"
+        << get_hostname()
         << "'  has a notification interval less than "
            "its check interval!  Notifications are only re-sent after "
            "checks are made, so the effective notification interval will "
@@ -3416,10 +3589,10 @@ void service::resolve(int& w, int& e) {
   }
 
   /* check for illegal characters in service description */
-  if (contains_illegal_object_chars(_description.c_str())) {
+  if (contains_illegal_object_chars(get_description().c_str())) {
     logger(log_verification_error, basic)
-        << "Error: The description string for service '" << _description
-        << "' on host '" << _hostname
+        << "Error: The description string for service '" << get_description()
+        << "' on host '" << get_hostname()
         << "' contains one or more illegal characters.";
     errors++;
   }
@@ -3428,8 +3601,8 @@ void service::resolve(int& w, int& e) {
   e += errors;
 
   if (errors)
-    throw engine_error() << "Cannot resolve service '" << _description
-                         << "' of host '" << _hostname << "'";
+    throw engine_error() << "Cannot resolve service '" << get_description()
+                         << "' of host '" << get_hostname() << "'";
 }
 
 bool service::get_host_problem_at_last_check() const {
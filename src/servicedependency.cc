@@ -19,6 +19,7 @@
 
 #include "com/centreon/engine/servicedependency.hh"
 #include "com/centreon/engine/broker.hh"
+#include "com/centreon/engine/dependency_index.hh"
 #include "com/centreon/engine/exceptions/error.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
@@ -76,7 +77,16 @@ servicedependency::servicedependency(std::string const& dependent_hostname,
       _fail_on_ok{fail_on_ok},
       _fail_on_warning{fail_on_warning},
       _fail_on_unknown{fail_on_unknown},
-      _fail_on_critical{fail_on_critical} {}
+      _fail_on_critical{fail_on_critical} {
+  dependency_index::services().invalidate();
+}
+
+/**
+ *  Destructor.
+ */
+servicedependency::~servicedependency() noexcept {
+  dependency_index::services().invalidate();
+}
 
 std::string const& servicedependency::get_dependent_service_description()
     const {
@@ -347,6 +357,9 @@ void servicedependency::resolve(int& w, int& e) {
       dependency_period_ptr = it->second.get();
   }
 
+  // The dependency index is built from the resolved pointers.
+  dependency_index::services().invalidate();
+
   // Add errors.
   if (errors) {
     e += errors;
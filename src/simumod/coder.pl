@@ -18,6 +18,15 @@ my $deregister = "";
 
 my $instruct = 0;
 
+# Callback types that can be received by batch (see nebcallbacks.hh).
+my %batchable = map { $_ => 1 } qw(
+    NEBCALLBACK_SERVICE_CHECK_DATA
+    NEBCALLBACK_HOST_CHECK_DATA
+    NEBCALLBACK_SERVICE_STATUS_DATA
+    NEBCALLBACK_HOST_STATUS_DATA
+    NEBCALLBACK_STATE_CHANGE_DATA
+);
+
 while (<F>) {
     if (m/typedef struct.*/) {
         $instruct = 1;
@@ -33,6 +42,9 @@ while (<F>) {
         elsif (m/^\s*const\s+char\*\s+([^\s]*);/) {
             $callback .= "\n      << \"  $1=\" << (neb_data->$1 ? neb_data->$1 : \"NULL\") << std::endl";
         }
+        elsif (m/^\s*const\s+nebstruct_perfdata_metric\*\s+([^\s]*);/) {
+            $callback .= "\n      << \"  $1=\" << metrics_str(neb_data->$1, neb_data->size) << std::endl";
+        }
         elsif (m/^\s*char\*\s+([^\s]*);/) {
             $callback .= "\n      << \"  $1=\" << (neb_data->$1 ? neb_data->$1 : \"NULL\") << std::endl";
         }
@@ -42,6 +54,10 @@ while (<F>) {
         elsif (m/}\s*([a-z_]*);/) {
             $instruct = 0;
             my $v = $1;
+
+            # Only the *_data structures are given to callbacks, the others
+            # are parts of them.
+            next if ($v !~ m/_data$/);
             my $fname = $v;
             $fname =~ s/nebstruct_//;
             $callback = qq(
@@ -80,6 +96,45 @@ static int callback_$fname(int callback_type __attribute__((unused)), void* data
       callback_$fname);
 );
 
+            # With SIMUMOD_BATCH set, batchable events are received by batch
+            # and each event of a batch is given to the usual handler.
+            if ($batchable{$nebcb}) {
+                $callback .= qq(/**
+ *  \@brief This function is called with a batch of events of type $v.
+ *
+ *  \@param callback_type An integer corresponding to the type.
+ *  \@param data The batch, a nebstruct_batch_data cast into void*
+ *
+ *  \@return 0 on success and -1 otherwise.
+ */
+static int callback_batch_$fname(int callback_type, void* data) {
+  nebstruct_batch_data* batch(static_cast<nebstruct_batch_data*>(data));
+  *fp << "batch of " << batch->size << " $v" << std::endl;
+  for (size_t i = 0; i < batch->size; ++i)
+    callback_$fname(callback_type, batch->events[i]);
+  return 0;
+}
+
+);
+                $register = qq(    if (use_batches) {
+      if (neb_register_batch_callback(
+            $nebcb,
+            gl_mod_handle,
+            0,
+            callback_batch_$fname)) {
+        throw engine_error()
+            << "$fname register batch callback failed";
+      }
+    }
+    else ) . ($register =~ s/^\s+//r);
+                $deregister = qq(    if (use_batches)
+      neb_deregister_batch_callback(
+        $nebcb,
+        callback_batch_$fname);
+    else
+  ) . $deregister;
+            }
+
             push(@cb, $callback);
             push(@reg, $register);
             push(@dereg, $deregister);
@@ -134,6 +189,15 @@ static std::string timeval_str(timeval const& t) {
   return std::string(buf);
 }
 
+/* Metric texts are not null-terminated. */
+static std::string metrics_str(nebstruct_perfdata_metric const* metrics,
+                               size_t size) {
+  std::string retval;
+  for (size_t i = 0; i < size; ++i)
+    retval.append("\\n    ").append(metrics[i].text, metrics[i].text_size);
+  return retval;
+}
+
 /**************************************
 *                                     *
 *           Global Objects            *
@@ -146,6 +210,9 @@ NEB_API_VERSION(CURRENT_NEB_API_VERSION)
 // Module handle
 static void* gl_mod_handle(NULL);
 
+// Receive the batchable events by batch (SIMUMOD_BATCH set).
+static bool use_batches(false);
+
 /**************************************
 *                                     *
 *         Callback Function           *
@@ -224,6 +291,8 @@ int nebmodule_init(int flags __attribute__((unused)),
   }
   if (!fp)
     fp = \&std::cout;
+  env = getenv("SIMUMOD_BATCH");
+  use_batches = env && *env;
 
   *fp << "################################################################################" << std::endl
       << "#                                  START SIMUMOD                               #" << std::endl
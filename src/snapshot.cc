@@ -0,0 +1,351 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/snapshot.hh"
+
+#include <algorithm>
+
+#include "com/centreon/engine/command_manager.hh"
+#include "com/centreon/engine/contact.hh"
+#include "com/centreon/engine/contactgroup.hh"
+#include "com/centreon/engine/host.hh"
+#include "com/centreon/engine/hostdependency.hh"
+#include "com/centreon/engine/hostgroup.hh"
+#include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/service.hh"
+#include "com/centreon/engine/servicedependency.hh"
+#include "com/centreon/engine/servicegroup.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::logging;
+
+/* Statistics are computed while publishing as long as someone asked for them
+ * during this delay (in seconds). */
+static time_t const stats_interest_delay = 60;
+
+/**
+ *  Default constructor.
+ */
+snapshot::snapshot() : _invalidated{false} {
+  for (std::atomic<time_t>& t : _last_stats_request)
+    t = 0;
+}
+
+/**
+ * @brief Accessor to the snapshot instance.
+ *
+ * @return A reference to the instance.
+ */
+snapshot& snapshot::instance() {
+  static snapshot instance;
+  return instance;
+}
+
+/**
+ * @brief Get the last published view. This method can be called from any
+ * thread. The returned pointer may be null if nothing has been published yet.
+ *
+ * @return A shared pointer to an immutable view.
+ */
+std::shared_ptr<const snapshot::data> snapshot::get() const {
+  return std::atomic_load(&_current);
+}
+
+/**
+ * @brief Forget the current view and the marked objects. Readers still
+ * owning the view are not impacted. This method must be called from the main
+ * loop.
+ */
+void snapshot::clear() {
+  std::atomic_store(&_current, std::shared_ptr<const data>());
+  _dirty_hosts.clear();
+  _dirty_services.clear();
+}
+
+/**
+ * @brief Tell the snapshot that some statistics sections are wanted, so the
+ * next publications will embed them.
+ *
+ * @param sections A mask of command_manager::stats_section.
+ */
+void snapshot::stats_requested(uint32_t sections) noexcept {
+  time_t now = time(nullptr);
+  for (uint32_t i = 0; i < 3; ++i)
+    if (sections & (1u << i))
+      _last_stats_request[i] = now;
+}
+
+/**
+ * @brief Force the lookup tables to be built again at the next publication.
+ * This is needed when the configuration is applied since groups may change
+ * even if the objects are the same.
+ */
+void snapshot::invalidate() noexcept {
+  _invalidated = true;
+}
+
+/**
+ * @brief Mark a host as changed, its entry will be copied again at the next
+ * publication. This method must be called from the main loop.
+ *
+ * @param hst The host.
+ */
+void snapshot::host_changed(const host* hst) {
+  _dirty_hosts.insert(hst);
+}
+
+/**
+ * @brief Mark a service as changed, its entry will be copied again at the
+ * next publication. This method must be called from the main loop.
+ *
+ * @param svc The service.
+ */
+void snapshot::service_changed(const service* svc) {
+  _dirty_services.insert(svc);
+}
+
+/**
+ * @brief Copy a host into a new entry.
+ *
+ * @param hst The host.
+ *
+ * @return The entry.
+ */
+static std::shared_ptr<const snapshot::host_entry> make_entry(
+    const host& hst) {
+  return std::make_shared<snapshot::host_entry>(snapshot::host_entry{
+      &hst, hst.get_host_id(), hst.get_name(), hst.get_alias(),
+      hst.get_address(), hst.get_check_period(), hst.get_current_state(),
+      hst.get_state_type(), hst.get_plugin_output(), hst.get_last_check(),
+      hst.get_current_attempt(), hst.get_problem_has_been_acknowledged(),
+      hst.is_in_downtime()});
+}
+
+/**
+ * @brief Copy a service into a new entry.
+ *
+ * @param svc The service.
+ *
+ * @return The entry.
+ */
+static std::shared_ptr<const snapshot::service_entry> make_entry(
+    const service& svc) {
+  return std::make_shared<snapshot::service_entry>(snapshot::service_entry{
+      &svc, svc.get_host_id(), svc.get_service_id(), svc.get_hostname(),
+      svc.get_description(), svc.get_check_period(), svc.get_current_state(),
+      svc.get_state_type(), svc.get_plugin_output(), svc.get_last_check(),
+      svc.get_current_attempt(), svc.get_problem_has_been_acknowledged(),
+      svc.is_in_downtime()});
+}
+
+/**
+ * @brief Build the lookup tables of a view.
+ *
+ * @param d The view.
+ *
+ * @return The lookup tables.
+ */
+static std::shared_ptr<const snapshot::index> make_index(
+    const snapshot::data& d) {
+  auto idx = std::make_shared<snapshot::index>();
+  idx->host_by_name.reserve(d.hosts.size());
+  idx->host_by_id.reserve(d.hosts.size());
+  idx->host_by_object.reserve(d.hosts.size());
+  for (size_t i = 0; i < d.hosts.size(); ++i) {
+    const snapshot::host_entry& h = *d.hosts[i];
+    idx->host_by_name[h.name] = i;
+    idx->host_by_id[h.id] = i;
+    idx->host_by_object[h.object] = i;
+  }
+  idx->service_by_names.reserve(d.services.size());
+  idx->service_by_ids.reserve(d.services.size());
+  idx->service_by_object.reserve(d.services.size());
+  for (size_t i = 0; i < d.services.size(); ++i) {
+    const snapshot::service_entry& s = *d.services[i];
+    idx->service_by_names[{s.host_name, s.description}] = i;
+    idx->service_by_ids[{s.host_id, s.service_id}] = i;
+    idx->service_by_object[s.object] = i;
+  }
+  for (auto& p : hostgroup::hostgroups) {
+    std::vector<size_t>& members = idx->hostgroup_members[p.first];
+    for (auto& m : p.second->members) {
+      auto found = idx->host_by_name.find(m.first);
+      if (found != idx->host_by_name.end())
+        members.push_back(found->second);
+    }
+  }
+  for (auto& p : servicegroup::servicegroups) {
+    std::vector<size_t>& members = idx->servicegroup_members[p.first];
+    for (auto& m : p.second->members) {
+      auto found = idx->service_by_names.find(m.first);
+      if (found != idx->service_by_names.end())
+        members.push_back(found->second);
+    }
+  }
+  return idx;
+}
+
+/**
+ * @brief Make a new view current. Only the objects marked since the previous
+ * publication are copied again, unless the configuration has been applied in
+ * the meantime. Nothing is done if nothing changed. This method must be
+ * called from the main loop, the only thread allowed to read the objects.
+ */
+void snapshot::publish() {
+  logger(dbg_functions, basic) << "snapshot::publish()";
+
+  std::shared_ptr<const data> prev{std::atomic_load(&_current)};
+  time_t now = time(nullptr);
+  uint32_t sections = 0;
+  for (uint32_t i = 0; i < 3; ++i)
+    if (now - _last_stats_request[i] < stats_interest_delay)
+      sections |= 1u << i;
+
+  /* Marked objects are only searched in a view built from the same objects,
+   * they may have been destroyed since. */
+  bool incremental = prev && !_invalidated.exchange(false) &&
+                     prev->hosts.size() == host::hosts.size() &&
+                     prev->services.size() == service::services.size();
+  if (incremental && _dirty_hosts.empty() && _dirty_services.empty() &&
+      !sections && !prev->stats)
+    return;
+
+  auto retval = std::make_shared<data>();
+  retval->published = now;
+
+  if (incremental) {
+    retval->hosts = prev->hosts;
+    retval->services = prev->services;
+    retval->idx = prev->idx;
+    for (const host* hst : _dirty_hosts) {
+      auto found = prev->idx->host_by_object.find(hst);
+      if (found != prev->idx->host_by_object.end())
+        retval->hosts[found->second] = make_entry(*hst);
+    }
+    for (const service* svc : _dirty_services) {
+      auto found = prev->idx->service_by_object.find(svc);
+      if (found != prev->idx->service_by_object.end())
+        retval->services[found->second] = make_entry(*svc);
+    }
+  } else {
+    retval->hosts.reserve(host::hosts.size());
+    for (auto& p : host::hosts)
+      retval->hosts.push_back(make_entry(*p.second));
+    retval->services.reserve(service::services.size());
+    for (auto& p : service::services)
+      retval->services.push_back(make_entry(*p.second));
+    /* Sorted by id, so that paged lists can go on from the last id read. */
+    std::sort(retval->hosts.begin(), retval->hosts.end(),
+              [](const std::shared_ptr<const host_entry>& a,
+                 const std::shared_ptr<const host_entry>& b) {
+                return a->id < b->id;
+              });
+    std::sort(retval->services.begin(), retval->services.end(),
+              [](const std::shared_ptr<const service_entry>& a,
+                 const std::shared_ptr<const service_entry>& b) {
+                return std::make_pair(a->host_id, a->service_id) <
+                       std::make_pair(b->host_id, b->service_id);
+              });
+    retval->idx = make_index(*retval);
+  }
+  _dirty_hosts.clear();
+  _dirty_services.clear();
+
+  retval->contacts_count = contact::contacts.size();
+  retval->hostgroups_count = hostgroup::hostgroups.size();
+  retval->servicegroups_count = servicegroup::servicegroups.size();
+  retval->contactgroups_count = contactgroup::contactgroups.size();
+  retval->hostdependencies_count = hostdependency::hostdependencies.size();
+  retval->servicedependencies_count =
+      servicedependency::servicedependencies.size();
+
+  /* Only the asked sections are built, the hosts and services ones are
+   * copied from their kept totals. */
+  retval->stats_sections = sections;
+  if (sections) {
+    auto stats = std::make_shared<Stats>();
+    command_manager::instance().fill_stats(sections, stats.get());
+    retval->stats = std::move(stats);
+  }
+
+  std::atomic_store(&_current, std::shared_ptr<const data>(std::move(retval)));
+}
+
+/**
+ * @brief Find a host by its name.
+ *
+ * @param name The host name.
+ *
+ * @return A pointer to the entry or nullptr if not found.
+ */
+const snapshot::host_entry* snapshot::data::find_host(
+    const std::string& name) const {
+  auto found = idx->host_by_name.find(name);
+  if (found == idx->host_by_name.end())
+    return nullptr;
+  return hosts[found->second].get();
+}
+
+/**
+ * @brief Find a host by its id.
+ *
+ * @param id The host id.
+ *
+ * @return A pointer to the entry or nullptr if not found.
+ */
+const snapshot::host_entry* snapshot::data::find_host(uint64_t id) const {
+  auto found = idx->host_by_id.find(id);
+  if (found == idx->host_by_id.end())
+    return nullptr;
+  return hosts[found->second].get();
+}
+
+/**
+ * @brief Find a service by its host name and its description.
+ *
+ * @param host_name The host name.
+ * @param description The service description.
+ *
+ * @return A pointer to the entry or nullptr if not found.
+ */
+const snapshot::service_entry* snapshot::data::find_service(
+    const std::string& host_name,
+    const std::string& description) const {
+  auto found = idx->service_by_names.find({host_name, description});
+  if (found == idx->service_by_names.end())
+    return nullptr;
+  return services[found->second].get();
+}
+
+/**
+ * @brief Find a service by its host id and its service id.
+ *
+ * @param host_id The host id.
+ * @param service_id The service id.
+ *
+ * @return A pointer to the entry or nullptr if not found.
+ */
+const snapshot::service_entry* snapshot::data::find_service(
+    uint64_t host_id,
+    uint64_t service_id) const {
+  auto found = idx->service_by_ids.find({host_id, service_id});
+  if (found == idx->service_by_ids.end())
+    return nullptr;
+  return services[found->second].get();
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/state_table.hh"
+
+using namespace com::centreon::engine;
+
+/**
+ *  Give an id to an object. Its fields are zeroed, the object sets them.
+ *
+ *  @param[in] obj  The object.
+ *
+ *  @return The id of the object.
+ */
+uint32_t state_table::add(checkable* obj) {
+  uint32_t id;
+  if (_free_ids.empty()) {
+    id = object.size();
+    object.push_back(obj);
+    next_check.push_back(0);
+    last_check.push_back(0);
+    last_state_change.push_back(0);
+    last_hard_state_change.push_back(0);
+    last_notification.push_back(0);
+    next_notification.push_back(0);
+    initial_notif_time.push_back(0);
+    last_acknowledgement.push_back(0);
+    last_state_history_update.push_back(0);
+    latency.push_back(0);
+    check_interval.push_back(0);
+    retry_interval.push_back(0);
+    freshness_threshold.push_back(0);
+    current_attempt.push_back(0);
+    check_options.push_back(0);
+    flags.push_back(0);
+    current_state.push_back(0);
+    state_type.push_back(0);
+    /* So that remove() can give any id back without allocating. */
+    if (_free_ids.capacity() < object.size())
+      _free_ids.reserve(object.capacity());
+  } else {
+    id = _free_ids.back();
+    _free_ids.pop_back();
+    object[id] = obj;
+  }
+  return id;
+}
+
+/**
+ *  Get the table of the hosts. It is never destroyed since hosts can be
+ *  destroyed at exit after it.
+ *
+ *  @return The table.
+ */
+state_table& state_table::hosts() {
+  static state_table* instance(new state_table);
+  return *instance;
+}
+
+/**
+ *  Release the id of a removed object.
+ *
+ *  @param[in] id  The id.
+ */
+void state_table::remove(uint32_t id) noexcept {
+  object[id] = nullptr;
+  next_check[id] = 0;
+  last_check[id] = 0;
+  last_state_change[id] = 0;
+  last_hard_state_change[id] = 0;
+  last_notification[id] = 0;
+  next_notification[id] = 0;
+  initial_notif_time[id] = 0;
+  last_acknowledgement[id] = 0;
+  last_state_history_update[id] = 0;
+  latency[id] = 0;
+  check_interval[id] = 0;
+  retry_interval[id] = 0;
+  freshness_threshold[id] = 0;
+  current_attempt[id] = 0;
+  check_options[id] = 0;
+  flags[id] = 0;
+  current_state[id] = 0;
+  state_type[id] = 0;
+  /* Reserved by add(), this cannot throw. */
+  _free_ids.push_back(id);
+}
+
+/**
+ *  Get the table of the services, anomaly detections included. It is never
+ *  destroyed since services can be destroyed at exit after it.
+ *
+ *  @return The table.
+ */
+state_table& state_table::services() {
+  static state_table* instance(new state_table);
+  return *instance;
+}
+
+/**
+ *  Get the number of slots of each column, free ones included.
+ *
+ *  @return A number of slots.
+ */
+uint32_t state_table::size() const noexcept {
+  return object.size();
+}
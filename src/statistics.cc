@@ -17,15 +17,35 @@
  *
  */
 
-#include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/statistics.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+
+#include "com/centreon/engine/checks/stats.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/logging/logger.hh"
+#include "com/centreon/engine/stats_segment.hh"
+#include "com/centreon/engine/status_stats.hh"
+#include "com/centreon/engine/version.hh"
+
 using namespace com::centreon::engine;
+using namespace com::centreon::engine::logging;
 
 /**
  *  The default constructor
  */
-statistics::statistics() {}
+statistics::statistics() : _segment{nullptr} {}
+
+/**
+ *  Destructor.
+ */
+statistics::~statistics() noexcept {
+  _close_segment();
+}
 
 /**
  * @brief Just an accessor to the statistics instance.
@@ -66,3 +86,189 @@ bool statistics::get_external_command_buffer_stats(buffer_stats& retval) const
   } else
     return false;
 }
+
+/**
+ * @brief Map the segment file, creating it if needed.
+ *
+ * @param path The segment file path.
+ *
+ * @return true on success.
+ */
+bool statistics::_open_segment(std::string const& path) {
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    char const* msg = strerror(errno);
+    logger(log_runtime_warning, basic)
+        << "Warning: Cannot open statistics segment '" << path << "': " << msg;
+    return false;
+  }
+  void* addr = MAP_FAILED;
+  if (ftruncate(fd, sizeof(stats_segment)) == 0)
+    addr = mmap(nullptr, sizeof(stats_segment), PROT_READ | PROT_WRITE,
+                MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    char const* msg = strerror(errno);
+    logger(log_runtime_warning, basic)
+        << "Warning: Cannot map statistics segment '" << path << "': " << msg;
+    close(fd);
+    return false;
+  }
+  close(fd);
+
+  _segment = static_cast<stats_segment*>(addr);
+  _segment->magic = stats_segment::magic_number;
+  _segment->version = stats_segment::current_version;
+  _segment_path = path;
+  return true;
+}
+
+/**
+ * @brief Unmap the segment if it is mapped.
+ */
+void statistics::_close_segment() noexcept {
+  if (_segment) {
+    munmap(_segment, sizeof(stats_segment));
+    _segment = nullptr;
+    _segment_path.clear();
+  }
+}
+
+/**
+ * @brief Copy the totals of the active or passive checks of the hosts or of
+ * the services into the segment.
+ *
+ * @param out The segment part.
+ * @param in The kept totals.
+ * @param latency The latency kind.
+ * @param execution_time The execution time kind, timing_max if there is no
+ *                       execution time (passive checks).
+ * @param now The current time.
+ */
+static void fill_type_stats(stats_segment::type_stats& out,
+                            status_stats::check_totals const& in,
+                            checks::stats::timing latency,
+                            checks::stats::timing execution_time,
+                            time_t now) {
+  static double const quantiles[3]{0.50, 0.95, 0.99};
+  checks::stats const& cs = checks::stats::instance();
+  int const minutes = checks::stats::percentiles_minutes;
+
+  out.min_latency = in.min_latency;
+  out.max_latency = in.max_latency;
+  out.average_latency = in.average_latency;
+  out.min_state_change = in.min_state_change;
+  out.max_state_change = in.max_state_change;
+  out.average_state_change = in.average_state_change;
+  for (int i = 0; i < 3; ++i)
+    out.latency_percentiles[i] =
+        cs.percentile(latency, quantiles[i], minutes, now);
+  if (execution_time != checks::stats::timing_max) {
+    out.min_execution_time = in.min_execution_time;
+    out.max_execution_time = in.max_execution_time;
+    out.average_execution_time = in.average_execution_time;
+    for (int i = 0; i < 3; ++i)
+      out.execution_time_percentiles[i] =
+          cs.percentile(execution_time, quantiles[i], minutes, now);
+  }
+  for (int i = 0; i < 4; ++i)
+    out.checks_last[i] = in.checks_last[i];
+}
+
+/**
+ * @brief Copy the totals of the hosts or of the services into the segment.
+ *
+ * @param out The segment part.
+ * @param in The kept totals.
+ */
+static void fill_objects_stats(stats_segment::objects_stats& out,
+                               status_stats::totals const& in) {
+  out.count = in.count;
+  out.checked = in.checked;
+  out.scheduled = in.scheduled;
+  out.actively_checked = in.active.count;
+  out.passively_checked = in.passive.count;
+  out.min_state_change = in.min_state_change;
+  out.max_state_change = in.max_state_change;
+  out.average_state_change = in.average_state_change;
+  for (int i = 0; i < 4; ++i)
+    out.states[i] = in.states[i];
+  out.flapping = in.flapping;
+  out.downtime = in.downtime;
+}
+
+/**
+ * @brief Write the current statistics in the segment read by centenginestats.
+ * The segment lives next to the status file and is only written when a status
+ * file is configured. The hosts and services statistics are kept up to date
+ * by their status updates, they are only copied here. This method must be
+ * called from the main loop.
+ */
+void statistics::publish_segment() {
+  if (config->status_file().empty()) {
+    remove_segment();
+    return;
+  }
+
+  std::string path(stats_segment::path(config->status_file()));
+  if (path != _segment_path) {
+    remove_segment();
+    if (!_open_segment(path))
+      return;
+  }
+
+  time_t now = time(nullptr);
+
+  stats_segment::payload p;
+  memset(&p, 0, sizeof(p));
+  strncpy(p.version, CENTREON_ENGINE_VERSION_STRING, sizeof(p.version) - 1);
+  p.updated = now;
+  p.program_start = program_start;
+  p.pid = get_pid();
+
+  buffer_stats buffer;
+  if (get_external_command_buffer_stats(buffer)) {
+    p.total_external_command_buffer_slots = buffer.total;
+    p.used_external_command_buffer_slots = buffer.used;
+    p.high_external_command_buffer_slots = buffer.high;
+  }
+
+  checks::stats const& cs = checks::stats::instance();
+  for (int type = 0; type < MAX_CHECK_STATS_TYPES; ++type) {
+    p.check_stats[type][0] = cs.checks_count(type, 1, now);
+    p.check_stats[type][1] = cs.checks_count(type, 5, now);
+    p.check_stats[type][2] = cs.checks_count(type, 15, now);
+  }
+
+  status_stats::totals totals;
+  status_stats::services().get(now, totals);
+  fill_objects_stats(p.services, totals);
+  fill_type_stats(p.services.active, totals.active,
+                  checks::stats::active_service_latency,
+                  checks::stats::active_service_execution_time, now);
+  fill_type_stats(p.services.passive, totals.passive,
+                  checks::stats::passive_service_latency,
+                  checks::stats::timing_max, now);
+
+  status_stats::hosts().get(now, totals);
+  fill_objects_stats(p.hosts, totals);
+  fill_type_stats(p.hosts.active, totals.active,
+                  checks::stats::active_host_latency,
+                  checks::stats::active_host_execution_time, now);
+  fill_type_stats(p.hosts.passive, totals.passive,
+                  checks::stats::passive_host_latency,
+                  checks::stats::timing_max, now);
+
+  _segment->write(p);
+}
+
+/**
+ * @brief Unmap and remove the segment file, so centenginestats falls back to
+ * the status file.
+ */
+void statistics::remove_segment() noexcept {
+  if (_segment) {
+    std::string path(_segment_path);
+    _close_segment();
+    unlink(path.c_str());
+  }
+}
@@ -0,0 +1,386 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/status_stats.hh"
+
+#include <algorithm>
+
+#include "com/centreon/engine/checkable.hh"
+#include "com/centreon/engine/state_table.hh"
+#include "com/centreon/engine/time_base.hh"
+
+using namespace com::centreon::engine;
+
+namespace {
+/* One slot per second of the last hour, the current one included. */
+uint32_t const seconds_kept = 3601;
+
+/**
+ *  Count a check in the second it was done, if it is in the last hour.
+ *
+ *  @param[in,out] seconds  The checks by second.
+ *  @param[in]     t        The check time, in the engine time base.
+ */
+template <typename S>
+void add_check(std::vector<S>& seconds, std::time_t t) {
+  if (t <= 0)
+    return;
+  S& s(seconds[t % seconds_kept]);
+  if (s.time != t) {
+    /* The slot already counts a more recent second. */
+    if (s.time > t)
+      return;
+    s.time = t;
+    s.checks = 0;
+  }
+  ++s.checks;
+}
+
+/**
+ *  Forget a check counted by add_check().
+ *
+ *  @param[in,out] seconds  The checks by second.
+ *  @param[in]     t        The check time, in the engine time base.
+ */
+template <typename S>
+void remove_check(std::vector<S>& seconds, std::time_t t) noexcept {
+  if (t <= 0)
+    return;
+  S& s(seconds[t % seconds_kept]);
+  if (s.time == t && s.checks)
+    --s.checks;
+}
+
+/**
+ *  Tell if a value removed from a range was one of its bounds.
+ *
+ *  @param[in] range  The range.
+ *  @param[in] value  The value.
+ *
+ *  @return True if the range must be computed again.
+ */
+template <typename R>
+bool on_bound(R const& range, double value) noexcept {
+  return value <= range.min || value >= range.max;
+}
+
+/**
+ *  Extend a range with a value.
+ *
+ *  @param[in,out] range  The range.
+ *  @param[in]     value  The value.
+ *  @param[in]     first  True if this is the only value of the range.
+ */
+template <typename R>
+void extend(R& range, double value, bool first) noexcept {
+  if (first || value < range.min)
+    range.min = value;
+  if (first || value > range.max)
+    range.max = value;
+}
+}  // namespace
+
+/**
+ *  Constructor. The totals are built on their first use.
+ *
+ *  @param[in] states  The state table of the objects.
+ */
+status_stats::status_stats(state_table const& states)
+    : _states(states),
+      _valid{false},
+      _count{0},
+      _checked{0},
+      _scheduled{0},
+      _by_state{0, 0, 0, 0},
+      _downtime{0},
+      _flapping{0},
+      _active{},
+      _passive{} {}
+
+/**
+ *  Get the totals.
+ *
+ *  @param[in]  now     The current time.
+ *  @param[out] retval  The totals.
+ */
+void status_stats::get(std::time_t now, totals& retval) {
+  if (!_valid)
+    _build();
+
+  retval.count = _count;
+  retval.checked = _checked;
+  retval.scheduled = _scheduled;
+  std::copy(_by_state, _by_state + 4, retval.states);
+  retval.downtime = _downtime;
+  retval.flapping = _flapping;
+
+  std::time_t internal(time_base::instance().to_internal(now));
+  _fill(_active, internal, retval.active);
+  _fill(_passive, internal, retval.passive);
+
+  if (_count) {
+    retval.average_state_change =
+        (_active.state_change + _passive.state_change) / _count;
+    if (!_passive.count) {
+      retval.min_state_change = retval.active.min_state_change;
+      retval.max_state_change = retval.active.max_state_change;
+    } else if (!_active.count) {
+      retval.min_state_change = retval.passive.min_state_change;
+      retval.max_state_change = retval.passive.max_state_change;
+    } else {
+      retval.min_state_change = std::min(retval.active.min_state_change,
+                                         retval.passive.min_state_change);
+      retval.max_state_change = std::max(retval.active.max_state_change,
+                                         retval.passive.max_state_change);
+    }
+  } else {
+    retval.average_state_change = 0;
+    retval.min_state_change = 0;
+    retval.max_state_change = 0;
+  }
+}
+
+/**
+ *  Get the totals of the hosts.
+ *
+ *  @return The totals.
+ */
+status_stats& status_stats::hosts() {
+  static status_stats* instance(new status_stats(state_table::hosts()));
+  return *instance;
+}
+
+/**
+ *  Build the totals again from the objects on their next use.
+ */
+void status_stats::invalidate() noexcept {
+  _valid = false;
+}
+
+/**
+ *  Get the totals of the objects of a state table.
+ *
+ *  @param[in] states  state_table::hosts() or state_table::services().
+ *
+ *  @return The totals.
+ */
+status_stats& status_stats::of(state_table const& states) {
+  return &states == &state_table::hosts() ? hosts() : services();
+}
+
+/**
+ *  Get the totals of the services, anomaly detections included.
+ *
+ *  @return The totals.
+ */
+status_stats& status_stats::services() {
+  static status_stats* instance(new status_stats(state_table::services()));
+  return *instance;
+}
+
+/**
+ *  Replace the contribution of an object by its current status.
+ *
+ *  @param[in] obj  The object.
+ */
+void status_stats::update(checkable const& obj) {
+  if (!_valid)
+    return;
+  uint32_t id(obj.get_state_id());
+  if (id >= _entries.size()) {
+    _valid = false;
+    return;
+  }
+  _remove(id);
+  _add(id, obj);
+}
+
+/**
+ *  Add the contribution of an object.
+ *
+ *  @param[in] id   The state table id of the object.
+ *  @param[in] obj  The object.
+ */
+void status_stats::_add(uint32_t id, checkable const& obj) {
+  entry& e(_entries[id]);
+  e.latency = _states.latency[id];
+  e.execution_time = obj.get_execution_time();
+  e.state_change = obj.get_percent_state_change();
+  e.last_check = _states.last_check[id];
+  e.state = _states.current_state[id];
+  e.flags = counted;
+  if (_states.flags[id] & state_table::has_been_checked)
+    e.flags |= checked;
+  if (_states.flags[id] & state_table::should_be_scheduled)
+    e.flags |= scheduled;
+  if (obj.get_check_type() == checkable::check_active)
+    e.flags |= active;
+  if (obj.is_in_downtime())
+    e.flags |= downtime;
+  if (obj.get_is_flapping())
+    e.flags |= flapping;
+
+  ++_count;
+  if (e.flags & checked)
+    ++_checked;
+  if (e.flags & scheduled)
+    ++_scheduled;
+  if (e.state < 4)
+    ++_by_state[e.state];
+  if (e.flags & downtime)
+    ++_downtime;
+  if (e.flags & flapping)
+    ++_flapping;
+
+  check_sums& sums(e.flags & active ? _active : _passive);
+  ++sums.count;
+  sums.latency += e.latency;
+  sums.execution_time += e.execution_time;
+  sums.state_change += e.state_change;
+  if (sums.ranges_valid) {
+    bool first(sums.count == 1);
+    extend(sums.latency_range, e.latency, first);
+    extend(sums.execution_time_range, e.execution_time, first);
+    extend(sums.state_change_range, e.state_change, first);
+  }
+  add_check(sums.seconds, e.last_check);
+}
+
+/**
+ *  Build the totals from the objects.
+ */
+void status_stats::_build() {
+  _entries.assign(_states.size(), entry());
+  _count = 0;
+  _checked = 0;
+  _scheduled = 0;
+  std::fill(_by_state, _by_state + 4, 0);
+  _downtime = 0;
+  _flapping = 0;
+  for (check_sums* sums : {&_active, &_passive}) {
+    sums->count = 0;
+    sums->latency = 0;
+    sums->execution_time = 0;
+    sums->state_change = 0;
+    sums->ranges_valid = true;
+    sums->seconds.assign(seconds_kept, second{0, 0});
+  }
+  for (uint32_t id = 0; id < _states.size(); ++id)
+    if (_states.object[id])
+      _add(id, *_states.object[id]);
+  _valid = true;
+}
+
+/**
+ *  Compute the ranges of the active or of the passive checks again, from
+ *  the kept contributions.
+ *
+ *  @param[in] is_active  True for the active checks.
+ */
+void status_stats::_compute_ranges(bool is_active) {
+  check_sums& sums(is_active ? _active : _passive);
+  bool first(true);
+  for (entry const& e : _entries)
+    if ((e.flags & counted) &&
+        static_cast<bool>(e.flags & active) == is_active) {
+      extend(sums.latency_range, e.latency, first);
+      extend(sums.execution_time_range, e.execution_time, first);
+      extend(sums.state_change_range, e.state_change, first);
+      first = false;
+    }
+  sums.ranges_valid = true;
+}
+
+/**
+ *  Fill the totals of the active or of the passive checks.
+ *
+ *  @param[in,out] sums    The sums.
+ *  @param[in]     now     The current time, in the engine time base.
+ *  @param[out]    retval  The totals.
+ */
+void status_stats::_fill(check_sums& sums,
+                         std::time_t now,
+                         check_totals& retval) {
+  static uint32_t const minutes[4]{1, 5, 15, 60};
+
+  if (!sums.ranges_valid)
+    _compute_ranges(&sums == &_active);
+
+  retval.count = sums.count;
+  if (sums.count) {
+    retval.min_latency = sums.latency_range.min;
+    retval.max_latency = sums.latency_range.max;
+    retval.average_latency = sums.latency / sums.count;
+    retval.min_execution_time = sums.execution_time_range.min;
+    retval.max_execution_time = sums.execution_time_range.max;
+    retval.average_execution_time = sums.execution_time / sums.count;
+    retval.min_state_change = sums.state_change_range.min;
+    retval.max_state_change = sums.state_change_range.max;
+    retval.average_state_change = sums.state_change / sums.count;
+  } else {
+    retval.min_latency = retval.max_latency = retval.average_latency = 0;
+    retval.min_execution_time = retval.max_execution_time =
+        retval.average_execution_time = 0;
+    retval.min_state_change = retval.max_state_change =
+        retval.average_state_change = 0;
+  }
+
+  std::fill(retval.checks_last, retval.checks_last + 4, 0);
+  for (second const& s : sums.seconds)
+    if (s.checks && s.time <= now)
+      for (int i = 0; i < 4; ++i)
+        if (now - s.time <= minutes[i] * 60)
+          retval.checks_last[i] += s.checks;
+}
+
+/**
+ *  Remove the contribution of an object, if it is counted.
+ *
+ *  @param[in] id  The state table id of the object.
+ */
+void status_stats::_remove(uint32_t id) noexcept {
+  entry& e(_entries[id]);
+  if (!(e.flags & counted))
+    return;
+
+  --_count;
+  if (e.flags & checked)
+    --_checked;
+  if (e.flags & scheduled)
+    --_scheduled;
+  if (e.state < 4)
+    --_by_state[e.state];
+  if (e.flags & downtime)
+    --_downtime;
+  if (e.flags & flapping)
+    --_flapping;
+
+  check_sums& sums(e.flags & active ? _active : _passive);
+  --sums.count;
+  sums.latency -= e.latency;
+  sums.execution_time -= e.execution_time;
+  sums.state_change -= e.state_change;
+  if (sums.ranges_valid &&
+      (on_bound(sums.latency_range, e.latency) ||
+       on_bound(sums.execution_time_range, e.execution_time) ||
+       on_bound(sums.state_change_range, e.state_change)))
+    sums.ranges_valid = false;
+  remove_check(sums.seconds, e.last_check);
+  e.flags = 0;
+}
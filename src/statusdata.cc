@@ -22,8 +22,11 @@
 
 #include "com/centreon/engine/broker.hh"
 #include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/statistics.hh"
 #include "com/centreon/engine/xsddefault.hh"
 
+using namespace com::centreon::engine;
+
 /******************************************************************/
 /****************** TOP-LEVEL OUTPUT FUNCTIONS ********************/
 /******************************************************************/
@@ -43,6 +46,9 @@ int update_all_status_data() {
 
   result = xsddefault_save_status_data();
 
+  /* centenginestats reads this segment instead of parsing the status file */
+  statistics::instance().publish_segment();
+
   /* send data to event broker */
   broker_aggregated_status_data(NEBTYPE_AGGREGATEDSTATUS_ENDDUMP, NEBFLAG_NONE,
                                 NEBATTR_NONE, NULL);
@@ -54,6 +60,8 @@ int update_all_status_data() {
 
 /* cleans up status data before program termination */
 int cleanup_status_data(int delete_status_data) {
+  if (delete_status_data)
+    statistics::instance().remove_segment();
   return xsddefault_cleanup_status_data(delete_status_data);
 }
 
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/time_base.hh"
+
+#include <cmath>
+
+using namespace com::centreon::engine;
+
+/**
+ *  Constructor. The engine time base starts equal to the wall clock.
+ */
+time_base::time_base()
+    : _offset{0},
+      _last_wall{0},
+      _last_monotonic{std::chrono::steady_clock::now()} {}
+
+/**
+ *  Compare the progress of the wall clock to the one of the monotonic clock
+ *  since the last call. Called by the main loop on each iteration.
+ *
+ *  Unlike a comparison of two wall-clock times, a loop blocked for a long
+ *  time is not taken for a time change.
+ *
+ *  @param[in] wall       The current wall-clock time.
+ *  @param[in] threshold  Minimum forward step, in seconds. Backward steps
+ *                        are always reported.
+ *
+ *  @return The step of the wall clock in seconds, 0 if there is none.
+ */
+int64_t time_base::detect_step(std::time_t wall, uint32_t threshold) {
+  std::chrono::steady_clock::time_point monotonic(
+      std::chrono::steady_clock::now());
+  if (!_last_wall) {
+    start(wall);
+    return 0;
+  }
+
+  double elapsed =
+      std::chrono::duration<double>(monotonic - _last_monotonic).count();
+  int64_t step = std::llround(wall - _last_wall - elapsed);
+  bool backwards = wall < _last_wall && step < 0;
+  bool forwards = step > 0 && step >= static_cast<int64_t>(threshold);
+  if (!backwards && !forwards)
+    step = 0;
+
+  /* The wall clock has a one second resolution, so the reference only moves
+   * with it to not accumulate rounding errors. */
+  if (step || wall != _last_wall) {
+    _last_wall = wall;
+    _last_monotonic = monotonic;
+  }
+  return step;
+}
+
+/**
+ *  Get the time base of the engine, shared by hosts, services and the
+ *  freshness deadlines.
+ *
+ *  @return The time base.
+ */
+time_base& time_base::instance() {
+  static time_base instance;
+  return instance;
+}
+
+/**
+ *  Get the current time in the engine time base.
+ *
+ *  @return A time.
+ */
+std::time_t time_base::now() const {
+  return to_internal(std::time(nullptr));
+}
+
+/**
+ *  Get the difference between the wall clock and the engine time base.
+ *
+ *  @return A number of seconds.
+ */
+int64_t time_base::offset() const noexcept {
+  return _offset;
+}
+
+/**
+ *  Take a wall-clock step into account: the stored timestamps move with it
+ *  as if they were all adjusted.
+ *
+ *  @param[in] time_difference  The step, in seconds.
+ */
+void time_base::shift(int64_t time_difference) noexcept {
+  _offset += time_difference;
+}
+
+/**
+ *  Set the reference of detect_step(), when the main loop starts.
+ *
+ *  @param[in] wall  The current wall-clock time.
+ */
+void time_base::start(std::time_t wall) {
+  _last_wall = wall;
+  _last_monotonic = std::chrono::steady_clock::now();
+}
+
+/**
+ *  Convert a wall-clock time to the engine time base.
+ *
+ *  @param[in] wall  The time.
+ *
+ *  @return The converted time.
+ */
+std::time_t time_base::to_internal(std::time_t wall) const noexcept {
+  if (wall == 0 || wall == -1)
+    return wall;
+  return wall - _offset;
+}
+
+/**
+ *  Convert a time of the engine time base to the wall clock. As
+ *  adjust_timestamp_for_time_change(), times moved before the epoch become
+ *  0.
+ *
+ *  @param[in] internal  The time.
+ *
+ *  @return The converted time.
+ */
+std::time_t time_base::to_wall(std::time_t internal) const noexcept {
+  if (internal == 0 || internal == -1)
+    return internal;
+  std::time_t retval = internal + _offset;
+  return retval < 0 ? 0 : retval;
+}
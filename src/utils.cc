@@ -27,6 +27,9 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include <algorithm>
 #include <cerrno>
@@ -42,11 +45,13 @@
 #include "com/centreon/engine/broker/loader.hh"
 #include "com/centreon/engine/checks/checker.hh"
 #include "com/centreon/engine/commands/raw.hh"
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/comment.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
 #include "com/centreon/engine/events/loop.hh"
 #include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/logging/broker.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/macros.hh"
 #include "com/centreon/engine/nebmods.hh"
@@ -248,12 +253,63 @@ void sighandler(int sig) {
 /************************* IPC FUNCTIONS **************************/
 /******************************************************************/
 
+/**
+ *  Tell if a character is a white space, as std::isspace() does in the C
+ *  locale.
+ *
+ *  @param[in] c  The character.
+ *
+ *  @return True if c is a white space.
+ */
+static inline bool is_space(char c) noexcept {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ *  Find the first occurrence of one of two characters. Sixteen characters are
+ *  compared at once when SSE2 is available.
+ *
+ *  @param[in] p    Beginning of the range.
+ *  @param[in] end  End of the range.
+ *  @param[in] a    First character.
+ *  @param[in] b    Second character.
+ *
+ *  @return A pointer to the character found or end.
+ */
+static char const* find_either(char const* p,
+                               char const* end,
+                               char a,
+                               char b) noexcept {
+#ifdef __SSE2__
+  __m128i const va = _mm_set1_epi8(a);
+  __m128i const vb = _mm_set1_epi8(b);
+  for (; end - p >= 16; p += 16) {
+    __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    int const mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)));
+    if (mask)
+      return p + __builtin_ctz(mask);
+  }
+#endif
+  for (; p < end; ++p)
+    if (*p == a || *p == b)
+      return p;
+  return end;
+}
+
 /**
  * @brief Parse buffer and fill the three strings given as references:
  *    * short_output
  *    * long_output
  *    * perf_data
  *
+ * The buffer is read once: each line is delimited by looking for its end and
+ * its pipes at the same time, and its parts are appended to the output
+ * strings directly from the buffer.
+ *
+ * When newlines are escaped, lines end with the escaped newlines ("\\n") up
+ * to the last one, and then with the real newlines.
+ *
  * @param[in] buffer
  * @param[out] short_output
  * @param[out] long_output
@@ -271,79 +327,83 @@ void parse_check_output(std::string const& buffer,
   bool long_pipe{false};
   bool perfdata_already_filled{false};
 
-  bool eof{false};
-  std::string line;
-  /* pos_line is used to cut a line
-   * start_line is the position of the line begin
-   * end_line is the position of the line end. */
-  size_t start_line{0}, end_line, pos_line;
+  char const* const end = buffer.data() + buffer.size();
+  /* Lines starting before or at this position end with an escaped newline. */
+  char const* last_escaped{nullptr};
+  if (newlines_are_escaped) {
+    size_t pos = buffer.rfind("\\n");
+    if (pos != std::string::npos)
+      last_escaped = buffer.data() + pos;
+  }
+
+  char const* start_line = buffer.data();
   int line_number{1};
-  while (!eof) {
-    if (newlines_are_escaped &&
-        (pos_line = buffer.find("\\n", start_line)) != std::string::npos) {
-      end_line = pos_line;
-      pos_line += 2;
-    } else if ((pos_line = buffer.find("\n", start_line)) !=
-               std::string::npos) {
-      end_line = pos_line;
-      pos_line++;
-    } else {
-      end_line = buffer.size();
-      eof = true;
+  for (;;) {
+    bool const escaped = last_escaped && start_line <= last_escaped;
+    char const sep = escaped ? '\\' : '\n';
+
+    /* Look for the end of the line and for its last pipe. Once the perfdata
+     * are on their own lines, pipes are not special anymore. */
+    char const* end_line = start_line;
+    char const* pipe{nullptr};
+    for (;;) {
+      end_line = find_either(end_line, end, sep, long_pipe ? sep : '|');
+      if (end_line == end)
+        break;
+      if (*end_line == '|')
+        pipe = end_line++;
+      else if (!escaped || (end_line + 1 < end && end_line[1] == 'n'))
+        break;
+      else
+        ++end_line;
     }
-    line = buffer.substr(start_line, end_line - start_line);
-    size_t pipe;
-    if (!long_pipe)
-      pipe = line.find_last_of('|');
-    else
-      pipe = std::string::npos;
-
-    if (pipe != std::string::npos) {
-      end_line = pipe;
-      /* Let's trim the output */
-      while (end_line > 1 && std::isspace(line[end_line - 1]))
-        end_line--;
 
+    if (pipe) {
       /* Let's trim the output */
-      pipe++;
-      while (pipe < line.size() - 1 && std::isspace(line[pipe]))
-        pipe++;
+      char const* end_text = pipe;
+      while (end_text - start_line > 1 && is_space(end_text[-1]))
+        --end_text;
+
+      /* Let's trim the perfdata */
+      char const* pd = pipe + 1;
+      while (pd < end_line - 1 && is_space(*pd))
+        ++pd;
 
       if (line_number == 1) {
-        short_buffer.append(line.substr(0, end_line));
-        pd_buffer.append(line.substr(pipe));
+        short_buffer.append(start_line, end_text);
+        pd_buffer.append(pd, end_line);
         perfdata_already_filled = true;
       } else {
         if (line_number > 2)
           long_buffer.append(escape_newlines_please ? "\\n" : "\n");
-        long_buffer.append(line.substr(0, end_line));
+        long_buffer.append(start_line, end_text);
         if (perfdata_already_filled)
-          pd_buffer.append(" ");
-        pd_buffer.append(line.substr(pipe));
+          pd_buffer.push_back(' ');
+        pd_buffer.append(pd, end_line);
         // Now, all new lines contain perfdata.
         long_pipe = true;
       }
     } else {
       /* Let's trim the output */
-      end_line = line.size();
-      while (end_line > 1 && std::isspace(line[end_line - 1]))
-        end_line--;
-      line.erase(end_line);
+      char const* end_text = end_line;
+      while (end_text - start_line > 1 && is_space(end_text[-1]))
+        --end_text;
       if (line_number == 1)
-        short_buffer.append(line);
-      else {
-        if (!long_pipe) {
-          if (line_number > 2)
-            long_buffer.append(escape_newlines_please ? "\\n" : "\n");
-          long_buffer.append(line);
-        } else {
-          if (perfdata_already_filled)
-            pd_buffer.append(" ");
-          pd_buffer.append(line);
-        }
+        short_buffer.append(start_line, end_text);
+      else if (!long_pipe) {
+        if (line_number > 2)
+          long_buffer.append(escape_newlines_please ? "\\n" : "\n");
+        long_buffer.append(start_line, end_text);
+      } else {
+        if (perfdata_already_filled)
+          pd_buffer.push_back(' ');
+        pd_buffer.append(start_line, end_text);
       }
     }
-    start_line = pos_line;
+
+    if (end_line == end)
+      break;
+    start_line = end_line + (escaped ? 2 : 1);
     line_number++;
   }
 }
@@ -415,7 +475,10 @@ bool set_cloexec(int fd) {
 void cleanup() {
   // Unload modules.
   if (!test_scheduling && !verify_config) {
+    commands::system_runner::deinit();
     checks::checker::deinit();
+    engine::logging::broker::flush();
+    neb_flush_batches(0);
     neb_free_callback_list();
     neb_unload_all_modules(NEBMODULE_FORCE_UNLOAD, sigshutdown
                                                        ? NEBMODULE_NEB_SHUTDOWN
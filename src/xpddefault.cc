@@ -25,6 +25,7 @@
 #include <unistd.h>
 #include <cstdio>
 #include <cstdlib>
+#include "com/centreon/engine/commands/system_runner.hh"
 #include "com/centreon/engine/common.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/globals.hh"
@@ -274,8 +275,6 @@ int xpddefault_run_service_performance_data_command(
     com::centreon::engine::service* svc) {
   std::string raw_command_line;
   std::string processed_command_line;
-  int early_timeout(false);
-  double exectime;
   int result(OK);
   int macro_options(STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
 
@@ -310,23 +309,26 @@ int xpddefault_run_service_performance_data_command(
 
   // run the command.
   try {
-    std::string tmp;
-    my_system_r(mac, processed_command_line, config->perfdata_timeout(),
-                &early_timeout, &exectime, tmp, 0);
+    std::string description(svc->get_description());
+    std::string host_name(svc->get_hostname());
+    commands::system_runner::instance().run(
+        mac, processed_command_line, config->perfdata_timeout(), 0,
+        [processed_command_line, description, host_name](
+            int, bool early_timeout, double, std::string const&) {
+          // check to see if the command timed out.
+          if (early_timeout)
+            logger(log_runtime_warning, basic)
+                << "Warning: Service performance data command '"
+                << processed_command_line << "' for service '" << description
+                << "' on host '" << host_name << "' timed out after "
+                << config->perfdata_timeout() << " seconds";
+        });
   } catch (std::exception const& e) {
     logger(log_runtime_error, basic)
         << "Error: can't execute service performance data command line '"
         << processed_command_line << "' : " << e.what();
   }
 
-  // check to see if the command timed out.
-  if (early_timeout == true)
-    logger(log_runtime_warning, basic)
-        << "Warning: Service performance data command '"
-        << processed_command_line << "' for service '" << svc->get_description()
-        << "' on host '" << svc->get_hostname() << "' timed out after "
-        << config->perfdata_timeout() << " seconds";
-
   return result;
 }
 
@@ -335,8 +337,6 @@ int xpddefault_run_host_performance_data_command(nagios_macros* mac,
                                                  host* hst) {
   std::string raw_command_line;
   std::string processed_command_line;
-  int early_timeout(false);
-  double exectime;
   int result(OK);
   int macro_options(STRIP_ILLEGAL_MACRO_CHARS | ESCAPE_MACRO_CHARS);
 
@@ -368,9 +368,19 @@ int xpddefault_run_host_performance_data_command(nagios_macros* mac,
 
   // run the command.
   try {
-    std::string tmp;
-    my_system_r(mac, processed_command_line, config->perfdata_timeout(),
-                &early_timeout, &exectime, tmp, 0);
+    std::string host_name(hst->get_name());
+    commands::system_runner::instance().run(
+        mac, processed_command_line, config->perfdata_timeout(), 0,
+        [processed_command_line, host_name](int, bool early_timeout, double,
+                                            std::string const&) {
+          // check to see if the command timed out.
+          if (early_timeout)
+            logger(log_runtime_warning, basic)
+                << "Warning: Host performance data command '"
+                << processed_command_line << "' for host '" << host_name
+                << "' timed out after " << config->perfdata_timeout()
+                << " seconds";
+        });
   } catch (std::exception const& e) {
     logger(log_runtime_error, basic)
         << "Error: can't execute host performance data command line '"
@@ -380,13 +390,6 @@ int xpddefault_run_host_performance_data_command(nagios_macros* mac,
   if (processed_command_line.empty())
     return ERROR;
 
-  // check to see if the command timed out.
-  if (early_timeout == true)
-    logger(log_runtime_warning, basic)
-        << "Warning: Host performance data command '" << processed_command_line
-        << "' for host '" << hst->get_name() << "' timed out after "
-        << config->perfdata_timeout() << " seconds";
-
   return result;
 }
 
@@ -30,12 +30,15 @@
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include "com/centreon/engine/checks/stats.hh"
 #include "com/centreon/engine/comment.hh"
 #include "com/centreon/engine/common.hh"
 #include "com/centreon/engine/configuration/applier/state.hh"
 #include "com/centreon/engine/contact.hh"
 #include "com/centreon/engine/downtimes/downtime.hh"
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
+#include "com/centreon/engine/events/check_scheduler.hh"
+#include "com/centreon/engine/events/loop.hh"
 #include "com/centreon/engine/globals.hh"
 #include "com/centreon/engine/logging/logger.hh"
 #include "com/centreon/engine/macros.hh"
@@ -48,6 +51,25 @@ using namespace com::centreon::engine::configuration::applier;
 
 static int xsddefault_status_log_fd(-1);
 
+/**
+ *  Write the 50th, 95th and 99th percentiles of a kind of duration.
+ *
+ *  @param[out] os   The status stream.
+ *  @param[in]  key  The status variable name.
+ *  @param[in]  type The kind of duration.
+ *  @param[in]  now  The current time.
+ */
+static void write_percentiles(std::ostream& os,
+                              char const* key,
+                              checks::stats::timing type,
+                              time_t now) {
+  checks::stats const& s(checks::stats::instance());
+  int const minutes(checks::stats::percentiles_minutes);
+  os << "\t" << key << "=" << s.percentile(type, 0.50, minutes, now) << ","
+     << s.percentile(type, 0.95, minutes, now) << ","
+     << s.percentile(type, 0.99, minutes, now) << "\n";
+}
+
 /******************************************************************/
 /********************* INIT/CLEANUP FUNCTIONS *********************/
 /******************************************************************/
@@ -285,9 +307,29 @@ int xsddefault_save_status_data() {
          "\tserial_host_check_stats="
       << check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[0] << ","
       << check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[1] << ","
-      << check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[2]
-      << "\n"
-         "\t}\n\n";
+      << check_statistics[SERIAL_HOST_CHECK_STATS].minute_stats[2] << "\n";
+  write_percentiles(stream, "active_host_latency_percentiles",
+                    checks::stats::active_host_latency, current_time);
+  write_percentiles(stream, "active_host_execution_time_percentiles",
+                    checks::stats::active_host_execution_time, current_time);
+  write_percentiles(stream, "passive_host_latency_percentiles",
+                    checks::stats::passive_host_latency, current_time);
+  write_percentiles(stream, "active_service_latency_percentiles",
+                    checks::stats::active_service_latency, current_time);
+  write_percentiles(stream, "active_service_execution_time_percentiles",
+                    checks::stats::active_service_execution_time,
+                    current_time);
+  write_percentiles(stream, "passive_service_latency_percentiles",
+                    checks::stats::passive_service_latency, current_time);
+  events::check_scheduler& scheduler(events::check_scheduler::instance());
+  stream << "\tservice_check_rates=" << scheduler.achieved_rate(current_time)
+         << "," << scheduler.configured_rate() << ","
+         << scheduler.admission_rate()
+         << "\n"
+            "\tready_service_checks="
+         << events::loop::instance().ready_checks()
+         << "\n"
+            "\t}\n\n";
 
   /* save host status data */
   for (host_map::iterator it(com::centreon::engine::host::hosts.begin()),
@@ -500,3 +500,71 @@ TEST_F(AnomalydetectionCheck, MetricWithQuotes) {
             "'metric'=90MT;;;0;100 metric_lower_thresholds=73.31MT;;;0;100 "
             "metric_upper_thresholds=83.26MT;;;0;100");
 }
+
+// Given a metric with ranges as thresholds, a min and a max
+// When the anomaly detection is checked
+// Then its perfdata keeps the min and the max of the metric but not its
+// thresholds, they are replaced by the forecasting range.
+TEST_F(AnomalydetectionCheck, MetricWithRanges) {
+  CreateFile(
+      "/tmp/thresholds_status_change.json",
+      "[{\n \"host_id\": \"12\",\n \"service_id\": \"9\",\n \"metric_name\": "
+      "\"metric\",\n \"predict\": [{\n \"timestamp\": 50000,\n \"upper\": "
+      "84,\n \"lower\": 74,\n \"fit\": 79\n }, {\n \"timestamp\": 100000,\n "
+      "\"upper\": 10,\n \"lower\": 5,\n \"fit\": 51.5\n }, {\n \"timestamp\": "
+      "150000,\n \"upper\": 100,\n \"lower\": 93,\n \"fit\": 96.5\n }, {\n "
+      "\"timestamp\": 200000,\n \"upper\": 100,\n \"lower\": 97,\n \"fit\": "
+      "98.5\n }, {\n \"timestamp\": 250000,\n \"upper\": 100,\n \"lower\": "
+      "21,\n \"fit\": 60.5\n }\n]}]");
+  _ad->init_thresholds();
+  _ad->set_status_change(true);
+
+  set_time(50000);
+  _svc->set_current_state(engine::service::state_ok);
+  _svc->set_last_hard_state(engine::service::state_ok);
+  _svc->set_last_hard_state_change(50000);
+  _svc->set_state_type(checkable::hard);
+  _svc->set_accept_passive_checks(true);
+  _svc->set_current_attempt(1);
+  _svc->set_last_check(50000);
+
+  _ad->set_current_state(engine::service::state_ok);
+  _ad->set_last_hard_state(engine::service::state_ok);
+  _ad->set_last_hard_state_change(50000);
+  _ad->set_state_type(checkable::hard);
+  _ad->set_current_attempt(1);
+  _ad->set_last_check(50000);
+
+  set_time(50500);
+  std::ostringstream oss;
+  std::time_t now{std::time(nullptr)};
+  oss << '[' << now << ']'
+      << " PROCESS_SERVICE_CHECK_RESULT;test_host;test_svc;2;service critical| "
+         "metric=90MT;@10:20;~:60;0;100";
+  std::string cmd{oss.str()};
+  process_external_command(cmd.c_str());
+  checks::checker::instance().reap();
+  ASSERT_EQ(_svc->get_state_type(), checkable::soft);
+  ASSERT_EQ(_svc->get_current_state(), engine::service::state_critical);
+  ASSERT_EQ(_svc->get_last_state_change(), now);
+  ASSERT_EQ(_svc->get_current_attempt(), 1);
+  ASSERT_EQ(_svc->get_plugin_output(), "service critical");
+  ASSERT_EQ(_svc->get_perf_data(), "metric=90MT;@10:20;~:60;0;100");
+  int check_options = 0;
+  int latency = 0;
+  bool time_is_valid;
+  time_t preferred_time;
+  _ad->run_async_check(check_options, latency, true, true, &time_is_valid,
+                       &preferred_time);
+  checks::checker::instance().reap();
+  ASSERT_EQ(_ad->get_state_type(), checkable::soft);
+  ASSERT_EQ(_ad->get_current_state(), engine::service::state_critical);
+  ASSERT_EQ(_ad->get_last_state_change(), now);
+  ASSERT_EQ(_ad->get_current_attempt(), 1);
+  ASSERT_EQ(_ad->get_plugin_output(),
+            "NON-OK: Unusual activity, the actual value of metric is 90.00MT "
+            "which is outside the forecasting range [73.31MT : 83.26MT]");
+  ASSERT_EQ(_ad->get_perf_data(),
+            "metric=90MT;;;0;100 metric_lower_thresholds=73.31MT;;;0;100 "
+            "metric_upper_thresholds=83.26MT;;;0;100");
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../test_engine.hh"
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/hostdependency.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/dependency_index.hh"
+#include "helper.hh"
+
+using namespace com::centreon::engine;
+
+class DependencyIndex : public TestEngine {
+ public:
+  void SetUp() override {
+    init_config_state();
+    configuration::applier::contact ct_aply;
+    configuration::contact ctct{new_configuration_contact("admin", true)};
+    ct_aply.add_object(ctct);
+    ct_aply.expand_objects(*config);
+    ct_aply.resolve_object(ctct);
+  }
+
+  void TearDown() override { deinit_config_state(); }
+
+  host* add_host(std::string const& name, uint64_t id) {
+    configuration::applier::host hst_aply;
+    configuration::host hst{new_configuration_host(name, "admin", id)};
+    hst_aply.add_object(hst);
+    hst_aply.resolve_object(hst);
+    host* retval(host::hosts.find(name)->second.get());
+    retval->set_has_been_checked(true);
+    return retval;
+  }
+
+  void add_dependency(std::string const& master, std::string const& dependent) {
+    configuration::applier::hostdependency hd_aply;
+    configuration::hostdependency hd{
+        new_configuration_hostdependency(master, dependent)};
+    hd_aply.expand_objects(*config);
+    hd_aply.add_object(hd);
+    hd_aply.resolve_object(hd);
+  }
+};
+
+// Given host2 depending on host1
+// When host1 goes down and up again
+// Then the result of host2 is kept and only evaluated again after each state
+// change of host1.
+TEST_F(DependencyIndex, MasterStateChange) {
+  host* host1(add_host("host1", 18));
+  host* host2(add_host("host2", 19));
+  add_dependency("host1", "host2");
+  dependency_index& index(dependency_index::hosts());
+
+  ASSERT_TRUE(host2->authorized_by_dependencies(dependency::notification));
+  ASSERT_EQ(index.get_verdict(host2->get_state_id(), dependency::notification),
+            dependency_index::authorized);
+  ASSERT_EQ(index.get_verdict(host2->get_state_id(), dependency::execution),
+            dependency_index::unknown);
+
+  host1->set_current_state(host::state_down);
+  ASSERT_EQ(index.get_verdict(host2->get_state_id(), dependency::notification),
+            dependency_index::unknown);
+  ASSERT_FALSE(host2->authorized_by_dependencies(dependency::notification));
+  ASSERT_EQ(index.get_verdict(host2->get_state_id(), dependency::notification),
+            dependency_index::blocked);
+
+  host1->set_current_state(host::state_up);
+  ASSERT_TRUE(host2->authorized_by_dependencies(dependency::notification));
+}
+
+// Given host3 depending on host2 depending on host1, with inheritance
+// When host1 goes down and up again
+// Then host3 is blocked while host1 is down.
+TEST_F(DependencyIndex, Inheritance) {
+  host* host1(add_host("host1", 18));
+  add_host("host2", 19);
+  host* host3(add_host("host3", 20));
+  add_dependency("host1", "host2");
+  add_dependency("host2", "host3");
+
+  ASSERT_TRUE(host3->authorized_by_dependencies(dependency::notification));
+  host1->set_current_state(host::state_down);
+  ASSERT_FALSE(host3->authorized_by_dependencies(dependency::notification));
+  host1->set_current_state(host::state_up);
+  ASSERT_TRUE(host3->authorized_by_dependencies(dependency::notification));
+}
+
+// Given 2000 hosts depending on 20 masters
+// When their dependencies are evaluated while masters change state
+// Then the results follow the masters.
+TEST_F(DependencyIndex, ManyDependents) {
+  uint32_t const masters = 20;
+  uint32_t const count = 2000;
+  std::vector<host*> hosts;
+  for (uint32_t i = 0; i < masters + count; ++i)
+    hosts.push_back(add_host("host_" + std::to_string(i), i + 1));
+  for (uint32_t i = masters; i < masters + count; ++i)
+    add_dependency("host_" + std::to_string(i % masters),
+                   "host_" + std::to_string(i));
+
+  uint32_t const rounds = 100;
+  uint32_t blocked = 0;
+  for (uint32_t r = 0; r < rounds; ++r) {
+    hosts[r % masters]->set_current_state(
+        (r / masters) % 2 ? host::state_up : host::state_down);
+    for (uint32_t i = masters; i < masters + count; ++i)
+      if (!hosts[i]->authorized_by_dependencies(dependency::notification))
+        ++blocked;
+  }
+
+  /* Each master goes down and up again every 20 rounds. */
+  ASSERT_GT(blocked, 0u);
+  for (uint32_t i = masters; i < masters + count; ++i)
+    ASSERT_EQ(hosts[i]->authorized_by_dependencies(dependency::notification),
+              hosts[i % masters]->get_current_state() == host::state_up);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "../test_engine.hh"
+#include "../timeperiod/utils.hh"
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/deadline_queue.hh"
+#include "com/centreon/engine/globals.hh"
+#include "helper.hh"
+
+using namespace com::centreon::engine;
+
+class Freshness : public TestEngine {
+ public:
+  void SetUp() override {
+    init_config_state();
+    _now = 1600000000;
+    set_time(_now);
+
+    configuration::applier::contact ct_aply;
+    configuration::contact ctct{new_configuration_contact("admin", true)};
+    ct_aply.add_object(ctct);
+    ct_aply.expand_objects(*config);
+    ct_aply.resolve_object(ctct);
+
+    configuration::host hst{new_configuration_host("test_host", "admin")};
+    configuration::applier::host hst_aply;
+    hst_aply.add_object(hst);
+
+    configuration::service svc{
+        new_configuration_service("test_host", "test_svc", "admin")};
+    configuration::applier::service svc_aply;
+    svc_aply.add_object(svc);
+
+    hst_aply.resolve_object(hst);
+    svc_aply.resolve_object(svc);
+
+    _host = host::hosts.begin()->second;
+    _svc = service::services.begin()->second;
+    config->check_service_freshness(true);
+    config->check_host_freshness(true);
+    host::rebuild_check_deadlines();
+    service::rebuild_check_deadlines();
+  }
+
+  void TearDown() override {
+    _host.reset();
+    _svc.reset();
+    deinit_config_state();
+  }
+
+  void make_fresh_service(time_t last_check) {
+    _svc->set_has_been_checked(true);
+    _svc->set_last_check(last_check);
+    _svc->set_freshness_threshold(60);
+    _svc->set_check_freshness(true);
+  }
+
+ protected:
+  time_t _now;
+  std::shared_ptr<host> _host;
+  std::shared_ptr<service> _svc;
+};
+
+// Given a deadline queue
+// When deadlines are set, changed and removed
+// Then only the current deadlines are popped, in order.
+TEST(DeadlineQueue, Pop) {
+  int objs[4];
+  deadline_queue<int> queue;
+  queue.set(&objs[0], 30);
+  queue.set(&objs[1], 10);
+  queue.set(&objs[2], 20);
+  queue.set(&objs[3], 15);
+  queue.set(&objs[2], 40);
+  queue.erase(&objs[3]);
+  ASSERT_EQ(queue.size(), 3u);
+  ASSERT_EQ(queue.deadline(&objs[2]), 40);
+
+  std::vector<int*> due;
+  queue.pop_due(25, due);
+  ASSERT_EQ(due, std::vector<int*>{&objs[1]});
+  due.clear();
+  queue.pop_due(100, due);
+  ASSERT_EQ(due, (std::vector<int*>{&objs[0], &objs[2]}));
+  ASSERT_EQ(queue.size(), 0u);
+}
+
+// Given a service whose results are fresh
+// When the freshness check runs before and after the threshold
+// Then the service is only freshened after the threshold.
+TEST_F(Freshness, ServiceGoesStale) {
+  make_fresh_service(_now);
+  service::check_result_freshness();
+  ASSERT_FALSE(_svc->get_is_being_freshened());
+
+  set_time(_now + 61);
+  service::check_result_freshness();
+  ASSERT_TRUE(_svc->get_is_being_freshened());
+}
+
+// Given a service whose results are fresh
+// When a new result comes before the threshold
+// Then the deadline moves and the service is not freshened at the old one.
+TEST_F(Freshness, NewResultMovesDeadline) {
+  make_fresh_service(_now);
+  set_time(_now + 50);
+  _svc->set_last_check(_now + 50);
+  _svc->update_freshness_deadline();
+
+  set_time(_now + 61);
+  service::check_result_freshness();
+  ASSERT_FALSE(_svc->get_is_being_freshened());
+
+  set_time(_now + 111);
+  service::check_result_freshness();
+  ASSERT_TRUE(_svc->get_is_being_freshened());
+}
+
+// Given a service whose freshness is not checked
+// Then it is not in the freshness queue and is never freshened.
+TEST_F(Freshness, DisabledFreshness) {
+  make_fresh_service(_now);
+  _svc->set_check_freshness(false);
+  set_time(_now + 1000);
+  service::check_result_freshness();
+  ASSERT_FALSE(_svc->get_is_being_freshened());
+}
+
+// Given a host whose check results are old
+// When the freshness check runs
+// Then the host is freshened.
+TEST_F(Freshness, HostGoesStale) {
+  _host->set_has_been_checked(true);
+  _host->set_last_check(_now - 100);
+  _host->set_freshness_threshold(60);
+  _host->set_check_freshness(true);
+  host::check_result_freshness();
+  ASSERT_TRUE(_host->get_is_being_freshened());
+}
+
+// Given a running service check
+// When its result does not come back in time
+// Then the check is detected as orphaned, and only then.
+TEST_F(Freshness, OrphanedService) {
+  _svc->set_next_check(_now);
+  _svc->set_is_executing(true);
+  _svc->update_orphan_deadline();
+  time_t late = _now + config->service_check_timeout() +
+                config->check_reaper_interval() + 600;
+
+  set_time(late);
+  service::check_for_orphaned();
+  ASSERT_TRUE(_svc->get_is_executing());
+
+  set_time(late + 1);
+  service::check_for_orphaned();
+  ASSERT_FALSE(_svc->get_is_executing());
+}
+
+// Given 300000 objects whose results become stale over one hour
+// When the freshness check runs every minute
+// Then each run only pops the objects due during the last minute.
+TEST(DeadlineQueue, ThreeHundredThousandObjects) {
+  uint32_t const count = 300000;
+  std::vector<int> objs(count);
+  deadline_queue<int> queue;
+  for (uint32_t i = 0; i < count; ++i)
+    queue.set(&objs[i], 1 + i % 3600);
+
+  std::vector<int*> due;
+  for (time_t now = 60; now <= 3600; now += 60) {
+    due.clear();
+    queue.pop_due(now, due);
+    for (int* obj : due)
+      queue.set(obj, now + 3600);
+    ASSERT_EQ(due.size(), count / 60);
+  }
+}
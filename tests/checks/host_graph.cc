@@ -0,0 +1,162 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../test_engine.hh"
+#include "com/centreon/engine/configuration/applier/command.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/host_graph.hh"
+#include "helper.hh"
+
+using namespace com::centreon::engine;
+
+class HostGraph : public TestEngine {
+ public:
+  void SetUp() override {
+    init_config_state();
+    configuration::command cmd("hcmd");
+    cmd.parse("command_line", "echo 0");
+    _cmd_aply.add_object(cmd);
+  }
+
+  void TearDown() override { deinit_config_state(); }
+
+  void add_host(std::string const& name,
+                uint64_t id,
+                std::string const& parents) {
+    configuration::host hst;
+    hst.parse("host_name", name.c_str());
+    hst.parse("address", "127.0.0.1");
+    hst.parse("_HOST_ID", std::to_string(id).c_str());
+    hst.parse("check_command", "hcmd");
+    if (!parents.empty())
+      hst.parse("parents", parents.c_str());
+    _hst_aply.add_object(hst);
+    _hosts.push_back(hst);
+  }
+
+  void resolve() {
+    _hst_aply.expand_objects(*config);
+    for (configuration::host const& hst : _hosts)
+      _hst_aply.resolve_object(hst);
+  }
+
+  host* get(std::string const& name) {
+    return host::hosts.find(name)->second.get();
+  }
+
+ protected:
+  configuration::applier::command _cmd_aply;
+  configuration::applier::host _hst_aply;
+  std::vector<configuration::host> _hosts;
+};
+
+// Given a host with two parents
+// When the parents go down and up
+// Then the host is DOWN while one parent is UP and UNREACHABLE otherwise.
+TEST_F(HostGraph, Reachability) {
+  add_host("p1", 1, "");
+  add_host("p2", 2, "");
+  add_host("c", 3, "p1,p2");
+  resolve();
+  host* c(get("c"));
+  c->set_current_state(host::state_down);
+
+  get("p1")->set_current_state(host::state_down);
+  ASSERT_EQ(host_graph::instance().up_parents(c), 1u);
+  ASSERT_EQ(c->determine_host_reachability(), host::state_down);
+  get("p2")->set_current_state(host::state_unreachable);
+  ASSERT_EQ(c->determine_host_reachability(), host::state_unreachable);
+  get("p2")->set_current_state(host::state_down);
+  ASSERT_EQ(host_graph::instance().up_parents(c), 0u);
+  get("p1")->set_current_state(host::state_up);
+  ASSERT_EQ(c->determine_host_reachability(), host::state_down);
+}
+
+// Given a diamond: r -> a, b -> d
+// When the ancestors and descendants are counted
+// Then each host is counted once.
+TEST_F(HostGraph, Diamond) {
+  add_host("r", 1, "");
+  add_host("a", 2, "r");
+  add_host("b", 3, "r");
+  add_host("d", 4, "a,b");
+  resolve();
+
+  ASSERT_EQ(number_of_total_child_hosts(get("r")), 3);
+  ASSERT_EQ(number_of_total_parent_hosts(get("d")), 3);
+  ASSERT_EQ(number_of_total_child_hosts(get("d")), 0);
+  ASSERT_EQ(number_of_total_child_hosts(nullptr), 4);
+}
+
+// Given a diamond: r -> a, b -> d
+// When the parents of d and then of a and b are collected in one visit
+// Then r is collected once.
+TEST_F(HostGraph, PropagationDedup) {
+  add_host("r", 1, "");
+  add_host("a", 2, "r");
+  add_host("b", 3, "r");
+  add_host("d", 4, "a,b");
+  resolve();
+
+  host_graph& graph(host_graph::instance());
+  auto all = [](host const* neighbour) { return neighbour != nullptr; };
+  std::vector<host*> targets;
+  graph.begin_visit();
+  graph.visit(get("d"));
+  graph.neighbours(get("d"), host_graph::parents, all, targets);
+  ASSERT_EQ(targets.size(), 2u);
+  graph.neighbours(get("a"), host_graph::parents, all, targets);
+  graph.neighbours(get("b"), host_graph::parents, all, targets);
+  graph.neighbours(get("r"), host_graph::children, all, targets);
+  ASSERT_EQ(targets.size(), 3u);
+  ASSERT_EQ(targets.back(), get("r"));
+}
+
+// Given 10000 hosts in a tree where each host has 10 children
+// When the root goes down and every host computes its reachability
+// Then the hosts below the root are UNREACHABLE.
+TEST_F(HostGraph, LargeTopology) {
+  uint32_t const count = 10000;
+  add_host("h_0", 1, "");
+  for (uint32_t i = 1; i < count; ++i)
+    add_host("h_" + std::to_string(i), i + 1,
+             "h_" + std::to_string((i - 1) / 10));
+  resolve();
+
+  std::vector<host*> hosts;
+  for (uint32_t i = 0; i < count; ++i)
+    hosts.push_back(get("h_" + std::to_string(i)));
+  ASSERT_EQ(number_of_total_child_hosts(hosts[0]),
+            static_cast<int>(count - 1));
+
+  for (host* hst : hosts) {
+    hst->set_current_state(host::state_down);
+    hst->set_current_state(hst->determine_host_reachability());
+  }
+
+  ASSERT_EQ(hosts[0]->get_current_state(), host::state_down);
+  for (uint32_t i = 1; i < count; ++i)
+    ASSERT_EQ(hosts[i]->get_current_state(), host::state_unreachable);
+}
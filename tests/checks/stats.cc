@@ -0,0 +1,120 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/checks/stats.hh"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "com/centreon/engine/time_base.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::checks;
+
+class CheckStats : public ::testing::Test {
+ public:
+  void SetUp() override { stats::instance().reset(); }
+  void TearDown() override { stats::instance().reset(); }
+
+ protected:
+  /* In the middle of a minute. */
+  time_t const _now = 1000 * 60 + 30;
+};
+
+// Given checks made during the last minutes
+// When they are counted on a window
+// Then the oldest minute of the window is weighted by its part in the window.
+TEST_F(CheckStats, SlidingWindow) {
+  stats& s(stats::instance());
+  for (int i = 0; i < 10; ++i)
+    s.add_check(PASSIVE_SERVICE_CHECK_STATS, _now);
+  for (int i = 0; i < 4; ++i)
+    s.add_check(PASSIVE_SERVICE_CHECK_STATS, _now - 60);
+  for (int i = 0; i < 2; ++i)
+    s.add_check(PASSIVE_SERVICE_CHECK_STATS, _now - 120);
+  /* Too old, it would use the slot of the current minute. */
+  s.add_check(PASSIVE_SERVICE_CHECK_STATS, _now - 16 * 60);
+
+  ASSERT_EQ(s.checks_count(PASSIVE_SERVICE_CHECK_STATS, 1, _now), 12u);
+  ASSERT_EQ(s.checks_count(PASSIVE_SERVICE_CHECK_STATS, 5, _now), 16u);
+  ASSERT_EQ(s.checks_count(PASSIVE_SERVICE_CHECK_STATS, 15, _now), 16u);
+  ASSERT_EQ(s.checks_count(PASSIVE_HOST_CHECK_STATS, 15, _now), 0u);
+  ASSERT_EQ(s.checks_count(PASSIVE_SERVICE_CHECK_STATS, 15, _now + 20 * 60),
+            0u);
+}
+
+// Given checks counted from several threads
+// Then no check is lost.
+TEST_F(CheckStats, ConcurrentUpdates) {
+  stats& s(stats::instance());
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&s, this] {
+      for (int i = 0; i < 10000; ++i)
+        s.add_check(EXTERNAL_COMMAND_STATS, _now);
+    });
+  for (std::thread& t : threads)
+    t.join();
+  ASSERT_EQ(s.checks_count(EXTERNAL_COMMAND_STATS, 1, _now), 40000u);
+}
+
+// Given 90 fast checks and 10 slow ones
+// Then the median is a fast one and the 95th percentile a slow one.
+TEST_F(CheckStats, Percentiles) {
+  stats& s(stats::instance());
+  ASSERT_EQ(s.percentile(stats::active_service_execution_time, 0.5, 5, _now),
+            0.0);
+  for (int i = 0; i < 90; ++i)
+    s.add_timing(stats::active_service_execution_time, 0.01, _now);
+  for (int i = 0; i < 10; ++i)
+    s.add_timing(stats::active_service_execution_time, 2.0, _now - 60);
+
+  double p50 = s.percentile(stats::active_service_execution_time, 0.5, 5, _now);
+  ASSERT_GE(p50, 0.01);
+  ASSERT_LE(p50, 0.01 * 1.2);
+  double p95 =
+      s.percentile(stats::active_service_execution_time, 0.95, 5, _now);
+  ASSERT_GE(p95, 2.0);
+  ASSERT_LE(p95, 2.0 * 1.2);
+  ASSERT_EQ(
+      s.percentile(stats::active_service_execution_time, 0.99, 5, _now),
+      p95);
+  /* The slow checks are out of a one minute window. */
+  ASSERT_EQ(s.percentile(stats::active_service_execution_time, 0.99, 1, _now),
+            p50);
+  ASSERT_EQ(s.percentile(stats::active_host_latency, 0.5, 5, _now), 0.0);
+}
+
+// Given checks made during the last minutes
+// When the wall clock steps one hour backwards
+// Then they are still counted and new checks go on adding to them.
+TEST_F(CheckStats, BackwardTimeStep) {
+  stats& s(stats::instance());
+  for (int i = 0; i < 10; ++i)
+    s.add_check(PASSIVE_SERVICE_CHECK_STATS, _now);
+
+  time_base::instance().shift(-3600);
+  time_t const now = _now - 3600;
+  ASSERT_EQ(s.checks_count(PASSIVE_SERVICE_CHECK_STATS, 5, now), 10u);
+  s.add_check(PASSIVE_SERVICE_CHECK_STATS, now);
+  ASSERT_EQ(s.checks_count(PASSIVE_SERVICE_CHECK_STATS, 5, now), 11u);
+  time_base::instance().shift(3600);
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "com/centreon/engine/commands/system_runner.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/macros.hh"
+#include "com/centreon/engine/service.hh"
+#include "helper.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::commands;
+
+class SystemRunner : public ::testing::Test {
+ public:
+  void SetUp() override { init_config_state(); }
+
+  void TearDown() override { deinit_config_state(); }
+
+  /* Reap finished commands as the main loop would do, until count callbacks
+   * have been called or the timeout is reached. */
+  static void reap_until(int const& count, int expected, int timeout_sec) {
+    auto limit =
+        std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+    while (count < expected && std::chrono::steady_clock::now() < limit) {
+      system_runner::instance().reap();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+};
+
+// Given max_concurrent_system_commands set to 0
+// When a command is run
+// Then its callback is called before run() returns.
+TEST_F(SystemRunner, Sync) {
+  nagios_macros* mac(get_global_macros());
+  int called = 0;
+  std::string output;
+  system_runner::instance().run(
+      mac, "/bin/echo bonjour", 5, 0,
+      [&](int result, bool early_timeout, double, std::string const& out) {
+        ++called;
+        ASSERT_EQ(result, service::state_ok);
+        ASSERT_FALSE(early_timeout);
+        output = out;
+      });
+  ASSERT_EQ(called, 1);
+  ASSERT_EQ(output, "bonjour\n");
+}
+
+// Given max_concurrent_system_commands set to 2
+// When a command is run
+// Then run() returns at once and its callback is called by reap().
+TEST_F(SystemRunner, Async) {
+  config->max_parallel_system_commands(2);
+  nagios_macros* mac(get_global_macros());
+  int called = 0;
+  std::string output;
+  system_runner::instance().run(
+      mac, "/bin/echo bonjour", 5, 0,
+      [&](int result, bool early_timeout, double, std::string const& out) {
+        ++called;
+        ASSERT_EQ(result, service::state_ok);
+        ASSERT_FALSE(early_timeout);
+        output = out;
+      });
+  ASSERT_EQ(called, 0);
+  reap_until(called, 1, 5);
+  ASSERT_EQ(called, 1);
+  ASSERT_EQ(output, "bonjour\n");
+  ASSERT_EQ(system_runner::instance().running(), 0u);
+}
+
+// Given max_concurrent_system_commands set to 2
+// When a command lasts longer than its timeout
+// Then its callback is called with early_timeout set and an unknown result.
+TEST_F(SystemRunner, AsyncTimeout) {
+  config->max_parallel_system_commands(2);
+  nagios_macros* mac(get_global_macros());
+  int called = 0;
+  system_runner::instance().run(
+      mac, "/bin/sleep 10", 1, 0,
+      [&](int result, bool early_timeout, double, std::string const&) {
+        ++called;
+        ASSERT_EQ(result, service::state_unknown);
+        ASSERT_TRUE(early_timeout);
+      });
+  reap_until(called, 1, 5);
+  ASSERT_EQ(called, 1);
+}
+
+// Given 40 notifications running a 1 second script and at most 20 commands
+// running in parallel
+// When they are run
+// Then run() never blocks: 20 of them are started and 20 are queued, and
+// the queued ones are only started, and completed, after the first ones.
+TEST_F(SystemRunner, AlertStorm) {
+  int const notifications = 40;
+  unsigned int const slots = 20;
+  config->max_parallel_system_commands(slots);
+  nagios_macros* mac(get_global_macros());
+  int called = 0;
+  std::vector<int> completed;
+
+  for (int i = 0; i < notifications; ++i)
+    system_runner::instance().run(
+        mac, "/bin/sleep 1", 10, 0,
+        [&called, &completed, i](int, bool, double, std::string const&) {
+          completed.push_back(i);
+          ++called;
+        });
+  ASSERT_EQ(system_runner::instance().running(), slots);
+  ASSERT_EQ(system_runner::instance().queued(), notifications - slots);
+
+  auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (called < notifications && std::chrono::steady_clock::now() < limit) {
+    system_runner::instance().reap();
+    ASSERT_LE(system_runner::instance().running(), slots);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  ASSERT_EQ(called, notifications);
+  ASSERT_EQ(system_runner::instance().queued(), 0u);
+  std::vector<int> first(completed.begin(), completed.begin() + slots);
+  std::sort(first.begin(), first.end());
+  for (unsigned int i = 0; i < slots; ++i)
+    ASSERT_EQ(first[i], static_cast<int>(i));
+}
+
+// Given at most 2 notifications running per command
+// When 4 notifications of the same command and 1 of another command are run
+// Then run() does not block, 2 of them are queued and only started when the
+// first ones of their command are over.
+TEST_F(SystemRunner, PerCommandLimit) {
+  config->max_parallel_system_commands(10);
+  config->max_parallel_notifications_per_command(2);
+  nagios_macros* mac(get_global_macros());
+  int called = 0;
+  std::vector<int> completed;
+
+  for (int i = 0; i < 4; ++i)
+    system_runner::instance().run(
+        mac, "/bin/sleep 1", 10, 0,
+        [&called, &completed, i](int, bool, double, std::string const&) {
+          completed.push_back(i);
+          ++called;
+        },
+        "mail");
+  system_runner::instance().run(
+      mac, "/bin/sleep 1", 10, 0,
+      [&called, &completed](int, bool, double, std::string const&) {
+        completed.push_back(4);
+        ++called;
+      },
+      "sms");
+
+  ASSERT_EQ(system_runner::instance().running(), 3u);
+  ASSERT_EQ(system_runner::instance().queued(), 2u);
+  reap_until(called, 5, 10);
+  ASSERT_EQ(called, 5);
+  ASSERT_EQ(system_runner::instance().queued(), 0u);
+  /* The queued mails complete last. */
+  std::vector<int> last(completed.begin() + 3, completed.end());
+  std::sort(last.begin(), last.end());
+  ASSERT_EQ(last, std::vector<int>({2, 3}));
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "com/centreon/engine/comment.hh"
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "helper.hh"
+#include "test_engine.hh"
+#include "timeperiod/utils.hh"
+
+using namespace com::centreon::engine;
+
+class CommentStore : public TestEngine {
+ public:
+  void SetUp() override { init_config_state(); }
+
+  void TearDown() override { deinit_config_state(); }
+
+  static void add(comment::type type,
+                  comment::e_type entry_type,
+                  uint64_t host_id,
+                  uint64_t service_id,
+                  uint64_t comment_id,
+                  bool persistent = false,
+                  time_t expire_time = 0) {
+    std::shared_ptr<comment> cmt{std::make_shared<comment>(
+        type, entry_type, host_id, service_id, 1000, "admin", "data",
+        persistent, comment::external, expire_time != 0, expire_time,
+        comment_id)};
+    comment::comments.insert({cmt->get_comment_id(), cmt});
+  }
+
+  static std::vector<uint64_t> ids() {
+    std::vector<uint64_t> retval;
+    for (comment_map::iterator it(comment::comments.begin()),
+         end(comment::comments.end());
+         it != end; ++it)
+      retval.push_back(it->first);
+    return retval;
+  }
+};
+
+// Given comments of two hosts and of a service of the first host
+// When the comments of the first host and then of the service are deleted
+// Then only these comments are removed.
+TEST_F(CommentStore, DeleteObjectComments) {
+  add(comment::host, comment::user, 1, 0, 1);
+  add(comment::host, comment::user, 2, 0, 2);
+  add(comment::service, comment::user, 1, 1, 3);
+  add(comment::host, comment::flapping, 1, 0, 4);
+  add(comment::service, comment::user, 1, 2, 5);
+  add(comment::service, comment::user, 1, 1, 6);
+
+  comment::delete_host_comments(1);
+  ASSERT_EQ(ids(), (std::vector<uint64_t>{2, 3, 5, 6}));
+  comment::delete_service_comments(1, 1);
+  ASSERT_EQ(ids(), (std::vector<uint64_t>{2, 5}));
+  ASSERT_TRUE(comment::delete_comment(5));
+  ASSERT_FALSE(comment::delete_comment(5));
+  comment::delete_service_comments(1, 2);
+  ASSERT_EQ(ids(), std::vector<uint64_t>{2});
+}
+
+// Given a host with acknowledgement comments, persistent or not
+// When its acknowledgement comments are deleted
+// Then only the non-persistent ones are removed.
+TEST_F(CommentStore, DeleteAcknowledgementComments) {
+  configuration::applier::contact ct_aply;
+  configuration::contact ctct{new_configuration_contact("admin", true)};
+  ct_aply.add_object(ctct);
+  ct_aply.expand_objects(*config);
+  ct_aply.resolve_object(ctct);
+  configuration::host hst{new_configuration_host("test_host", "admin", 7)};
+  configuration::applier::host hst_aply;
+  hst_aply.add_object(hst);
+  hst_aply.resolve_object(hst);
+
+  add(comment::host, comment::acknowledgment, 7, 0, 1);
+  add(comment::host, comment::acknowledgment, 7, 0, 2, true);
+  add(comment::host, comment::user, 7, 0, 3);
+  add(comment::host, comment::acknowledgment, 8, 0, 4);
+
+  comment::delete_host_acknowledgement_comments(
+      host::hosts.begin()->second.get());
+  ASSERT_EQ(ids(), (std::vector<uint64_t>{2, 3, 4}));
+}
+
+// Given comments expiring at different times
+// When their expire comment events run
+// Then only the comments expired before the current time are removed.
+TEST_F(CommentStore, Expiration) {
+  add(comment::host, comment::user, 1, 0, 1, false, 100);
+  add(comment::host, comment::user, 1, 0, 2, false, 200);
+  add(comment::host, comment::user, 1, 0, 3, false, 300);
+  add(comment::host, comment::user, 1, 0, 4);
+  add(comment::host, comment::user, 1, 0, 5, false, 150);
+  comment::delete_comment(5);
+
+  set_time(200);
+  for (uint64_t id = 1; id <= 5; ++id)
+    comment::remove_if_expired_comment(id);
+  ASSERT_EQ(ids(), (std::vector<uint64_t>{2, 3, 4}));
+  set_time(1000);
+  for (uint64_t id = 1; id <= 5; ++id)
+    comment::remove_if_expired_comment(id);
+  ASSERT_EQ(ids(), std::vector<uint64_t>{4});
+}
+
+// Given comments with automatic ids
+// When a comment is deleted
+// Then its id is given again.
+TEST_F(CommentStore, FreeIds) {
+  comment::set_next_comment_id(1);
+  for (int i = 0; i < 5; ++i)
+    add(comment::host, comment::user, 1, 0, 0);
+  ASSERT_EQ(ids(), (std::vector<uint64_t>{1, 2, 3, 4, 5}));
+  comment::delete_comment(2);
+  add(comment::host, comment::user, 1, 0, 0);
+  add(comment::host, comment::user, 1, 0, 0);
+  ASSERT_EQ(ids(), (std::vector<uint64_t>{1, 2, 3, 4, 5, 6}));
+}
+
+// Given 500k comments on 5000 services
+// When the comments of every service are deleted
+// Then each deletion only removes the comments of its service.
+TEST_F(CommentStore, ManyComments) {
+  uint64_t const count = 500000;
+  uint64_t const services = 5000;
+  for (uint64_t i = 1; i <= count; ++i)
+    add(comment::service, comment::acknowledgment, i % services / 100 + 1,
+        i % services + 1, i, false, i % 2 ? 1000 + i : 0);
+  ASSERT_EQ(comment::comments.size(), count);
+
+  for (uint64_t s = 0; s < services; ++s) {
+    comment::delete_service_comments(s / 100 + 1, s + 1);
+    ASSERT_EQ(comment::comments.size(), count - (s + 1) * count / services);
+  }
+
+  ASSERT_TRUE(comment::comments.empty());
+}
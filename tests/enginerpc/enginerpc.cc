@@ -18,12 +18,14 @@
  */
 #include "com/centreon/engine/enginerpc.hh"
 
+#include <grpcpp/create_channel.h>
 #include <gtest/gtest.h>
 
 #include <atomic>
 #include <chrono>
 #include <cstdio>
 #include <fstream>
+#include <set>
 #include <thread>
 
 #include "../test_engine.hh"
@@ -44,6 +46,7 @@
 #include "com/centreon/engine/downtimes/downtime_manager.hh"
 #include "com/centreon/engine/events/loop.hh"
 #include "com/centreon/engine/modules/external_commands/commands.hh"
+#include "com/centreon/engine/snapshot.hh"
 #include "com/centreon/engine/timezone_manager.hh"
 #include "com/centreon/engine/version.hh"
 #include "helper.hh"
@@ -353,6 +356,85 @@ TEST_F(EngineRpc, GetService) {
   erpc.shutdown();
 }
 
+/* Concurrent GetService requests while the main loop changes the service
+ * state and publishes snapshots: every answer must be consistent. */
+TEST_F(EngineRpc, GetServiceUnderLoad) {
+  enginerpc erpc("0.0.0.0", 40001);
+  std::atomic<bool> stop{false};
+  snapshot::instance().publish();
+
+  std::thread main_loop([this, &stop]() {
+    int state = 0;
+    while (!stop) {
+      _svc->set_current_state(
+          static_cast<engine::service::service_state>(state));
+      _svc->update_status();
+      state = (state + 1) % 4;
+      command_manager::instance().execute();
+      snapshot::instance().publish();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  constexpr int clients = 4;
+  constexpr int calls_per_client = 2500;
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int c = 0; c < clients; ++c)
+    threads.emplace_back([&failures, start]() {
+      std::unique_ptr<Engine::Stub> stub(Engine::NewStub(grpc::CreateChannel(
+          "127.0.0.1:40001", grpc::InsecureChannelCredentials())));
+      for (int i = 0; i < calls_per_client; ++i) {
+        /* Each client sends one request every 400us. */
+        std::this_thread::sleep_until(
+            start + std::chrono::microseconds(i * 400));
+        ServiceIdentifier request;
+        request.mutable_names()->set_host_name("test_host");
+        request.mutable_names()->set_service_name("test_svc");
+        EngineService response;
+        grpc::ClientContext context;
+        grpc::Status status = stub->GetService(&context, request, &response);
+        if (!status.ok() || response.host_id() != 12 ||
+            response.service_id() != 13 ||
+            response.current_state() > EngineService::UNKNOWN)
+          ++failures;
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+
+  stop = true;
+  main_loop.join();
+  snapshot::instance().clear();
+  erpc.shutdown();
+
+  ASSERT_EQ(failures, 0);
+}
+
+/* Only objects whose status was updated are copied again. */
+TEST_F(EngineRpc, SnapshotFollowsStatusUpdates) {
+  snapshot::instance().publish();
+  auto first = snapshot::instance().get();
+  ASSERT_EQ(first->find_service(12, 13)->current_state,
+            engine::service::state_critical);
+
+  _svc->set_current_state(engine::service::state_ok);
+  snapshot::instance().publish();
+  ASSERT_EQ(snapshot::instance().get()->find_service(12, 13)->current_state,
+            engine::service::state_critical);
+
+  _svc->update_status();
+  snapshot::instance().publish();
+  auto second = snapshot::instance().get();
+  ASSERT_EQ(second->find_service(12, 13)->current_state,
+            engine::service::state_ok);
+  ASSERT_EQ(second->find_host(12), first->find_host(12));
+  ASSERT_EQ(second->idx, first->idx);
+
+  snapshot::instance().clear();
+}
+
 TEST_F(EngineRpc, GetWrongService) {
   enginerpc erpc("0.0.0.0", 40001);
   std::unique_ptr<std::thread> th;
@@ -387,6 +469,136 @@ TEST_F(EngineRpc, GetWrongService) {
   erpc.shutdown();
 }
 
+TEST_F(EngineRpc, ListHosts) {
+  enginerpc erpc("0.0.0.0", 40001);
+  engine::host::hosts["test_host"]->set_current_state(engine::host::state_down);
+  engine::host::hosts["child_host"]->set_current_state(engine::host::state_up);
+  snapshot::instance().publish();
+
+  std::unique_ptr<Engine::Stub> stub(Engine::NewStub(grpc::CreateChannel(
+      "127.0.0.1:40001", grpc::InsecureChannelCredentials())));
+
+  /* Two pages of one host. */
+  std::set<std::string> names;
+  std::string token;
+  for (int page = 0; page < 2; ++page) {
+    HostsQuery query;
+    query.set_page_size(1);
+    query.set_page_token(token);
+    query.mutable_fields()->add_paths("name");
+    grpc::ClientContext context;
+    auto reader = stub->ListHosts(&context, query);
+    HostsChunk chunk;
+    int count = 0;
+    while (reader->Read(&chunk)) {
+      for (auto& h : chunk.hosts()) {
+        ASSERT_TRUE(h.alias().empty());
+        names.insert(h.name());
+        ++count;
+      }
+      token = chunk.next_page_token();
+    }
+    ASSERT_TRUE(reader->Finish().ok());
+    ASSERT_EQ(count, 1);
+    ASSERT_EQ(token.empty(), page == 1);
+  }
+  ASSERT_EQ(names, std::set<std::string>({"test_host", "child_host"}));
+
+  /* A page holding the last matching host gives no token, even if other
+   * hosts follow it. */
+  {
+    HostsQuery query;
+    query.set_page_size(1);
+    query.add_states(EngineHost::DOWN);
+    grpc::ClientContext context;
+    auto reader = stub->ListHosts(&context, query);
+    HostsChunk chunk;
+    int count = 0;
+    while (reader->Read(&chunk)) {
+      count += chunk.hosts_size();
+      token = chunk.next_page_token();
+    }
+    ASSERT_TRUE(reader->Finish().ok());
+    ASSERT_EQ(count, 1);
+    ASSERT_TRUE(token.empty());
+  }
+
+  /* Filter on state. */
+  HostsQuery query;
+  query.add_states(EngineHost::DOWN);
+  grpc::ClientContext context;
+  auto reader = stub->ListHosts(&context, query);
+  HostsChunk chunk;
+  std::vector<std::string> down;
+  while (reader->Read(&chunk))
+    for (auto& h : chunk.hosts())
+      down.push_back(h.name());
+  ASSERT_TRUE(reader->Finish().ok());
+  ASSERT_EQ(down, std::vector<std::string>({"test_host"}));
+
+  /* Unknown states are rejected. */
+  HostsQuery query_bad;
+  query_bad.add_states(static_cast<EngineHost::State>(40));
+  grpc::ClientContext context_bad;
+  auto reader_bad = stub->ListHosts(&context_bad, query_bad);
+  while (reader_bad->Read(&chunk))
+    ;
+  ASSERT_EQ(reader_bad->Finish().error_code(), grpc::INVALID_ARGUMENT);
+
+  snapshot::instance().clear();
+  erpc.shutdown();
+}
+
+TEST_F(EngineRpc, ListServices) {
+  enginerpc erpc("0.0.0.0", 40001);
+  snapshot::instance().publish();
+
+  std::unique_ptr<Engine::Stub> stub(Engine::NewStub(grpc::CreateChannel(
+      "127.0.0.1:40001", grpc::InsecureChannelCredentials())));
+
+  ServicesQuery query;
+  query.set_servicegroup("test_sg");
+  query.mutable_fields()->add_paths("description");
+  query.mutable_fields()->add_paths("current_state");
+  grpc::ClientContext context;
+  auto reader = stub->ListServices(&context, query);
+  ServicesChunk chunk;
+  std::vector<EngineService> services;
+  while (reader->Read(&chunk))
+    for (auto& s : chunk.services())
+      services.push_back(s);
+  ASSERT_TRUE(reader->Finish().ok());
+  ASSERT_EQ(services.size(), 1u);
+  ASSERT_EQ(services[0].description(), "test_svc");
+  ASSERT_EQ(services[0].current_state(), EngineService::CRITICAL);
+  ASSERT_TRUE(services[0].host_name().empty());
+
+  /* Both services of test_host are in test_hg, with chunks of one service. */
+  ServicesQuery query_hg;
+  query_hg.set_hostgroup("test_hg");
+  query_hg.set_chunk_size(1);
+  grpc::ClientContext context_hg;
+  auto reader_hg = stub->ListServices(&context_hg, query_hg);
+  int chunks = 0;
+  while (reader_hg->Read(&chunk)) {
+    ASSERT_EQ(chunk.services_size(), 1);
+    ++chunks;
+  }
+  ASSERT_TRUE(reader_hg->Finish().ok());
+  ASSERT_EQ(chunks, 2);
+
+  ServicesQuery query_bad;
+  query_bad.set_servicegroup("wrong_sg");
+  grpc::ClientContext context_bad;
+  auto reader_bad = stub->ListServices(&context_bad, query_bad);
+  while (reader_bad->Read(&chunk))
+    ;
+  ASSERT_FALSE(reader_bad->Finish().ok());
+
+  snapshot::instance().clear();
+  erpc.shutdown();
+}
+
 TEST_F(EngineRpc, GetContact) {
   enginerpc erpc("0.0.0.0", 40001);
   std::unique_ptr<std::thread> th;
@@ -1767,6 +1979,67 @@ TEST_F(EngineRpc, ProcessServiceCheckResultBadService) {
   erpc.shutdown();
 }
 
+TEST_F(EngineRpc, ProcessCheckResults) {
+  enginerpc erpc("0.0.0.0", 40001);
+  std::unique_ptr<std::thread> th;
+  std::condition_variable condvar;
+  std::mutex mutex;
+  bool continuerunning = false;
+
+  call_command_manager(th, &condvar, &mutex, &continuerunning);
+
+  std::unique_ptr<Engine::Stub> stub(Engine::NewStub(grpc::CreateChannel(
+      "127.0.0.1:40001", grpc::InsecureChannelCredentials())));
+
+  Checks checks;
+  Check* c = checks.add_checks();
+  c->set_host_name("test_host");
+  c->set_svc_desc("test_svc");
+  c->set_code(2);
+  c->set_output("by names");
+  c = checks.add_checks();
+  c->set_host_id(12);
+  c->set_service_id(13);
+  c->set_output("by ids");
+  c = checks.add_checks();
+  c->set_host_name("test_host");
+  c->set_code(1);
+  c = checks.add_checks();
+  c->set_host_name("wrong_host");
+  c->set_svc_desc("test_svc");
+  c = checks.add_checks();
+  c->set_host_id(12);
+  c->set_service_id(1000);
+  c = checks.add_checks();
+  c->set_host_name("test_host");
+  c->set_code(3);
+  c = checks.add_checks();
+  c->set_svc_desc("test_svc");
+
+  ChecksStatus response;
+  grpc::ClientContext context;
+  grpc::Status status = stub->ProcessCheckResults(&context, checks, &response);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    continuerunning = true;
+  }
+  condvar.notify_one();
+  th->join();
+
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(response.accepted(), 3u);
+  ASSERT_EQ(response.status_size(), 7);
+  ASSERT_EQ(response.status(0), ChecksStatus::ACCEPTED);
+  ASSERT_EQ(response.status(1), ChecksStatus::ACCEPTED);
+  ASSERT_EQ(response.status(2), ChecksStatus::ACCEPTED);
+  ASSERT_EQ(response.status(3), ChecksStatus::HOST_NOT_FOUND);
+  ASSERT_EQ(response.status(4), ChecksStatus::SERVICE_NOT_FOUND);
+  /* A host check return code cannot be 3. */
+  ASSERT_EQ(response.status(5), ChecksStatus::INVALID);
+  ASSERT_EQ(response.status(6), ChecksStatus::INVALID);
+  erpc.shutdown();
+}
+
 TEST_F(EngineRpc, ProcessHostCheckResult) {
   enginerpc erpc("0.0.0.0", 40001);
   auto output = execute("ProcessHostCheckResult test_host 0");
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/modules/external_commands/command_reader.hh"
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/modules/external_commands/commands.hh"
+#include "com/centreon/engine/modules/external_commands/internal.hh"
+#include "helper.hh"
+#include "test_engine.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::modules::external_commands;
+
+class CommandReader : public TestEngine {
+ public:
+  void SetUp() override {
+    init_config_state();
+    ASSERT_EQ(pipe2(_fds, O_NONBLOCK), 0);
+  }
+
+  void TearDown() override {
+    close(_fds[0]);
+    close(_fds[1]);
+    deinit_config_state();
+  }
+
+  void write_all(std::string const& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+      ssize_t r = ::write(_fds[1], data.data() + done, data.size() - done);
+      if (r > 0)
+        done += r;
+      else
+        std::this_thread::yield();
+    }
+  }
+
+  std::vector<std::string> process(command_reader& reader) {
+    std::vector<std::string> retval;
+    reader.process([&retval](char* cmd, size_t len) {
+      retval.emplace_back(cmd, len);
+      ASSERT_EQ(cmd[len], 0);
+    });
+    return retval;
+  }
+
+ protected:
+  int _fds[2];
+};
+
+// Given a reader on a pipe
+// When lines are written in several parts
+// Then only complete and non-empty lines are processed, without their '\n'.
+TEST_F(CommandReader, SplitLines) {
+  command_reader reader(_fds[0], 0, nullptr);
+  write_all("[1] A\n[2] BB\n\n[3] C");
+  ASSERT_EQ(reader.read(), 19u);
+  ASSERT_EQ(process(reader), (std::vector<std::string>{"[1] A", "[2] BB"}));
+
+  write_all("CC\n");
+  reader.read();
+  ASSERT_EQ(process(reader), std::vector<std::string>{"[3] CCC"});
+  ASSERT_TRUE(process(reader).empty());
+}
+
+// Given a reader with an immediate filter
+// When commands are read
+// Then the commands accepted by the filter are not queued.
+TEST_F(CommandReader, Immediate) {
+  std::vector<std::string> immediate;
+  command_reader reader(_fds[0], 0, [&immediate](char* cmd, size_t len) {
+    if (cmd[0] != 'x')
+      return false;
+    immediate.emplace_back(cmd, len);
+    return true;
+  });
+  write_all("a\nx1\nb\nx2\n");
+  reader.read();
+  ASSERT_EQ(immediate, (std::vector<std::string>{"x1", "x2"}));
+  ASSERT_EQ(reader.queued(), 2u);
+  ASSERT_EQ(process(reader), (std::vector<std::string>{"a", "b"}));
+  ASSERT_EQ(reader.queued(), 0u);
+}
+
+// Given a reader accepting 3 queued commands
+// When 4 commands are written
+// Then the reader stops reading until the main loop processes them.
+TEST_F(CommandReader, Full) {
+  command_reader reader(_fds[0], 3, nullptr);
+  write_all("a\nb\nc\n");
+  reader.read();
+  ASSERT_TRUE(reader.full());
+  write_all("d\n");
+  ASSERT_EQ(reader.read(), 0u);
+  ASSERT_FALSE(reader.submit("e"));
+
+  ASSERT_EQ(process(reader), (std::vector<std::string>{"a", "b", "c"}));
+  ASSERT_FALSE(reader.full());
+  ASSERT_TRUE(reader.submit("e"));
+  reader.read();
+  ASSERT_EQ(process(reader), (std::vector<std::string>{"e", "d"}));
+}
+
+// Given a writer thread sending passive check results through a pipe
+// When the reader reads them and the main loop processes them
+// Then every command is received intact, in order, across chunk boundaries.
+TEST_F(CommandReader, ManyCommands) {
+  uint32_t const count = 50000;
+  command_reader reader(_fds[0], 0, nullptr);
+
+  std::thread writer([this] {
+    std::string buffer;
+    char line[128];
+    for (uint32_t i = 0; i < count; ++i) {
+      snprintf(line, sizeof(line),
+               "[1614585600] PROCESS_SERVICE_CHECK_RESULT;host_%u;svc_%u;0;"
+               "OK - %u|value=%u\n",
+               i / 100, i % 100, i, i);
+      buffer.append(line);
+      if (buffer.size() > 32768) {
+        write_all(buffer);
+        buffer.clear();
+      }
+    }
+    write_all(buffer);
+  });
+
+  uint32_t received = 0;
+  bool ordered = true;
+  while (received < count) {
+    reader.read();
+    reader.process([&received, &ordered](char* cmd, size_t len) {
+      char const* ok = strstr(cmd, "OK - ");
+      if (!ok || strtoul(ok + 5, nullptr, 10) != received ||
+          cmd[len - 1] == '\n')
+        ordered = false;
+      ++received;
+    });
+  }
+  writer.join();
+
+  ASSERT_TRUE(ordered);
+  ASSERT_EQ(received, count);
+}
+
+// Given 100 services accepting passive checks and a reader executing the
+// thread-safe commands like the command file worker
+// When passive check results are written in the pipe
+// Then they are all turned into check results sent to the checker by
+// batches.
+TEST_F(CommandReader, PassiveCheckResults) {
+  configuration::applier::contact ct_aply;
+  configuration::contact ctct{new_configuration_contact("admin", true)};
+  ct_aply.add_object(ctct);
+  ct_aply.expand_objects(*config);
+  ct_aply.resolve_object(ctct);
+  configuration::host hst{new_configuration_host("test_host", "admin")};
+  configuration::applier::host hst_aply;
+  hst_aply.add_object(hst);
+  configuration::applier::service svc_aply;
+  std::vector<configuration::service> svcs;
+  for (int i = 0; i < 100; ++i) {
+    svcs.push_back(new_configuration_service(
+        "test_host", "svc_" + std::to_string(i), "admin", i + 1));
+    svc_aply.add_object(svcs.back());
+  }
+  hst_aply.resolve_object(hst);
+  for (configuration::service& svc : svcs)
+    svc_aply.resolve_object(svc);
+
+  command_reader reader(_fds[0], 0, [](char* cmd, size_t len) {
+    if (!gl_processor.is_thread_safe(cmd))
+      return false;
+    gl_processor.execute(cmd, len);
+    return true;
+  });
+
+  uint32_t const count = 20000;
+  std::thread writer([this] {
+    std::string buffer;
+    char line[128];
+    for (uint32_t i = 0; i < count; ++i) {
+      snprintf(line, sizeof(line),
+               "[%lld] PROCESS_SERVICE_CHECK_RESULT;test_host;svc_%u;%u;"
+               "output %u|value=%u\n",
+               static_cast<long long>(time(nullptr)), i % 100, i % 4, i, i);
+      buffer.append(line);
+      if (buffer.size() > 32768) {
+        write_all(buffer);
+        buffer.clear();
+      }
+    }
+    write_all(buffer);
+  });
+
+  batch_passive_check_results(true);
+  size_t received = 0;
+  while (received < count) {
+    reader.read();
+    received += flush_passive_check_results();
+  }
+  batch_passive_check_results(false);
+  writer.join();
+
+  ASSERT_EQ(received, count);
+  ASSERT_EQ(reader.queued(), 0u);
+}
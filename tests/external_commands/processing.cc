@@ -0,0 +1,59 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/modules/external_commands/processing.hh"
+#include <gtest/gtest.h>
+#include "com/centreon/engine/checks/stats.hh"
+#include "com/centreon/engine/modules/external_commands/internal.hh"
+#include "helper.hh"
+
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::modules::external_commands;
+
+class ExternalCommandProcessing : public ::testing::Test {
+ public:
+  void SetUp() override { init_config_state(); }
+
+  void TearDown() override { deinit_config_state(); }
+};
+
+// Given the external command processor
+// When commands are looked up
+// Then known commands are found, prefixes and unknown commands are not.
+TEST_F(ExternalCommandProcessing, Lookup) {
+  ASSERT_TRUE(gl_processor.is_thread_safe(
+      "[1614585600] PROCESS_SERVICE_CHECK_RESULT;host;svc;0;output"));
+  ASSERT_TRUE(gl_processor.is_thread_safe(
+      "[1614585600] PROCESS_HOST_CHECK_RESULT;host;0;output"));
+  ASSERT_FALSE(gl_processor.is_thread_safe("[1614585600] PROCESS_FILE;f;0"));
+  ASSERT_FALSE(gl_processor.is_thread_safe(
+      "[1614585600] PROCESS_SERVICE_CHECK_RESUL;host;svc;0;output"));
+  ASSERT_FALSE(gl_processor.is_thread_safe("[1614585600] "));
+
+  checks::stats::instance().reset();
+  ASSERT_FALSE(gl_processor.execute("[1614585600] UNKNOWN_COMMAND;a;b"));
+  ASSERT_TRUE(gl_processor.execute("[1614585600] _CUSTOM_COMMAND;a;b"));
+  ASSERT_EQ(checks::stats::instance().checks_count(EXTERNAL_COMMAND_STATS, 1,
+                                                   std::time(nullptr)),
+            0u);
+  ASSERT_TRUE(gl_processor.execute("[1614585600] DISABLE_NOTIFICATIONS"));
+  ASSERT_FALSE(config->enable_notifications());
+  ASSERT_TRUE(gl_processor.execute("[1614585600] ENABLE_NOTIFICATIONS"));
+  ASSERT_TRUE(config->enable_notifications());
+}
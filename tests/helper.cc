@@ -20,6 +20,7 @@
 #include "helper.hh"
 
 #include <com/centreon/engine/checks/checker.hh>
+#include <com/centreon/engine/commands/system_runner.hh>
 #include <com/centreon/engine/configuration/applier/logging.hh>
 #include <com/centreon/engine/configuration/applier/state.hh>
 
@@ -34,9 +35,11 @@ void init_config_state(void) {
   // Hack to instanciate the logger.
   configuration::applier::logging::instance();
   checks::checker::init();
+  commands::system_runner::init();
 }
 
 void deinit_config_state(void) {
+  commands::system_runner::deinit();
   delete config;
   config = nullptr;
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/logging/async_file.hh"
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "com/centreon/engine/logging/logger.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+
+class AsyncFile : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ::unlink(_path);
+    ::unlink(_old_path);
+  }
+
+  void TearDown() override {
+    ::unlink(_path);
+    ::unlink(_old_path);
+  }
+
+  static uint32_t count_lines(char const* path) {
+    std::ifstream f(path);
+    std::string line;
+    uint32_t retval = 0;
+    while (std::getline(f, line))
+      ++retval;
+    return retval;
+  }
+
+ protected:
+  char const* _path = "/tmp/async_file.log";
+  char const* _old_path = "/tmp/async_file.log.old";
+};
+
+// Given an asynchronous log file
+// When 4 threads log 10000 lines each
+// Then the file contains 40000 lines after flush().
+TEST_F(AsyncFile, AllLinesWritten) {
+  engine::logging::async_file f(_path, false);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&f, t] {
+      for (int i = 0; i < 10000; ++i) {
+        std::string msg("thread " + std::to_string(t) + " line " +
+                        std::to_string(i));
+        f.log(engine::logging::log_info_message, engine::logging::basic,
+              msg.c_str(), msg.size());
+      }
+    });
+  for (std::thread& t : threads)
+    t.join();
+  f.flush();
+
+  ASSERT_EQ(count_lines(_path), 40000u);
+  std::ifstream in(_path);
+  std::string line;
+  std::getline(in, line);
+  ASSERT_EQ(line[0], '[');
+  ASSERT_NE(line.find("] thread "), std::string::npos);
+}
+
+// Given an asynchronous log file limited to 10kB
+// When more than 10kB are logged
+// Then the file is rotated.
+TEST_F(AsyncFile, Rotation) {
+  engine::logging::async_file f(_path, true, 10000);
+  std::string msg(50, 'x');
+  for (int i = 0; i < 1000; ++i) {
+    f.log(engine::logging::log_info_message, engine::logging::basic,
+          msg.c_str(), msg.size());
+    if (i % 100 == 0)
+      f.flush();
+  }
+  f.flush();
+
+  struct stat st;
+  ASSERT_EQ(stat(_old_path, &st), 0);
+  ASSERT_EQ(stat(_path, &st), 0);
+  ASSERT_LT(st.st_size, 20000);
+}
+
+// Given an asynchronous log file
+// When 200 short-lived threads log one line each
+// Then their lines are written after they exit.
+TEST_F(AsyncFile, ExitedThreads) {
+  engine::logging::async_file f(_path, false);
+  for (int t = 0; t < 200; ++t) {
+    std::thread th([&f, t] {
+      std::string msg("thread " + std::to_string(t));
+      f.log(engine::logging::log_info_message, engine::logging::basic,
+            msg.c_str(), msg.size());
+    });
+    th.join();
+  }
+  f.flush();
+  f.flush();
+  ASSERT_EQ(count_lines(_path), 200u);
+}
+
+// Given 300000 passive check results logged, as with log_passive_checks at
+// 30k checks per second during 10 seconds
+// When they are written in an asynchronous file
+// Then all of them are in the file once it is flushed.
+TEST_F(AsyncFile, ManyPassiveChecks) {
+  uint32_t const count = 300000;
+  std::string msg(
+      "PASSIVE SERVICE CHECK: host_1234;service_12;0;OK - everything is fine "
+      "| metric=12ms;100;200;0;");
+
+  {
+    engine::logging::async_file f(_path, true);
+    for (uint32_t i = 0; i < count; ++i)
+      f.log(engine::logging::log_passive_check, engine::logging::basic,
+            msg.c_str(), msg.size());
+    f.flush();
+  }
+  ASSERT_EQ(count_lines(_path), count);
+}
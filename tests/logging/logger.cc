@@ -0,0 +1,99 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/logging/logger.hh"
+
+#include <gtest/gtest.h>
+
+
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/logging/backend.hh"
+#include "com/centreon/logging/engine.hh"
+#include "helper.hh"
+
+using namespace com::centreon;
+using namespace com::centreon::engine;
+using namespace com::centreon::engine::logging;
+
+class Logger : public ::testing::Test {
+ public:
+  void SetUp() override { init_config_state(); }
+
+  void TearDown() override { deinit_config_state(); }
+};
+
+/* A backend counting its logs. */
+class counter : public com::centreon::logging::backend {
+ public:
+  uint32_t count = 0;
+
+  void close() noexcept override {}
+  void log(uint64_t types,
+           uint32_t verbose,
+           char const* msg,
+           uint32_t size) noexcept override {
+    (void)types;
+    (void)verbose;
+    (void)msg;
+    (void)size;
+    ++count;
+  }
+  void open() override {}
+  void reopen() override {}
+};
+
+static int evaluated = 0;
+
+static int evaluate() {
+  return ++evaluated;
+}
+
+// Given a backend logging dbg_checks up to the more verbosity
+// When it is added to and removed from the logging engine
+// Then the mask follows it.
+TEST_F(Logger, MaskFollowsBackends) {
+  counter c;
+  ASSERT_FALSE(mask::is_log(dbg_checks, basic));
+
+  unsigned long id =
+      com::centreon::logging::engine::instance().add(&c, dbg_checks, more);
+  mask::update();
+  ASSERT_TRUE(mask::is_log(dbg_checks, basic));
+  ASSERT_TRUE(mask::is_log(dbg_checks, more));
+  ASSERT_FALSE(mask::is_log(dbg_checks, most));
+  ASSERT_FALSE(mask::is_log(dbg_macros, basic));
+
+#ifndef CCE_NO_DEBUG_LOGS
+  logger(dbg_checks, more) << "check";
+  ASSERT_EQ(c.count, 1u);
+#endif  // !CCE_NO_DEBUG_LOGS
+
+  com::centreon::logging::engine::instance().remove(id);
+  mask::update();
+  ASSERT_FALSE(mask::is_log(dbg_checks, basic));
+}
+
+// Given no backend logging dbg_functions
+// When a dbg_functions log is written
+// Then its content is not evaluated.
+TEST_F(Logger, DisabledLogNotEvaluated) {
+  evaluated = 0;
+  logger(dbg_functions, basic) << "value " << evaluate();
+  ASSERT_EQ(evaluated, 0);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/events/check_placement.hh"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace com::centreon::engine::events;
+
+static double peak(std::vector<double> const& load) {
+  return *std::max_element(load.begin(), load.end());
+}
+
+static double average(std::vector<double> const& load) {
+  return std::accumulate(load.begin(), load.end(), 0.0) / load.size();
+}
+
+// Given 600 checks of one second every 5 minutes
+// When they are placed
+// Then two checks start each second.
+TEST(CheckPlacement, SameInterval) {
+  check_placement placement(300, 0);
+  for (int i = 0; i < 600; ++i)
+    placement.add(300, 1.0);
+  placement.place();
+
+  std::vector<uint32_t> starts(300, 0);
+  for (size_t i = 0; i < 600; ++i) {
+    ASSERT_LT(placement.phase(i), 300u);
+    ++starts[placement.phase(i)];
+  }
+  ASSERT_EQ(std::count(starts.begin(), starts.end(), 2), 300);
+  ASSERT_DOUBLE_EQ(peak(placement.concurrency()), 2.0);
+}
+
+// Given checks already scheduled in the first half of the interval
+// When new checks are placed
+// Then they fill the second half.
+TEST(CheckPlacement, ExistingLoad) {
+  check_placement placement(300, 0);
+  for (uint32_t i = 0; i < 150; ++i)
+    placement.add_load(300, i, 1.0);
+  for (int i = 0; i < 150; ++i)
+    placement.add(300, 1.0);
+  placement.place();
+
+  for (size_t i = 0; i < 150; ++i)
+    ASSERT_GE(placement.phase(i), 150u);
+  ASSERT_DOUBLE_EQ(peak(placement.concurrency()), 1.0);
+}
+
+// Given checks already scheduled, all at the same second, and others spread
+// When new checks are placed
+// Then the piled up checks are moved, except one, and the spread ones stay.
+TEST(CheckPlacement, MoveOverloadedChecks) {
+  check_placement placement(300, 0);
+  std::vector<size_t> piled;
+  for (int i = 0; i < 100; ++i)
+    piled.push_back(placement.add_scheduled(300, 0, 1.0));
+  std::vector<size_t> spread;
+  for (uint32_t i = 100; i < 200; ++i)
+    spread.push_back(placement.add_scheduled(300, i, 1.0));
+  for (int i = 0; i < 100; ++i)
+    placement.add(300, 1.0);
+  placement.place();
+
+  ASSERT_EQ(std::count_if(piled.begin(), piled.end(),
+                          [&placement](size_t idx) {
+                            return placement.moved(idx);
+                          }),
+            99);
+  for (uint32_t i = 0; i < 100; ++i) {
+    ASSERT_FALSE(placement.moved(spread[i]));
+    ASSERT_EQ(placement.phase(spread[i]), i + 100);
+  }
+  ASSERT_DOUBLE_EQ(peak(placement.concurrency()), 1.0);
+}
+
+// Given a spread shorter than the check interval
+// Then the first checks are all placed in the spread.
+TEST(CheckPlacement, Spread) {
+  check_placement placement(3600, 600);
+  for (int i = 0; i < 1000; ++i)
+    placement.add(3600, 0.5);
+  placement.place();
+  for (size_t i = 0; i < 1000; ++i)
+    ASSERT_LT(placement.phase(i), 600u);
+}
+
+// Given long checks and short checks with different intervals
+// When they are placed
+// Then the peak concurrency stays close to the average, and long checks
+// are not started at the same time.
+TEST(CheckPlacement, MixedIntervals) {
+  check_placement placement(3600, 0);
+  for (int i = 0; i < 60; ++i)
+    placement.add(600, 30.0);
+  for (int i = 0; i < 3000; ++i)
+    placement.add(60, 0.2);
+  for (int i = 0; i < 2000; ++i)
+    placement.add(300, 1.0);
+  placement.place();
+
+  std::vector<double> load(placement.concurrency());
+  ASSERT_NEAR(average(load), 60 * 30.0 / 600 + 3000 * 0.2 / 60 + 2000 / 300.0,
+              1e-6);
+  ASSERT_LT(peak(load), average(load) * 1.2);
+}
+
+// Given 300000 services with usual intervals and execution times
+// When they are placed
+// Then the concurrency peak stays close to the average.
+TEST(CheckPlacement, ThreeHundredThousandServices) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> interval(0, 3);
+  std::exponential_distribution<double> cost(2.0);
+  uint32_t const intervals[] = {60, 300, 600, 3600};
+
+  check_placement placement(3600, 1800);
+  for (int i = 0; i < 300000; ++i)
+    placement.add(intervals[interval(gen)], cost(gen) + 0.01);
+  placement.place();
+
+  std::vector<double> load(placement.concurrency());
+  ASSERT_LT(peak(load), average(load) * 1.5);
+}
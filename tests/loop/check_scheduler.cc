@@ -0,0 +1,172 @@
+/*
+ * Copyright 2019 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include "com/centreon/engine/events/check_scheduler.hh"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "../test_engine.hh"
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/globals.hh"
+#include "helper.hh"
+
+using namespace com::centreon::engine;
+
+class CheckScheduler : public TestEngine {
+ public:
+  void SetUp() override {
+    init_config_state();
+    events::check_scheduler::instance().reset();
+
+    configuration::applier::contact ct_aply;
+    configuration::contact ctct{new_configuration_contact("admin", true)};
+    ct_aply.add_object(ctct);
+    ct_aply.expand_objects(*config);
+    ct_aply.resolve_object(ctct);
+
+    configuration::host hst{new_configuration_host("test_host", "admin")};
+    configuration::applier::host hst_aply;
+    hst_aply.add_object(hst);
+
+    configuration::applier::service svc_aply;
+    configuration::service fast{
+        new_configuration_service("test_host", "fast", "admin", 1)};
+    configuration::service slow{
+        new_configuration_service("test_host", "slow", "admin", 2)};
+    svc_aply.add_object(fast);
+    svc_aply.add_object(slow);
+    hst_aply.resolve_object(hst);
+    svc_aply.resolve_object(fast);
+    svc_aply.resolve_object(slow);
+
+    for (service_map::value_type const& p : service::services) {
+      if (p.first.second == "fast") {
+        _fast = p.second;
+        _fast->set_check_command("fast_cmd!arg");
+      } else {
+        _slow = p.second;
+        _slow->set_check_command("slow_cmd");
+      }
+    }
+    currently_running_service_checks = 0;
+  }
+
+  void TearDown() override {
+    currently_running_service_checks = 0;
+    _fast.reset();
+    _slow.reset();
+    events::check_scheduler::instance().reset();
+    deinit_config_state();
+  }
+
+ protected:
+  std::shared_ptr<service> _fast;
+  std::shared_ptr<service> _slow;
+};
+
+// Given no max_concurrent_checks
+// Then every check is admitted.
+TEST_F(CheckScheduler, Unlimited) {
+  events::check_scheduler& scheduler(events::check_scheduler::instance());
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_TRUE(scheduler.admit(_slow.get(), 1.0));
+  ASSERT_EQ(scheduler.admission_rate(), 0);
+}
+
+// Given commands with different execution times
+// Then each command has its own average, with arguments ignored, and
+// unknown commands use the average of all the checks.
+TEST_F(CheckScheduler, ExecutionTimes) {
+  config->max_parallel_service_checks(10);
+  events::check_scheduler& scheduler(events::check_scheduler::instance());
+  ASSERT_EQ(scheduler.expected_execution_time(_fast.get()), 1.0);
+  for (int i = 0; i < 50; ++i) {
+    scheduler.add_execution_time(_fast.get(), 0.1);
+    scheduler.add_execution_time(_slow.get(), 4.0);
+  }
+  ASSERT_NEAR(scheduler.expected_execution_time(_fast.get()), 0.1, 1e-3);
+  ASSERT_NEAR(scheduler.expected_execution_time(_slow.get()), 4.0, 1e-3);
+  ASSERT_NEAR(scheduler.projected_overhead(_slow.get()), 0.4, 1e-3);
+
+  _fast->set_check_command("fast_cmd!other");
+  ASSERT_NEAR(scheduler.expected_execution_time(_fast.get()), 0.1, 1e-3);
+  _fast->set_check_command("unknown_cmd");
+  double mean = scheduler.expected_execution_time(_fast.get());
+  ASSERT_GT(mean, 0.1);
+  ASSERT_LT(mean, 4.0);
+}
+
+// Given max_concurrent_checks checks already running
+// Then no check is admitted.
+TEST_F(CheckScheduler, ConcurrencyCap) {
+  config->max_parallel_service_checks(4);
+  events::check_scheduler& scheduler(events::check_scheduler::instance());
+  currently_running_service_checks = 4;
+  ASSERT_FALSE(scheduler.admit(_fast.get(), 1.0));
+  currently_running_service_checks = 3;
+  ASSERT_TRUE(scheduler.admit(_fast.get(), 1.0));
+}
+
+// Given 10 check slots and checks lasting 0.5s
+// When checks are asked as fast as possible during 60 simulated seconds
+// Then about 10 / 0.5 = 20 checks are admitted per second, and slow checks
+// take the place of several fast ones.
+TEST_F(CheckScheduler, TokenBucket) {
+  config->max_parallel_service_checks(10);
+  events::check_scheduler& scheduler(events::check_scheduler::instance());
+  for (int i = 0; i < 50; ++i) {
+    scheduler.add_execution_time(_fast.get(), 0.5);
+    scheduler.add_execution_time(_slow.get(), 5.0);
+  }
+
+  uint32_t fast_count = 0;
+  double now = 1000.0;
+  for (int i = 0; i < 60000; ++i, now += 0.001)
+    if (scheduler.admit(_fast.get(), now))
+      ++fast_count;
+  double fast_rate = fast_count / 60.0;
+  ASSERT_NEAR(fast_rate, 20.0, 1.0);
+
+  uint32_t slow_count = 0;
+  for (int i = 0; i < 60000; ++i, now += 0.001)
+    if (scheduler.admit(_slow.get(), now))
+      ++slow_count;
+  ASSERT_NEAR(slow_count / 60.0, 2.0, 0.2);
+}
+
+// Given the adaptive scheduler
+// Then the configured rate follows the check intervals of the services.
+TEST_F(CheckScheduler, ConfiguredRate) {
+  config->use_adaptive_check_scheduler(true);
+  config->interval_length(60);
+  _fast->set_check_interval(1);
+  _slow->set_check_interval(5);
+  _fast->set_should_be_scheduled(true);
+  _slow->set_should_be_scheduled(true);
+  _fast->set_checks_enabled(true);
+  _slow->set_checks_enabled(true);
+  ASSERT_NEAR(events::check_scheduler::instance().configured_rate(),
+              1.0 / 60 + 1.0 / 300, 1e-9);
+  ASSERT_EQ(events::loop::instance().ready_checks(), 0u);
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../test_engine.hh"
+#include "../timeperiod/utils.hh"
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/events/loop.hh"
+#include "com/centreon/engine/time_base.hh"
+#include "helper.hh"
+
+using namespace com::centreon::engine;
+
+class TimeChange : public TestEngine {
+ public:
+  void SetUp() override {
+    init_config_state();
+    _now = 1600000000;
+    set_time(_now);
+
+    configuration::applier::contact ct_aply;
+    configuration::contact ctct{new_configuration_contact("admin", true)};
+    ct_aply.add_object(ctct);
+    ct_aply.expand_objects(*config);
+    ct_aply.resolve_object(ctct);
+
+    configuration::host hst{new_configuration_host("test_host", "admin")};
+    configuration::applier::host hst_aply;
+    hst_aply.add_object(hst);
+
+    configuration::service svc{
+        new_configuration_service("test_host", "test_svc", "admin")};
+    configuration::applier::service svc_aply;
+    svc_aply.add_object(svc);
+
+    hst_aply.resolve_object(hst);
+    svc_aply.resolve_object(svc);
+
+    _host = host::hosts.begin()->second;
+    _svc = service::services.begin()->second;
+  }
+
+  void TearDown() override {
+    events::loop::instance().clear();
+    time_base::instance().shift(-time_base::instance().offset());
+    _host.reset();
+    _svc.reset();
+    deinit_config_state();
+  }
+
+ protected:
+  time_t _now;
+  std::shared_ptr<host> _host;
+  std::shared_ptr<service> _svc;
+};
+
+// Given a time base moved by a time change
+// When times are converted
+// Then unset times are kept and times before the epoch become 0.
+TEST_F(TimeChange, Conversions) {
+  time_base base;
+  base.shift(-100);
+  ASSERT_EQ(base.to_internal(1000), 1100);
+  ASSERT_EQ(base.to_wall(1100), 1000);
+  ASSERT_EQ(base.to_wall(50), 0);
+  ASSERT_EQ(base.to_internal(0), 0);
+  ASSERT_EQ(base.to_wall(-1), -1);
+}
+
+// Given a time base following the wall clock
+// When the wall clock moves backwards, forwards or not at all
+// Then only backward steps and forward steps over the threshold are
+// reported.
+TEST_F(TimeChange, DetectStep) {
+  time_base base;
+  ASSERT_EQ(base.detect_step(_now, 60), 0);
+  ASSERT_EQ(base.detect_step(_now, 60), 0);
+  ASSERT_EQ(base.detect_step(_now - 3600, 60), -3600);
+  ASSERT_EQ(base.detect_step(_now - 3570, 60), 0);
+  ASSERT_EQ(base.detect_step(_now + 30, 60), 3600);
+}
+
+// Given a service with check and notification times and a scheduled check
+// When the system time moves one hour back
+// Then the times of the service, its check event and its freshness deadline
+// all move back.
+TEST_F(TimeChange, Compensate) {
+  _svc->set_next_check(_now + 300);
+  _svc->set_last_check(_now - 300);
+  _svc->set_last_state_change(_now - 7200);
+  _svc->set_last_notification(_now - 600);
+  _host->set_last_state_history_update(_now - 60);
+  _svc->set_has_been_checked(true);
+  _svc->set_freshness_threshold(600);
+  _svc->set_check_freshness(true);
+  config->check_service_freshness(true);
+  timed_event* evt =
+      new timed_event(timed_event::EVENT_SERVICE_CHECK, _now + 300, false, 0L,
+                      nullptr, true, _svc.get(), nullptr, 0);
+  events::loop::instance().add_event(evt, events::loop::low);
+  timed_event* fixed =
+      new timed_event(timed_event::EVENT_USER_FUNCTION, _now + 100, false, 0L,
+                      nullptr, false, nullptr, nullptr, 0);
+  events::loop::instance().add_event(fixed, events::loop::low);
+
+  events::loop::instance().compensate_for_system_time_change(_now,
+                                                             _now - 3600);
+
+  ASSERT_EQ(_svc->get_next_check(), _now + 300 - 3600);
+  ASSERT_EQ(_svc->get_last_check(), _now - 300 - 3600);
+  ASSERT_EQ(_svc->get_last_state_change(), _now - 7200 - 3600);
+  ASSERT_EQ(_svc->get_last_notification(), _now - 600 - 3600);
+  ASSERT_EQ(_svc->get_last_hard_state_change(), 0);
+  ASSERT_EQ(_host->get_last_state_history_update(), _now - 60 - 3600);
+  ASSERT_EQ(evt->run_time, _now + 300 - 3600);
+  ASSERT_EQ(fixed->run_time, _now + 100);
+  ASSERT_EQ(events::loop::instance().find_event(
+                events::loop::low, timed_event::EVENT_SERVICE_CHECK,
+                _svc.get()),
+            evt);
+
+  /* The result of the last check, one hour ago now, is stale. */
+  set_time(_now - 3600 + 200);
+  service::check_result_freshness();
+  ASSERT_FALSE(_svc->get_is_being_freshened());
+  set_time(_now - 3600 + 400);
+  service::check_result_freshness();
+  ASSERT_TRUE(_svc->get_is_being_freshened());
+}
+
+// Given 3000 scheduled events
+// When the system time moves back
+// Then all their run times move back by the same amount.
+TEST_F(TimeChange, ManyEvents) {
+  uint32_t const count = 3000;
+  std::vector<timed_event*> evts;
+  for (uint32_t i = 0; i < count; ++i) {
+    evts.push_back(new timed_event(timed_event::EVENT_USER_FUNCTION,
+                                   _now + count - i, false, 0L, nullptr, true,
+                                   nullptr, nullptr, 0));
+    events::loop::instance().schedule(evts.back(), false);
+  }
+
+  events::loop::instance().compensate_for_system_time_change(_now,
+                                                             _now - 3600);
+
+  ASSERT_EQ(time_base::instance().offset(), -3600);
+  for (uint32_t i = 0; i < count; ++i)
+    ASSERT_EQ(evts[i]->run_time, _now + count - i - 3600);
+}
@@ -0,0 +1,302 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <sys/time.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "com/centreon/engine/broker.hh"
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/nebcallbacks.hh"
+#include "com/centreon/engine/neberrors.hh"
+#include "com/centreon/engine/nebmods.hh"
+#include "com/centreon/engine/nebstructs.hh"
+#include "helper.hh"
+#include "test_engine.hh"
+
+using namespace com::centreon::engine;
+
+static std::vector<int> called;
+static int module;
+
+static int callback1(int, void*) {
+  called.push_back(1);
+  return 0;
+}
+
+static int callback2(int, void*) {
+  called.push_back(2);
+  return 0;
+}
+
+static int callback3(int, void*) {
+  called.push_back(3);
+  return 0;
+}
+
+static int self_deregister(int callback_type, void*) {
+  called.push_back(4);
+  neb_deregister_callback(callback_type, self_deregister);
+  return 0;
+}
+
+static std::vector<std::string> batched_lines;
+
+static int batch_callback(int callback_type, void* data) {
+  nebstruct_batch_data* ds{static_cast<nebstruct_batch_data*>(data)};
+  called.push_back(ds->callback_type == callback_type ? 5 : -1);
+  for (size_t i = 0; i < ds->size; ++i)
+    batched_lines.push_back(
+        static_cast<nebstruct_service_check_data*>(ds->events[i])
+            ->command_line);
+  return 0;
+}
+
+static int batch_count(int, void* data) {
+  called.push_back(static_cast<nebstruct_batch_data*>(data)->size);
+  return 0;
+}
+
+static std::vector<std::string> metric_labels;
+
+static int perfdata_callback(int, void* data) {
+  nebstruct_perfdata_data* ds{static_cast<nebstruct_perfdata_data*>(data)};
+  for (size_t i = 0; i < ds->size; ++i)
+    metric_labels.push_back(std::string(ds->service_description) + '/' +
+                            ds->metrics[i].label + '=' +
+                            std::to_string(ds->metrics[i].value));
+  return 0;
+}
+
+class NebCallbacks : public TestEngine {
+ public:
+  void SetUp() override {
+    init_config_state();
+    neb_init_callback_list();
+    called.clear();
+    batched_lines.clear();
+    metric_labels.clear();
+  }
+
+  void TearDown() override {
+    neb_free_callback_list();
+    deinit_config_state();
+  }
+
+  service* create_service() {
+    configuration::applier::contact ct_aply;
+    configuration::contact ctct{new_configuration_contact("admin", true)};
+    ct_aply.add_object(ctct);
+    ct_aply.expand_objects(*config);
+    ct_aply.resolve_object(ctct);
+    configuration::host hst{new_configuration_host("test_host", "admin")};
+    configuration::applier::host hst_aply;
+    hst_aply.add_object(hst);
+    configuration::service svc{
+        new_configuration_service("test_host", "test_svc", "admin")};
+    configuration::applier::service svc_aply;
+    svc_aply.add_object(svc);
+    hst_aply.resolve_object(hst);
+    svc_aply.resolve_object(svc);
+    return service::services.begin()->second.get();
+  }
+};
+
+// Given callbacks registered with priorities 5, 1 and 5
+// When callbacks are made
+// Then they are called by priority, then in their registration order.
+TEST_F(NebCallbacks, Priority) {
+  ASSERT_FALSE(neb_has_callbacks(NEBCALLBACK_LOG_DATA));
+  neb_register_callback(NEBCALLBACK_LOG_DATA, &module, 5, callback1);
+  neb_register_callback(NEBCALLBACK_LOG_DATA, &module, 1, callback2);
+  neb_register_callback(NEBCALLBACK_LOG_DATA, &module, 5, callback3);
+  ASSERT_TRUE(neb_has_callbacks(NEBCALLBACK_LOG_DATA));
+  ASSERT_FALSE(neb_has_callbacks(NEBCALLBACK_HOST_CHECK_DATA));
+
+  neb_make_callbacks(NEBCALLBACK_LOG_DATA, nullptr);
+  ASSERT_EQ(called, (std::vector<int>{2, 1, 3}));
+}
+
+// Given three callbacks of the same type
+// When the first one is deregistered
+// Then the two others are still called.
+TEST_F(NebCallbacks, DeregisterFirst) {
+  neb_register_callback(NEBCALLBACK_LOG_DATA, &module, 0, callback1);
+  neb_register_callback(NEBCALLBACK_LOG_DATA, &module, 0, callback2);
+  neb_register_callback(NEBCALLBACK_LOG_DATA, &module, 0, callback3);
+  ASSERT_EQ(neb_deregister_callback(NEBCALLBACK_LOG_DATA, callback1), OK);
+  ASSERT_EQ(neb_deregister_callback(NEBCALLBACK_LOG_DATA, callback1),
+            NEBERROR_CALLBACKNOTFOUND);
+
+  neb_make_callbacks(NEBCALLBACK_LOG_DATA, nullptr);
+  ASSERT_EQ(called, (std::vector<int>{2, 3}));
+
+  neb_deregister_module_callbacks(&module);
+  ASSERT_FALSE(neb_has_callbacks(NEBCALLBACK_LOG_DATA));
+}
+
+// Given a callback deregistering itself
+// When callbacks are made twice
+// Then the following callbacks are called the first time and it is not
+// called the second time.
+TEST_F(NebCallbacks, SelfDeregister) {
+  neb_register_callback(NEBCALLBACK_LOG_DATA, &module, 0, self_deregister);
+  neb_register_callback(NEBCALLBACK_LOG_DATA, &module, 1, callback1);
+
+  neb_make_callbacks(NEBCALLBACK_LOG_DATA, nullptr);
+  neb_make_callbacks(NEBCALLBACK_LOG_DATA, nullptr);
+  ASSERT_EQ(called, (std::vector<int>{4, 1, 1}));
+}
+
+// Given a service and no module subscribed to service checks
+// When broker_service_check() is called many times
+// Then no callback is called, and once a callback is subscribed it gets
+// every call.
+TEST_F(NebCallbacks, ManyChecksWithoutSubscriber) {
+  service* s{create_service()};
+
+  uint32_t const count = 1000000;
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  auto send = [&]() {
+    for (uint32_t i = 0; i < count; ++i)
+      broker_service_check(NEBTYPE_SERVICECHECK_PROCESSED, NEBFLAG_NONE,
+                           NEBATTR_NONE, s, 0, tv, tv, "check_cmd!arg1!arg2",
+                           0.1, 0.2, 60, false, 0, "/bin/check arg1 arg2",
+                           &tv);
+  };
+
+  send();
+  ASSERT_TRUE(called.empty());
+  neb_register_callback(NEBCALLBACK_SERVICE_CHECK_DATA, &module, 0,
+                        callback1);
+  send();
+  ASSERT_EQ(called.size(), count);
+}
+
+// Given a callback on perfdata
+// When the perfdata of a service are sent
+// Then the callback receives its parsed metrics, and nothing is sent for a
+// service without perfdata.
+TEST_F(NebCallbacks, Perfdata) {
+  service* s{create_service()};
+  neb_register_callback(NEBCALLBACK_PERFDATA_DATA, &module, 0,
+                        perfdata_callback);
+
+  s->set_perf_data("");
+  broker_perfdata(NEBTYPE_PERFDATA_PROCESSED, NEBFLAG_NONE, NEBATTR_NONE,
+                  nullptr, s, nullptr);
+  ASSERT_TRUE(metric_labels.empty());
+
+  s->set_perf_data("rta=0.5ms;100;200;0 'packet loss'=0%;20;50");
+  broker_perfdata(NEBTYPE_PERFDATA_PROCESSED, NEBFLAG_NONE, NEBATTR_NONE,
+                  nullptr, s, nullptr);
+  ASSERT_EQ(metric_labels,
+            (std::vector<std::string>{"test_svc/rta=0.500000",
+                                      "test_svc/packet loss=0.000000"}));
+}
+
+// Given a batch callback on service checks
+// When service checks are sent and their command lines are modified
+// Then the batch callback receives them only when batches are flushed, with
+// the original command lines.
+TEST_F(NebCallbacks, Batch) {
+  service* s{create_service()};
+  ASSERT_EQ(neb_register_batch_callback(NEBCALLBACK_LOG_DATA, &module, 0,
+                                        batch_callback),
+            NEBERROR_CALLBACKNOBATCH);
+  ASSERT_EQ(neb_register_batch_callback(NEBCALLBACK_SERVICE_CHECK_DATA,
+                                        &module, 0, batch_callback),
+            OK);
+  ASSERT_TRUE(neb_has_callbacks(NEBCALLBACK_SERVICE_CHECK_DATA));
+
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  char cmd[32];
+  for (int i = 0; i < 3; ++i) {
+    snprintf(cmd, sizeof(cmd), "/bin/check %d", i);
+    broker_service_check(NEBTYPE_SERVICECHECK_PROCESSED, NEBFLAG_NONE,
+                         NEBATTR_NONE, s, 0, tv, tv, "check_cmd", 0.1, 0.2,
+                         60, false, 0, cmd, &tv);
+    strcpy(cmd, "overwritten");
+  }
+  ASSERT_TRUE(called.empty());
+
+  /* Not old enough. */
+  neb_flush_batches(60000);
+  ASSERT_TRUE(called.empty());
+
+  neb_flush_batches(0);
+  ASSERT_EQ(called, (std::vector<int>{5}));
+  ASSERT_EQ(batched_lines,
+            (std::vector<std::string>{"/bin/check 0", "/bin/check 1",
+                                      "/bin/check 2"}));
+
+  neb_flush_batches(0);
+  ASSERT_EQ(called.size(), 1u);
+
+  ASSERT_EQ(neb_deregister_batch_callback(NEBCALLBACK_SERVICE_CHECK_DATA,
+                                          batch_callback),
+            OK);
+  ASSERT_FALSE(neb_has_callbacks(NEBCALLBACK_SERVICE_CHECK_DATA));
+  ASSERT_EQ(neb_deregister_batch_callback(NEBCALLBACK_SERVICE_CHECK_DATA,
+                                          batch_callback),
+            NEBERROR_CALLBACKNOTFOUND);
+}
+
+// Given a service
+// When broker_service_check() is called many times
+// Then a per-event callback gets each event and a batch callback flushed
+// every 1000 events gets them by 1000.
+TEST_F(NebCallbacks, ManyChecksByBatch) {
+  service* s{create_service()};
+
+  uint32_t const count = 1000000;
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  auto send = [&]() {
+    for (uint32_t i = 0; i < count; ++i) {
+      broker_service_check(NEBTYPE_SERVICECHECK_PROCESSED, NEBFLAG_NONE,
+                           NEBATTR_NONE, s, 0, tv, tv, "check_cmd!arg1!arg2",
+                           0.1, 0.2, 60, false, 0, "/bin/check arg1 arg2",
+                           &tv);
+      if (i % 1000 == 999)
+        neb_flush_batches(0);
+    }
+  };
+
+  neb_register_callback(NEBCALLBACK_SERVICE_CHECK_DATA, &module, 0,
+                        callback1);
+  send();
+  ASSERT_EQ(called.size(), count);
+  neb_deregister_callback(NEBCALLBACK_SERVICE_CHECK_DATA, callback1);
+
+  called.clear();
+  neb_register_batch_callback(NEBCALLBACK_SERVICE_CHECK_DATA, &module, 0,
+                              batch_count);
+  send();
+  ASSERT_EQ(called.size(), count / 1000);
+  ASSERT_EQ(called.front(), 1000);
+}
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 #include <time.h>
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -1090,3 +1091,37 @@ TEST_F(HostNotification, HostEscalationRetention) {
 
   ASSERT_EQ(notification0, notification1);
 }
+
+// Given a host with the contact admin and a contact group containing admin
+// and test_contact
+// When its contacts are flattened
+// Then admin appears once, and removing test_contact updates the list.
+TEST_F(HostNotification, FlattenedContacts) {
+  configuration::applier::contact ct_aply;
+  configuration::contact ctct{new_configuration_contact("test_contact", false)};
+  ct_aply.add_object(ctct);
+  ct_aply.expand_objects(*config);
+  ct_aply.resolve_object(ctct);
+
+  configuration::applier::contactgroup cg_aply;
+  configuration::contactgroup cg{
+      new_configuration_contactgroup("test_cg", "admin,test_contact")};
+  cg_aply.add_object(cg);
+  cg_aply.expand_objects(*config);
+  cg_aply.resolve_object(cg);
+
+  _host->get_contactgroups()["test_cg"] =
+      engine::contactgroup::contactgroups["test_cg"].get();
+
+  std::vector<engine::contact*> const& contacts{
+      _host->get_flattened_contacts()};
+  ASSERT_EQ(contacts.size(), 2u);
+  ASSERT_EQ(std::count(contacts.begin(), contacts.end(),
+                       engine::contact::contacts["admin"].get()),
+            1);
+
+  ct_aply.remove_object(ctct);
+  ASSERT_EQ(_host->get_flattened_contacts().size(), 1u);
+  ASSERT_EQ(_host->get_flattened_contacts()[0],
+            engine::contact::contacts["admin"].get());
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/name_table.hh"
+#include "com/centreon/engine/object_index.hh"
+#include "com/centreon/engine/service.hh"
+#include "helper.hh"
+#include "test_engine.hh"
+
+using namespace com::centreon::engine;
+
+class ObjectIndex : public TestEngine {
+ public:
+  void SetUp() override { init_config_state(); }
+
+  void TearDown() override { deinit_config_state(); }
+};
+
+// Given the name table
+// When names are interned
+// Then each distinct name gets its own stable id, and unknown names are not
+// found.
+TEST_F(ObjectIndex, NameTable) {
+  name_table names;
+  uint32_t a = names.intern("name_table_a");
+  uint32_t b = names.intern("name_table_b");
+  ASSERT_NE(a, 0u);
+  ASSERT_NE(a, b);
+  ASSERT_EQ(names.intern("name_table_a"), a);
+  ASSERT_EQ(names.find("name_table_bxx", 12), b);
+  ASSERT_EQ(names.name(b), "name_table_b");
+  ASSERT_EQ(names.find("name_table_c"), 0u);
+  ASSERT_EQ(names.name(0), "");
+
+  for (int i = 0; i < 10000; ++i)
+    names.intern("name_table_" + std::to_string(i));
+  ASSERT_EQ(names.size(), 10002u);
+  ASSERT_EQ(names.find("name_table_a"), a);
+  ASSERT_EQ(names.name(names.find("name_table_9999")), "name_table_9999");
+}
+
+// Given hosts and services created by the appliers
+// When they are modified or removed
+// Then the object index follows them.
+TEST_F(ObjectIndex, Appliers) {
+  configuration::applier::contact ct_aply;
+  configuration::contact ctct{new_configuration_contact("admin", true)};
+  ct_aply.add_object(ctct);
+  ct_aply.expand_objects(*config);
+  ct_aply.resolve_object(ctct);
+  configuration::host hst{new_configuration_host("test_host", "admin")};
+  configuration::applier::host hst_aply;
+  hst_aply.add_object(hst);
+  configuration::service svc{
+      new_configuration_service("test_host", "test_svc", "admin")};
+  configuration::applier::service svc_aply;
+  svc_aply.add_object(svc);
+
+  ASSERT_EQ(object_index::find_contact("admin"),
+            contact::contacts["admin"].get());
+  ASSERT_EQ(object_index::find_host("test_host"),
+            host::hosts["test_host"].get());
+  service* s = object_index::find_service("test_host", "test_svc");
+  ASSERT_NE(s, nullptr);
+  ASSERT_EQ(s, (service::services[{"test_host", "test_svc"}].get()));
+  ASSERT_EQ(object_index::find_service("test_hostxx", 9, "test_svcxx", 8), s);
+  ASSERT_EQ(object_index::find_service("test_host", "test_svc2"), nullptr);
+
+  ASSERT_TRUE(svc.parse("service_description", "test_svc2"));
+  svc_aply.modify_object(svc);
+  ASSERT_EQ(object_index::find_service("test_host", "test_svc"), nullptr);
+  ASSERT_EQ(object_index::find_service("test_host", "test_svc2"), s);
+  ASSERT_EQ(s->get_description(), "test_svc2");
+
+  svc_aply.remove_object(svc);
+  ASSERT_EQ(object_index::find_service("test_host", "test_svc2"), nullptr);
+  hst_aply.remove_object(hst);
+  ASSERT_EQ(object_index::find_host("test_host"), nullptr);
+}
@@ -1,6 +1,102 @@
+#include <cctype>
+#include <random>
 #include "com/centreon/engine/utils.hh"
 #include "gtest/gtest.h"
 
+/* The line by line implementation replaced by the single pass one, kept as
+ * a reference. */
+static void reference_parse_check_output(std::string const& buffer,
+                                         std::string& short_buffer,
+                                         std::string& long_buffer,
+                                         std::string& pd_buffer,
+                                         bool escape_newlines_please,
+                                         bool newlines_are_escaped) {
+  bool long_pipe{false};
+  bool perfdata_already_filled{false};
+
+  bool eof{false};
+  std::string line;
+  size_t start_line{0}, end_line, pos_line;
+  int line_number{1};
+  while (!eof) {
+    if (newlines_are_escaped &&
+        (pos_line = buffer.find("\\n", start_line)) != std::string::npos) {
+      end_line = pos_line;
+      pos_line += 2;
+    } else if ((pos_line = buffer.find("\n", start_line)) !=
+               std::string::npos) {
+      end_line = pos_line;
+      pos_line++;
+    } else {
+      end_line = buffer.size();
+      eof = true;
+    }
+    line = buffer.substr(start_line, end_line - start_line);
+    size_t pipe;
+    if (!long_pipe)
+      pipe = line.find_last_of('|');
+    else
+      pipe = std::string::npos;
+
+    if (pipe != std::string::npos) {
+      end_line = pipe;
+      while (end_line > 1 && std::isspace(line[end_line - 1]))
+        end_line--;
+      pipe++;
+      while (pipe < line.size() - 1 && std::isspace(line[pipe]))
+        pipe++;
+
+      if (line_number == 1) {
+        short_buffer.append(line.substr(0, end_line));
+        pd_buffer.append(line.substr(pipe));
+        perfdata_already_filled = true;
+      } else {
+        if (line_number > 2)
+          long_buffer.append(escape_newlines_please ? "\\n" : "\n");
+        long_buffer.append(line.substr(0, end_line));
+        if (perfdata_already_filled)
+          pd_buffer.append(" ");
+        pd_buffer.append(line.substr(pipe));
+        long_pipe = true;
+      }
+    } else {
+      end_line = line.size();
+      while (end_line > 1 && std::isspace(line[end_line - 1]))
+        end_line--;
+      line.erase(end_line);
+      if (line_number == 1)
+        short_buffer.append(line);
+      else {
+        if (!long_pipe) {
+          if (line_number > 2)
+            long_buffer.append(escape_newlines_please ? "\\n" : "\n");
+          long_buffer.append(line);
+        } else {
+          if (perfdata_already_filled)
+            pd_buffer.append(" ");
+          pd_buffer.append(line);
+        }
+      }
+    }
+    start_line = pos_line;
+    line_number++;
+  }
+}
+
+/* A 128KB plugin output with long output and perfdata on several lines. */
+static std::string large_output() {
+  std::string retval{
+      "DISK OK - free space: / 3326 MB (56%); | /=2643MB;5948\\n"};
+  for (int i = 0; retval.size() < 65536; ++i)
+    retval.append("/mnt/volume" + std::to_string(i) +
+                  " 15272 MB (77%);  \\n");
+  retval.append("| /boot=68MB;88;93;0;98 ");
+  for (int i = 0; retval.size() < 2 * 65536; ++i)
+    retval.append("\\n/mnt/volume" + std::to_string(i) +
+                  "=69357MB;253404;253409;0;253414");
+  return retval;
+}
+
 TEST(ParseCheckOutput, singleLineWithoutPerfdata) {
   std::string buf = "The service is OK";
   std::string short_output;
@@ -182,3 +278,53 @@ TEST(ParseCheckOutput, CheckDummy) {
   ASSERT_EQ(long_output, "");
   ASSERT_EQ(perf_data, "v3metric1=1 v3metric2=18;1 v3metric3=12;1;2;0;");
 }
+
+// Given random outputs made of newlines, escaped newlines, pipes and spaces
+// When they are parsed with all the options
+// Then the result is the same as with the line by line implementation.
+TEST(ParseCheckOutput, Fuzz) {
+  static char const alphabet[] = "ab =;\t\r\n\\n||";
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> length(0, 64);
+  std::uniform_int_distribution<size_t> letter(0, sizeof(alphabet) - 2);
+  for (int i = 0; i < 200000; ++i) {
+    std::string buf;
+    for (size_t j = length(gen); j > 0; --j)
+      buf.push_back(alphabet[letter(gen)]);
+    for (int options = 0; options < 4; ++options) {
+      std::string expected[3];
+      std::string result[3];
+      reference_parse_check_output(buf, expected[0], expected[1], expected[2],
+                                   options & 1, options & 2);
+      parse_check_output(buf, result[0], result[1], result[2], options & 1,
+                         options & 2);
+      ASSERT_EQ(result[0], expected[0]) << "output: '" << buf << "'";
+      ASSERT_EQ(result[1], expected[1]) << "output: '" << buf << "'";
+      ASSERT_EQ(result[2], expected[2]) << "output: '" << buf << "'";
+    }
+  }
+}
+
+// Given a 128KB output with long output and perfdata on several lines
+// When it is parsed
+// Then the result is the same as with the line by line implementation.
+TEST(ParseCheckOutput, LargeOutput) {
+  std::string const buf{large_output()};
+  for (bool escaped : {false, true}) {
+    std::string input{buf};
+    if (!escaped)
+      for (size_t pos = 0;
+           (pos = input.find("\\n", pos)) != std::string::npos;)
+        input.replace(pos, 2, "\n");
+
+    std::string expected[3];
+    std::string result[3];
+    reference_parse_check_output(input, expected[0], expected[1], expected[2],
+                                 true, escaped);
+    parse_check_output(input, result[0], result[1], result[2], true, escaped);
+    for (int i = 0; i < 3; ++i)
+      ASSERT_EQ(result[i], expected[i]);
+    ASSERT_FALSE(result[1].empty());
+    ASSERT_FALSE(result[2].empty());
+  }
+}
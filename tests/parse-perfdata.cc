@@ -0,0 +1,134 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "com/centreon/engine/perfdata.hh"
+
+using namespace com::centreon::engine;
+
+// Given a perfdata with several metrics
+// When it is parsed
+// Then each metric has its label, value, unit, thresholds, min and max.
+TEST(ParsePerfdata, Metrics) {
+  std::string pd{"time=0.012s;1;2;0;10 size=1024B;;;0 'used space'=80%;@10:20"};
+  std::vector<perfdata::metric> const& metrics(perfdata::parse(pd));
+  ASSERT_EQ(metrics.size(), 3u);
+
+  ASSERT_STREQ(metrics[0].label, "time");
+  ASSERT_DOUBLE_EQ(metrics[0].value, 0.012);
+  ASSERT_STREQ(metrics[0].uom, "s");
+  ASSERT_EQ(metrics[0].warning_low, 0);
+  ASSERT_EQ(metrics[0].warning, 1);
+  ASSERT_EQ(metrics[0].critical_low, 0);
+  ASSERT_EQ(metrics[0].critical, 2);
+  ASSERT_EQ(metrics[0].min, 0);
+  ASSERT_EQ(metrics[0].max, 10);
+  ASSERT_EQ(metrics[0].data_source_type, 'g');
+  ASSERT_EQ(std::string(metrics[0].text, metrics[0].text_size), "time=0.012s");
+
+  ASSERT_STREQ(metrics[1].label, "size");
+  ASSERT_EQ(metrics[1].value, 1024);
+  ASSERT_STREQ(metrics[1].uom, "B");
+  ASSERT_TRUE(std::isnan(metrics[1].warning));
+  ASSERT_TRUE(std::isnan(metrics[1].critical));
+  ASSERT_EQ(metrics[1].min, 0);
+  ASSERT_TRUE(std::isnan(metrics[1].max));
+
+  ASSERT_STREQ(metrics[2].label, "used space");
+  ASSERT_EQ(metrics[2].value, 80);
+  ASSERT_STREQ(metrics[2].uom, "%");
+  ASSERT_EQ(metrics[2].warning_low, 10);
+  ASSERT_EQ(metrics[2].warning, 20);
+  ASSERT_EQ(metrics[2].warning_inverted, 1);
+  ASSERT_TRUE(std::isnan(metrics[2].critical));
+  ASSERT_EQ(std::string(metrics[2].text, metrics[2].text_size),
+            "'used space'=80%");
+}
+
+// Given ranges written in all the possible forms
+// When they are parsed
+// Then omitted starts are 0, omitted ends are infinite and '~' is -infinite.
+TEST(ParsePerfdata, Ranges) {
+  double const inf = std::numeric_limits<double>::infinity();
+  std::string pd{"a=1;10:;~:5 b=1;:3;-2.5:-1"};
+  std::vector<perfdata::metric> const& metrics(perfdata::parse(pd));
+  ASSERT_EQ(metrics.size(), 2u);
+  ASSERT_EQ(metrics[0].warning_low, 10);
+  ASSERT_EQ(metrics[0].warning, inf);
+  ASSERT_EQ(metrics[0].critical_low, -inf);
+  ASSERT_EQ(metrics[0].critical, 5);
+  ASSERT_EQ(metrics[0].warning_inverted, 0);
+  ASSERT_EQ(metrics[1].warning_low, 0);
+  ASSERT_EQ(metrics[1].warning, 3);
+  ASSERT_EQ(metrics[1].critical_low, -2.5);
+  ASSERT_EQ(metrics[1].critical, -1);
+}
+
+// Given metrics with data source types, quotes and unknown values
+// When they are parsed
+// Then labels are given without their type nor quotes.
+TEST(ParsePerfdata, Labels) {
+  std::string pd{"d[traffic]=12c 'it''s'=U a[]=2 'g[x y]'=3"};
+  std::vector<perfdata::metric> const& metrics(perfdata::parse(pd));
+  ASSERT_EQ(metrics.size(), 4u);
+  ASSERT_STREQ(metrics[0].label, "traffic");
+  ASSERT_EQ(metrics[0].data_source_type, 'd');
+  ASSERT_STREQ(metrics[0].uom, "c");
+  ASSERT_STREQ(metrics[1].label, "it's");
+  ASSERT_TRUE(std::isnan(metrics[1].value));
+  ASSERT_STREQ(metrics[2].label, "a[]");
+  ASSERT_EQ(metrics[2].data_source_type, 'g');
+  ASSERT_STREQ(metrics[3].label, "x y");
+  ASSERT_EQ(perfdata::find(metrics, "x y"), &metrics[3]);
+  ASSERT_EQ(perfdata::find(metrics, "y"), nullptr);
+}
+
+// Given a perfdata with invalid metrics
+// When it is parsed
+// Then the invalid metrics are skipped.
+TEST(ParsePerfdata, Invalid) {
+  std::string pd{"novalue= =1 x=abc ok=1;a;b;c;d nolabel 'unterminated=2"};
+  std::vector<perfdata::metric> const& metrics(perfdata::parse(pd));
+  ASSERT_EQ(metrics.size(), 1u);
+  ASSERT_STREQ(metrics[0].label, "ok");
+  ASSERT_TRUE(std::isnan(metrics[0].warning));
+  ASSERT_TRUE(std::isnan(metrics[0].max));
+  ASSERT_TRUE(perfdata::parse("").empty());
+}
+
+// Given the perfdata of a check with 50 metrics
+// When it is parsed
+// Then the 50 metrics are returned in order.
+TEST(ParsePerfdata, ManyMetrics) {
+  std::string pd;
+  for (int i = 0; i < 50; ++i)
+    pd.append("'/mnt/volume" + std::to_string(i) +
+              "'=69357MB;253404;253409;0;253414 ");
+  std::vector<perfdata::metric> const& metrics(perfdata::parse(pd));
+  ASSERT_EQ(metrics.size(), 50u);
+  for (int i = 0; i < 50; ++i)
+    ASSERT_EQ(std::string(metrics[i].label), "/mnt/volume" + std::to_string(i));
+  ASSERT_EQ(metrics[49].value, 69357);
+  ASSERT_EQ(metrics[49].max, 253414);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/state_table.hh"
+#include "helper.hh"
+#include "test_engine.hh"
+
+using namespace com::centreon::engine;
+
+class StateTable : public TestEngine {
+ public:
+  void SetUp() override { init_config_state(); }
+
+  void TearDown() override { deinit_config_state(); }
+};
+
+// Given a state table
+// When objects are added and removed
+// Then the ids of removed objects are given to the next added objects, with
+// cleared fields.
+TEST_F(StateTable, ReuseIds) {
+  state_table states;
+  checkable* a = reinterpret_cast<checkable*>(0x10);
+  checkable* b = reinterpret_cast<checkable*>(0x20);
+  ASSERT_EQ(states.add(a), 0u);
+  ASSERT_EQ(states.add(b), 1u);
+  states.next_check[0] = 1000;
+  states.flags[0] = state_table::is_executing;
+  states.remove(0);
+  ASSERT_EQ(states.object[0], nullptr);
+  ASSERT_EQ(states.add(b), 0u);
+  ASSERT_EQ(states.next_check[0], 0);
+  ASSERT_EQ(states.flags[0], 0);
+  ASSERT_EQ(states.size(), 2u);
+}
+
+// Given a host and a service
+// When their scheduling fields are set
+// Then they are stored in the host and service tables, and the slots are
+// released with the objects.
+TEST_F(StateTable, Objects) {
+  configuration::applier::contact ct_aply;
+  configuration::contact ctct{new_configuration_contact("admin", true)};
+  ct_aply.add_object(ctct);
+  ct_aply.expand_objects(*config);
+  ct_aply.resolve_object(ctct);
+  configuration::host hst{new_configuration_host("test_host", "admin")};
+  configuration::applier::host hst_aply;
+  hst_aply.add_object(hst);
+  configuration::service svc{
+      new_configuration_service("test_host", "test_svc", "admin")};
+  configuration::applier::service svc_aply;
+  svc_aply.add_object(svc);
+  hst_aply.resolve_object(hst);
+  svc_aply.resolve_object(svc);
+
+  std::shared_ptr<host> h = host::hosts.begin()->second;
+  std::shared_ptr<service> s = service::services.begin()->second;
+  state_table& hosts = state_table::hosts();
+  state_table& services = state_table::services();
+  uint32_t hid = h->get_state_id();
+  uint32_t sid = s->get_state_id();
+  ASSERT_EQ(hosts.object[hid], h.get());
+  ASSERT_EQ(services.object[sid], s.get());
+
+  s->set_next_check(1234);
+  s->set_current_state(service::state_critical);
+  s->set_check_options(CHECK_OPTION_FORCE_EXECUTION);
+  s->set_is_executing(true);
+  h->set_current_attempt(2);
+  h->set_checks_enabled(false);
+  ASSERT_EQ(services.next_check[sid], 1234);
+  ASSERT_EQ(services.current_state[sid], service::state_critical);
+  ASSERT_EQ(services.check_options[sid], CHECK_OPTION_FORCE_EXECUTION);
+  ASSERT_TRUE(services.flags[sid] & state_table::is_executing);
+  ASSERT_EQ(hosts.current_attempt[hid], 2);
+  ASSERT_FALSE(hosts.flags[hid] & state_table::checks_enabled);
+  ASSERT_EQ(s->get_current_state(), service::state_critical);
+  ASSERT_TRUE(s->get_is_executing());
+  ASSERT_FALSE(h->get_checks_enabled());
+
+  h.reset();
+  s.reset();
+  deinit_config_state();
+  ASSERT_EQ(hosts.object[hid], nullptr);
+  ASSERT_EQ(services.object[sid], nullptr);
+  init_config_state();
+}
+
+// Given 1.2 million services in a state table
+// When the services to check are searched from the flags and next_check
+// columns, and some ids are given back
+// Then the due services are found and the ids given back are reused.
+TEST_F(StateTable, ManyServices) {
+  uint32_t const count = 1200000;
+  state_table states;
+  for (uint32_t i = 0; i < count; ++i) {
+    states.add(nullptr);
+    states.next_check[i] = 1600000000 + i % 600;
+    states.flags[i] = state_table::should_be_scheduled |
+                      (i % 10 ? state_table::checks_enabled : 0);
+  }
+
+  uint16_t const wanted =
+      state_table::should_be_scheduled | state_table::checks_enabled;
+  uint32_t due = 0;
+  for (uint32_t i = 0; i < count; ++i)
+    due += (states.flags[i] & wanted) == wanted &&
+           states.next_check[i] < 1600000060;
+  ASSERT_EQ(due, 108000u);
+
+  for (uint32_t i = 0; i < count; i += 2)
+    states.remove(i);
+  for (uint32_t i = 0; i < count; i += 2)
+    ASSERT_LT(states.add(nullptr), count);
+  ASSERT_EQ(states.size(), count);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/globals.hh"
+#include "com/centreon/engine/statistics.hh"
+#include "com/centreon/engine/stats_segment.hh"
+#include "helper.hh"
+
+using namespace com::centreon::engine;
+
+class StatsSegment : public ::testing::Test {
+ public:
+  void SetUp() override {
+    init_config_state();
+    config->status_file("/tmp/stats_segment_status.dat");
+  }
+
+  void TearDown() override {
+    statistics::instance().remove_segment();
+    deinit_config_state();
+  }
+};
+
+// Given a configured status file
+// When statistics are published
+// Then they can be read from the segment next to the status file
+// And the segment is removed with the status data.
+TEST_F(StatsSegment, PublishAndRemove) {
+  statistics::instance().publish_segment();
+  statistics::instance().publish_segment();
+
+  std::string path(stats_segment::path(config->status_file()));
+  int fd = open(path.c_str(), O_RDONLY);
+  ASSERT_GE(fd, 0);
+  void* addr =
+      mmap(nullptr, sizeof(stats_segment), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  ASSERT_NE(addr, MAP_FAILED);
+
+  stats_segment::payload p;
+  ASSERT_TRUE(static_cast<stats_segment const*>(addr)->read(p));
+  munmap(addr, sizeof(stats_segment));
+  ASSERT_EQ(p.pid, getpid());
+  ASSERT_EQ(p.program_start, program_start);
+  ASSERT_EQ(p.services.count, 0u);
+  ASSERT_EQ(p.hosts.count, 0u);
+
+  statistics::instance().remove_segment();
+  ASSERT_NE(access(path.c_str(), F_OK), 0);
+}
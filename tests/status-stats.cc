@@ -0,0 +1,140 @@
+/*
+ * Copyright 2021 Centreon (https://www.centreon.com/)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For more information : contact@centreon.com
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "com/centreon/engine/configuration/applier/contact.hh"
+#include "com/centreon/engine/configuration/applier/host.hh"
+#include "com/centreon/engine/configuration/applier/service.hh"
+#include "com/centreon/engine/configuration/state.hh"
+#include "com/centreon/engine/status_stats.hh"
+#include "helper.hh"
+#include "test_engine.hh"
+
+using namespace com::centreon::engine;
+
+class StatusStats : public TestEngine {
+ public:
+  void SetUp() override {
+    init_config_state();
+
+    configuration::applier::contact ct_aply;
+    configuration::contact ctct{new_configuration_contact("admin", true)};
+    ct_aply.add_object(ctct);
+    ct_aply.expand_objects(*config);
+    ct_aply.resolve_object(ctct);
+    configuration::host hst{new_configuration_host("test_host", "admin")};
+    configuration::applier::host hst_aply;
+    hst_aply.add_object(hst);
+    hst_aply.resolve_object(hst);
+    configuration::applier::service svc_aply;
+    for (int i = 0; i < 3; ++i) {
+      configuration::service svc{new_configuration_service(
+          "test_host", "test_svc_" + std::to_string(i), "admin", i + 1)};
+      svc_aply.add_object(svc);
+      svc_aply.resolve_object(svc);
+    }
+    for (auto& p : service::services)
+      _svc.push_back(p.second.get());
+  }
+
+  void TearDown() override {
+    _svc.clear();
+    deinit_config_state();
+  }
+
+ protected:
+  std::vector<service*> _svc;
+};
+
+// Given three services
+// When the state of one of them changes
+// Then the totals only follow it once its status is updated.
+TEST_F(StatusStats, FollowStatusUpdates) {
+  status_stats::totals totals;
+  status_stats::services().get(1000, totals);
+  ASSERT_EQ(totals.count, 3u);
+  ASSERT_EQ(totals.states[service::state_ok], 3u);
+  ASSERT_EQ(totals.active.count, 3u);
+
+  _svc[0]->set_current_state(service::state_critical);
+  status_stats::services().get(1000, totals);
+  ASSERT_EQ(totals.states[service::state_critical], 0u);
+
+  _svc[0]->update_status();
+  status_stats::services().get(1000, totals);
+  ASSERT_EQ(totals.states[service::state_ok], 2u);
+  ASSERT_EQ(totals.states[service::state_critical], 1u);
+
+  _svc[1]->set_check_type(checkable::check_passive);
+  _svc[1]->update_status();
+  status_stats::services().get(1000, totals);
+  ASSERT_EQ(totals.active.count, 2u);
+  ASSERT_EQ(totals.passive.count, 1u);
+  ASSERT_EQ(totals.count, 3u);
+}
+
+// Given three services with different latencies
+// When the one with the highest latency gets a lower one
+// Then the maximum and the average follow.
+TEST_F(StatusStats, Ranges) {
+  for (int i = 0; i < 3; ++i) {
+    _svc[i]->set_latency(i + 1);
+    _svc[i]->update_status();
+  }
+  status_stats::totals totals;
+  status_stats::services().get(1000, totals);
+  ASSERT_EQ(totals.active.min_latency, 1);
+  ASSERT_EQ(totals.active.max_latency, 3);
+  ASSERT_EQ(totals.active.average_latency, 2);
+
+  _svc[2]->set_latency(0.5);
+  _svc[2]->update_status();
+  status_stats::services().get(1000, totals);
+  ASSERT_EQ(totals.active.min_latency, 0.5);
+  ASSERT_EQ(totals.active.max_latency, 2);
+  ASSERT_EQ(totals.active.average_latency, 3.5 / 3);
+}
+
+// Given services checked 30 seconds, 200 seconds and 2000 seconds ago
+// When the totals are read
+// Then each check is counted in the windows containing it.
+TEST_F(StatusStats, ChecksLastMinutes) {
+  time_t const now = 1600000000;
+  time_t const ago[3]{30, 200, 2000};
+  for (int i = 0; i < 3; ++i) {
+    _svc[i]->set_last_check(now - ago[i]);
+    _svc[i]->update_status();
+  }
+  status_stats::totals totals;
+  status_stats::services().get(now, totals);
+  ASSERT_EQ(totals.active.checks_last[0], 1u);
+  ASSERT_EQ(totals.active.checks_last[1], 2u);
+  ASSERT_EQ(totals.active.checks_last[2], 2u);
+  ASSERT_EQ(totals.active.checks_last[3], 3u);
+
+  _svc[0]->set_last_check(now - 4000);
+  _svc[0]->update_status();
+  status_stats::services().get(now, totals);
+  ASSERT_EQ(totals.active.checks_last[0], 0u);
+  ASSERT_EQ(totals.active.checks_last[3], 2u);
+}